@@ -0,0 +1,21 @@
+#!/usr/bin/env bash
+set -e
+
+# Perf variant in its own build dir: sdkconfig + sdkconfig.perf overrides.
+# The regular build/ and sdkconfig are left untouched.
+# Usage: ./build_perf.sh [idf.py actions...]   (default: build)
+
+if [ $# -eq 0 ]; then
+  set -- build
+fi
+
+# Regenerate from the overlay whenever either input changed
+if [ -f build_perf/sdkconfig ] && \
+   { [ sdkconfig -nt build_perf/sdkconfig ] || [ sdkconfig.perf -nt build_perf/sdkconfig ]; }; then
+  rm build_perf/sdkconfig
+fi
+
+idf.py -B build_perf \
+  -D SDKCONFIG=build_perf/sdkconfig \
+  -D SDKCONFIG_DEFAULTS="sdkconfig;sdkconfig.perf" \
+  "$@"
@@ -13,6 +13,10 @@
 #include "esp_netif.h"
 #include "esp_wifi.h"
 #include "nvs_flash.h"
+#include "esp_heap_caps.h"
+#include "mem_track.h"
+#include "evtrace.h"
+#include "dlog.h"
 
 #include "lwip/sockets.h"
 #include "lwip/inet.h"
@@ -59,7 +63,7 @@ static int wifi_scan_list(CommWifiAp* out, int cap)
         return 0;
     }
 
-    wifi_ap_record_t *aps = (wifi_ap_record_t *)calloc(ap_num, sizeof(*aps));
+    wifi_ap_record_t *aps = (wifi_ap_record_t *)MemTrack_Calloc(kMemTagWifi, ap_num, sizeof(*aps), MALLOC_CAP_DEFAULT);
     if (!aps) {
         ESP_LOGW(TAG, "scan: out of memory");
         return 0;
@@ -92,13 +96,14 @@ static int wifi_scan_list(CommWifiAp* out, int cap)
         }
     }
 
-    free(aps);
+    MemTrack_Free(aps);
     return count;
 }
 
 static void udp_echo_task(void *arg)
 {
     const int port = CONFIG_COMM_WIFI_UDP_PORT;
+    EVTRACE_TASK("udp_echo");
 
     int sock = socket(AF_INET, SOCK_DGRAM, IPPROTO_IP);
     if (sock < 0) {
@@ -134,9 +139,12 @@ static void udp_echo_task(void *arg)
             break;
         }
 
-        char addr_str[64];
-        inet_ntoa_r(source_addr.sin_addr, addr_str, sizeof(addr_str));
-        ESP_LOGI(TAG, "RX %d bytes from %s:%d", len, addr_str, ntohs(source_addr.sin_port));
+        EVTRACE_BEGIN_V(kEvtUdpEcho, len);
+        // Deferred + rate limited: formatting per datagram throttled the echo
+        uint32_t ip = ntohl(source_addr.sin_addr.s_addr);
+        DLOGI_RL(TAG, 250, "RX %d bytes from %lu.%lu.%lu.%lu:%u", len,
+                 (ip >> 24) & 0xFF, (ip >> 16) & 0xFF, (ip >> 8) & 0xFF, ip & 0xFF,
+                 ntohs(source_addr.sin_port));
 
         int sent = sendto(sock, rxbuf, len, 0,
                           (struct sockaddr *)&source_addr, sizeof(source_addr));
@@ -144,7 +152,8 @@ static void udp_echo_task(void *arg)
             ESP_LOGE(TAG, "sendto() failed: errno=%d", errno);
             break;
         }
-        ESP_LOGI(TAG, "TX %d bytes", sent);
+        DLOGI_RL(TAG, 250, "TX %d bytes", sent);
+        EVTRACE_END(kEvtUdpEcho);
     }
 
     close(sock);
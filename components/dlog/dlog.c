@@ -0,0 +1,157 @@
+#include "dlog.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+static const char* TAG = "DLOG";
+
+_Static_assert((DLOG_RING_ENTRIES & (DLOG_RING_ENTRIES - 1)) == 0, "ring size must be a power of two");
+
+typedef struct {
+    const DlogSite* site;
+    const char* tag;
+    uint32_t ts_ms;
+    uint16_t suppressed;
+    uint8_t  level;
+    uint8_t  nargs;
+    uint32_t args[DLOG_MAX_ARGS];
+} DlogEntry;
+
+// Static so sites can log before Dlog_Init(); entries wait for the task
+static DlogEntry s_ring[DLOG_RING_ENTRIES];
+static uint32_t s_head = 0;     // next write
+static uint32_t s_tail = 0;     // next read
+static uint32_t s_dropped = 0;
+static portMUX_TYPE s_mux = portMUX_INITIALIZER_UNLOCKED;
+static volatile DlogSink s_sink = NULL;
+
+void Dlog_Write(DlogSite* site, esp_log_level_t level, const char* tag,
+                int nargs, const uint32_t* args)
+{
+    uint32_t now = esp_log_timestamp();
+
+    portENTER_CRITICAL_SAFE(&s_mux);
+
+    if (site->min_interval_ms && site->last_ms &&
+        (now - site->last_ms) < site->min_interval_ms) {
+        site->suppressed++;
+        portEXIT_CRITICAL_SAFE(&s_mux);
+        return;
+    }
+
+    if (s_head - s_tail >= DLOG_RING_ENTRIES) {
+        s_dropped++;
+        portEXIT_CRITICAL_SAFE(&s_mux);
+        return;
+    }
+
+    DlogEntry* e = &s_ring[s_head & (DLOG_RING_ENTRIES - 1)];
+    e->site = site;
+    e->tag = tag;
+    e->ts_ms = now;
+    e->suppressed = (uint16_t)(site->suppressed > 0xFFFF ? 0xFFFF : site->suppressed);
+    e->level = (uint8_t)level;
+    e->nargs = (uint8_t)nargs;
+    memcpy(e->args, args, sizeof(e->args));
+    s_head++;
+
+    site->last_ms = now ? now : 1;
+    site->suppressed = 0;
+
+    portEXIT_CRITICAL_SAFE(&s_mux);
+}
+
+uint32_t Dlog_GetDropped(void)
+{
+    return s_dropped;
+}
+
+void Dlog_SetSink(DlogSink sink)
+{
+    s_sink = sink;
+}
+
+static char level_letter(esp_log_level_t level)
+{
+    switch (level) {
+    case ESP_LOG_ERROR: return 'E';
+    case ESP_LOG_WARN:  return 'W';
+    case ESP_LOG_DEBUG: return 'D';
+    case ESP_LOG_VERBOSE: return 'V';
+    default:            return 'I';
+    }
+}
+
+static void format_entry(const DlogEntry* e)
+{
+    char msg[160];
+    char line[224];
+    const uint32_t* a = e->args;
+
+    // Unused trailing arguments are ignored by vsnprintf
+    snprintf(msg, sizeof(msg), e->site->fmt, a[0], a[1], a[2], a[3], a[4], a[5]);
+
+    esp_log_level_t level = (esp_log_level_t)e->level;
+    int n;
+    if (e->suppressed) {
+        n = snprintf(line, sizeof(line), "%c (%lu) %s: %s (+%u suppressed)\n",
+                     level_letter(level), (unsigned long)e->ts_ms, e->tag, msg,
+                     (unsigned)e->suppressed);
+    } else {
+        n = snprintf(line, sizeof(line), "%c (%lu) %s: %s\n",
+                     level_letter(level), (unsigned long)e->ts_ms, e->tag, msg);
+    }
+    if (n < 0) return;
+    if (n >= (int)sizeof(line)) {
+        n = (int)sizeof(line) - 1;
+        line[n - 1] = '\n';
+    }
+
+    esp_log_write(level, e->tag, "%s", line);
+
+    DlogSink sink = s_sink;
+    if (sink) sink(line, (uint32_t)n);
+}
+
+static void dlog_task(void* arg)
+{
+    (void)arg;
+    uint32_t reported_drops = 0;
+
+    while (1) {
+        while (1) {
+            DlogEntry e;
+
+            portENTER_CRITICAL(&s_mux);
+            bool empty = (s_tail == s_head);
+            if (!empty) {
+                e = s_ring[s_tail & (DLOG_RING_ENTRIES - 1)];
+                s_tail++;
+            }
+            portEXIT_CRITICAL(&s_mux);
+
+            if (empty) break;
+            format_entry(&e);
+        }
+
+        uint32_t drops = s_dropped;
+        if (drops != reported_drops) {
+            ESP_LOGW(TAG, "ring full, %lu entries lost", (unsigned long)(drops - reported_drops));
+            reported_drops = drops;
+        }
+
+        vTaskDelay(pdMS_TO_TICKS(DLOG_TASK_PERIOD_MS));
+    }
+}
+
+void Dlog_Init(void)
+{
+    static bool started = false;
+    if (started) return;
+    started = true;
+
+    xTaskCreate(dlog_task, "dlog", 3072, NULL, 1, NULL);
+}
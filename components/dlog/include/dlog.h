@@ -0,0 +1,51 @@
+#pragma once
+#include <stdint.h>
+
+#include "esp_log.h"
+
+// Deferred logging for hot paths.
+// A call site stores a pointer to its static descriptor (format, tag, rate
+// limit) plus up to DLOG_MAX_ARGS raw 32-bit arguments in a ring; a
+// low-priority task does the printf work and the UART0 output later.
+//
+// Arguments are copied as uint32_t, so formats may only use 32-bit integer
+// conversions (%d %u %x %c %ld %lu ...). No %s, no floats, no 64-bit values.
+
+#define DLOG_MAX_ARGS     6
+#define DLOG_RING_ENTRIES 128   // power of two
+#define DLOG_TASK_PERIOD_MS 20
+
+typedef struct {
+    const char* fmt;
+    uint32_t min_interval_ms;   // 0 = no rate limit
+    uint32_t last_ms;
+    uint32_t suppressed;        // rate-limited since the last stored entry
+} DlogSite;
+
+void Dlog_Init(void);
+
+// tag must have static storage (the usual per-file TAG is fine)
+void Dlog_Write(DlogSite* site, esp_log_level_t level, const char* tag,
+                int nargs, const uint32_t* args);
+
+uint32_t Dlog_GetDropped(void);     // entries lost to a full ring
+
+// Optional copy of every formatted line (newline included) for another
+// transport, e.g. the UART1 log channel. Runs in the dlog task; NULL removes it.
+typedef void (*DlogSink)(const char* line, uint32_t len);
+void Dlog_SetSink(DlogSink sink);
+
+#define DLOG_NARGS(...)  DLOG_NARGS_(0, ##__VA_ARGS__, 6, 5, 4, 3, 2, 1, 0)
+#define DLOG_NARGS_(_0, _1, _2, _3, _4, _5, _6, n, ...) n
+
+#define DLOG_AT(level, tag_, interval_ms, fmt_, ...)                                     \
+    do {                                                                                 \
+        _Static_assert(DLOG_NARGS(__VA_ARGS__) <= DLOG_MAX_ARGS, "too many dlog args"); \
+        static DlogSite _dlog_site = { .fmt = (fmt_), .min_interval_ms = (interval_ms) }; \
+        const uint32_t _dlog_args[DLOG_MAX_ARGS] = { __VA_ARGS__ };                      \
+        Dlog_Write(&_dlog_site, (level), (tag_), DLOG_NARGS(__VA_ARGS__), _dlog_args);   \
+    } while (0)
+
+#define DLOGI(tag, fmt, ...)               DLOG_AT(ESP_LOG_INFO, tag, 0, fmt, ##__VA_ARGS__)
+#define DLOGW(tag, fmt, ...)               DLOG_AT(ESP_LOG_WARN, tag, 0, fmt, ##__VA_ARGS__)
+#define DLOGI_RL(tag, interval_ms, fmt, ...) DLOG_AT(ESP_LOG_INFO, tag, interval_ms, fmt, ##__VA_ARGS__)
@@ -0,0 +1,185 @@
+#include "evtrace.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <stdatomic.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_attr.h"
+#include "esp_cpu.h"
+#include "esp_timer.h"
+#include "esp_heap_caps.h"
+#include "esp_log.h"
+#include "sdkconfig.h"
+#include "mem_track.h"
+
+static const char* TAG = "EVTRACE";
+
+#define EVTRACE_CORES CONFIG_FREERTOS_NUMBER_OF_CORES
+
+_Static_assert(sizeof(EvTraceEvent) == 16, "EvTraceEvent must stay 16 bytes");
+_Static_assert((EVTRACE_RING_EVENTS & (EVTRACE_RING_EVENTS - 1)) == 0, "ring size must be a power of two");
+
+typedef struct {
+    EvTraceEvent* buf;
+    atomic_uint head;       // total events ever reserved on this ring
+} EvTraceRing;
+
+static const char* const kEventNames[kEvtCount] = {
+#define EVTRACE_NAME(id, name) name,
+    EVTRACE_EVENT_LIST(EVTRACE_NAME)
+#undef EVTRACE_NAME
+};
+
+#define EVTRACE_MAX_TASKS 24
+
+typedef struct {
+    uint32_t task;
+    const char* name;
+} EvTraceTaskName;
+
+static EvTraceRing s_rings[EVTRACE_CORES];
+static atomic_bool s_on = false;
+
+// Names outlive the ring (the naming event is usually overwritten first)
+static EvTraceTaskName s_tasks[EVTRACE_MAX_TASKS];
+static int s_task_count = 0;
+static portMUX_TYPE s_task_mux = portMUX_INITIALIZER_UNLOCKED;
+
+void IRAM_ATTR EvTrace_Emit(uint16_t id, uint8_t type, uint32_t value)
+{
+    if (!atomic_load_explicit(&s_on, memory_order_relaxed)) return;
+
+    // The task may migrate after the core id is read; the atomic reservation
+    // keeps the slot private either way, the core field just names the ring.
+    uint32_t core = (uint32_t)esp_cpu_get_core_id();
+    EvTraceRing* r = &s_rings[core];
+
+    unsigned idx = atomic_fetch_add_explicit(&r->head, 1u, memory_order_relaxed);
+    EvTraceEvent* e = &r->buf[idx & (EVTRACE_RING_EVENTS - 1)];
+
+    e->ccount = esp_cpu_get_cycle_count();
+    e->task = (uint32_t)(uintptr_t)xTaskGetCurrentTaskHandle();
+    e->id = id;
+    e->type = type;
+    e->core = (uint8_t)core;
+    e->value = value;
+}
+
+void EvTrace_NameTask(const char* name)
+{
+    uint32_t task = (uint32_t)(uintptr_t)xTaskGetCurrentTaskHandle();
+
+    portENTER_CRITICAL(&s_task_mux);
+    int i = 0;
+    while (i < s_task_count && s_tasks[i].task != task) i++;
+    if (i < EVTRACE_MAX_TASKS) {
+        s_tasks[i].task = task;
+        s_tasks[i].name = name;
+        if (i == s_task_count) s_task_count++;
+    }
+    portEXIT_CRITICAL(&s_task_mux);
+
+    EvTrace_Emit(kEvtTaskName, kEvTypeMeta, (uint32_t)(uintptr_t)name);
+}
+
+static void emit_sync(void)
+{
+    // Pairs this core's cycle counter with the shared microsecond clock
+    EvTrace_Emit(kEvtSync, kEvTypeMeta, (uint32_t)esp_timer_get_time());
+}
+
+static void sync_task(void* arg)
+{
+    (void)arg;
+    EVTRACE_TASK("evtrace_sync");
+
+    while (1) {
+        emit_sync();
+        vTaskDelay(pdMS_TO_TICKS(EVTRACE_SYNC_MS));
+    }
+}
+
+void EvTrace_Init(void)
+{
+    static bool inited = false;
+    if (inited) return;
+    if (!EVTRACE_ENABLED) return;   // nothing emits, so nothing to allocate
+
+    for (int c = 0; c < EVTRACE_CORES; c++) {
+        s_rings[c].buf = (EvTraceEvent*)MemTrack_Calloc(kMemTagTrace, EVTRACE_RING_EVENTS,
+                                                        sizeof(EvTraceEvent),
+                                                        MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+        if (!s_rings[c].buf) {
+            ESP_LOGE(TAG, "no memory for core %d ring", c);
+            return;
+        }
+        atomic_store(&s_rings[c].head, 0u);
+    }
+    inited = true;
+
+    // One low-priority sync task per core keeps cycle-counter wraps resolvable
+    for (int c = 0; c < EVTRACE_CORES; c++) {
+        xTaskCreatePinnedToCore(sync_task, "evtrace_sync", 2048, NULL, 1, NULL, c);
+    }
+
+    atomic_store(&s_on, true);
+    ESP_LOGI(TAG, "init %d cores x %d events", EVTRACE_CORES, EVTRACE_RING_EVENTS);
+}
+
+void EvTrace_Enable(bool on)
+{
+    atomic_store(&s_on, on && s_rings[0].buf != NULL);
+}
+
+bool EvTrace_IsEnabled(void)
+{
+    return atomic_load(&s_on);
+}
+
+static void dump_ring(int core)
+{
+    const EvTraceRing* r = &s_rings[core];
+    unsigned head = atomic_load(&r->head);
+    unsigned count = head < EVTRACE_RING_EVENTS ? head : EVTRACE_RING_EVENTS;
+
+    printf("#CORE %d events=%u lost=%u\n", core, count, head - count);
+
+    for (unsigned i = head - count; i != head; i++) {
+        const EvTraceEvent* e = &r->buf[i & (EVTRACE_RING_EVENTS - 1)];
+        printf("E %08lx %08lx %04x %02x %02x %08lx\n",
+               (unsigned long)e->ccount, (unsigned long)e->task, (unsigned)e->id,
+               (unsigned)e->type, (unsigned)e->core, (unsigned long)e->value);
+    }
+}
+
+void EvTrace_DumpUart(void)
+{
+    if (!s_rings[0].buf) {
+        ESP_LOGW(TAG, "not enabled (CONFIG_EVTRACE_ENABLE)");
+        return;
+    }
+
+    bool was_on = atomic_exchange(&s_on, false);
+    // Let writers that already passed the enable check finish their slot
+    vTaskDelay(pdMS_TO_TICKS(2));
+
+    printf("\n#EVTRACE v1 cpu_hz=%lu cores=%d ring=%d\n",
+           (unsigned long)CONFIG_ESP_DEFAULT_CPU_FREQ_MHZ * 1000000UL, EVTRACE_CORES,
+           EVTRACE_RING_EVENTS);
+    for (int i = 0; i < kEvtCount; i++) {
+        printf("#ID %d %s\n", i, kEventNames[i]);
+    }
+    for (int i = 0; i < s_task_count; i++) {
+        printf("#TASK %08lx %s\n", (unsigned long)s_tasks[i].task, s_tasks[i].name);
+    }
+    for (int c = 0; c < EVTRACE_CORES; c++) {
+        dump_ring(c);
+        atomic_store(&s_rings[c].head, 0u);
+    }
+    printf("#END\n");
+    fflush(stdout);
+
+    atomic_store(&s_on, was_on);
+}
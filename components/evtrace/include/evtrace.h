@@ -0,0 +1,99 @@
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+
+// Binary event trace.
+// One ring per core; writers reserve a slot with an atomic increment, so
+// tasks and ISRs on either core can emit without taking a lock. Events are
+// 16 bytes with a CPU cycle-count timestamp. The rings are dumped as text
+// over the console (EvTrace_DumpUart) and turned into Chrome/Perfetto JSON
+// on the host by tools/evtrace_to_json.py.
+//
+// Off unless CONFIG_EVTRACE_ENABLE is set: the rings cost 32 KiB of internal
+// RAM. Host builds pass EVTRACE_ENABLED=0 directly.
+
+#ifndef EVTRACE_ENABLED
+#if defined(ESP_PLATFORM)
+#include "sdkconfig.h"
+#endif
+#if defined(CONFIG_EVTRACE_ENABLE) && CONFIG_EVTRACE_ENABLE
+#define EVTRACE_ENABLED 1
+#else
+#define EVTRACE_ENABLED 0
+#endif
+#endif
+
+#define EVTRACE_RING_EVENTS 1024    // per core, power of two
+#define EVTRACE_SYNC_MS     1000    // cycle counter <-> esp_timer resync period
+
+// Event ids. The name table is emitted in the dump header, so the host
+// converter needs no copy of this list.
+#define EVTRACE_EVENT_LIST(X)          \
+    X(kEvtSync,        "sync")         \
+    X(kEvtTaskName,    "task_name")    \
+    X(kEvtAppKey,      "app_key")      \
+    X(kEvtAppTick,     "app_tick")     \
+    X(kEvtLcdBlit,     "lcd_blit")     \
+    X(kEvtLcdFill,     "lcd_fill")     \
+    X(kEvtLcdPixel,    "lcd_pixel")    \
+    X(kEvtLcdQueue,    "lcd_dma_queue")\
+    X(kEvtLcdWait,     "lcd_dma_wait") \
+    X(kEvtI2sRead,     "i2s_read")     \
+    X(kEvtI2sWrite,    "i2s_write")    \
+    X(kEvtUartRx,      "uart1_rx")     \
+    X(kEvtUartKey,     "uart1_key")    \
+    X(kEvtUartPkt,     "uart_pkt")     \
+    X(kEvtUdpEcho,     "udp_echo")     \
+    X(kEvtFlashWrite,  "flash_write")
+
+typedef enum {
+#define EVTRACE_ENUM(id, name) id,
+    EVTRACE_EVENT_LIST(EVTRACE_ENUM)
+#undef EVTRACE_ENUM
+    kEvtCount
+} EvTraceId;
+
+typedef enum {
+    kEvTypeBegin = 0,
+    kEvTypeEnd,
+    kEvTypeInstant,
+    kEvTypeCounter,
+    kEvTypeMeta,        // sync / task name
+} EvTraceType;
+
+typedef struct {
+    uint32_t ccount;    // CPU cycle counter of the emitting core
+    uint32_t task;      // current task handle (0 in ISR before scheduler)
+    uint16_t id;        // EvTraceId
+    uint8_t  type;      // EvTraceType
+    uint8_t  core;
+    uint32_t value;
+} EvTraceEvent;
+
+void EvTrace_Init(void);
+void EvTrace_Enable(bool on);
+bool EvTrace_IsEnabled(void);
+
+void EvTrace_Emit(uint16_t id, uint8_t type, uint32_t value);
+
+// Label the calling task; name must have static storage
+void EvTrace_NameTask(const char* name);
+
+// Stops tracing, prints both rings on the console, then restarts
+void EvTrace_DumpUart(void);
+
+#if EVTRACE_ENABLED
+#define EVTRACE_BEGIN(id)            EvTrace_Emit((id), kEvTypeBegin, 0)
+#define EVTRACE_BEGIN_V(id, v)       EvTrace_Emit((id), kEvTypeBegin, (uint32_t)(v))
+#define EVTRACE_END(id)              EvTrace_Emit((id), kEvTypeEnd, 0)
+#define EVTRACE_INSTANT(id, v)       EvTrace_Emit((id), kEvTypeInstant, (uint32_t)(v))
+#define EVTRACE_COUNTER(id, v)       EvTrace_Emit((id), kEvTypeCounter, (uint32_t)(v))
+#define EVTRACE_TASK(name)           EvTrace_NameTask(name)
+#else
+#define EVTRACE_BEGIN(id)            do { } while (0)
+#define EVTRACE_BEGIN_V(id, v)       do { (void)(v); } while (0)
+#define EVTRACE_END(id)              do { } while (0)
+#define EVTRACE_INSTANT(id, v)       do { (void)(v); } while (0)
+#define EVTRACE_COUNTER(id, v)       do { (void)(v); } while (0)
+#define EVTRACE_TASK(name)           do { } while (0)
+#endif
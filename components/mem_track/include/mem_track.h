@@ -0,0 +1,72 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
+
+// Tagged heap accounting.
+// Every block carries a small header (tag, heap class, size) so frees are
+// attributed to the subsystem that allocated them. Use the MemTrack_* calls
+// instead of malloc/heap_caps_malloc and always free with MemTrack_Free().
+
+#define MEM_TAG_LIST(X) \
+    X(kMemTagUi,     "UI")    \
+    X(kMemTagLcd,    "LCD")   \
+    X(kMemTagInput,  "INPUT") \
+    X(kMemTagArena,  "ARENA") \
+    X(kMemTagNet,    "NET")   \
+    X(kMemTagWifi,   "WIFI")  \
+    X(kMemTagBle,    "BLE")   \
+    X(kMemTagAudio,  "AUDIO") \
+    X(kMemTagTrace,  "TRACE") \
+    X(kMemTagMisc,   "MISC")
+
+typedef enum {
+#define MEM_TAG_ENUM(id, name) id,
+    MEM_TAG_LIST(MEM_TAG_ENUM)
+#undef MEM_TAG_ENUM
+    kMemTagCount
+} MemTag;
+
+typedef enum {
+    kMemClassInternal = 0,  // plain internal RAM
+    kMemClassDma,           // DMA-capable RAM
+    kMemClassSpiram,        // external PSRAM
+    kMemClassCount
+} MemClass;
+
+typedef struct {
+    uint32_t live;          // bytes currently allocated (payload only)
+    uint32_t peak;          // highest value of live
+    uint32_t allocs;        // successful allocations
+    uint32_t frees;
+    uint32_t fails;         // allocations the heap refused
+} MemTrackStat;
+
+typedef struct {
+    uint32_t free_bytes;
+    uint32_t largest_block;
+    uint32_t min_free;      // low-water mark since boot
+    uint8_t  frag_pct;      // 100 - largest*100/free, 0 = one free block
+} MemTrackHeapInfo;
+
+void* MemTrack_Malloc(MemTag tag, size_t bytes, uint32_t caps);
+void* MemTrack_Calloc(MemTag tag, size_t n, size_t size, uint32_t caps);
+void* MemTrack_Realloc(MemTag tag, void* ptr, size_t bytes, uint32_t caps);
+void* MemTrack_AlignedAlloc(MemTag tag, size_t align, size_t bytes, uint32_t caps);
+void  MemTrack_Free(void* ptr);
+
+// Queue whose storage and control block come from tracked memory
+QueueHandle_t MemTrack_QueueCreate(MemTag tag, uint32_t length, uint32_t item_size);
+void MemTrack_QueueDelete(QueueHandle_t q);
+
+// Snapshot of one tag in one heap class (summed over classes if cls < 0)
+void MemTrack_GetStat(MemTag tag, int cls, MemTrackStat* out);
+void MemTrack_GetHeapInfo(MemClass cls, MemTrackHeapInfo* out);
+
+const char* MemTrack_TagName(MemTag tag);
+const char* MemTrack_ClassName(MemClass cls);
+
+void MemTrack_Log(void);
@@ -0,0 +1,285 @@
+#include "mem_track.h"
+
+#include <string.h>
+
+#include "esp_heap_caps.h"
+#include "esp_log.h"
+
+static const char* TAG = "MEM";
+
+#define MEM_HDR_MAGIC 0x4D54524Bu   // "MTRK"
+
+// 16 bytes so the payload keeps the heap's natural alignment
+typedef struct {
+    uint32_t magic;
+    uint32_t size;      // payload bytes
+    uint16_t pad;       // payload - raw block start
+    uint8_t  tag;
+    uint8_t  cls;
+    uint32_t reserved;
+} MemHdr;
+
+_Static_assert(sizeof(MemHdr) == 16, "MemHdr must stay 16 bytes");
+
+static const char* const kTagNames[kMemTagCount] = {
+#define MEM_TAG_NAME(id, name) name,
+    MEM_TAG_LIST(MEM_TAG_NAME)
+#undef MEM_TAG_NAME
+};
+
+static const char* const kClassNames[kMemClassCount] = { "INT", "DMA", "PSRAM" };
+
+static MemTrackStat s_stats[kMemTagCount][kMemClassCount];
+static portMUX_TYPE s_mux = portMUX_INITIALIZER_UNLOCKED;
+
+static MemClass class_from_caps(uint32_t caps)
+{
+    if (caps & MALLOC_CAP_SPIRAM) return kMemClassSpiram;
+    if (caps & MALLOC_CAP_DMA) return kMemClassDma;
+    return kMemClassInternal;
+}
+
+static MemTag clamp_tag(MemTag tag)
+{
+    return ((int)tag < 0 || tag >= kMemTagCount) ? kMemTagMisc : tag;
+}
+
+static void note_alloc(MemTag tag, MemClass cls, size_t bytes)
+{
+    portENTER_CRITICAL(&s_mux);
+    MemTrackStat* s = &s_stats[tag][cls];
+    s->live += (uint32_t)bytes;
+    s->allocs++;
+    if (s->live > s->peak) s->peak = s->live;
+    portEXIT_CRITICAL(&s_mux);
+}
+
+static void note_free(MemTag tag, MemClass cls, size_t bytes)
+{
+    portENTER_CRITICAL(&s_mux);
+    MemTrackStat* s = &s_stats[tag][cls];
+    s->live -= (uint32_t)bytes;
+    s->frees++;
+    portEXIT_CRITICAL(&s_mux);
+}
+
+static void note_fail(MemTag tag, MemClass cls, size_t bytes)
+{
+    portENTER_CRITICAL(&s_mux);
+    s_stats[tag][cls].fails++;
+    portEXIT_CRITICAL(&s_mux);
+
+    ESP_LOGW(TAG, "%s: %u bytes (%s) failed", kTagNames[tag], (unsigned)bytes, kClassNames[cls]);
+}
+
+static void* finish_block(uint8_t* raw, size_t pad, MemTag tag, MemClass cls, size_t bytes)
+{
+    uint8_t* user = raw + pad;
+    MemHdr* h = (MemHdr*)(user - sizeof(MemHdr));
+    h->magic = MEM_HDR_MAGIC;
+    h->size = (uint32_t)bytes;
+    h->pad = (uint16_t)pad;
+    h->tag = (uint8_t)tag;
+    h->cls = (uint8_t)cls;
+    h->reserved = 0;
+
+    note_alloc(tag, cls, bytes);
+    return user;
+}
+
+static MemHdr* header_of(void* ptr)
+{
+    MemHdr* h = (MemHdr*)((uint8_t*)ptr - sizeof(MemHdr));
+    return (h->magic == MEM_HDR_MAGIC) ? h : NULL;
+}
+
+void* MemTrack_Malloc(MemTag tag, size_t bytes, uint32_t caps)
+{
+    tag = clamp_tag(tag);
+    MemClass cls = class_from_caps(caps);
+
+    uint8_t* raw = (uint8_t*)heap_caps_malloc(sizeof(MemHdr) + bytes, caps);
+    if (!raw) {
+        note_fail(tag, cls, bytes);
+        return NULL;
+    }
+    return finish_block(raw, sizeof(MemHdr), tag, cls, bytes);
+}
+
+void* MemTrack_Calloc(MemTag tag, size_t n, size_t size, uint32_t caps)
+{
+    if (size && n > SIZE_MAX / size) return NULL;
+
+    void* p = MemTrack_Malloc(tag, n * size, caps);
+    if (p) memset(p, 0, n * size);
+    return p;
+}
+
+void* MemTrack_AlignedAlloc(MemTag tag, size_t align, size_t bytes, uint32_t caps)
+{
+    tag = clamp_tag(tag);
+    MemClass cls = class_from_caps(caps);
+
+    // The header sits in the first aligned slot, so pad is a multiple of align
+    if (align < sizeof(MemHdr)) align = sizeof(MemHdr);
+    if (align & (align - 1)) return NULL;
+
+    uint8_t* raw = (uint8_t*)heap_caps_aligned_alloc(align, align + bytes, caps);
+    if (!raw) {
+        note_fail(tag, cls, bytes);
+        return NULL;
+    }
+    return finish_block(raw, align, tag, cls, bytes);
+}
+
+void* MemTrack_Realloc(MemTag tag, void* ptr, size_t bytes, uint32_t caps)
+{
+    if (!ptr) return MemTrack_Malloc(tag, bytes, caps);
+    if (bytes == 0) {
+        MemTrack_Free(ptr);
+        return NULL;
+    }
+
+    MemHdr* h = header_of(ptr);
+    if (!h) {
+        ESP_LOGE(TAG, "realloc of untracked block %p", ptr);
+        return NULL;
+    }
+
+    MemTag old_tag = (MemTag)h->tag;
+    MemClass old_cls = (MemClass)h->cls;
+    size_t old_size = h->size;
+
+    // Aligned blocks carry extra padding; move them the slow way
+    if (h->pad != sizeof(MemHdr)) {
+        void* np = MemTrack_Malloc(tag, bytes, caps);
+        if (!np) return NULL;
+        memcpy(np, ptr, old_size < bytes ? old_size : bytes);
+        MemTrack_Free(ptr);
+        return np;
+    }
+
+    tag = clamp_tag(tag);
+    MemClass cls = class_from_caps(caps);
+
+    // On failure the old block (and its header) is untouched
+    uint8_t* raw = (uint8_t*)heap_caps_realloc(h, sizeof(MemHdr) + bytes, caps);
+    if (!raw) {
+        note_fail(tag, cls, bytes);
+        return NULL;
+    }
+
+    note_free(old_tag, old_cls, old_size);
+    return finish_block(raw, sizeof(MemHdr), tag, cls, bytes);
+}
+
+void MemTrack_Free(void* ptr)
+{
+    if (!ptr) return;
+
+    MemHdr* h = header_of(ptr);
+    if (!h) {
+        ESP_LOGE(TAG, "free of untracked block %p", ptr);
+        return;
+    }
+
+    uint8_t* raw = (uint8_t*)ptr - h->pad;
+    note_free((MemTag)h->tag, (MemClass)h->cls, h->size);
+    h->magic = 0;   // catches double frees
+    heap_caps_free(raw);
+}
+
+QueueHandle_t MemTrack_QueueCreate(MemTag tag, uint32_t length, uint32_t item_size)
+{
+    // Control block and ring storage in one tracked block. With static
+    // creation the handle is the address of the StaticQueue_t, which is what
+    // MemTrack_QueueDelete() relies on.
+    size_t bytes = sizeof(StaticQueue_t) + (size_t)length * item_size;
+    uint8_t* mem = (uint8_t*)MemTrack_Malloc(tag, bytes, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    if (!mem) return NULL;
+
+    StaticQueue_t* qcb = (StaticQueue_t*)mem;
+    uint8_t* storage = mem + sizeof(StaticQueue_t);
+    return xQueueCreateStatic(length, item_size, storage, qcb);
+}
+
+void MemTrack_QueueDelete(QueueHandle_t q)
+{
+    if (!q) return;
+    vQueueDelete(q);
+    MemTrack_Free((void*)q);
+}
+
+void MemTrack_GetStat(MemTag tag, int cls, MemTrackStat* out)
+{
+    if (!out) return;
+    memset(out, 0, sizeof(*out));
+    if ((int)tag < 0 || tag >= kMemTagCount) return;
+
+    portENTER_CRITICAL(&s_mux);
+    for (int c = 0; c < kMemClassCount; c++) {
+        if (cls >= 0 && c != cls) continue;
+        const MemTrackStat* s = &s_stats[tag][c];
+        out->live += s->live;
+        out->peak += s->peak;   // sum of per-class peaks when cls < 0
+        out->allocs += s->allocs;
+        out->frees += s->frees;
+        out->fails += s->fails;
+    }
+    portEXIT_CRITICAL(&s_mux);
+}
+
+void MemTrack_GetHeapInfo(MemClass cls, MemTrackHeapInfo* out)
+{
+    if (!out) return;
+    memset(out, 0, sizeof(*out));
+
+    uint32_t caps;
+    switch (cls) {
+    case kMemClassDma:    caps = MALLOC_CAP_DMA; break;
+    case kMemClassSpiram: caps = MALLOC_CAP_SPIRAM; break;
+    default:              caps = MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT; break;
+    }
+
+    out->free_bytes = (uint32_t)heap_caps_get_free_size(caps);
+    out->largest_block = (uint32_t)heap_caps_get_largest_free_block(caps);
+    out->min_free = (uint32_t)heap_caps_get_minimum_free_size(caps);
+    if (out->free_bytes > 0) {
+        out->frag_pct = (uint8_t)(100u - (uint32_t)((uint64_t)out->largest_block * 100u / out->free_bytes));
+    }
+}
+
+const char* MemTrack_TagName(MemTag tag)
+{
+    return ((int)tag < 0 || tag >= kMemTagCount) ? "?" : kTagNames[tag];
+}
+
+const char* MemTrack_ClassName(MemClass cls)
+{
+    return ((int)cls < 0 || cls >= kMemClassCount) ? "?" : kClassNames[cls];
+}
+
+void MemTrack_Log(void)
+{
+    ESP_LOGI(TAG, "%-6s %-5s %7s %7s %6s %6s %4s", "tag", "heap", "live", "peak", "alloc", "free", "fail");
+
+    for (int t = 0; t < kMemTagCount; t++) {
+        for (int c = 0; c < kMemClassCount; c++) {
+            MemTrackStat s;
+            MemTrack_GetStat((MemTag)t, c, &s);
+            if (s.allocs == 0 && s.fails == 0) continue;
+            ESP_LOGI(TAG, "%-6s %-5s %7u %7u %6u %6u %4u", kTagNames[t], kClassNames[c],
+                     (unsigned)s.live, (unsigned)s.peak, (unsigned)s.allocs,
+                     (unsigned)s.frees, (unsigned)s.fails);
+        }
+    }
+
+    for (int c = 0; c < kMemClassCount; c++) {
+        MemTrackHeapInfo hi;
+        MemTrack_GetHeapInfo((MemClass)c, &hi);
+        if (hi.free_bytes == 0) continue;
+        ESP_LOGI(TAG, "heap %-5s free=%u largest=%u min=%u frag=%u%%", kClassNames[c],
+                 (unsigned)hi.free_bytes, (unsigned)hi.largest_block,
+                 (unsigned)hi.min_free, (unsigned)hi.frag_pct);
+    }
+}
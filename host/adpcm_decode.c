@@ -0,0 +1,107 @@
+// Decodes a MIC recording (main/audio/mic_recorder.h) to a 16-bit mono WAV.
+//
+//   ./adpcm_decode mic.ima mic.wav
+//
+// Getting the file off the board: dump the spiffs partition and unpack it
+// with mkspiffs (page 256, block 4096, the IDF defaults):
+//
+//   parttool.py -p PORT read_partition --partition-name spiffs --output spiffs.bin
+//   mkspiffs -u out -b 4096 -p 256 -s 0x1EE000 spiffs.bin      # out/mic.ima
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "dsp/ima_adpcm.h"
+
+static uint32_t rd32(const uint8_t* p)
+{
+    return (uint32_t)p[0] | (uint32_t)p[1] << 8 | (uint32_t)p[2] << 16 | (uint32_t)p[3] << 24;
+}
+
+static void wr16(uint8_t* p, uint16_t v)
+{
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+}
+
+static void wr32(uint8_t* p, uint32_t v)
+{
+    wr16(p, (uint16_t)v);
+    wr16(p + 2, (uint16_t)(v >> 16));
+}
+
+static void wav_header(uint8_t* h, uint32_t rate, uint32_t samples)
+{
+    uint32_t data = samples * 2;
+    memcpy(h, "RIFF", 4);
+    wr32(h + 4, 36 + data);
+    memcpy(h + 8, "WAVEfmt ", 8);
+    wr32(h + 16, 16);
+    wr16(h + 20, 1);            // PCM
+    wr16(h + 22, 1);            // mono
+    wr32(h + 24, rate);
+    wr32(h + 28, rate * 2);
+    wr16(h + 32, 2);
+    wr16(h + 34, 16);
+    memcpy(h + 36, "data", 4);
+    wr32(h + 40, data);
+}
+
+int main(int argc, char** argv)
+{
+    if (argc != 3) {
+        fprintf(stderr, "usage: %s in.ima out.wav\n", argv[0]);
+        return 2;
+    }
+
+    FILE* in = fopen(argv[1], "rb");
+    if (!in) {
+        perror(argv[1]);
+        return 1;
+    }
+    uint8_t h[16];
+    if (fread(h, 1, sizeof(h), in) != sizeof(h) || memcmp(h, "IMA1", 4) != 0 ||
+        (h[8] | h[9] << 8) != IMA_ADPCM_BLOCK_BYTES || (h[10] | h[11] << 8) != IMA_ADPCM_BLOCK_SAMPLES) {
+        fprintf(stderr, "%s: not a MIC recording\n", argv[1]);
+        fclose(in);
+        return 1;
+    }
+    uint32_t rate = rd32(h + 4);
+
+    FILE* out = fopen(argv[2], "wb");
+    if (!out) {
+        perror(argv[2]);
+        fclose(in);
+        return 1;
+    }
+
+    // Header first with a zero length, patched once the block count is known
+    uint8_t wav[44];
+    wav_header(wav, rate, 0);
+    fwrite(wav, 1, sizeof(wav), out);
+
+    uint8_t block[IMA_ADPCM_BLOCK_BYTES];
+    int16_t pcm[IMA_ADPCM_BLOCK_SAMPLES];
+    uint32_t blocks = 0;
+    while (fread(block, 1, sizeof(block), in) == sizeof(block)) {
+        ImaAdpcm_DecodeBlock(block, pcm);
+        for (int i = 0; i < IMA_ADPCM_BLOCK_SAMPLES; i++) {
+            uint8_t le[2];
+            wr16(le, (uint16_t)pcm[i]);
+            fwrite(le, 1, 2, out);
+        }
+        blocks++;
+    }
+
+    uint32_t samples = blocks * IMA_ADPCM_BLOCK_SAMPLES;
+    wav_header(wav, rate, samples);
+    fseek(out, 0, SEEK_SET);
+    fwrite(wav, 1, sizeof(wav), out);
+    fclose(out);
+    fclose(in);
+
+    printf("%lu blocks, %lu samples at %lu Hz (%.2f s)\n", (unsigned long)blocks, (unsigned long)samples,
+           (unsigned long)rate, rate ? (double)samples / rate : 0.0);
+    return 0;
+}
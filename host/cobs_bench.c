@@ -0,0 +1,201 @@
+// COBS channel mux: round-trip self-check, then encode/decode throughput.
+//
+//   ./cobs_bench          check + benchmark
+//   ./cobs_bench check    check only
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "input/cobs_mux.h"
+#include "host_util.h"
+
+#define CHECK(c)                                                         \
+    do {                                                                 \
+        if (!(c)) {                                                      \
+            fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #c); \
+            abort();                                                     \
+        }                                                                \
+    } while (0)
+
+#define RING_BYTES 4096
+
+static void fill(uint8_t* p, size_t n, uint32_t* seed, int zero_pct)
+{
+    for (size_t i = 0; i < n; i++) {
+        uint32_t r = host_rand(seed);
+        p[i] = ((int)(r % 100) < zero_pct) ? 0 : (uint8_t)(1 + (r >> 8) % 255);
+    }
+}
+
+static void check_roundtrip(void)
+{
+    static uint8_t ring_mem[COBS_MUX_MAX_CHANNELS][RING_BYTES];
+    static uint8_t wire[64 * 1024];
+    static uint8_t sent[COBS_MUX_MAX_CHANNELS][64 * 1024];
+    size_t sent_len[COBS_MUX_MAX_CHANNELS];
+    SpscRing rings[COBS_MUX_MAX_CHANNELS];
+    uint32_t seed = 0xBEEF;
+
+    for (int round = 0; round < 2000; round++) {
+        CobsMux m;
+        CobsMux_Init(&m);
+        for (int c = 0; c < 4; c++) {
+            SpscRing_Init(&rings[c], ring_mem[c], RING_BYTES);
+            // Start mid-buffer so frames wrap
+            uint32_t skew = host_rand(&seed) % RING_BYTES;
+            rings[c].head = skew;
+            rings[c].tail = skew;
+            CHECK(CobsMux_Register(&m, (uint8_t)c, &rings[c], NULL, NULL));
+            sent_len[c] = 0;
+        }
+
+        // A burst of frames, some for channel 6 (unregistered), some corrupted
+        size_t n = 0;
+        uint32_t expect_bad = 0;
+        uint32_t expect_unknown = 0;
+        for (int f = 0; f < 16; f++) {
+            uint8_t pl[600];
+            size_t len = host_rand(&seed) % 600;
+            int zero_pct = (int)(host_rand(&seed) % 3) * 30;
+            fill(pl, len, &seed, zero_pct);
+
+            uint8_t chan = (uint8_t)(host_rand(&seed) % 5);
+            if (chan == 4) chan = 6;
+
+            size_t fn = CobsMux_Encode(chan, pl, len, wire + n, sizeof(wire) - n);
+            CHECK(fn > 0 && fn <= COBS_MUX_FRAME_MAX(len));
+            for (size_t k = 1; k + 1 < fn; k++) CHECK(wire[n + k] != 0);
+
+            bool corrupt = (host_rand(&seed) % 8) == 0;
+            if (corrupt) {
+                // Flip to another non-zero value so the framing stays intact
+                size_t at = n + 1 + host_rand(&seed) % (fn - 2);
+                wire[at] = (uint8_t)(wire[at] == 0xFF ? 0x01 : wire[at] + 1);
+                if (chan == 6) expect_unknown++;
+                else expect_bad++;
+            } else if (chan == 6) {
+                expect_unknown++;
+            } else {
+                memcpy(sent[chan] + sent_len[chan], pl, len);
+                sent_len[chan] += len;
+            }
+            n += fn;
+        }
+
+        // Feed in random chunks, draining the rings into out[] between chunks
+        static uint8_t out[COBS_MUX_MAX_CHANNELS][64 * 1024];
+        size_t out_len[COBS_MUX_MAX_CHANNELS] = { 0 };
+        for (size_t off = 0; off < n;) {
+            size_t chunk = 1 + host_rand(&seed) % 300;
+            if (chunk > n - off) chunk = n - off;
+            CobsMux_Feed(&m, wire + off, chunk);
+            off += chunk;
+            for (int c = 0; c < 4; c++) {
+                out_len[c] += SpscRing_Read(&rings[c], out[c] + out_len[c], RING_BYTES);
+            }
+        }
+
+        // A corrupted byte may hit a COBS code and break framing instead of
+        // the CRC; either way the frame must be rejected, never delivered
+        uint32_t rejected = m.crc_errors + m.framing_errors;
+        CHECK(rejected + m.unknown_chan >= expect_bad + expect_unknown);
+        for (int c = 0; c < 4; c++) {
+            CHECK(out_len[c] == sent_len[c]);
+            CHECK(memcmp(out[c], sent[c], sent_len[c]) == 0);
+        }
+    }
+
+    // Overrun: a frame bigger than the ring is dropped whole
+    {
+        static uint8_t small_mem[64];
+        SpscRing small;
+        SpscRing_Init(&small, small_mem, sizeof(small_mem));
+        CobsMux m;
+        CobsMux_Init(&m);
+        CobsMux_Register(&m, kMuxChanLog, &small, NULL, NULL);
+
+        uint8_t pl[100];
+        memset(pl, 'x', sizeof(pl));
+        size_t fn = CobsMux_Encode(kMuxChanLog, pl, sizeof(pl), wire, sizeof(wire));
+        CobsMux_Feed(&m, wire, fn);
+        CHECK(SpscRing_Used(&small) == 0);
+        CHECK(m.ch[kMuxChanLog].overruns == 1);
+
+        fn = CobsMux_Encode(kMuxChanLog, pl, 40, wire, sizeof(wire));
+        CobsMux_Feed(&m, wire, fn);
+        CHECK(SpscRing_Used(&small) == 40);
+    }
+
+    // Truncated frame followed by a good one: resync on the delimiter
+    {
+        static uint8_t mem[256];
+        SpscRing r;
+        SpscRing_Init(&r, mem, sizeof(mem));
+        CobsMux m;
+        CobsMux_Init(&m);
+        CobsMux_Register(&m, kMuxChanKey, &r, NULL, NULL);
+
+        const uint8_t key = 0x03;
+        size_t fn = CobsMux_Encode(kMuxChanKey, &key, 1, wire, sizeof(wire));
+        CobsMux_Feed(&m, wire, fn - 3);
+        CobsMux_Feed(&m, wire, fn);
+        CHECK(SpscRing_Used(&r) == 1);
+        CHECK(m.framing_errors == 1);
+    }
+
+    printf("cobs_mux: round trip checks passed\n");
+}
+
+static volatile uint32_t s_sink;
+
+static void bench(size_t len, int zero_pct)
+{
+    static uint8_t wire[4 * 1024 * 1024];
+    static uint8_t ring_mem[1 << 16];
+    uint8_t pl[2048];
+    uint32_t seed = 42;
+    fill(pl, len, &seed, zero_pct);
+
+    const int frames = (int)((sizeof(wire) - 4096) / COBS_MUX_FRAME_MAX(len));
+    uint64_t t0 = host_now_ns();
+    size_t n = 0;
+    for (int f = 0; f < frames; f++) n += CobsMux_Encode(kMuxChanData, pl, len, wire + n, sizeof(wire) - n);
+    uint64_t t_enc = host_now_ns() - t0;
+
+    SpscRing r;
+    SpscRing_Init(&r, ring_mem, sizeof(ring_mem));
+    CobsMux m;
+    CobsMux_Init(&m);
+    CobsMux_Register(&m, kMuxChanData, &r, NULL, NULL);
+
+    // 256-byte blocks like the router reads; the consumer drains as it goes
+    t0 = host_now_ns();
+    for (size_t off = 0; off < n; off += 256) {
+        size_t chunk = (n - off) < 256 ? (n - off) : 256;
+        CobsMux_Feed(&m, wire + off, chunk);
+        SpscRing_Drain(&r);
+    }
+    uint64_t t_dec = host_now_ns() - t0;
+    CHECK(m.frames_ok == (uint32_t)frames);
+    s_sink = m.frames_ok;
+
+    double payload_mb = (double)frames * len / 1e6;
+    printf("  len %4zu zeros %2d%%  encode %7.1f MB/s  decode %7.1f MB/s  overhead %5.2f%%\n", len,
+           zero_pct, payload_mb / (t_enc / 1e9), payload_mb / (t_dec / 1e9),
+           100.0 * ((double)n / ((double)frames * len) - 1.0));
+}
+
+int main(int argc, char** argv)
+{
+    check_roundtrip();
+    if (argc > 1 && strcmp(argv[1], "check") == 0) return 0;
+
+    printf("Throughput (payload bytes):\n");
+    const size_t lens[] = { 1, 16, 64, 256, 1024 };
+    for (size_t i = 0; i < sizeof(lens) / sizeof(lens[0]); i++) {
+        bench(lens[i], 0);
+        bench(lens[i], 10);
+    }
+    return 0;
+}
@@ -0,0 +1,944 @@
+// Golden-output checks for the pure-logic firmware units: word wrap, the
+// console ring, glyph rasterizers, key/packet parsers, the mic front end and
+// level math, the fixed-point FFT, the pitch tracker, IMA-ADPCM, the speaker
+// mixer and compressed clips, the monitor effect chain, CRCs.
+// Each case renders text that is compared against host/golden/<case>.txt.
+//
+//   ./golden_check            compare, exit 1 on any mismatch
+//   ./golden_check --update   rewrite the golden files
+
+#include <math.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "core/crc.h"
+#include "display/font_raster.h"
+#include "dsp/audio_asset.h"
+#include "dsp/audio_fx.h"
+#include "dsp/audio_mix.h"
+#include "dsp/dsp_q15.h"
+#include "dsp/fft_q15.h"
+#include "dsp/ima_adpcm.h"
+#include "dsp/mic_convert.h"
+#include "dsp/mic_levels.h"
+#include "dsp/pitch_yin.h"
+#include "dsp/sound_level.h"
+#include "input/key_frame.h"
+#include "input/uart_pkt.h"
+#include "ui/ui_console.h"
+#include "ui/ui_wrap.h"
+
+#ifndef GOLDEN_DIR
+#define GOLDEN_DIR "golden"
+#endif
+
+#define OUT_CAP (64 * 1024)
+
+static char s_out[OUT_CAP];
+static size_t s_len;
+
+static void out(const char* fmt, ...)
+{
+    va_list ap;
+    va_start(ap, fmt);
+    int n = vsnprintf(s_out + s_len, OUT_CAP - s_len, fmt, ap);
+    va_end(ap);
+    if (n > 0) s_len += (size_t)n;
+    if (s_len >= OUT_CAP) s_len = OUT_CAP - 1;
+}
+
+// -------------------- cases --------------------
+
+static const char* k_texts[] = {
+    "Hello world",
+    "The quick brown fox jumps over the lazy dog and keeps running",
+    "Supercalifragilisticexpialidocious word",
+    "line one\nline two\n\nafter blank",
+    "  leading spaces and   runs   of  spaces  ",
+    "",
+};
+
+static void case_wrap(void)
+{
+    static const int cols[] = { 8, 16, 24 };
+    for (size_t t = 0; t < sizeof(k_texts) / sizeof(k_texts[0]); t++) {
+        for (size_t c = 0; c < sizeof(cols) / sizeof(cols[0]); c++) {
+            out("# text %zu cols %d\n", t, cols[c]);
+            const char* p = k_texts[t];
+            char line[64];
+            int guard = 0;
+            while (*p && guard++ < 64) {
+                p = UiWrap_NextLine(p, cols[c], line, sizeof(line));
+                out("|%s|\n", line);
+            }
+            const char* q = UiWrap_SkipLines(k_texts[t], cols[c], 2);
+            out("skip2 -> %d\n", (int)(q - k_texts[t]));
+        }
+    }
+}
+
+static void dump_console(const UiConsole* c, int rows)
+{
+    int n = UiConsole_Count(c);
+    out("count=%d first=%d follow=%d\n", n, c->first, c->follow ? 1 : 0);
+    for (int i = c->first; i < n && i < c->first + rows; i++) {
+        out("  [%02d] %s\n", i, UiConsole_GetLine(c, i));
+    }
+}
+
+static void case_console(void)
+{
+    static UiConsole c;
+    UiConsole_Init(&c);
+
+    for (int i = 0; i < 20; i++) {
+        char msg[80];
+        snprintf(msg, sizeof(msg), "msg %d: the console wraps long lines at cols", i);
+        UiConsole_AppendWrapped(&c, msg, 24);
+    }
+    dump_console(&c, 6);
+
+    UiConsole_ScrollOlder(&c, 6);
+    UiConsole_ScrollOlder(&c, 6);
+    dump_console(&c, 6);
+
+    UiConsole_ScrollNewer(&c, 6);
+    dump_console(&c, 6);
+
+    for (int i = 0; i < 4; i++) UiConsole_ScrollNewer(&c, 6);
+    dump_console(&c, 6);
+
+    UiConsole_Clear(&c);
+    UiConsole_AppendWrapped(&c, "after clear\nsecond line", 24);
+    dump_console(&c, 6);
+}
+
+static void dump_buf(const uint16_t* buf, int bw, int bh)
+{
+    for (int y = 0; y < bh; y++) {
+        char row[256];
+        for (int x = 0; x < bw; x++) row[x] = buf[y * bw + x] ? '#' : '.';
+        row[bw] = 0;
+        out("%s\n", row);
+    }
+}
+
+static void case_font(void)
+{
+    static uint16_t buf[48 * 40];
+
+    memset(buf, 0, sizeof(buf));
+    FontRaster_Text8x16(buf, 40, 40, 1, 2, "Ab3\nxy", 0xFFFF, 9, 20);
+    out("# 8x16 \"Ab3\\nxy\" 40x40\n");
+    dump_buf(buf, 40, 40);
+
+    memset(buf, 0, sizeof(buf));
+    FontRaster_Text5x7(buf, 48, 9, -2, 1, "OK-42!", 0xFFFF, 6);
+    out("# 5x7 \"OK-42!\" 48x9 x=-2\n");
+    dump_buf(buf, 48, 9);
+}
+
+static void on_key(uint8_t cmd, void* arg)
+{
+    (void)arg;
+    InputKey k = kInputNone;
+    bool ok = KeyFrame_CmdToKey(cmd, &k);
+    out("key cmd=%02X -> %s%d\n", cmd, ok ? "" : "unmapped ", (int)k);
+}
+
+static void case_key_frame(void)
+{
+    static const uint8_t stream[] = {
+        'h', 'i', 0xAA, 0x01, 0x55, 'x', 0xAA, 0x02, 0x55, 0xAA, 0x09, 0x55,
+        0xAA, 0x03, 0x00, 'y', 0xAA, 0x04, 0x55, 0xAA, 0x05, 0x55, 'z', 0xAA,
+    };
+    // Same stream fed whole and in 1..5 byte chunks: output must not depend on it
+    for (uint32_t chunk = 0; chunk <= 5; chunk++) {
+        KeyFrameParser p;
+        KeyFrame_Reset(&p);
+        out("# chunk %u\n", (unsigned)chunk);
+        uint32_t step = chunk ? chunk : (uint32_t)sizeof(stream);
+        for (uint32_t i = 0; i < sizeof(stream); i += step) {
+            uint32_t n = sizeof(stream) - i < step ? (uint32_t)sizeof(stream) - i : step;
+            uint8_t data[sizeof(stream) + 2];
+            uint32_t o = KeyFrame_ParseBlock(&p, stream + i, n, data, on_key, NULL);
+            if (o) {
+                out("data");
+                for (uint32_t k = 0; k < o; k++) out(" %02X", data[k]);
+                out("\n");
+            }
+        }
+        out("state=%d\n", (int)p.state);
+    }
+}
+
+static void case_uart_pkt(void)
+{
+    static const uint8_t stream[] = {
+        0x00, 0xBB, 0x03, 0x01, 0x02, 0x03, 0x06, 0x66,     // ok
+        0xBB, 0x02, 0x10, 0x20, 0x31, 0x66,                 // bad sum
+        0xBB, 0x01, 0x7F, 0x7F, 0x00,                       // bad tail
+        0xBB, 0x00, 0x00, 0x66,                             // empty ok
+        0xBB, 0x02, 0xFF, 0xFF, 0xFE, 0x66,                 // sum wraps
+    };
+    static const char* names[] = { "none", "ok", "bad_sum", "bad_tail" };
+    uint8_t data[UART_PKT_MAX_DATA];
+    UartPktParser p;
+    UartPkt_Init(&p, data);
+
+    size_t i = 0;
+    while (i < sizeof(stream)) {
+        UartPktResult res;
+        i += UartPkt_Feed(&p, stream + i, sizeof(stream) - i, &res);
+        if (res == kUartPktNone) continue;
+        out("%s len=%u", names[res], (unsigned)p.len);
+        if (res == kUartPktOk) {
+            uint8_t hdr[2], inv[UART_PKT_MAX_DATA], trl[2];
+            UartPkt_BuildInvertReply(data, p.len, hdr, inv, trl);
+            out(" reply %02X %02X |", hdr[0], hdr[1]);
+            for (unsigned k = 0; k < p.len; k++) out(" %02X", inv[k]);
+            out(" | %02X %02X", trl[0], trl[1]);
+        }
+        out("\n");
+    }
+    out("in_frame=%d\n", UartPkt_InFrame(&p) ? 1 : 0);
+}
+
+#define MIC_N   256
+#define MIC_SR  16000
+
+static void mic_synth(int32_t* raw, double hz, double amp, int32_t dc)
+{
+    for (int i = 0; i < MIC_N; i++) {
+        double v = amp * sin(2.0 * M_PI * hz * i / MIC_SR);
+        // INMP441 layout: 24-bit sample left aligned in a 32-bit word
+        raw[i] = (int32_t)((int32_t)lrint(v) + dc) * 256;
+    }
+}
+
+static void case_mic(void)
+{
+    static const double tones[] = { 250.0, 1000.0, 4000.0 };
+    static const double amps[] = { 0.0, 2000.0, 60000.0, 4000000.0 };
+    int32_t raw[MIC_N];
+    int16_t s[MIC_N];
+    int bands[MIC_LEVELS_BANDS];
+
+    for (size_t t = 0; t < sizeof(tones) / sizeof(tones[0]); t++) {
+        for (size_t a = 0; a < sizeof(amps) / sizeof(amps[0]); a++) {
+            mic_synth(raw, tones[t], amps[a], 12345);
+            MicLevels_Condition(raw, MIC_N, s);
+            MicLevels_OctaveBands(s, MIC_N, MIC_SR, bands, MIC_LEVELS_BANDS);
+            out("tone %4.0f amp %8.0f: vol=%3d zc=%4d peak=%4d bands",
+                tones[t], amps[a], MicLevels_VolumePct(s, MIC_N),
+                MicLevels_ZeroCrossHz(s, MIC_N, MIC_SR), MicLevels_PeakBandHz(bands, MIC_LEVELS_BANDS));
+            for (int b = 0; b < MIC_LEVELS_BANDS; b++) out(" %3d", bands[b]);
+            out("\n");
+        }
+    }
+}
+
+// DC blocker across block boundaries: a 1 kHz tone on a DC offset that steps
+// halfway through. Block-wise and one-shot conversion must agree exactly.
+static void case_mic_convert(void)
+{
+    enum { N = 4096, BLOCK = 256 };
+    static int32_t raw[N];
+    static int16_t whole[N], split[N];
+
+    for (int i = 0; i < N; i++) {
+        int32_t dc = i < N / 2 ? 40000 : -90000;
+        raw[i] = ((int32_t)lrint(150000.0 * sin(2.0 * M_PI * 1000.0 * i / MIC_SR)) + dc) * 256;
+    }
+
+    static const int decims[] = { 1, 2, 4 };
+    for (size_t d = 0; d < sizeof(decims) / sizeof(decims[0]); d++) {
+        int decim = decims[d];
+        int n_out = N / decim;
+        MicConvert c;
+
+        MicConvert_Init(&c, MIC_CONVERT_POLE_SHIFT, decim);
+        MicConvert_Process(&c, raw, whole, N);
+        MicConvert_Init(&c, MIC_CONVERT_POLE_SHIFT, decim);
+        for (int i = 0; i < N; i += BLOCK) MicConvert_Process(&c, raw + i, split + i / decim, BLOCK);
+
+        out("decim=%d split=%s crc=%08X\n", decim, memcmp(whole, split, (size_t)n_out * 2) ? "DIFF" : "same",
+            (unsigned)Crc32_Update(CRC32_INIT, (const uint8_t*)whole, (size_t)n_out * 2));
+
+        // Mean per 1/8 of the input: the offset decays after start and after the step
+        for (int seg = 0; seg < 8; seg++) {
+            int64_t sum = 0;
+            int len = n_out / 8;
+            int peak = 0;
+            for (int i = seg * len; i < (seg + 1) * len; i++) {
+                sum += whole[i];
+                if (abs(whole[i]) > peak) peak = abs(whole[i]);
+            }
+            out("  seg %d mean=%6d peak=%5d\n", seg, (int)(sum / len), peak);
+        }
+    }
+}
+
+// Bit-exact reference for dsp/fft_q15.c: the power CRC covers every bin
+static void case_fft(void)
+{
+    static const int sizes[] = { 256, 512, 1024 };
+    static const double amps[] = { 0.0, 200.0, 20000.0, 32767.0 };
+    static int16_t mem[FFT_Q15_MAX_N * 2];
+    static int16_t x[FFT_Q15_MAX_N];
+    static uint32_t power[FFT_Q15_MAX_N / 2 + 1];
+    uint16_t edges[17];
+    int32_t bands[16];
+
+    for (size_t si = 0; si < sizeof(sizes) / sizeof(sizes[0]); si++) {
+        int n = sizes[si];
+        FftQ15 f;
+        FftQ15_Init(&f, n, mem);
+        FftQ15_LogBandEdges(n, MIC_SR, 63, 8000, 16, edges);
+
+        out("n=%d edges", n);
+        for (int b = 0; b <= 16; b++) out(" %u", edges[b]);
+        out("\n");
+
+        for (size_t a = 0; a < sizeof(amps) / sizeof(amps[0]); a++) {
+            uint32_t seed = 7;
+            for (int i = 0; i < n; i++) {
+                seed ^= seed << 13;
+                seed ^= seed >> 17;
+                seed ^= seed << 5;
+                double v = amps[a] * sin(2.0 * M_PI * 1037.0 * i / MIC_SR) +
+                           0.25 * amps[a] * sin(2.0 * M_PI * 3100.0 * i / MIC_SR) + (double)((int)(seed & 7) - 4);
+                if (v > 32767.0) v = 32767.0;
+                if (v < -32768.0) v = -32768.0;
+                x[i] = (int16_t)lrint(v);
+            }
+
+            int exp = FftQ15_Power(&f, x, power);
+            FftQ15_BandsDbfs(&f, power, exp, edges, 16, bands);
+            uint32_t crc = Crc32_Update(CRC32_INIT, (const uint8_t*)power, (size_t)(n / 2 + 1) * sizeof(uint32_t));
+
+            out("n=%4d amp=%5.0f exp=%3d peak=%4d crc=%08X bands", n, amps[a], exp,
+                FftQ15_PeakHz(&f, power, MIC_SR, 2), (unsigned)crc);
+            for (int b = 0; b < 16; b++) out(" %d", (int)bands[b]);
+            out("\n");
+        }
+    }
+
+    static const uint64_t ps[] = { 0, 1, 2, 255, 256, 1000, 65535, 1ull << 32, ~0ull };
+    out("db_q8");
+    for (size_t i = 0; i < sizeof(ps) / sizeof(ps[0]); i++) out(" %d", (int)FftQ15_DbQ8(ps[i]));
+    out("\n");
+}
+
+// Tuner accuracy on synthetic tones across 55..1000 Hz: pure sines, a
+// harmonic-rich tone, a quiet tone in noise, and noise alone (must be
+// unvoiced). err is against the true frequency, in 1/10 cent.
+static void case_pitch(void)
+{
+    enum { SR = 16000, WINDOW = 512, FMIN = 55, FMAX = 1000 };
+    static const double tones[] = { 55.0, 82.41, 110.0, 146.83, 196.0, 246.94, 329.63, 440.0, 523.25, 659.26,
+                                    880.0, 987.77 };
+    static const char* kinds[] = { "sine", "rich", "noisy", "noise" };
+    static uint8_t mem[8192];
+    static int16_t x[1024];
+    PitchYin p;
+
+    PitchYin_Init(&p, SR, WINDOW, FMIN, FMAX, mem);
+    int n = PitchYin_FrameSamples(&p);
+    out("window=%d lags=%d..%d frame=%d\n", WINDOW, p.tau_min, p.tau_max, n);
+
+    for (int k = 0; k < 4; k++) {
+        int worst = 0;
+        for (size_t t = 0; t < sizeof(tones) / sizeof(tones[0]); t++) {
+            double f = tones[t];
+            uint32_t seed = 1;
+            for (int i = 0; i < n; i++) {
+                double ph = 2.0 * M_PI * f * i / SR, v = 0.0;
+                seed ^= seed << 13;
+                seed ^= seed >> 17;
+                seed ^= seed << 5;
+                double noise = (double)((int)(seed & 255) - 128);
+                if (k == 0) v = 8000.0 * sin(ph);
+                if (k == 1) {
+                    for (int h = 1; h <= 8 && f * h < SR / 2; h++) v += 6000.0 / h * sin(ph * h);
+                }
+                if (k == 2) v = 300.0 * sin(ph) + 150.0 * sin(2.0 * ph) + noise / 2.0;
+                if (k == 3) v = noise * 8.0;
+                x[i] = (int16_t)lrint(v);
+            }
+
+            PitchYinResult r;
+            bool voiced = PitchYin_Estimate(&p, x, &r);
+            int cents;
+            char name[8];
+            PitchYin_NoteName(PitchYin_NoteCents(r.freq_centihz, &cents), name, sizeof(name));
+            int err = r.freq_centihz ? (int)lrint(12000.0 * log2(r.freq_centihz / 100.0 / f)) : 0;
+            if (k < 3 && abs(err) > worst) worst = abs(err);
+
+            out("%-5s %7.2f voiced=%d f=%6lu.%02lu %-4s %+3dc err=%+4d clarity=%5u lags=%u\n", kinds[k], f,
+                voiced ? 1 : 0, (unsigned long)(r.freq_centihz / 100), (unsigned long)(r.freq_centihz % 100), name,
+                cents, err, (unsigned)r.clarity_q15, (unsigned)r.lags);
+        }
+        if (k < 3) out("%-5s worst err=%d\n", kinds[k], worst);
+    }
+
+    static const uint32_t notes[] = { 2750, 4400, 26163, 43999, 44000, 45300, 45400, 100000 };
+    out("note");
+    for (size_t i = 0; i < sizeof(notes) / sizeof(notes[0]); i++) {
+        int cents;
+        int m = PitchYin_NoteCents(notes[i], &cents);
+        out(" %lu:%d%+d", (unsigned long)notes[i], m, cents);
+    }
+    out("\n");
+}
+
+static void case_adpcm(void)
+{
+    enum { SR = 16000, BLOCKS = 8, N = BLOCKS * IMA_ADPCM_BLOCK_SAMPLES };
+    static const char* kinds[] = { "silence", "sine440", "sine3k", "chirp", "noise", "square" };
+    static int16_t x[N], y[N];
+    static uint8_t enc[BLOCKS * IMA_ADPCM_BLOCK_BYTES];
+
+    out("block=%d bytes / %d samples ratio=%.3f\n", IMA_ADPCM_BLOCK_BYTES, IMA_ADPCM_BLOCK_SAMPLES,
+        IMA_ADPCM_BLOCK_SAMPLES * 2.0 / IMA_ADPCM_BLOCK_BYTES);
+    for (int k = 0; k < 6; k++) {
+        uint32_t seed = 7;
+        for (int i = 0; i < N; i++) {
+            double t = (double)i / SR, v = 0.0;
+            seed ^= seed << 13;
+            seed ^= seed >> 17;
+            seed ^= seed << 5;
+            if (k == 1) v = 8000.0 * sin(2.0 * M_PI * 440.0 * t);
+            if (k == 2) v = 8000.0 * sin(2.0 * M_PI * 3000.0 * t);
+            if (k == 3) v = 12000.0 * sin(2.0 * M_PI * (100.0 + 3000.0 * t) * t);
+            if (k == 4) v = (double)((int)(seed & 4095) - 2048);
+            if (k == 5) v = (i / 40) & 1 ? 6000.0 : -6000.0;
+            x[i] = (int16_t)lrint(v);
+        }
+
+        ImaAdpcmState st;
+        ImaAdpcm_Init(&st);
+        for (int b = 0; b < BLOCKS; b++) {
+            ImaAdpcm_EncodeBlock(&st, x + b * IMA_ADPCM_BLOCK_SAMPLES, enc + b * IMA_ADPCM_BLOCK_BYTES);
+        }
+        for (int b = 0; b < BLOCKS; b++) {
+            ImaAdpcm_DecodeBlock(enc + b * IMA_ADPCM_BLOCK_BYTES, y + b * IMA_ADPCM_BLOCK_SAMPLES);
+        }
+
+        double sig = 0.0, err = 0.0;
+        int worst = 0;
+        for (int i = 0; i < N; i++) {
+            int e = y[i] - x[i];
+            sig += (double)x[i] * x[i];
+            err += (double)e * e;
+            if (abs(e) > worst) worst = abs(e);
+        }
+        double snr = err > 0.0 ? 10.0 * log10(sig / err) : 99.0;
+        if (sig == 0.0) snr = 0.0;
+        out("%-7s snr=%5.1f dB max_err=%5d index=%2u crc=%08X\n", kinds[k], snr, worst, (unsigned)st.index,
+            (unsigned)Crc32_Update(CRC32_INIT, enc, sizeof(enc)));
+    }
+}
+
+static void case_audio_mix(void)
+{
+    enum { OUT_RATE = 16000, OUT_N = 1600, SPAN = 37 };
+    static const uint32_t rates[] = { 8000, 11025, 16000, 22050, 44100, 48000 };
+    static int16_t src[8192];
+    static int16_t y[OUT_N];
+    static int32_t acc[OUT_N];
+
+    // 1 kHz sine fed in odd-sized spans, against the ideal at each output time
+    for (size_t r = 0; r < sizeof(rates) / sizeof(rates[0]); r++) {
+        int src_n = (int)((uint64_t)OUT_N * rates[r] / OUT_RATE) + 4;
+        for (int i = 0; i < src_n; i++) src[i] = (int16_t)lrint(12000.0 * sin(2.0 * M_PI * 1000.0 * i / rates[r]));
+
+        AudioMixVoice v;
+        AudioMix_VoiceInit(&v, rates[r], OUT_RATE, AUDIO_MIX_UNITY_Q15);
+        int got = 0, off = 0;
+        while (got < OUT_N && off < src_n) {
+            int span = src_n - off < SPAN ? src_n - off : SPAN;
+            int used = 0;
+            got += AudioMix_Resample(&v, src + off, span, y + got, OUT_N - got, &used);
+            off += used;
+        }
+
+        double sig = 0.0, err = 0.0;
+        for (int k = 0; k < got; k++) {
+            double t = (double)k * v.step_q16 / 65536.0 / rates[r];
+            double ideal = 12000.0 * sin(2.0 * M_PI * 1000.0 * t);
+            sig += ideal * ideal;
+            err += (y[k] - ideal) * (y[k] - ideal);
+        }
+        out("resample %5lu->%d step=%06lX out=%d used=%d snr=%5.1f dB crc=%08X\n", (unsigned long)rates[r],
+            OUT_RATE, (unsigned long)v.step_q16, got, off, err > 0.0 ? 10.0 * log10(sig / err) : 99.0,
+            (unsigned)Crc32_Update(CRC32_INIT, (const uint8_t*)y, (size_t)got * sizeof(int16_t)));
+    }
+
+    // Ramps: constant full-scale input, gain read back through the output
+    for (int i = 0; i < OUT_N; i++) src[i] = 32767;
+    AudioMixVoice v;
+    AudioMix_VoiceInit(&v, OUT_RATE, OUT_RATE, AUDIO_MIX_UNITY_Q15 / 2);
+    memset(acc, 0, sizeof(acc));
+    AudioMix_Accumulate(&v, src, acc, 512);
+    out("ramp up  ");
+    for (int k = 0; k <= 512; k += 64) out(" %d", (int)acc[k == 512 ? 511 : k]);
+    out(" gain=%d\n", v.gain_q15);
+
+    AudioMix_SetTarget(&v, 0);
+    memset(acc, 0, sizeof(acc));
+    AudioMix_Accumulate(&v, src, acc, 512);
+    out("ramp down");
+    for (int k = 0; k <= 512; k += 64) out(" %d", (int)acc[k == 512 ? 511 : k]);
+    out(" silent=%d\n", AudioMix_IsSilent(&v) ? 1 : 0);
+
+    // Two loud voices summed: saturation instead of wraparound
+    AudioMixVoice a, b;
+    AudioMix_VoiceInit(&a, OUT_RATE, OUT_RATE, AUDIO_MIX_UNITY_Q15);
+    AudioMix_VoiceInit(&b, OUT_RATE, OUT_RATE, AUDIO_MIX_UNITY_Q15);
+    for (int i = 0; i < OUT_N; i++) src[i] = (int16_t)lrint(30000.0 * sin(2.0 * M_PI * 500.0 * i / OUT_RATE));
+    memset(acc, 0, sizeof(acc));
+    AudioMix_Accumulate(&a, src, acc, OUT_N);
+    AudioMix_Accumulate(&b, src, acc, OUT_N);
+    uint32_t clipped = AudioMix_Saturate(acc, y, OUT_N);
+    int16_t lo = 0, hi = 0;
+    for (int i = 0; i < OUT_N; i++) {
+        if (y[i] < lo) lo = y[i];
+        if (y[i] > hi) hi = y[i];
+    }
+    out("saturate clipped=%u range=%d..%d\n", (unsigned)clipped, lo, hi);
+}
+
+// Builds the asset the way tools/audio_pack.py does
+static uint32_t asset_pack(uint8_t* dst, int format, uint32_t rate, const int16_t* x, uint32_t n)
+{
+    memcpy(dst, AUDIO_ASSET_MAGIC, 4);
+    memset(dst + 4, 0, 4);
+    dst[4] = (uint8_t)format;
+    for (int i = 0; i < 4; i++) {
+        dst[8 + i] = (uint8_t)(rate >> (8 * i));
+        dst[12 + i] = (uint8_t)(n >> (8 * i));
+    }
+    uint8_t* p = dst + AUDIO_ASSET_HEADER_BYTES;
+    if (format == kAudioAssetUlaw) {
+        for (uint32_t i = 0; i < n; i++) *p++ = AudioAsset_UlawEncode(x[i]);
+    } else if (format == kAudioAssetImaAdpcm) {
+        int16_t blk[IMA_ADPCM_BLOCK_SAMPLES];
+        ImaAdpcmState st;
+        ImaAdpcm_Init(&st);
+        for (uint32_t s = 0; s < n; s += IMA_ADPCM_BLOCK_SAMPLES) {
+            uint32_t k = n - s < IMA_ADPCM_BLOCK_SAMPLES ? n - s : IMA_ADPCM_BLOCK_SAMPLES;
+            memset(blk, 0, sizeof(blk));
+            memcpy(blk, x + s, k * sizeof(int16_t));
+            ImaAdpcm_EncodeBlock(&st, blk, p);
+            p += IMA_ADPCM_BLOCK_BYTES;
+        }
+    } else {
+        memcpy(p, x, n * sizeof(int16_t));
+        p += n * sizeof(int16_t);
+    }
+    return (uint32_t)(p - dst);
+}
+
+static void case_audio_asset(void)
+{
+    enum { N = 4000 };      // not a whole number of ADPCM blocks or chunks
+    static const char* names[] = { "pcm", "ima", "ulaw" };
+    static int16_t x[N], y[N + AUDIO_ASSET_CHUNK_MAX];
+    static uint8_t asset[AUDIO_ASSET_HEADER_BYTES + N * 2];
+
+    uint32_t seed = 3;
+    for (int i = 0; i < N; i++) {
+        seed ^= seed << 13;
+        seed ^= seed >> 17;
+        seed ^= seed << 5;
+        double t = i / 16000.0;
+        double v = 9000.0 * sin(2.0 * M_PI * 220.0 * t) + 3000.0 * sin(2.0 * M_PI * 1800.0 * t);
+        x[i] = (int16_t)lrint(v * (i < N / 2 ? (double)i / (N / 2) : 1.0) + (int)(seed & 255) - 128);
+    }
+
+    for (int f = 0; f < 3; f++) {
+        uint32_t len = asset_pack(asset, f, 16000, x, N);
+        AudioAssetReader r;
+        bool ok = AudioAsset_Open(&r, asset, len);
+        bool short_ok = AudioAsset_Open(&r, asset, len - 1);
+        AudioAsset_Open(&r, asset, len);
+
+        uint32_t got = 0, chunks = 0, n;
+        while ((n = AudioAsset_Decode(&r, y + got)) > 0) {
+            got += n;
+            chunks++;
+        }
+        double sig = 0.0, err = 0.0;
+        for (int i = 0; i < N; i++) {
+            sig += (double)x[i] * x[i];
+            err += (double)(y[i] - x[i]) * (y[i] - x[i]);
+        }
+        out("%-4s open=%d truncated=%d bytes=%5u (%5.1f%%) samples=%u chunks=%u snr=%5.1f crc=%08X\n", names[f],
+            ok ? 1 : 0, short_ok ? 1 : 0, (unsigned)len, 100.0 * len / (N * 2), (unsigned)got, (unsigned)chunks,
+            err > 0.0 ? 10.0 * log10(sig / err) : 99.0,
+            (unsigned)Crc32_Update(CRC32_INIT, (const uint8_t*)y, got * sizeof(int16_t)));
+    }
+
+    static const int16_t probes[] = { 0, 1, -1, 100, -100, 1000, 8000, -8000, 32000, -32768, 32767 };
+    out("ulaw");
+    for (size_t i = 0; i < sizeof(probes) / sizeof(probes[0]); i++) {
+        uint8_t u = AudioAsset_UlawEncode(probes[i]);
+        out(" %d:%02X:%d", probes[i], u, AudioAsset_UlawDecode(u));
+    }
+    out("\n");
+}
+
+static double seg_rms(const int16_t* y, int n)
+{
+    double e = 0.0;
+    for (int i = 0; i < n; i++) e += (double)y[i] * y[i];
+    return sqrt(e / n);
+}
+
+static void case_audio_fx(void)
+{
+    enum { RATE = 16000, N = 6400, SEG = 800, SPAN = 37 };
+    static int16_t x[N], y[N], z[N];
+    static int16_t delay_a[RATE * AUDIO_FX_ECHO_MS / 1000], delay_b[RATE * AUDIO_FX_ECHO_MS / 1000];
+    static const char* const kNames[] = { "clean", "gate", "echo", "robot" };
+    AudioFx fx, fx2;
+
+    out("gain");
+    for (int db = AUDIO_FX_GAIN_DB_MIN - 3; db <= AUDIO_FX_GAIN_DB_MAX + 3; db += 3) {
+        AudioFx_Init(&fx, RATE, NULL);
+        AudioFx_SetGainDb(&fx, db);
+        out(" %+d:%ld(%+.1f)", db, (long)fx.gain_q12, 20.0 * log10(fx.gain_q12 / 4096.0));
+    }
+    out("\n");
+
+    // Low noise, a burst of 500 Hz, low noise again: the gate opens and closes
+    uint32_t seed = 11;
+    for (int i = 0; i < N; i++) {
+        seed ^= seed << 13;
+        seed ^= seed >> 17;
+        seed ^= seed << 5;
+        double tone = (i >= 2 * SEG && i < 5 * SEG) ? 6000.0 * sin(2.0 * M_PI * 500.0 * i / RATE) : 0.0;
+        x[i] = (int16_t)lrint(tone + (int)(seed % 81) - 40);
+    }
+
+    for (int p = 0; p < kAudioFxCount; p++) {
+        // Whole buffer vs odd spans: the stages carry their state across calls
+        AudioFx_Init(&fx, RATE, delay_a);
+        AudioFx_Init(&fx2, RATE, delay_b);
+        AudioFx_SetPreset(&fx, (AudioFxPreset)p);
+        AudioFx_SetPreset(&fx2, (AudioFxPreset)p);
+        memcpy(y, x, sizeof(y));
+        memcpy(z, x, sizeof(z));
+        uint32_t clipped = AudioFx_Process(&fx, y, N);
+        for (int off = 0; off < N; off += SPAN) AudioFx_Process(&fx2, z + off, N - off < SPAN ? N - off : SPAN);
+
+        out("%-5s %-5s spans=%s clipped=%u rms", kNames[p], AudioFx_PresetName((AudioFxPreset)p),
+            memcmp(y, z, sizeof(y)) == 0 ? "same" : "DIFF", (unsigned)clipped);
+        for (int s = 0; s < N / SEG; s++) out(" %5.0f", seg_rms(y + s * SEG, SEG));
+        out(" crc=%08X\n", (unsigned)Crc32_Update(CRC32_INIT, (const uint8_t*)y, sizeof(y)));
+    }
+
+    // Echo taps of a pulse (long enough for the gate to open), and a boost that clips
+    AudioFx_Init(&fx, RATE, delay_a);
+    AudioFx_SetPreset(&fx, kAudioFxEcho);
+    memset(y, 0, sizeof(y));
+    for (int i = 0; i < 64; i++) y[i] = 10000;
+    AudioFx_Process(&fx, y, N);
+    int tap = RATE * AUDIO_FX_ECHO_MS / 1000;
+    out("echo taps %d %d %d (delay %d)\n", y[32], y[tap + 32], y[2 * tap + 32], tap);
+
+    AudioFx_Init(&fx, RATE, NULL);
+    AudioFx_SetGainDb(&fx, 12);
+    for (int i = 0; i < SEG; i++) y[i] = (int16_t)lrint(12000.0 * sin(2.0 * M_PI * 250.0 * i / RATE));
+    uint32_t clipped = AudioFx_Process(&fx, y, SEG);
+    out("boost +12 dB clipped=%u rms=%.0f\n", (unsigned)clipped, seg_rms(y, SEG));
+}
+
+// Steady-state gain of a filter run over a sine: rms of the second half
+static double tone_gain_db(double hz, int amp, DspCascadeQ15* f15, DspCascadeQ31* f31)
+{
+    enum { RATE = 16000, N = 4000 };
+    static int16_t x[N];
+    static int32_t w[N];
+    for (int i = 0; i < N; i++) x[i] = (int16_t)lrint(amp * sin(2.0 * M_PI * hz * i / RATE));
+    double in = seg_rms(x + N / 2, N / 2);
+    if (f15) {
+        DspCascadeQ15_Reset(f15);
+        DspCascadeQ15_Process(f15, x, N);
+        return 20.0 * log10(seg_rms(x + N / 2, N / 2) / in);
+    }
+    for (int i = 0; i < N; i++) w[i] = x[i] * (1 << 14);
+    DspCascadeQ31_Reset(f31);
+    DspCascadeQ31_Process(f31, w, N);
+    double e = 0.0;
+    for (int i = N / 2; i < N; i++) e += ((double)w[i] / (1 << 14)) * ((double)w[i] / (1 << 14));
+    return 20.0 * log10(sqrt(e / (N / 2)) / in);
+}
+
+static void case_dsp_q15(void)
+{
+    enum { RATE = 16000, N = 4000, SPAN = 37, TAPS = 31 };
+    static int16_t x[N], y[N], z[N];
+    static const double kHz[] = { 50, 150, 500, 1000, 3000, 6000 };
+    static const char* const kTypes[] = { "lp", "hp", "peak", "lshelf", "hshelf" };
+    static const struct { DspBiquadType type; int f0, q, gain; } kDesigns[] = {
+        { kDspBiquadLowPass, 1000, 71, 0 },
+        { kDspBiquadHighPass, 150, 71, 0 },
+        { kDspBiquadPeak, 3000, 100, 60 },
+        { kDspBiquadLowShelf, 200, 71, -60 },
+        { kDspBiquadHighShelf, 4000, 71, 60 },
+    };
+
+    // log2 / dB against libm over a sweep of magnitudes
+    double worst_log2 = 0.0;
+    double worst_db = 0.0;
+    for (uint64_t v = 2; v < (1ull << 62); v += v / 2 + 7) {
+        double l2 = Dsp_Log2Q16(v) / 65536.0 - log2((double)v);
+        double db = Dsp_PowerDbQ8(v) / 256.0 - 10.0 * log10((double)v);
+        if (fabs(l2) > worst_log2) worst_log2 = fabs(l2);
+        if (fabs(db) > worst_db) worst_db = fabs(db);
+    }
+    out("log2 max_err=%.6f power_db max_err=%.4f db(0)=%ld amp_db(32767)=%ld\n", worst_log2, worst_db,
+        (long)Dsp_PowerDbQ8(0), (long)Dsp_AmpDbQ8(32767));
+
+    uint32_t bad_sqrt = 0;
+    for (uint64_t v = 0; v < (1ull << 63); v += v / 4 + 3) {
+        uint64_t r = Dsp_Isqrt64(v);
+        if (r * r > v || (r + 1) * (r + 1) <= v) bad_sqrt++;
+    }
+    out("isqrt bad=%u max=%lu\n", (unsigned)bad_sqrt, (unsigned long)Dsp_Isqrt64(UINT64_MAX));
+
+    for (int i = 0; i < N; i++) x[i] = (int16_t)lrint(10000.0 * sin(2.0 * M_PI * 440.0 * i / RATE));
+    int32_t rms = Dsp_RmsQ15(x, N - 1);
+    int32_t peak = Dsp_PeakQ15(x, N);
+    x[N - 3] = -32768;
+    out("sine 10000: rms=%ld peak=%ld peak(-32768 in the tail)=%ld sumsq(n=7)=%llu\n", (long)rms, (long)peak,
+        (long)Dsp_PeakQ15(x, N), (unsigned long long)Dsp_SumSquaresQ15(x, 7));
+
+    // Designed vs measured response; Q15 and Q31 run the same coefficients
+    for (size_t d = 0; d < sizeof(kDesigns) / sizeof(kDesigns[0]); d++) {
+        DspBiquadCoef c;
+        DspCascadeQ15 f15;
+        DspCascadeQ31 f31;
+        bool ok = DspBiquad_Design(kDesigns[d].type, RATE, (uint32_t)kDesigns[d].f0, kDesigns[d].q,
+                                   kDesigns[d].gain, &c);
+        ok = ok && DspCascadeQ15_Init(&f15, &c, 1) && DspCascadeQ31_Init(&f31, &c, 1);
+        out("%-6s %4d Hz %s q30 %ld %ld %ld %ld %ld\n", kTypes[d], kDesigns[d].f0, ok ? "ok" : "FAIL", (long)c.b0,
+            (long)c.b1, (long)c.b2, (long)c.a1, (long)c.a2);
+        if (!ok) continue;
+        for (size_t k = 0; k < sizeof(kHz) / sizeof(kHz[0]); k++) {
+            out("  %4.0f: design %+6.2f q31 %+6.2f q15 %+6.2f\n", kHz[k],
+                DspBiquad_ResponseDbQ8(&c, 1, RATE, (uint32_t)kHz[k]) / 256.0,
+                tone_gain_db(kHz[k], 8000, NULL, &f31), tone_gain_db(kHz[k], 8000, &f15, NULL));
+        }
+    }
+
+    // FIR: Hann-windowed sinc low-pass at fs/8, scaled to sum |h| = 1; the
+    // negative lobes make that cost some passband gain
+    int16_t h[TAPS];
+    int16_t hist_a[2 * TAPS], hist_b[2 * TAPS];
+    double hd[TAPS];
+    double sum = 0.0;
+    for (int i = 0; i < TAPS; i++) {
+        double t = i - (TAPS - 1) / 2.0;
+        double sinc = t == 0.0 ? 0.25 : sin(M_PI * 0.25 * t) / (M_PI * t);
+        hd[i] = sinc * (0.5 - 0.5 * cos(2.0 * M_PI * (i + 1) / (TAPS + 1)));
+        sum += fabs(hd[i]);
+    }
+    int32_t hsum = 0;
+    for (int i = 0; i < TAPS; i++) {
+        h[i] = (int16_t)(hd[i] / sum * 32767.0);
+        hsum += h[i] < 0 ? -h[i] : h[i];
+    }
+    DspFirQ15 fa, fb;
+    DspFirQ15_Init(&fa, h, TAPS, hist_a);
+    DspFirQ15_Init(&fb, h, TAPS, hist_b);
+    memset(x, 0, sizeof(x));
+    x[0] = 32767;
+    DspFirQ15_Process(&fa, x, y, TAPS + 4);
+    int imp_err = 0;
+    for (int i = 0; i < TAPS + 4; i++) {
+        int want = i < TAPS ? (int)lrint(h[i] * 32767.0 / 32768.0) : 0;
+        if (abs(y[i] - want) > imp_err) imp_err = abs(y[i] - want);
+    }
+    out("fir %d taps sum|h|=%ld impulse max_err=%d\n", TAPS, (long)hsum, imp_err);
+
+    for (int k = 0; k < 3; k++) {
+        double hz = k == 0 ? 500.0 : k == 1 ? 2000.0 : 5000.0;
+        for (int i = 0; i < N; i++) x[i] = (int16_t)lrint(16000.0 * sin(2.0 * M_PI * hz * i / RATE));
+        DspFirQ15_Init(&fa, h, TAPS, hist_a);
+        DspFirQ15_Init(&fb, h, TAPS, hist_b);
+        DspFirQ15_Process(&fa, x, y, N);
+        for (int off = 0; off < N; off += SPAN) DspFirQ15_Process(&fb, x + off, z + off, N - off < SPAN ? N - off : SPAN);
+        out("fir %4.0f Hz: %+6.2f dB spans=%s\n", hz, 20.0 * log10(seg_rms(y + N / 2, N / 2) / seg_rms(x + N / 2, N / 2)),
+            memcmp(y, z, sizeof(y)) == 0 ? "same" : "DIFF");
+    }
+}
+
+// IEC 61672 A-weighting, nominal
+static double a_weight_db(double f)
+{
+    const double f1 = 20.598997, f2 = 107.65265, f3 = 737.86223, f4 = 12194.217;
+    double f2s = f * f;
+    double ra = (f4 * f4 * f2s * f2s) /
+                ((f2s + f1 * f1) * sqrt((f2s + f2 * f2) * (f2s + f3 * f3)) * (f2s + f4 * f4));
+    return 20.0 * log10(ra) + 2.0;
+}
+
+static void case_sound_level(void)
+{
+    enum { RATE = 16000, BLOCK = 256, N = 64 * BLOCK };
+    static int16_t x[N];
+    static const double kHz[] = { 31.5, 63, 100, 250, 500, 1000, 2000, 4000, 6000, 7000 };
+    DspBiquadCoef c[SOUND_LEVEL_SECTIONS];
+    SoundLevel m;
+    SoundLevels lv;
+
+    out("design %s\n", SoundLevel_DesignAWeighting(RATE, c) ? "ok" : "FAIL");
+    for (size_t k = 0; k < sizeof(kHz) / sizeof(kHz[0]); k++) {
+        out("  %6.1f Hz: %+6.2f dB (iec %+6.2f)\n", kHz[k],
+            DspBiquad_ResponseDbQ8(c, SOUND_LEVEL_SECTIONS, RATE, (uint32_t)kHz[k]) / 256.0, a_weight_db(kHz[k]));
+    }
+    out("rates 8k=%d 48k=%d 96k=%d\n", SoundLevel_DesignAWeighting(8000, c), SoundLevel_DesignAWeighting(48000, c),
+        SoundLevel_DesignAWeighting(96000, c));
+
+    // About a second of a -20 dBFS sine per frequency, fed in blocks
+    static const double kTone[] = { 100, 1000, 4000 };
+    for (size_t k = 0; k < sizeof(kTone) / sizeof(kTone[0]); k++) {
+        SoundLevel_Init(&m, RATE);
+        for (int i = 0; i < N; i++) x[i] = (int16_t)lrint(3276.7 * sin(2.0 * M_PI * kTone[k] * i / RATE));
+        for (int off = 0; off < N; off += BLOCK) SoundLevel_Process(&m, x + off, BLOCK);
+        SoundLevel_GetLevels(&m, &lv);
+        out("tone %4.0f Hz -20 dBFS: laf %+7.2f laeq %+7.2f peak %+6.2f\n", kTone[k], lv.fast_db_q8 / 256.0,
+            lv.leq_db_q8 / 256.0, lv.peak_db_q8 / 256.0);
+    }
+
+    // A 94 dB SPL calibrator through the INMP441 scaling (-26 dBFS at 24 bits)
+    SoundLevel_Init(&m, RATE);
+    int32_t raw[BLOCK];
+    int16_t s[BLOCK];
+    double amp24 = 8388607.0 * pow(10.0, -26.0 / 20.0);
+    for (int off = 0; off < N; off += BLOCK) {
+        for (int i = 0; i < BLOCK; i++) {
+            raw[i] = (int32_t)lrint(amp24 * sin(2.0 * M_PI * 1000.0 * (off + i) / RATE)) * 256;
+        }
+        MicLevels_Condition(raw, BLOCK, s);
+        SoundLevel_Process(&m, s, BLOCK);
+    }
+    SoundLevel_GetLevels(&m, &lv);
+    out("calibrator: %.2f dB(A) SPL\n", (lv.fast_db_q8 + SOUND_LEVEL_SPL_OFFSET_Q8) / 256.0);
+
+    // F time weighting: loud, then silence; about 34.7 dB/s down
+    SoundLevel_Init(&m, RATE);
+    for (int i = 0; i < N; i++) x[i] = (int16_t)lrint(10000.0 * sin(2.0 * M_PI * 1000.0 * i / RATE));
+    for (int off = 0; off < N; off += BLOCK) SoundLevel_Process(&m, x + off, BLOCK);
+    memset(x, 0, sizeof(x));
+    out("decay");
+    for (int b = 0; b <= 16; b++) {
+        if (b % 4 == 0) {
+            SoundLevel_GetLevels(&m, &lv);
+            out(" %dms:%+.1f", b * BLOCK * 1000 / RATE, lv.fast_db_q8 / 256.0);
+        }
+        SoundLevel_Process(&m, x, BLOCK);
+    }
+    SoundLevel_GetLevels(&m, &lv);
+    out(" leq %+.2f silence_peak %+.0f\n", lv.leq_db_q8 / 256.0, lv.peak_db_q8 / 256.0);
+}
+
+static void case_crc(void)
+{
+    static const char check[] = "123456789";
+    out("crc16 %04X\n", Crc16_Update(CRC16_INIT, (const uint8_t*)check, 9));
+    out("crc32 %08X\n", (unsigned)Crc32_Update(CRC32_INIT, (const uint8_t*)check, 9));
+    uint16_t c16 = Crc16_Update(CRC16_INIT, (const uint8_t*)check, 4);
+    c16 = Crc16_Update(c16, (const uint8_t*)check + 4, 5);
+    out("crc16 split %04X\n", c16);
+}
+
+// -------------------- driver --------------------
+
+typedef struct {
+    const char* name;
+    void (*run)(void);
+} GoldenCase;
+
+static const GoldenCase k_cases[] = {
+    { "wrap",      case_wrap },
+    { "console",   case_console },
+    { "font",      case_font },
+    { "key_frame", case_key_frame },
+    { "uart_pkt",  case_uart_pkt },
+    { "mic",       case_mic },
+    { "mic_convert", case_mic_convert },
+    { "fft",       case_fft },
+    { "pitch",     case_pitch },
+    { "adpcm",     case_adpcm },
+    { "audio_mix", case_audio_mix },
+    { "audio_asset", case_audio_asset },
+    { "audio_fx",  case_audio_fx },
+    { "dsp_q15",   case_dsp_q15 },
+    { "sound_level", case_sound_level },
+    { "crc",       case_crc },
+};
+
+static char* read_file(const char* path, size_t* len)
+{
+    FILE* f = fopen(path, "rb");
+    if (!f) return NULL;
+    char* buf = malloc(OUT_CAP);
+    *len = fread(buf, 1, OUT_CAP, f);
+    fclose(f);
+    return buf;
+}
+
+static void report_diff(const char* want, size_t want_len, const char* got, size_t got_len)
+{
+    int line = 1;
+    size_t i = 0;
+    while (i < want_len && i < got_len && want[i] == got[i]) {
+        if (got[i] == '\n') line++;
+        i++;
+    }
+    fprintf(stderr, "  first difference at line %d\n", line);
+}
+
+int main(int argc, char** argv)
+{
+    bool update = argc > 1 && strcmp(argv[1], "--update") == 0;
+    int failed = 0;
+
+    for (size_t c = 0; c < sizeof(k_cases) / sizeof(k_cases[0]); c++) {
+        s_len = 0;
+        k_cases[c].run();
+
+        char path[512];
+        snprintf(path, sizeof(path), "%s/%s.txt", GOLDEN_DIR, k_cases[c].name);
+
+        if (update) {
+            FILE* f = fopen(path, "wb");
+            if (!f) {
+                perror(path);
+                return 1;
+            }
+            fwrite(s_out, 1, s_len, f);
+            fclose(f);
+            printf("%-10s written\n", k_cases[c].name);
+            continue;
+        }
+
+        size_t want_len = 0;
+        char* want = read_file(path, &want_len);
+        bool ok = want && want_len == s_len && memcmp(want, s_out, s_len) == 0;
+        printf("%-10s %s\n", k_cases[c].name, ok ? "ok" : "MISMATCH");
+        if (!ok) {
+            failed++;
+            if (!want) fprintf(stderr, "  missing %s (run with --update)\n", path);
+            else report_diff(want, want_len, s_out, s_len);
+        }
+        free(want);
+    }
+    return failed ? 1 : 0;
+}
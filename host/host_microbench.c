@@ -0,0 +1,626 @@
+// Microbenchmarks for the pure-logic firmware units. Each case runs its body
+// in a loop calibrated to ~200 ms and reports ns/op and, where the op has a
+// natural byte count, throughput.
+//
+//   ./host_microbench            all cases
+//   ./host_microbench wrap crc   only cases whose name contains a filter
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "core/crc.h"
+#include "core/lat_stats.h"
+#include "core/spsc_ring.h"
+#include "display/font_raster.h"
+#include "dsp/audio_asset.h"
+#include "dsp/audio_fx.h"
+#include "dsp/audio_mix.h"
+#include "dsp/dsp_q15.h"
+#include "dsp/fft_q15.h"
+#include "dsp/ima_adpcm.h"
+#include "dsp/mic_convert.h"
+#include "dsp/mic_levels.h"
+#include "dsp/pitch_yin.h"
+#include "dsp/sound_level.h"
+#include "input/cobs_mux.h"
+#include "input/key_frame.h"
+#include "input/uart_pkt.h"
+#include "input/uart_proto2.h"
+#include "ui/ui_console.h"
+#include "ui/ui_wrap.h"
+#include "host_util.h"
+
+#define TARGET_NS 200000000ull
+
+static volatile uint32_t s_sink;
+
+static uint8_t s_bytes[16 * 1024];
+static const char s_text[] =
+    "Experiment notes: the quick brown fox jumps over the lazy dog while the "
+    "ADC samples at 1 kHz and the UART echoes frames back to the host.\n"
+    "Second paragraph with a verylongwordthatmustbehardcutbythewrapper and more.";
+
+// Each case does one op and returns the bytes it processed (0 if n/a)
+typedef size_t (*BenchFn)(void);
+
+// -------------------- cases --------------------
+
+static size_t b_wrap(void)
+{
+    char line[64];
+    const char* p = s_text;
+    while (*p) p = UiWrap_NextLine(p, 24, line, sizeof(line));
+    s_sink += (uint8_t)line[0];
+    return sizeof(s_text) - 1;
+}
+
+static size_t b_wrap_skip(void)
+{
+    s_sink += (uint32_t)(UiWrap_SkipLines(s_text, 24, 6) - s_text);
+    return 0;
+}
+
+static UiConsole s_console;
+
+static size_t b_console_append(void)
+{
+    UiConsole_AppendWrapped(&s_console, "rx 0042: BB 03 01 02 03 06 66 ok, reply sent", 24);
+    return 0;
+}
+
+static size_t b_console_scroll(void)
+{
+    UiConsole_ScrollOlder(&s_console, 10);
+    UiConsole_ScrollNewer(&s_console, 10);
+    s_sink += (uint32_t)s_console.first;
+    return 0;
+}
+
+static uint16_t s_row[160 * 20];
+
+static size_t b_font8x16_row(void)
+{
+    // One UI body row: 17 glyphs of 8x16 into a 160x20 strip
+    FontRaster_Text8x16(s_row, 160, 20, 2, 2, "RTT P50  1234 us", 0xFFFF, 9, 20);
+    s_sink += s_row[2 * 160 + 4];
+    return 0;
+}
+
+static size_t b_font5x7_label(void)
+{
+    FontRaster_Text5x7(s_row, 160, 9, 0, 1, "63 125 250 500 1k 2k 3k", 0xFFFF, 6);
+    s_sink += s_row[160 + 1];
+    return 0;
+}
+
+static KeyFrameParser s_keys;
+static uint8_t s_key_stream[4096];
+static uint8_t s_key_out[sizeof(s_key_stream) + 2];
+
+static void on_key(uint8_t cmd, void* arg)
+{
+    (void)arg;
+    s_sink += cmd;
+}
+
+static size_t b_key_frame(void)
+{
+    uint32_t o = KeyFrame_ParseBlock(&s_keys, s_key_stream, sizeof(s_key_stream), s_key_out, on_key, NULL);
+    s_sink += o;
+    return sizeof(s_key_stream);
+}
+
+static uint8_t s_pkt_stream[4096];
+static size_t s_pkt_len;
+
+static size_t b_uart_pkt(void)
+{
+    uint8_t data[UART_PKT_MAX_DATA];
+    UartPktParser p;
+    UartPkt_Init(&p, data);
+    size_t i = 0;
+    while (i < s_pkt_len) {
+        UartPktResult res;
+        i += UartPkt_Feed(&p, s_pkt_stream + i, s_pkt_len - i, &res);
+        s_sink += res;
+    }
+    return s_pkt_len;
+}
+
+static int32_t s_mic_raw[256];
+static int16_t s_mic[256];
+static int16_t s_mic_scratch[256];
+
+static size_t b_mic_condition(void)
+{
+    MicLevels_Condition(s_mic_raw, 256, s_mic);
+    s_sink += (uint16_t)s_mic[3];
+    return sizeof(s_mic_raw);
+}
+
+static MicConvert s_mic_conv;
+static MicConvert s_mic_conv_d2;
+
+static size_t b_mic_convert(void)
+{
+    s_sink += MicConvert_Process(&s_mic_conv, s_mic_raw, s_mic_scratch, 256);
+    return sizeof(s_mic_raw);
+}
+
+static size_t b_mic_convert_decim2(void)
+{
+    s_sink += MicConvert_Process(&s_mic_conv_d2, s_mic_raw, s_mic_scratch, 256);
+    return sizeof(s_mic_raw);
+}
+
+static size_t b_mic_volume(void)
+{
+    s_sink += (uint32_t)MicLevels_VolumePct(s_mic, 256);
+    return 0;
+}
+
+static size_t b_mic_bands(void)
+{
+    int bands[MIC_LEVELS_BANDS];
+    MicLevels_OctaveBands(s_mic, 256, 16000, bands, MIC_LEVELS_BANDS);
+    s_sink += (uint32_t)bands[4];
+    return 0;
+}
+
+static FftQ15 s_fft[3];
+static int16_t s_fft_mem[3][FFT_Q15_MAX_N * 2];
+static int16_t s_fft_in[FFT_Q15_MAX_N];
+static uint32_t s_fft_power[FFT_Q15_MAX_N / 2 + 1];
+
+// 16 kHz, 512-sample window, 55..1000 Hz: a voiced A4 stops right after the
+// dip, noise scans every lag
+static PitchYin s_yin;
+static uint8_t s_yin_mem[8192];
+static int16_t s_yin_a4[1024];
+static int16_t s_yin_noise[1024];
+
+static size_t b_yin_a4(void)
+{
+    PitchYinResult r;
+    PitchYin_Estimate(&s_yin, s_yin_a4, &r);
+    s_sink += r.freq_centihz;
+    return 0;
+}
+
+static size_t b_yin_noise(void)
+{
+    PitchYinResult r;
+    PitchYin_Estimate(&s_yin, s_yin_noise, &r);
+    s_sink += r.lags;
+    return 0;
+}
+
+// One recorder block: 505 samples <-> 256 bytes
+static int16_t s_adpcm_pcm[IMA_ADPCM_BLOCK_SAMPLES];
+static uint8_t s_adpcm_block[IMA_ADPCM_BLOCK_BYTES];
+
+static size_t b_adpcm_encode(void)
+{
+    ImaAdpcmState st = {.predictor = 0, .index = 20};
+    ImaAdpcm_EncodeBlock(&st, s_adpcm_pcm, s_adpcm_block);
+    s_sink += s_adpcm_block[100];
+    return sizeof(s_adpcm_pcm);
+}
+
+static size_t b_adpcm_decode(void)
+{
+    int16_t pcm[IMA_ADPCM_BLOCK_SAMPLES];
+    ImaAdpcm_DecodeBlock(s_adpcm_block, pcm);
+    s_sink += (uint16_t)pcm[300];
+    return sizeof(pcm);
+}
+
+// Speaker mixer, one 128-sample output block (8 ms at 16 kHz)
+#define MIX_BLOCK 128
+static int16_t s_mix_src[4096];
+static int16_t s_mix_tmp[MIX_BLOCK];
+static int32_t s_mix_acc[MIX_BLOCK];
+
+static size_t mix_voice(uint32_t src_rate)
+{
+    static AudioMixVoice v[2];
+    static uint32_t pos[2];
+    AudioMixVoice* m = &v[src_rate != 16000];
+    uint32_t* p = &pos[src_rate != 16000];
+    if (m->step_q16 == 0 || *p > 2048) {
+        AudioMix_VoiceInit(m, src_rate, 16000, AUDIO_MIX_UNITY_Q15 / 2);
+        m->gain_q15 = m->target_q15;    // steady state, not the start ramp
+        *p = 0;
+    }
+    int used = 0;
+    int n = AudioMix_Resample(m, s_mix_src + *p, 1024, s_mix_tmp, MIX_BLOCK, &used);
+    *p += (uint32_t)used;
+    memset(s_mix_acc, 0, sizeof(s_mix_acc));    // as the engine does per block
+    AudioMix_Accumulate(m, s_mix_tmp, s_mix_acc, n);
+    s_sink += (uint32_t)s_mix_acc[n - 1];
+    return (size_t)n * sizeof(int16_t);
+}
+
+static size_t b_mix_voice(void) { return mix_voice(16000); }
+static size_t b_mix_voice_22k(void) { return mix_voice(22050); }
+
+static size_t b_mix_saturate(void)
+{
+    s_sink += AudioMix_Saturate(s_mix_acc, s_mix_tmp, MIX_BLOCK);
+    return MIX_BLOCK * sizeof(int16_t);
+}
+
+// Monitor effect chain, one 32-sample block (2 ms at 16 kHz, the default)
+#define FX_BLOCK 32
+
+static size_t fx_block(AudioFxPreset preset)
+{
+    static AudioFx fx[kAudioFxCount];
+    static int16_t delay[kAudioFxCount][16000 * AUDIO_FX_ECHO_MS / 1000];
+    static uint32_t pos;
+    int16_t buf[FX_BLOCK];
+    if (fx[preset].gain_q12 == 0) {
+        AudioFx_Init(&fx[preset], 16000, delay[preset]);
+        AudioFx_SetPreset(&fx[preset], preset);
+        AudioFx_SetGainDb(&fx[preset], 6);
+    }
+    pos = (pos + FX_BLOCK) & 2047;
+    memcpy(buf, s_mix_src + pos, sizeof(buf));
+    s_sink += AudioFx_Process(&fx[preset], buf, FX_BLOCK);
+    s_sink += (uint16_t)buf[FX_BLOCK - 1];
+    return sizeof(buf);
+}
+
+static size_t b_fx_clean(void) { return fx_block(kAudioFxClean); }
+static size_t b_fx_gate(void) { return fx_block(kAudioFxGate); }
+static size_t b_fx_echo(void) { return fx_block(kAudioFxEcho); }
+static size_t b_fx_robot(void) { return fx_block(kAudioFxRobot); }
+
+// DSP kernels over 256-sample blocks, the same set as the DSP experiment
+// (main/experiments/exp_dsp.c), which reports them in cycles per sample
+#define DSP_BLOCK 256
+#define DSP_TAPS  32
+
+static int16_t s_dsp_buf[DSP_BLOCK];
+static int32_t s_dsp_w[DSP_BLOCK];
+static int16_t s_dsp_taps[DSP_TAPS];
+static int16_t s_dsp_hist[2 * DSP_TAPS];
+static DspFirQ15 s_dsp_fir;
+static DspCascadeQ15 s_dsp_eq15;
+static DspCascadeQ31 s_dsp_eq31;
+static SoundLevel s_slm;
+
+static size_t b_dsp_sumsq(void)
+{
+    s_sink += (uint32_t)Dsp_SumSquaresQ15(s_fft_in, DSP_BLOCK);
+    return DSP_BLOCK * sizeof(int16_t);
+}
+
+static size_t b_dsp_peak(void)
+{
+    s_sink += (uint32_t)Dsp_PeakQ15(s_fft_in, DSP_BLOCK);
+    return DSP_BLOCK * sizeof(int16_t);
+}
+
+static size_t b_dsp_fir(void)
+{
+    DspFirQ15_Process(&s_dsp_fir, s_fft_in, s_dsp_buf, DSP_BLOCK);
+    s_sink += (uint16_t)s_dsp_buf[DSP_BLOCK - 1];
+    return DSP_BLOCK * sizeof(int16_t);
+}
+
+static size_t b_dsp_bq15(void)
+{
+    memcpy(s_dsp_buf, s_fft_in, sizeof(s_dsp_buf));
+    DspCascadeQ15_Process(&s_dsp_eq15, s_dsp_buf, DSP_BLOCK);
+    s_sink += (uint16_t)s_dsp_buf[DSP_BLOCK - 1];
+    return DSP_BLOCK * sizeof(int16_t);
+}
+
+static size_t b_dsp_bq31(void)
+{
+    for (int i = 0; i < DSP_BLOCK; i++) s_dsp_w[i] = s_fft_in[i] * (1 << 14);
+    DspCascadeQ31_Process(&s_dsp_eq31, s_dsp_w, DSP_BLOCK);
+    s_sink += (uint32_t)s_dsp_w[DSP_BLOCK - 1];
+    return DSP_BLOCK * sizeof(int16_t);
+}
+
+static size_t b_dsp_power_db(void)
+{
+    for (int i = 0; i < DSP_BLOCK; i++) {
+        s_sink += (uint32_t)Dsp_PowerDbQ8((uint64_t)(uint32_t)((int32_t)s_fft_in[i] * s_fft_in[i]) * (uint32_t)(i + 1));
+    }
+    return 0;
+}
+
+static size_t b_slm_a_weight(void)
+{
+    SoundLevel_Process(&s_slm, s_fft_in, DSP_BLOCK);
+    return DSP_BLOCK * sizeof(int16_t);
+}
+
+// One decode chunk of an embedded clip, through the asset reader
+static uint8_t s_asset_ulaw[AUDIO_ASSET_HEADER_BYTES + 256] = "SND1\x02\0\0\0\x80\x3e\0\0\0\x01\0\0";
+static uint8_t s_asset_ima[AUDIO_ASSET_HEADER_BYTES + IMA_ADPCM_BLOCK_BYTES] =
+    "SND1\x01\0\0\0\x80\x3e\0\0\xf9\x01\0\0";
+
+static size_t asset_decode(const uint8_t* asset, uint32_t len)
+{
+    AudioAssetReader r;
+    int16_t pcm[AUDIO_ASSET_CHUNK_MAX];
+    AudioAsset_Open(&r, asset, len);
+    uint32_t n = AudioAsset_Decode(&r, pcm);
+    s_sink += (uint16_t)pcm[n - 1];
+    return n * sizeof(int16_t);
+}
+
+static size_t b_asset_ulaw(void) { return asset_decode(s_asset_ulaw, sizeof(s_asset_ulaw)); }
+static size_t b_asset_ima(void) { return asset_decode(s_asset_ima, sizeof(s_asset_ima)); }
+
+static size_t fft_power(int idx)
+{
+    FftQ15* f = &s_fft[idx];
+    s_sink += (uint32_t)FftQ15_Power(f, s_fft_in, s_fft_power);
+    s_sink += s_fft_power[f->n / 8];
+    return (size_t)f->n * sizeof(int16_t);
+}
+
+static size_t b_fft256(void) { return fft_power(0); }
+static size_t b_fft512(void) { return fft_power(1); }
+static size_t b_fft1024(void) { return fft_power(2); }
+
+// The MIC page's per-window cost: FFT + 24 band levels + peak
+static size_t b_fft512_bands(void)
+{
+    static uint16_t edges[25];
+    int32_t bands[24];
+    if (!edges[24]) FftQ15_LogBandEdges(512, 16000, 63, 8000, 24, edges);
+
+    int exp = FftQ15_Power(&s_fft[1], s_fft_in, s_fft_power);
+    FftQ15_BandsDbfs(&s_fft[1], s_fft_power, exp, edges, 24, bands);
+    s_sink += (uint32_t)bands[10] + (uint32_t)FftQ15_PeakHz(&s_fft[1], s_fft_power, 16000, 2);
+    return 512 * sizeof(int16_t);
+}
+
+static size_t b_crc16(void)
+{
+    s_sink += Crc16_Update(CRC16_INIT, s_bytes, sizeof(s_bytes));
+    return sizeof(s_bytes);
+}
+
+static size_t b_crc32(void)
+{
+    s_sink += Crc32_Update(CRC32_INIT, s_bytes, sizeof(s_bytes));
+    return sizeof(s_bytes);
+}
+
+static uint8_t s_cobs_wire[COBS_MUX_FRAME_MAX(512)];
+
+static size_t b_cobs_encode(void)
+{
+    s_sink += (uint32_t)CobsMux_Encode(kMuxChanData, s_bytes, 512, s_cobs_wire, sizeof(s_cobs_wire));
+    return 512;
+}
+
+static uint8_t s_up2_frame[UP2_MAX_FRAME];
+static uint8_t s_up2_buf[UP2_MAX_PAYLOAD];
+
+static size_t b_up2_encode(void)
+{
+    s_sink += (uint32_t)Up2_Encode(s_up2_frame, sizeof(s_up2_frame), 0, kUp2TypeData, 1, 0,
+                                   s_bytes, 256);
+    return 256;
+}
+
+static size_t b_up2_parse(void)
+{
+    Up2Parser p;
+    Up2Parser_Init(&p, s_up2_buf, UP2_MAX_PAYLOAD);
+    Up2Result res;
+    size_t n = Up2_FrameSize(0, 256);
+    s_sink += (uint32_t)Up2Parser_Feed(&p, s_up2_frame, n, &res);
+    return n;
+}
+
+static SpscRing s_ring;
+static uint8_t s_ring_buf[4096];
+
+static size_t b_spsc(void)
+{
+    uint8_t tmp[256];
+    SpscRing_Write(&s_ring, s_bytes, sizeof(tmp));
+    s_sink += SpscRing_Read(&s_ring, tmp, sizeof(tmp));
+    return sizeof(tmp);
+}
+
+static uint32_t s_lat_buf[256];
+static LatStats s_lat;
+
+static size_t b_lat_snapshot(void)
+{
+    static uint32_t scratch[256];
+    LatSummary sum;
+    uint32_t n = LatStats_Snapshot(&s_lat, scratch);
+    LatStats_Percentiles(scratch, n, &sum);
+    s_sink += sum.p99;
+    return 0;
+}
+
+// -------------------- driver --------------------
+
+typedef struct {
+    const char* name;
+    BenchFn fn;
+} BenchCase;
+
+static const BenchCase k_cases[] = {
+    { "wrap.next_line",     b_wrap },
+    { "wrap.skip_lines",    b_wrap_skip },
+    { "console.append",     b_console_append },
+    { "console.scroll",     b_console_scroll },
+    { "font.8x16_row",      b_font8x16_row },
+    { "font.5x7_label",     b_font5x7_label },
+    { "key_frame.block",    b_key_frame },
+    { "uart_pkt.feed",      b_uart_pkt },
+    { "mic.condition",      b_mic_condition },
+    { "mic.convert256",     b_mic_convert },
+    { "mic.convert256_d2",  b_mic_convert_decim2 },
+    { "mic.volume",         b_mic_volume },
+    { "mic.octave_bands",   b_mic_bands },
+    { "fft.q15_256",        b_fft256 },
+    { "fft.q15_512",        b_fft512 },
+    { "fft.q15_1024",       b_fft1024 },
+    { "fft.q15_512_bands",  b_fft512_bands },
+    { "pitch.yin_a4",       b_yin_a4 },
+    { "pitch.yin_noise",    b_yin_noise },
+    { "adpcm.encode_block", b_adpcm_encode },
+    { "asset.ulaw256",      b_asset_ulaw },
+    { "asset.ima505",       b_asset_ima },
+    { "mix.voice128",       b_mix_voice },
+    { "mix.voice128_22k",   b_mix_voice_22k },
+    { "mix.saturate128",    b_mix_saturate },
+    { "fx.clean32",         b_fx_clean },
+    { "fx.gate32",          b_fx_gate },
+    { "fx.echo32",          b_fx_echo },
+    { "fx.robot32",         b_fx_robot },
+    { "dsp.sumsq256",       b_dsp_sumsq },
+    { "dsp.peak256",        b_dsp_peak },
+    { "dsp.fir32_256",      b_dsp_fir },
+    { "dsp.bq15x2_256",     b_dsp_bq15 },
+    { "dsp.bq31x2_256",     b_dsp_bq31 },
+    { "dsp.power_db256",    b_dsp_power_db },
+    { "slm.a_weight256",    b_slm_a_weight },
+    { "adpcm.decode_block", b_adpcm_decode },
+    { "crc.crc16",          b_crc16 },
+    { "crc.crc32",          b_crc32 },
+    { "cobs.encode512",     b_cobs_encode },
+    { "up2.encode256",      b_up2_encode },
+    { "up2.parse256",       b_up2_parse },
+    { "spsc.rw256",         b_spsc },
+    { "lat.snapshot256",    b_lat_snapshot },
+};
+
+static void setup(void)
+{
+    uint32_t seed = 7;
+    for (size_t i = 0; i < sizeof(s_bytes); i++) s_bytes[i] = (uint8_t)host_rand(&seed);
+
+    static const int fft_n[3] = { 256, 512, 1024 };
+    for (int i = 0; i < 3; i++) FftQ15_Init(&s_fft[i], fft_n[i], s_fft_mem[i]);
+    for (int i = 0; i < FFT_Q15_MAX_N; i++) {
+        s_fft_in[i] = (int16_t)(3000.0 * sin(2.0 * M_PI * 1037.0 * i / 16000.0) + (int)(host_rand(&seed) & 63) - 32);
+    }
+
+    PitchYin_Init(&s_yin, 16000, 512, 55, 1000, s_yin_mem);
+    for (int i = 0; i < PitchYin_FrameSamples(&s_yin); i++) {
+        double ph = 2.0 * M_PI * 440.0 * i / 16000.0;
+        s_yin_a4[i] = (int16_t)(6000.0 * sin(ph) + 3000.0 * sin(2.0 * ph) + 1500.0 * sin(3.0 * ph));
+        s_yin_noise[i] = (int16_t)((int)(host_rand(&seed) & 2047) - 1024);
+    }
+
+    for (int i = 0; i < IMA_ADPCM_BLOCK_SAMPLES; i++) {
+        s_adpcm_pcm[i] = (int16_t)(4000.0 * sin(2.0 * M_PI * 440.0 * i / 16000.0) + (int)(host_rand(&seed) & 511) - 256);
+    }
+    b_adpcm_encode();
+    memcpy(s_asset_ima + AUDIO_ASSET_HEADER_BYTES, s_adpcm_block, IMA_ADPCM_BLOCK_BYTES);
+    for (int i = 0; i < 256; i++) s_asset_ulaw[AUDIO_ASSET_HEADER_BYTES + i] = AudioAsset_UlawEncode(s_adpcm_pcm[i]);
+    for (size_t i = 0; i < sizeof(s_mix_src) / sizeof(s_mix_src[0]); i++) {
+        s_mix_src[i] = (int16_t)(12000.0 * sin(2.0 * M_PI * 440.0 * i / 22050.0));
+    }
+
+    for (int i = 0; i < DSP_TAPS; i++) s_dsp_taps[i] = 32768 / DSP_TAPS;
+    DspFirQ15_Init(&s_dsp_fir, s_dsp_taps, DSP_TAPS, s_dsp_hist);
+    DspBiquadCoef eq[2];
+    DspBiquad_Design(kDspBiquadHighPass, 16000, 150, 71, 0, &eq[0]);
+    DspBiquad_Design(kDspBiquadPeak, 16000, 3000, 100, 40, &eq[1]);
+    DspCascadeQ15_Init(&s_dsp_eq15, eq, 2);
+    DspCascadeQ31_Init(&s_dsp_eq31, eq, 2);
+    SoundLevel_Init(&s_slm, 16000);
+
+    UiConsole_Init(&s_console);
+    for (int i = 0; i < UI_CONSOLE_MAX_LINES; i++) b_console_append();
+
+    // Mostly data with a key frame every ~64 bytes and a few head bytes in data
+    KeyFrame_Reset(&s_keys);
+    for (size_t i = 0; i < sizeof(s_key_stream); i++) {
+        uint8_t b = (uint8_t)host_rand(&seed);
+        s_key_stream[i] = b == 0xAA ? 0x20 : b;
+    }
+    for (size_t i = 0; i + 3 <= sizeof(s_key_stream); i += 64) {
+        s_key_stream[i] = 0xAA;
+        s_key_stream[i + 1] = (uint8_t)(1 + i % 5);
+        s_key_stream[i + 2] = 0x55;
+    }
+
+    // Back to back 32-byte packets
+    s_pkt_len = 0;
+    while (s_pkt_len + 32 + UART_PKT_OVERHEAD <= sizeof(s_pkt_stream)) {
+        uint8_t* f = s_pkt_stream + s_pkt_len;
+        f[0] = UART_PKT_HEAD;
+        f[1] = 32;
+        memcpy(f + 2, s_bytes + s_pkt_len, 32);
+        f[34] = UartPkt_Sum(f + 2, 32);
+        f[35] = UART_PKT_TAIL;
+        s_pkt_len += 32 + UART_PKT_OVERHEAD;
+    }
+
+    for (int i = 0; i < 256; i++) {
+        double v = 300000.0 * sin(2.0 * M_PI * 1000.0 * i / 16000.0) + 20000.0 * sin(0.37 * i);
+        s_mic_raw[i] = (int32_t)lrint(v) * 256;
+    }
+    MicLevels_Condition(s_mic_raw, 256, s_mic);
+    MicConvert_Init(&s_mic_conv, MIC_CONVERT_POLE_SHIFT, 1);
+    MicConvert_Init(&s_mic_conv_d2, MIC_CONVERT_POLE_SHIFT, 2);
+
+    Up2_Encode(s_up2_frame, sizeof(s_up2_frame), 0, kUp2TypeData, 1, 0, s_bytes, 256);
+    SpscRing_Init(&s_ring, s_ring_buf, sizeof(s_ring_buf));
+
+    LatStats_Init(&s_lat, s_lat_buf, 256);
+    for (int i = 0; i < 256; i++) LatStats_Add(&s_lat, host_rand(&seed) % 5000);
+}
+
+static bool selected(const char* name, int argc, char** argv)
+{
+    if (argc < 2) return true;
+    for (int i = 1; i < argc; i++) {
+        if (strstr(name, argv[i])) return true;
+    }
+    return false;
+}
+
+int main(int argc, char** argv)
+{
+    setup();
+
+    printf("%-20s %12s %12s %10s\n", "case", "ops", "ns/op", "MB/s");
+    for (size_t c = 0; c < sizeof(k_cases) / sizeof(k_cases[0]); c++) {
+        if (!selected(k_cases[c].name, argc, argv)) continue;
+
+        // Grow the batch until it runs long enough to time reliably
+        uint64_t iters = 1;
+        uint64_t dt = 0;
+        size_t bytes = 0;
+        while (1) {
+            uint64_t t0 = host_now_ns();
+            for (uint64_t i = 0; i < iters; i++) bytes = k_cases[c].fn();
+            dt = host_now_ns() - t0;
+            if (dt >= TARGET_NS / 10) break;
+            iters *= 4;
+        }
+        iters = iters * TARGET_NS / (dt ? dt : 1) + 1;
+        uint64_t t0 = host_now_ns();
+        for (uint64_t i = 0; i < iters; i++) bytes = k_cases[c].fn();
+        dt = host_now_ns() - t0;
+
+        double ns_op = (double)dt / (double)iters;
+        if (bytes) {
+            printf("%-20s %12llu %12.1f %10.1f\n", k_cases[c].name, (unsigned long long)iters, ns_op,
+                   (double)bytes * 1000.0 / ns_op);
+        } else {
+            printf("%-20s %12llu %12.1f %10s\n", k_cases[c].name, (unsigned long long)iters, ns_op, "-");
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,31 @@
+#pragma once
+#include <stdint.h>
+#include "esp_err.h"
+
+// Pin levels are only recorded; the simulator has no board attached
+
+typedef int gpio_num_t;
+
+#define GPIO_NUM_0   0
+#define GPIO_NUM_1   1
+#define GPIO_NUM_2   2
+#define GPIO_NUM_13  13
+#define GPIO_NUM_14  14
+#define GPIO_NUM_MAX 49
+
+typedef enum { GPIO_MODE_DISABLE = 0, GPIO_MODE_INPUT, GPIO_MODE_OUTPUT } gpio_mode_t;
+typedef enum { GPIO_INTR_DISABLE = 0 } gpio_int_type_t;
+typedef enum { GPIO_PULLUP_DISABLE = 0, GPIO_PULLUP_ENABLE } gpio_pullup_t;
+typedef enum { GPIO_PULLDOWN_DISABLE = 0, GPIO_PULLDOWN_ENABLE } gpio_pulldown_t;
+
+typedef struct {
+    uint64_t pin_bit_mask;
+    gpio_mode_t mode;
+    gpio_pullup_t pull_up_en;
+    gpio_pulldown_t pull_down_en;
+    gpio_int_type_t intr_type;
+} gpio_config_t;
+
+esp_err_t gpio_config(const gpio_config_t* cfg);
+esp_err_t gpio_set_level(gpio_num_t pin, uint32_t level);
+int gpio_get_level(gpio_num_t pin);
@@ -0,0 +1,22 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+#define MALLOC_CAP_EXEC         (1u << 0)
+#define MALLOC_CAP_32BIT        (1u << 1)
+#define MALLOC_CAP_8BIT         (1u << 2)
+#define MALLOC_CAP_DMA          (1u << 3)
+#define MALLOC_CAP_SPIRAM       (1u << 10)
+#define MALLOC_CAP_INTERNAL     (1u << 11)
+#define MALLOC_CAP_DEFAULT      (1u << 12)
+
+// Backed by malloc; free sizes come from a virtual heap of the target's size
+void* heap_caps_malloc(size_t size, uint32_t caps);
+void* heap_caps_calloc(size_t n, size_t size, uint32_t caps);
+void* heap_caps_realloc(void* ptr, size_t size, uint32_t caps);
+void* heap_caps_aligned_alloc(size_t align, size_t size, uint32_t caps);
+void  heap_caps_free(void* ptr);
+
+size_t heap_caps_get_free_size(uint32_t caps);
+size_t heap_caps_get_largest_free_block(uint32_t caps);
+size_t heap_caps_get_minimum_free_size(uint32_t caps);
@@ -0,0 +1,5 @@
+#pragma once
+#include <stdint.h>
+
+// Microseconds on the simulator's virtual clock
+int64_t esp_timer_get_time(void);
@@ -0,0 +1,40 @@
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+// Single-threaded FreeRTOS stand-in for the app simulator (host/sim). Time
+// is virtual: blocking calls advance the simulated clock instead of sleeping.
+
+typedef uint32_t TickType_t;
+typedef int32_t BaseType_t;
+typedef uint32_t UBaseType_t;
+typedef uint32_t StackType_t;
+
+#define pdTRUE              ((BaseType_t)1)
+#define pdFALSE             ((BaseType_t)0)
+#define pdPASS              pdTRUE
+#define pdFAIL              pdFALSE
+
+#define configTICK_RATE_HZ  100
+#define portTICK_PERIOD_MS  (1000 / configTICK_RATE_HZ)
+#define portMAX_DELAY       ((TickType_t)0xFFFFFFFFu)
+#define pdMS_TO_TICKS(ms)   ((TickType_t)(((uint64_t)(ms) * configTICK_RATE_HZ) / 1000u))
+#define pdTICKS_TO_MS(t)    ((uint32_t)(((uint64_t)(t) * 1000u) / configTICK_RATE_HZ))
+
+typedef struct { int unused; } portMUX_TYPE;
+#define portMUX_INITIALIZER_UNLOCKED { 0 }
+#define portENTER_CRITICAL(m)       do { (void)(m); } while (0)
+#define portEXIT_CRITICAL(m)        do { (void)(m); } while (0)
+#define portENTER_CRITICAL_ISR(m)   do { (void)(m); } while (0)
+#define portEXIT_CRITICAL_ISR(m)    do { (void)(m); } while (0)
+#define portYIELD_FROM_ISR(x)       do { (void)(x); } while (0)
+
+#define BIT0  0x00000001u
+#define BIT1  0x00000002u
+#define BIT2  0x00000004u
+#define BIT3  0x00000008u
+#define BIT4  0x00000010u
+#define BIT5  0x00000020u
+#define BIT6  0x00000040u
+#define BIT7  0x00000080u
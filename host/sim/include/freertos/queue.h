@@ -0,0 +1,28 @@
+#pragma once
+#include "freertos/FreeRTOS.h"
+
+typedef struct SimQueue {
+    uint8_t* storage;
+    uint32_t length;
+    uint32_t item_size;
+    uint32_t head;
+    uint32_t count;
+    bool owns_storage;
+} StaticQueue_t;
+
+typedef StaticQueue_t* QueueHandle_t;
+
+QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t item_size);
+QueueHandle_t xQueueCreateStatic(UBaseType_t length, UBaseType_t item_size, uint8_t* storage,
+                                 StaticQueue_t* qcb);
+void vQueueDelete(QueueHandle_t q);
+
+// An empty queue advances the clock by the timeout; waiting forever on one
+// can never be satisfied in a single-threaded run and aborts.
+BaseType_t xQueueSend(QueueHandle_t q, const void* item, TickType_t timeout);
+BaseType_t xQueueReceive(QueueHandle_t q, void* out, TickType_t timeout);
+BaseType_t xQueueReset(QueueHandle_t q);
+UBaseType_t uxQueueMessagesWaiting(QueueHandle_t q);
+
+#define xQueueSendToBack(q, item, t)        xQueueSend((q), (item), (t))
+#define xQueueSendFromISR(q, item, woken)   xQueueSend((q), (item), 0)
@@ -0,0 +1,14 @@
+#pragma once
+#include "freertos/FreeRTOS.h"
+
+typedef struct SimSemaphore* SemaphoreHandle_t;
+
+SemaphoreHandle_t xSemaphoreCreateMutex(void);
+SemaphoreHandle_t xSemaphoreCreateBinary(void);
+SemaphoreHandle_t xSemaphoreCreateCounting(UBaseType_t max, UBaseType_t initial);
+void vSemaphoreDelete(SemaphoreHandle_t s);
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t s, TickType_t timeout);
+BaseType_t xSemaphoreGive(SemaphoreHandle_t s);
+
+#define xSemaphoreGiveFromISR(s, woken)     xSemaphoreGive(s)
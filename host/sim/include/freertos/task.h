@@ -0,0 +1,15 @@
+#pragma once
+#include "freertos/FreeRTOS.h"
+
+typedef void (*TaskFunction_t)(void*);
+typedef struct SimTask* TaskHandle_t;
+
+// Tasks run inline, to completion, inside xTaskCreate; vTaskDelete(NULL)
+// returns to the creator. Good enough for the finite bring-up tasks the UI
+// spawns; a task that never ends would hang the simulator.
+BaseType_t xTaskCreate(TaskFunction_t fn, const char* name, uint32_t stack_words, void* arg,
+                       UBaseType_t prio, TaskHandle_t* out);
+void vTaskDelete(TaskHandle_t t);
+
+void vTaskDelay(TickType_t ticks);
+TickType_t xTaskGetTickCount(void);
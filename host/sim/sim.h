@@ -0,0 +1,37 @@
+#pragma once
+#include <stdbool.h>
+#include <stdint.h>
+
+// Headless app simulator: App_Run against a virtual ST7735, a scripted key
+// feed and a single-threaded FreeRTOS stand-in on a virtual clock.
+
+// -------------------- clock (sim_rtos.c) --------------------
+uint64_t Sim_NowUs(void);
+void Sim_AdvanceUs(uint64_t us);
+void Sim_SetVerbose(bool on);
+bool Sim_Verbose(void);
+
+// -------------------- virtual LCD (sim_lcd.c) --------------------
+typedef struct {
+    uint64_t txns;          // SPI transactions, as the firmware driver issues them
+    uint64_t bytes;         // bytes on the wire, commands included
+    uint64_t spi_ns;        // modelled bus time
+    uint32_t blits;
+    uint32_t fills;
+    uint32_t pixels;        // St7735_DrawPixel calls
+} SimLcdStats;
+
+void SimLcd_GetStats(SimLcdStats* out);
+uint32_t SimLcd_FrameCrc(void);
+bool SimLcd_WritePpm(const char* path);
+
+// -------------------- scripted input (sim_input.c) --------------------
+// One command per line, '#' starts a comment:
+//   up | down | enter | back [count]   key presses
+//   wait <ms>                          let the app run (experiment ticks)
+//   shot <name>                        close a report segment, dump a PPM
+bool SimInput_Load(const char* path);
+
+// -------------------- report (sim_main.c) --------------------
+void Sim_Shot(const char* name);
+void Sim_Finish(void) __attribute__((noreturn));
@@ -0,0 +1,140 @@
+// Scripted key feed: replaces input/ (UART1 router + GPIO keys) for the
+// simulator. App_Run polls with a timeout; waits in the script hand that
+// time to the app so experiment ticks run exactly as on the board.
+
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "input/input.h"
+#include "input/drv_input_gpio_keys.h"
+
+#include "sim.h"
+
+#define SIM_SCRIPT_MAX  1024
+#define SIM_NAME_MAX    48
+
+typedef enum {
+    kCmdKey = 0,
+    kCmdWait,
+    kCmdShot,
+} SimCmdType;
+
+typedef struct {
+    SimCmdType type;
+    InputKey key;
+    uint32_t wait_ms;
+    char name[SIM_NAME_MAX];
+} SimCmd;
+
+static SimCmd s_script[SIM_SCRIPT_MAX];
+static int s_count;
+static int s_pos;
+static uint64_t s_wait_until_us;
+static bool s_waiting;
+
+static bool parse_key(const char* word, InputKey* out)
+{
+    if (strcmp(word, "up") == 0) *out = kInputUp;
+    else if (strcmp(word, "down") == 0) *out = kInputDown;
+    else if (strcmp(word, "enter") == 0) *out = kInputEnter;
+    else if (strcmp(word, "back") == 0) *out = kInputBack;
+    else return false;
+    return true;
+}
+
+static bool push(const SimCmd* c)
+{
+    if (s_count >= SIM_SCRIPT_MAX) return false;
+    s_script[s_count++] = *c;
+    return true;
+}
+
+bool SimInput_Load(const char* path)
+{
+    FILE* f = fopen(path, "r");
+    if (!f) {
+        perror(path);
+        return false;
+    }
+
+    char line[256];
+    int lineno = 0;
+    bool ok = true;
+    while (ok && fgets(line, sizeof(line), f)) {
+        lineno++;
+        char* hash = strchr(line, '#');
+        if (hash) *hash = 0;
+
+        char word[32] = { 0 };
+        char arg[SIM_NAME_MAX] = { 0 };
+        int n = sscanf(line, "%31s %47s", word, arg);
+        if (n <= 0) continue;
+
+        SimCmd c;
+        memset(&c, 0, sizeof(c));
+        if (parse_key(word, &c.key)) {
+            int repeat = n > 1 ? atoi(arg) : 1;
+            c.type = kCmdKey;
+            for (int i = 0; i < repeat && ok; i++) ok = push(&c);
+        } else if (strcmp(word, "wait") == 0 && n > 1 && isdigit((unsigned char)arg[0])) {
+            c.type = kCmdWait;
+            c.wait_ms = (uint32_t)strtoul(arg, NULL, 10);
+            ok = push(&c);
+        } else if (strcmp(word, "shot") == 0 && n > 1) {
+            c.type = kCmdShot;
+            snprintf(c.name, sizeof(c.name), "%s", arg);
+            ok = push(&c);
+        } else {
+            fprintf(stderr, "%s:%d: bad command '%s'\n", path, lineno, word);
+            ok = false;
+        }
+    }
+    fclose(f);
+
+    if (ok && s_count == SIM_SCRIPT_MAX) fprintf(stderr, "%s: script too long\n", path);
+    return ok;
+}
+
+void Input_Init(void)
+{
+    s_pos = 0;
+    s_waiting = false;
+}
+
+bool Input_Poll(InputKey* out_key, uint32_t timeout_ms)
+{
+    while (1) {
+        if (s_waiting) {
+            uint64_t now = Sim_NowUs();
+            if (now < s_wait_until_us) {
+                uint64_t step = (uint64_t)timeout_ms * 1000u;
+                if (step > s_wait_until_us - now) step = s_wait_until_us - now;
+                Sim_AdvanceUs(step);
+                return false;
+            }
+            s_waiting = false;
+        }
+
+        if (s_pos >= s_count) Sim_Finish();
+
+        const SimCmd* c = &s_script[s_pos++];
+        switch (c->type) {
+            case kCmdKey:
+                *out_key = c->key;
+                return true;
+            case kCmdWait:
+                s_waiting = true;
+                s_wait_until_us = Sim_NowUs() + (uint64_t)c->wait_ms * 1000u;
+                break;
+            case kCmdShot:
+                Sim_Shot(c->name);
+                break;
+        }
+    }
+}
+
+// GPIO keys are not wired in the simulator; the script is the only source
+void DrvInputGpioKeys_Init(void) {}
+void DrvInputGpioKeys_Poll(void) {}
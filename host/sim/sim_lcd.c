@@ -0,0 +1,361 @@
+// Virtual ST7735 (240x320, RGB565): implements display/st7735.h on top of a
+// small model of the controller. Each public call issues the same command /
+// data / pixel-chunk sequence as display/st7735.c, so transaction and byte
+// counts match the firmware driver and bus time is modelled from them.
+
+#include <stdio.h>
+#include <string.h>
+
+#include "display/st7735.h"
+#include "core/crc.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+#include "sim.h"
+
+#define LCD_W               240
+#define LCD_H               320
+#define LCD_SPI_HZ          40000000u   // devcfg.clock_speed_hz in st7735.c
+#define LCD_DMA_CHUNK_BYTES 4096        // pixel payload per queued transaction
+#define LCD_TXN_OVERHEAD_NS 1500u       // per-transaction setup, rough estimate
+
+#define ST7735_SW_INVERT_DEFAULT 0
+#define ST7735_SW_RB_SWAP_DEFAULT 1
+#define ST7735_HW_INVERT_DEFAULT 1
+
+// Controller state
+static uint16_t s_gram[LCD_W * LCD_H];  // words as sent on the wire
+static uint8_t s_cmd;
+static uint8_t s_param[4];
+static int s_nparam;
+static int s_win_x0, s_win_y0, s_win_x1, s_win_y1;
+static int s_wr_x, s_wr_y;
+static bool s_panel_invert;
+static bool s_madctl_bgr;
+static int s_vs_top, s_vs_area = LCD_H, s_vs_start;    // VSCRDEF / VSCSAD
+
+// Driver state
+static bool s_sw_invert = ST7735_SW_INVERT_DEFAULT;
+static bool s_sw_rb_swap = ST7735_SW_RB_SWAP_DEFAULT;
+static bool s_hw_invert = ST7735_HW_INVERT_DEFAULT;
+static int s_scroll_top, s_scroll_bottom, s_scroll_row;
+
+static SimLcdStats s_stats;
+static St7735Stats s_drv_stats;
+static bool s_in_dma;           // pixel chunks are queued DMA on the board
+
+static void bus_txn(uint32_t bytes)
+{
+    uint64_t ns = (uint64_t)bytes * 8u * 1000000000u / LCD_SPI_HZ + LCD_TXN_OVERHEAD_NS;
+    s_stats.txns++;
+    s_stats.bytes += bytes;
+    s_stats.spi_ns += ns;
+    s_drv_stats.txns++;
+    s_drv_stats.bytes += bytes;
+    // The app waits for queued chunks at the next window; polled ones spin
+    if (s_in_dma) s_drv_stats.dma_wait_us += ns / 1000u;
+    Sim_AdvanceUs(ns / 1000u);
+}
+
+// -------------------- controller model --------------------
+
+static void ctl_pixel(uint16_t word)
+{
+    if (s_wr_y > s_win_y1) return;
+    if (s_wr_x < LCD_W && s_wr_y < LCD_H) s_gram[s_wr_y * LCD_W + s_wr_x] = word;
+    if (++s_wr_x > s_win_x1) {
+        s_wr_x = s_win_x0;
+        s_wr_y++;
+    }
+}
+
+static void write_cmd(uint8_t cmd)
+{
+    bus_txn(1);
+    s_cmd = cmd;
+    s_nparam = 0;
+
+    switch (cmd) {
+        case 0x2C:  // RAMWR
+            s_wr_x = s_win_x0;
+            s_wr_y = s_win_y0;
+            break;
+        case 0x20: s_panel_invert = false; break;
+        case 0x21: s_panel_invert = true; break;
+        default: break;
+    }
+}
+
+static void ctl_param(uint8_t b)
+{
+    if (s_nparam < (int)sizeof(s_param)) s_param[s_nparam] = b;
+    s_nparam++;
+
+    if (s_cmd == 0x2A && s_nparam == 4) {
+        s_win_x0 = (s_param[0] << 8) | s_param[1];
+        s_win_x1 = (s_param[2] << 8) | s_param[3];
+    } else if (s_cmd == 0x2B && s_nparam == 4) {
+        s_win_y0 = (s_param[0] << 8) | s_param[1];
+        s_win_y1 = (s_param[2] << 8) | s_param[3];
+    } else if (s_cmd == 0x36 && s_nparam == 1) {
+        s_madctl_bgr = (b & 0x08) != 0;
+    } else if (s_cmd == 0x33 && s_nparam == 4) {
+        s_vs_top = (s_param[0] << 8) | s_param[1];
+        s_vs_area = (s_param[2] << 8) | s_param[3];
+    } else if (s_cmd == 0x37 && s_nparam == 2) {
+        s_vs_start = (s_param[0] << 8) | s_param[1];
+    }
+}
+
+static void write_data(const uint8_t* data, int len)
+{
+    bus_txn((uint32_t)len);
+    if (s_cmd == 0x2C) {
+        for (int i = 0; i + 1 < len; i += 2) ctl_pixel((uint16_t)((data[i] << 8) | data[i + 1]));
+    } else {
+        for (int i = 0; i < len; i++) ctl_param(data[i]);
+    }
+}
+
+static void write_u16_be(uint16_t v)
+{
+    uint8_t d[2] = { (uint8_t)(v >> 8), (uint8_t)(v & 0xFF) };
+    write_data(d, 2);
+}
+
+static void set_addr_window(int x0, int y0, int x1, int y1)
+{
+    write_cmd(0x2A);
+    write_u16_be((uint16_t)x0);
+    write_u16_be((uint16_t)x1);
+
+    write_cmd(0x2B);
+    write_u16_be((uint16_t)y0);
+    write_u16_be((uint16_t)y1);
+
+    write_cmd(0x2C);
+}
+
+// -------------------- driver side --------------------
+
+static inline uint16_t color_apply_sw(uint16_t c)
+{
+    if (s_sw_rb_swap) {
+        uint16_t r = (c >> 11) & 0x1F;
+        uint16_t g = (c >> 5) & 0x3F;
+        uint16_t b = c & 0x1F;
+        c = (uint16_t)((b << 11) | (g << 5) | r);
+    }
+    if (s_sw_invert) {
+        c = (uint16_t)~c;
+    }
+    return c;
+}
+
+// Pixel payload goes out in DMA-sized chunks, one transaction each
+static void queue_pixels(const uint16_t* pixels, uint16_t fill, int count_words)
+{
+    static uint8_t chunk[LCD_DMA_CHUNK_BYTES];
+    uint16_t fill_c = color_apply_sw(fill);
+
+    while (count_words > 0) {
+        int nwords = count_words;
+        if (nwords > LCD_DMA_CHUNK_BYTES / 2) nwords = LCD_DMA_CHUNK_BYTES / 2;
+
+        for (int i = 0; i < nwords; i++) {
+            uint16_t v = pixels ? color_apply_sw(pixels[i]) : fill_c;
+            chunk[i * 2 + 0] = (uint8_t)(v >> 8);
+            chunk[i * 2 + 1] = (uint8_t)(v & 0xFF);
+        }
+        s_in_dma = true;
+        write_data(chunk, nwords * 2);
+        s_in_dma = false;
+
+        if (pixels) pixels += nwords;
+        count_words -= nwords;
+    }
+}
+
+int St7735_Width(void)  { return LCD_W; }
+int St7735_Height(void) { return LCD_H; }
+
+void St7735_Init(void)
+{
+    // hw_reset()
+    vTaskDelay(pdMS_TO_TICKS(50));
+    vTaskDelay(pdMS_TO_TICKS(120));
+
+    s_sw_invert = ST7735_SW_INVERT_DEFAULT;
+    s_sw_rb_swap = ST7735_SW_RB_SWAP_DEFAULT;
+
+    write_cmd(0x01);
+    vTaskDelay(pdMS_TO_TICKS(150));
+    write_cmd(0x11);
+    vTaskDelay(pdMS_TO_TICKS(150));
+
+    write_cmd(0x3A);
+    {
+        uint8_t d = 0x05;
+        write_data(&d, 1);
+    }
+
+    write_cmd(0x36);
+    {
+        uint8_t d = 0x08;
+        write_data(&d, 1);
+    }
+
+    write_cmd(0x13);
+    write_cmd(ST7735_HW_INVERT_DEFAULT ? 0x21 : 0x20);
+    s_hw_invert = ST7735_HW_INVERT_DEFAULT;
+
+    write_cmd(0x29);
+    vTaskDelay(pdMS_TO_TICKS(50));
+}
+
+void St7735_Flush(void)
+{
+}
+
+void St7735_DrawPixel(int x, int y, uint16_t color565)
+{
+    if (x < 0 || y < 0) return;
+    if (x >= LCD_W || y >= LCD_H) return;
+
+    s_stats.pixels++;
+    set_addr_window(x, y, x, y);
+
+    uint16_t c = color_apply_sw(color565);
+    uint8_t d[2] = { (uint8_t)(c >> 8), (uint8_t)(c & 0xFF) };
+    write_data(d, 2);
+}
+
+void St7735_BlitRect(int x, int y, int w, int h, const uint16_t* pixels565)
+{
+    if (w <= 0 || h <= 0) return;
+    if (x < 0 || y < 0) return;
+    if (x + w > LCD_W) return;
+    if (y + h > LCD_H) return;
+    if (!pixels565) return;
+
+    s_stats.blits++;
+    set_addr_window(x, y, x + w - 1, y + h - 1);
+    queue_pixels(pixels565, 0, w * h);
+}
+
+void St7735_FillRect(int x, int y, int w, int h, uint16_t color565)
+{
+    if (w <= 0 || h <= 0) return;
+    if (x < 0 || y < 0) return;
+    if (x + w > LCD_W) return;
+    if (y + h > LCD_H) return;
+
+    s_stats.fills++;
+    set_addr_window(x, y, x + w - 1, y + h - 1);
+    queue_pixels(NULL, color565, w * h);
+}
+
+void St7735_Fill(uint16_t color565)
+{
+    s_stats.fills++;
+    set_addr_window(0, 0, LCD_W - 1, LCD_H - 1);
+    queue_pixels(NULL, color565, LCD_W * LCD_H);
+}
+
+void St7735_SetInversion(bool on)
+{
+    write_cmd(on ? 0x21 : 0x20);
+    s_hw_invert = on;
+}
+
+void St7735_SetScrollArea(int top_fixed, int bottom_fixed)
+{
+    if (top_fixed < 0 || bottom_fixed < 0 || top_fixed + bottom_fixed >= LCD_H) return;
+
+    write_cmd(0x33);
+    write_u16_be((uint16_t)top_fixed);
+    write_u16_be((uint16_t)(LCD_H - top_fixed - bottom_fixed));
+    write_u16_be((uint16_t)bottom_fixed);
+    s_scroll_top = top_fixed;
+    s_scroll_bottom = bottom_fixed;
+}
+
+void St7735_ScrollTo(int row)
+{
+    if (row < 0 || row >= LCD_H) return;
+
+    write_cmd(0x37);
+    write_u16_be((uint16_t)row);
+    s_scroll_row = row;
+}
+
+void St7735_ScrollReset(void)
+{
+    if (s_scroll_top == 0 && s_scroll_bottom == 0 && s_scroll_row == 0) return;
+    St7735_SetScrollArea(0, 0);
+    St7735_ScrollTo(0);
+}
+
+void St7735_SetSoftwareInvert(bool on) { s_sw_invert = on; }
+void St7735_SetSoftwareRBSwap(bool on) { s_sw_rb_swap = on; }
+bool St7735_GetSoftwareInvert(void) { return s_sw_invert; }
+bool St7735_GetSoftwareRBSwap(void) { return s_sw_rb_swap; }
+bool St7735_GetInversion(void) { return s_hw_invert; }
+
+void St7735_GetStats(St7735Stats* out)
+{
+    *out = s_drv_stats;
+}
+
+// -------------------- inspection --------------------
+
+void SimLcd_GetStats(SimLcdStats* out)
+{
+    *out = s_stats;
+}
+
+uint32_t SimLcd_FrameCrc(void)
+{
+    return Crc32_Update(CRC32_INIT, (const uint8_t*)s_gram, sizeof(s_gram));
+}
+
+// What the glass shows. MADCTL BGR puts the first field on blue, and the
+// board's IPS panel shows true colours with inversion on (the firmware
+// default), so inversion off is what looks inverted.
+static void glass_rgb(uint16_t w, uint8_t rgb[3])
+{
+    if (!s_panel_invert) w = (uint16_t)~w;
+    uint8_t hi5 = (uint8_t)((w >> 11) & 0x1F);
+    uint8_t g6 = (uint8_t)((w >> 5) & 0x3F);
+    uint8_t lo5 = (uint8_t)(w & 0x1F);
+    uint8_t r5 = s_madctl_bgr ? lo5 : hi5;
+    uint8_t b5 = s_madctl_bgr ? hi5 : lo5;
+    rgb[0] = (uint8_t)((r5 << 3) | (r5 >> 2));
+    rgb[1] = (uint8_t)((g6 << 2) | (g6 >> 4));
+    rgb[2] = (uint8_t)((b5 << 3) | (b5 >> 2));
+}
+
+// Memory row shown on display line y under vertical scroll
+static int glass_row(int y)
+{
+    if (s_vs_area <= 0 || y < s_vs_top || y >= s_vs_top + s_vs_area) return y;
+    int start = s_vs_start - s_vs_top;
+    if (start < 0 || start >= s_vs_area) start = 0;
+    return s_vs_top + (start + (y - s_vs_top)) % s_vs_area;
+}
+
+bool SimLcd_WritePpm(const char* path)
+{
+    FILE* f = fopen(path, "wb");
+    if (!f) return false;
+
+    fprintf(f, "P6\n%d %d\n255\n", LCD_W, LCD_H);
+    for (int y = 0; y < LCD_H; y++) {
+        for (int x = 0; x < LCD_W; x++) {
+            uint8_t rgb[3];
+            glass_rgb(s_gram[glass_row(y) * LCD_W + x], rgb);
+            fwrite(rgb, 1, 3, f);
+        }
+    }
+    return fclose(f) == 0;
+}
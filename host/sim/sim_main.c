@@ -0,0 +1,146 @@
+// Headless app simulator. Runs App_Run against the virtual LCD with keys
+// from a script; every "shot" closes a report segment:
+//
+//   name  t=<virtual ms>  txns  bytes  spi_us  fb=<crc32 of the frame>
+//
+// Those columns are deterministic and are what --golden compares. Host CPU
+// time per segment is printed too but never compared.
+//
+//   app_sim SCRIPT [--out DIR] [--golden FILE [--update]] [-v]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "core/app.h"
+
+#include "sim.h"
+
+#define REPORT_CAP (64 * 1024)
+
+static char s_report[REPORT_CAP];
+static size_t s_report_len;
+
+static const char* s_out_dir;
+static const char* s_golden;
+static bool s_update;
+
+static SimLcdStats s_prev;
+static uint64_t s_prev_cpu_ns;
+static int s_shots;
+
+static uint64_t cpu_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+void Sim_Shot(const char* name)
+{
+    SimLcdStats cur;
+    SimLcd_GetStats(&cur);
+    uint64_t cpu = cpu_ns();
+
+    char line[192];
+    int n = snprintf(line, sizeof(line), "%-18s t=%7llu txns=%6llu bytes=%8llu spi_us=%7llu fb=%08X",
+                     name,
+                     (unsigned long long)(Sim_NowUs() / 1000u),
+                     (unsigned long long)(cur.txns - s_prev.txns),
+                     (unsigned long long)(cur.bytes - s_prev.bytes),
+                     (unsigned long long)((cur.spi_ns - s_prev.spi_ns) / 1000u),
+                     (unsigned)SimLcd_FrameCrc());
+    if (n > 0 && s_report_len + (size_t)n + 1 < REPORT_CAP) {
+        memcpy(s_report + s_report_len, line, (size_t)n);
+        s_report_len += (size_t)n;
+        s_report[s_report_len++] = '\n';
+    }
+    printf("%s cpu_us=%llu\n", line, (unsigned long long)((cpu - s_prev_cpu_ns) / 1000u));
+
+    if (s_out_dir) {
+        char path[512];
+        snprintf(path, sizeof(path), "%s/%02d_%s.ppm", s_out_dir, s_shots, name);
+        if (!SimLcd_WritePpm(path)) fprintf(stderr, "sim: cannot write %s\n", path);
+    }
+
+    s_shots++;
+    s_prev = cur;
+    s_prev_cpu_ns = cpu;
+}
+
+static int check_golden(void)
+{
+    if (s_update) {
+        FILE* f = fopen(s_golden, "wb");
+        if (!f) {
+            perror(s_golden);
+            return 1;
+        }
+        fwrite(s_report, 1, s_report_len, f);
+        fclose(f);
+        printf("golden written: %s\n", s_golden);
+        return 0;
+    }
+
+    static char want[REPORT_CAP];
+    size_t want_len = 0;
+    FILE* f = fopen(s_golden, "rb");
+    if (f) {
+        want_len = fread(want, 1, sizeof(want), f);
+        fclose(f);
+    }
+    if (f && want_len == s_report_len && memcmp(want, s_report, want_len) == 0) {
+        printf("golden ok: %s\n", s_golden);
+        return 0;
+    }
+
+    // Report the first differing line
+    size_t i = 0;
+    int line = 1;
+    while (i < want_len && i < s_report_len && want[i] == s_report[i]) {
+        if (want[i] == '\n') line++;
+        i++;
+    }
+    fprintf(stderr, "golden MISMATCH: %s line %d%s\n", s_golden, line, f ? "" : " (missing, use --update)");
+    return 1;
+}
+
+void Sim_Finish(void)
+{
+    SimLcdStats st;
+    SimLcd_GetStats(&st);
+    printf("total: t=%llu ms txns=%llu bytes=%llu spi_us=%llu blits=%u fills=%u pixels=%u\n",
+           (unsigned long long)(Sim_NowUs() / 1000u), (unsigned long long)st.txns,
+           (unsigned long long)st.bytes, (unsigned long long)(st.spi_ns / 1000u),
+           st.blits, st.fills, st.pixels);
+
+    int rc = s_golden ? check_golden() : 0;
+    fflush(stdout);
+    exit(rc);
+}
+
+static void usage(void)
+{
+    fprintf(stderr, "usage: app_sim SCRIPT [--out DIR] [--golden FILE [--update]] [-v]\n");
+    exit(2);
+}
+
+int main(int argc, char** argv)
+{
+    const char* script = NULL;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--out") == 0 && i + 1 < argc) s_out_dir = argv[++i];
+        else if (strcmp(argv[i], "--golden") == 0 && i + 1 < argc) s_golden = argv[++i];
+        else if (strcmp(argv[i], "--update") == 0) s_update = true;
+        else if (strcmp(argv[i], "-v") == 0) Sim_SetVerbose(true);
+        else if (argv[i][0] == '-' || script) usage();
+        else script = argv[i];
+    }
+    if (!script || (s_update && !s_golden)) usage();
+    if (!SimInput_Load(script)) return 2;
+
+    s_prev_cpu_ns = cpu_ns();
+    App_Run();      // returns through Sim_Finish() when the script runs out
+    return 0;
+}
@@ -0,0 +1,39 @@
+// Experiments the simulator can run: the ones that only need the display,
+// timers, GPIO levels and tracked memory. Same order as the firmware menu.
+
+#include "experiments/experiments_registry.h"
+
+extern const Experiment g_exp_gpio;
+extern const Experiment g_exp_semaforo;
+extern const Experiment g_exp_maze;
+extern const Experiment g_exp_lcd_color;
+extern const Experiment g_exp_mem;
+extern const Experiment g_exp_bench;
+
+static const Experiment* kList[] = {
+    &g_exp_gpio,
+    &g_exp_semaforo,
+    &g_exp_maze,
+    &g_exp_lcd_color,
+    &g_exp_mem,
+    &g_exp_bench,
+};
+
+int Experiments_Count(void)
+{
+    return (int)(sizeof(kList) / sizeof(kList[0]));
+}
+
+const Experiment* Experiments_GetByIndex(int index)
+{
+    if (index < 0 || index >= Experiments_Count()) return 0;
+    return kList[index];
+}
+
+const Experiment* Experiments_GetById(int id)
+{
+    for (int i = 0; i < Experiments_Count(); i++) {
+        if (kList[i]->id == id) return kList[i];
+    }
+    return 0;
+}
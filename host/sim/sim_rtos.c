@@ -0,0 +1,339 @@
+// FreeRTOS, esp_timer, esp_log, heap_caps and gpio stand-ins for the
+// simulator. Everything runs on the caller's thread; blocking calls that
+// cannot be satisfied advance the virtual clock by their timeout.
+
+#include <setjmp.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include "freertos/semphr.h"
+#include "freertos/event_groups.h"
+#include "esp_timer.h"
+#include "esp_log.h"
+#include "esp_heap_caps.h"
+#include "driver/gpio.h"
+
+#include "sim.h"
+
+#define SIM_TICK_US         (1000000u / configTICK_RATE_HZ)
+#define SIM_HEAP_INTERNAL   (300u * 1024u)      // free internal RAM after boot, roughly
+#define SIM_HEAP_HDR        16u
+
+static uint64_t s_now_us;
+static bool s_verbose;
+
+// -------------------- clock --------------------
+
+uint64_t Sim_NowUs(void) { return s_now_us; }
+void Sim_AdvanceUs(uint64_t us) { s_now_us += us; }
+void Sim_SetVerbose(bool on) { s_verbose = on; }
+bool Sim_Verbose(void) { return s_verbose; }
+
+int64_t esp_timer_get_time(void) { return (int64_t)s_now_us; }
+
+TickType_t xTaskGetTickCount(void) { return (TickType_t)(s_now_us / SIM_TICK_US); }
+
+static void wait_ticks(TickType_t ticks, const char* what)
+{
+    if (ticks == portMAX_DELAY) {
+        fprintf(stderr, "sim: %s would block forever (nothing else runs)\n", what);
+        abort();
+    }
+    s_now_us += (uint64_t)ticks * SIM_TICK_US;
+}
+
+void vTaskDelay(TickType_t ticks)
+{
+    // Sleeps end on the next tick boundary, like the real scheduler
+    uint64_t target = (s_now_us / SIM_TICK_US + ticks) * SIM_TICK_US;
+    if (target > s_now_us) s_now_us = target;
+}
+
+// -------------------- tasks --------------------
+
+static jmp_buf* s_task_exit;
+
+BaseType_t xTaskCreate(TaskFunction_t fn, const char* name, uint32_t stack_words, void* arg,
+                       UBaseType_t prio, TaskHandle_t* out)
+{
+    (void)stack_words;
+    (void)prio;
+    if (out) *out = NULL;
+    if (s_verbose) fprintf(stderr, "sim: task %s runs inline\n", name);
+
+    jmp_buf jb;
+    jmp_buf* prev = s_task_exit;
+    s_task_exit = &jb;
+    if (setjmp(jb) == 0) fn(arg);
+    s_task_exit = prev;
+    return pdPASS;
+}
+
+void vTaskDelete(TaskHandle_t t)
+{
+    if (t == NULL && s_task_exit) longjmp(*s_task_exit, 1);
+}
+
+// -------------------- queues --------------------
+
+QueueHandle_t xQueueCreateStatic(UBaseType_t length, UBaseType_t item_size, uint8_t* storage,
+                                 StaticQueue_t* qcb)
+{
+    memset(qcb, 0, sizeof(*qcb));
+    qcb->storage = storage;
+    qcb->length = length;
+    qcb->item_size = item_size;
+    return qcb;
+}
+
+QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t item_size)
+{
+    StaticQueue_t* q = malloc(sizeof(StaticQueue_t) + (size_t)length * item_size);
+    if (!q) return NULL;
+    xQueueCreateStatic(length, item_size, (uint8_t*)(q + 1), q);
+    q->owns_storage = true;
+    return q;
+}
+
+void vQueueDelete(QueueHandle_t q)
+{
+    if (q && q->owns_storage) free(q);
+}
+
+BaseType_t xQueueSend(QueueHandle_t q, const void* item, TickType_t timeout)
+{
+    if (q->count == q->length) {
+        wait_ticks(timeout, "xQueueSend");
+        return pdFALSE;
+    }
+    uint32_t tail = (q->head + q->count) % q->length;
+    memcpy(q->storage + (size_t)tail * q->item_size, item, q->item_size);
+    q->count++;
+    return pdTRUE;
+}
+
+BaseType_t xQueueReceive(QueueHandle_t q, void* out, TickType_t timeout)
+{
+    if (q->count == 0) {
+        wait_ticks(timeout, "xQueueReceive");
+        return pdFALSE;
+    }
+    memcpy(out, q->storage + (size_t)q->head * q->item_size, q->item_size);
+    q->head = (q->head + 1) % q->length;
+    q->count--;
+    return pdTRUE;
+}
+
+BaseType_t xQueueReset(QueueHandle_t q)
+{
+    q->head = 0;
+    q->count = 0;
+    return pdPASS;
+}
+
+UBaseType_t uxQueueMessagesWaiting(QueueHandle_t q) { return q->count; }
+
+// -------------------- semaphores --------------------
+
+struct SimSemaphore {
+    uint32_t count;
+    uint32_t max;
+};
+
+static SemaphoreHandle_t sem_new(uint32_t max, uint32_t initial)
+{
+    SemaphoreHandle_t s = calloc(1, sizeof(*s));
+    if (!s) return NULL;
+    s->max = max;
+    s->count = initial;
+    return s;
+}
+
+SemaphoreHandle_t xSemaphoreCreateMutex(void) { return sem_new(1, 1); }
+SemaphoreHandle_t xSemaphoreCreateBinary(void) { return sem_new(1, 0); }
+SemaphoreHandle_t xSemaphoreCreateCounting(UBaseType_t max, UBaseType_t initial) { return sem_new(max, initial); }
+void vSemaphoreDelete(SemaphoreHandle_t s) { free(s); }
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t s, TickType_t timeout)
+{
+    if (s->count == 0) {
+        wait_ticks(timeout, "xSemaphoreTake");
+        return pdFALSE;
+    }
+    s->count--;
+    return pdTRUE;
+}
+
+BaseType_t xSemaphoreGive(SemaphoreHandle_t s)
+{
+    if (s->count >= s->max) return pdFALSE;
+    s->count++;
+    return pdTRUE;
+}
+
+// -------------------- event groups --------------------
+
+struct SimEventGroup {
+    EventBits_t bits;
+};
+
+EventGroupHandle_t xEventGroupCreate(void) { return calloc(1, sizeof(struct SimEventGroup)); }
+
+EventBits_t xEventGroupSetBits(EventGroupHandle_t g, EventBits_t bits)
+{
+    g->bits |= bits;
+    return g->bits;
+}
+
+EventBits_t xEventGroupClearBits(EventGroupHandle_t g, EventBits_t bits)
+{
+    EventBits_t prev = g->bits;
+    g->bits &= ~bits;
+    return prev;
+}
+
+EventBits_t xEventGroupGetBits(EventGroupHandle_t g) { return g->bits; }
+
+EventBits_t xEventGroupWaitBits(EventGroupHandle_t g, EventBits_t bits, BaseType_t clear_on_exit,
+                                BaseType_t wait_all, TickType_t timeout)
+{
+    EventBits_t have = g->bits;
+    bool ok = wait_all ? (have & bits) == bits : (have & bits) != 0;
+    if (!ok) {
+        wait_ticks(timeout, "xEventGroupWaitBits");
+        return g->bits;
+    }
+    if (clear_on_exit) g->bits &= ~bits;
+    return have;
+}
+
+// -------------------- esp_log / esp_err --------------------
+
+void esp_log_write(esp_log_level_t level, const char* tag, const char* fmt, ...)
+{
+    static const char kLevels[] = "NEWIDV";
+    if (!s_verbose) return;
+
+    fprintf(stderr, "%c (%lu) %s: ", kLevels[level], (unsigned long)(s_now_us / 1000u), tag);
+    va_list ap;
+    va_start(ap, fmt);
+    vfprintf(stderr, fmt, ap);
+    va_end(ap);
+    fputc('\n', stderr);
+}
+
+uint32_t esp_log_timestamp(void) { return (uint32_t)(s_now_us / 1000u); }
+
+const char* esp_err_to_name(esp_err_t err)
+{
+    switch (err) {
+        case ESP_OK: return "ESP_OK";
+        case ESP_FAIL: return "ESP_FAIL";
+        case ESP_ERR_NO_MEM: return "ESP_ERR_NO_MEM";
+        case ESP_ERR_INVALID_ARG: return "ESP_ERR_INVALID_ARG";
+        case ESP_ERR_INVALID_STATE: return "ESP_ERR_INVALID_STATE";
+        case ESP_ERR_TIMEOUT: return "ESP_ERR_TIMEOUT";
+        default: return "ESP_ERR_?";
+    }
+}
+
+// -------------------- heap --------------------
+// Blocks carry their requested size so the virtual heap's free figure, and
+// with it every screen that shows memory, stays the same across libcs.
+
+static size_t s_heap_used;
+static size_t s_heap_peak;
+
+static bool heap_internal(uint32_t caps) { return (caps & MALLOC_CAP_SPIRAM) == 0; }
+
+void* heap_caps_aligned_alloc(size_t align, size_t size, uint32_t caps)
+{
+    // No PSRAM on this board (CONFIG_SPIRAM is not set)
+    if (!heap_internal(caps)) return NULL;
+    if (s_heap_used + size > SIM_HEAP_INTERNAL) return NULL;
+    if (align < SIM_HEAP_HDR) align = SIM_HEAP_HDR;
+
+    uint8_t* raw = NULL;
+    if (posix_memalign((void**)&raw, align, align + size) != 0) return NULL;
+    uint8_t* user = raw + align;
+    ((size_t*)(user - SIM_HEAP_HDR))[0] = size;
+    ((size_t*)(user - SIM_HEAP_HDR))[1] = align;
+
+    s_heap_used += size;
+    if (s_heap_used > s_heap_peak) s_heap_peak = s_heap_used;
+    return user;
+}
+
+void* heap_caps_malloc(size_t size, uint32_t caps)
+{
+    return heap_caps_aligned_alloc(SIM_HEAP_HDR, size, caps);
+}
+
+void* heap_caps_calloc(size_t n, size_t size, uint32_t caps)
+{
+    void* p = heap_caps_malloc(n * size, caps);
+    if (p) memset(p, 0, n * size);
+    return p;
+}
+
+void heap_caps_free(void* ptr)
+{
+    if (!ptr) return;
+    uint8_t* user = (uint8_t*)ptr;
+    size_t size = ((size_t*)(user - SIM_HEAP_HDR))[0];
+    size_t align = ((size_t*)(user - SIM_HEAP_HDR))[1];
+    s_heap_used -= size;
+    free(user - align);
+}
+
+void* heap_caps_realloc(void* ptr, size_t size, uint32_t caps)
+{
+    if (!ptr) return heap_caps_malloc(size, caps);
+    size_t old = ((size_t*)((uint8_t*)ptr - SIM_HEAP_HDR))[0];
+    void* p = heap_caps_malloc(size, caps);
+    if (!p) return NULL;
+    memcpy(p, ptr, old < size ? old : size);
+    heap_caps_free(ptr);
+    return p;
+}
+
+size_t heap_caps_get_free_size(uint32_t caps)
+{
+    return heap_internal(caps) ? SIM_HEAP_INTERNAL - s_heap_used : 0;
+}
+
+size_t heap_caps_get_largest_free_block(uint32_t caps)
+{
+    return heap_caps_get_free_size(caps);
+}
+
+size_t heap_caps_get_minimum_free_size(uint32_t caps)
+{
+    return heap_internal(caps) ? SIM_HEAP_INTERNAL - s_heap_peak : 0;
+}
+
+// -------------------- gpio --------------------
+
+static uint8_t s_gpio_level[GPIO_NUM_MAX];
+
+esp_err_t gpio_config(const gpio_config_t* cfg)
+{
+    return cfg ? ESP_OK : ESP_ERR_INVALID_ARG;
+}
+
+esp_err_t gpio_set_level(gpio_num_t pin, uint32_t level)
+{
+    if (pin < 0 || pin >= GPIO_NUM_MAX) return ESP_ERR_INVALID_ARG;
+    s_gpio_level[pin] = level ? 1 : 0;
+    return ESP_OK;
+}
+
+int gpio_get_level(gpio_num_t pin)
+{
+    return (pin < 0 || pin >= GPIO_NUM_MAX) ? 0 : s_gpio_level[pin];
+}
@@ -0,0 +1,34 @@
+// Components the simulator does not model. The firmware sources are built
+// with EVTRACE_ENABLED=0, so only the explicit calls remain here.
+
+#include "evtrace.h"
+#include "dlog.h"
+#include "core/input_replay.h"
+
+void EvTrace_Init(void) {}
+void EvTrace_Enable(bool on) { (void)on; }
+bool EvTrace_IsEnabled(void) { return false; }
+void EvTrace_Emit(uint16_t id, uint8_t type, uint32_t value)
+{
+    (void)id;
+    (void)type;
+    (void)value;
+}
+void EvTrace_NameTask(const char* name) { (void)name; }
+void EvTrace_DumpUart(void) {}
+
+// Deferred log entries carry 32-bit args for the target's printf; dropped
+void Dlog_Init(void) {}
+void Dlog_Write(DlogSite* site, esp_log_level_t level, const char* tag, int nargs, const uint32_t* args)
+{
+    (void)site;
+    (void)level;
+    (void)tag;
+    (void)nargs;
+    (void)args;
+}
+uint32_t Dlog_GetDropped(void) { return 0; }
+
+// Input replay needs NVS and a live replay task; scripts drive the sim instead
+void InputReplay_OnPoll(void) {}
+void InputReplay_OnEvent(const AppEvent* ev) { (void)ev; }
@@ -0,0 +1,241 @@
+// Host benchmark for UART protocol v2: CRC throughput (table vs bitwise),
+// parser throughput, and goodput of the sliding window over a simulated
+// lossy link at a given baud rate.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "core/crc.h"
+#include "input/uart_proto2.h"
+#include "host_util.h"
+
+static uint16_t crc16_bitwise(uint16_t crc, const uint8_t* d, size_t n)
+{
+    while (n--) {
+        crc ^= (uint16_t)(*d++ << 8);
+        for (int b = 0; b < 8; b++) crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x1021) : (uint16_t)(crc << 1);
+    }
+    return crc;
+}
+
+static uint32_t crc32_bitwise(uint32_t crc, const uint8_t* d, size_t n)
+{
+    crc = ~crc;
+    while (n--) {
+        crc ^= *d++;
+        for (int b = 0; b < 8; b++) crc = (crc & 1) ? (crc >> 1) ^ 0xEDB88320u : crc >> 1;
+    }
+    return ~crc;
+}
+
+static volatile uint32_t s_sink;
+
+static void bench_crc(void)
+{
+    static uint8_t buf[64 * 1024];
+    uint32_t seed = 1;
+    for (size_t i = 0; i < sizeof(buf); i++) buf[i] = (uint8_t)host_rand(&seed);
+
+    const int reps = 400;
+    struct {
+        const char* name;
+        int kind;
+    } cases[] = {
+        { "crc16 table", 0 }, { "crc16 bitwise", 1 }, { "crc32 table", 2 }, { "crc32 bitwise", 3 },
+    };
+
+    for (size_t c = 0; c < sizeof(cases) / sizeof(cases[0]); c++) {
+        int r = (cases[c].kind & 1) ? reps / 8 : reps;
+        uint64_t t0 = host_now_ns();
+        uint32_t acc = 0;
+        for (int i = 0; i < r; i++) {
+            switch (cases[c].kind) {
+                case 0: acc += Crc16_Update(CRC16_INIT, buf, sizeof(buf)); break;
+                case 1: acc += crc16_bitwise(CRC16_INIT, buf, sizeof(buf)); break;
+                case 2: acc += Crc32_Update(CRC32_INIT, buf, sizeof(buf)); break;
+                default: acc += crc32_bitwise(CRC32_INIT, buf, sizeof(buf)); break;
+            }
+        }
+        uint64_t dt = host_now_ns() - t0;
+        s_sink = acc;
+        printf("  %-14s %8.1f MB/s\n", cases[c].name, (double)r * sizeof(buf) * 1e3 / (double)dt);
+    }
+}
+
+static void bench_parse(uint8_t flags, uint16_t payload)
+{
+    static uint8_t stream[1 << 20];
+    static uint8_t pbuf[UP2_MAX_PAYLOAD];
+    uint8_t pl[UP2_MAX_PAYLOAD];
+    memset(pl, 0x5A, sizeof(pl));
+
+    size_t n = 0;
+    uint8_t seq = 0;
+    while (n + UP2_MAX_FRAME < sizeof(stream)) {
+        n += Up2_Encode(stream + n, sizeof(stream) - n, flags, kUp2TypeData, seq++, 0, pl, payload);
+    }
+
+    Up2Parser p;
+    Up2Parser_Init(&p, pbuf, UP2_MAX_PAYLOAD);
+
+    const int reps = 20;
+    uint64_t t0 = host_now_ns();
+    for (int r = 0; r < reps; r++) {
+        // 256-byte blocks like the router hands over
+        for (size_t off = 0; off < n;) {
+            size_t chunk = (n - off) < 256 ? (n - off) : 256;
+            size_t used = 0;
+            while (used < chunk) {
+                Up2Result res;
+                used += Up2Parser_Feed(&p, stream + off + used, chunk - used, &res);
+            }
+            off += chunk;
+        }
+    }
+    uint64_t dt = host_now_ns() - t0;
+    printf("  parse %-5s len %-4u %8.1f MB/s  (%u frames ok, %u crc err)\n",
+           (flags & UP2_FLAG_CRC32) ? "crc32" : "crc16", (unsigned)payload,
+           (double)reps * n * 1e3 / (double)dt, p.frames_ok, p.crc_errors);
+}
+
+// ---------------------------------------------------------------------------
+// Link simulation: sender window -> lossy wire -> receiver, acks back over
+// a lossy wire. Time advances in 1 ms steps; each direction carries
+// baud / 10 bytes per second.
+
+typedef struct {
+    uint8_t data[64 * 1024];
+    size_t len;
+} Wire;
+
+static void wire_put(Wire* w, const uint8_t* d, size_t n, double loss, uint32_t* seed)
+{
+    if (w->len + n > sizeof(w->data)) return;
+    memcpy(w->data + w->len, d, n);
+    // Loss model: one corrupted byte per lost frame
+    if ((double)(host_rand(seed) % 100000) / 100000.0 < loss) {
+        w->data[w->len + host_rand(seed) % n] ^= 0x10;
+    }
+    w->len += n;
+}
+
+static size_t wire_take(Wire* w, uint8_t* out, size_t max)
+{
+    size_t n = w->len < max ? w->len : max;
+    memcpy(out, w->data, n);
+    memmove(w->data, w->data + n, w->len - n);
+    w->len -= n;
+    return n;
+}
+
+static uint32_t s_bad_payloads;
+
+static void sim_link(uint32_t baud, uint16_t payload, uint8_t window, double loss)
+{
+    static uint8_t slots[UP2_MAX_WINDOW * UP2_MAX_PAYLOAD];
+    static uint8_t rx_pbuf[UP2_MAX_PAYLOAD];
+    static uint8_t tx_pbuf[UP2_MAX_PAYLOAD];
+    static Wire fwd, back;
+    fwd.len = back.len = 0;
+
+    uint32_t seed = 0xC0FFEE;
+    const uint32_t bytes_per_ms = baud / 10 / 1000;
+    const uint32_t rto_ms = 20 + (uint32_t)(2u * window * Up2_FrameSize(0, payload) / (bytes_per_ms ? bytes_per_ms : 1));
+
+    Up2Tx tx;
+    Up2Tx_Init(&tx, slots, payload, window, 0, rto_ms);
+    Up2Rx rx;
+    Up2Rx_Init(&rx, 4);
+    Up2Parser rp, tp;
+    Up2Parser_Init(&rp, rx_pbuf, UP2_MAX_PAYLOAD);
+    Up2Parser_Init(&tp, tx_pbuf, UP2_MAX_PAYLOAD);
+
+    uint8_t pl[UP2_MAX_PAYLOAD];
+    uint8_t frame[UP2_MAX_FRAME];
+    uint8_t chunk[4096];
+    uint32_t idle_ms = 0;
+
+    const uint32_t sim_ms = 10000;
+    uint32_t budget_tx = 0;
+    for (uint32_t t = 0; t < sim_ms; t++) {
+        // Sender fills the window and pushes frames as the line allows
+        while (Up2Tx_CanQueue(&tx)) {
+            memset(pl, (int)tx.next, payload);
+            Up2Tx_Queue(&tx, pl, payload);
+        }
+        budget_tx += bytes_per_ms;
+        while (budget_tx >= Up2_FrameSize(0, payload)) {
+            size_t n = Up2Tx_Poll(&tx, t, 0, frame, sizeof(frame));
+            if (!n) break;
+            wire_put(&fwd, frame, n, loss, &seed);
+            budget_tx -= (uint32_t)n;
+        }
+        if (budget_tx > 4 * Up2_FrameSize(0, payload)) budget_tx = 4 * Up2_FrameSize(0, payload);
+
+        // Receiver side
+        size_t n = wire_take(&fwd, chunk, bytes_per_ms < sizeof(chunk) ? bytes_per_ms : sizeof(chunk));
+        for (size_t off = 0; off < n;) {
+            Up2Result res;
+            off += Up2Parser_Feed(&rp, chunk + off, n - off, &res);
+            if (res == kUp2Frame && Up2Rx_Accept(&rx, &rp.frame)) {
+                // Every payload byte is its seq; anything else came from the wrong slot
+                for (uint16_t i = 0; i < rp.frame.len; i++) {
+                    if (rp.frame.payload[i] != rp.frame.seq) {
+                        s_bad_payloads++;
+                        break;
+                    }
+                }
+            }
+        }
+        idle_ms = n ? 0 : idle_ms + 1;
+        if (Up2Rx_AckDue(&rx) || (idle_ms == 2 && rx.unacked)) {
+            size_t an = Up2Rx_EncodeAck(&rx, 0, frame, sizeof(frame));
+            wire_put(&back, frame, an, loss, &seed);
+        }
+
+        // Acks reach the sender
+        n = wire_take(&back, chunk, bytes_per_ms < sizeof(chunk) ? bytes_per_ms : sizeof(chunk));
+        for (size_t off = 0; off < n;) {
+            Up2Result res;
+            off += Up2Parser_Feed(&tp, chunk + off, n - off, &res);
+            if (res == kUp2Frame && tp.frame.type == kUp2TypeAck) Up2Tx_OnAck(&tx, tp.frame.ack, t);
+        }
+    }
+
+    double goodput = (double)rx.delivered_bytes / (sim_ms / 1000.0);
+    double line = baud / 10.0;
+    printf("  baud %7u len %4u win %2u loss %4.1f%%  goodput %8.0f B/s (%5.1f%% of line)  "
+           "retx %u timeouts %u ooo %u\n",
+           baud, (unsigned)payload, (unsigned)window, loss * 100.0, goodput, 100.0 * goodput / line,
+           tx.retransmits, tx.timeouts, rx.out_of_order);
+}
+
+int main(void)
+{
+    printf("CRC (64 KiB buffer):\n");
+    bench_crc();
+
+    printf("Parser (256-byte blocks):\n");
+    bench_parse(0, 16);
+    bench_parse(0, 256);
+    bench_parse(UP2_FLAG_CRC32, 256);
+    bench_parse(UP2_FLAG_CRC32, 1024);
+
+    printf("Link simulation (10 s):\n");
+    const uint32_t bauds[] = { 115200, 921600 };
+    for (size_t b = 0; b < 2; b++) {
+        sim_link(bauds[b], 256, 1, 0.0);
+        sim_link(bauds[b], 256, 8, 0.0);
+        sim_link(bauds[b], 256, 8, 0.01);
+        sim_link(bauds[b], 256, 8, 0.05);
+        sim_link(bauds[b], 256, 3, 0.01);
+        sim_link(bauds[b], 256, 5, 0.05);
+        sim_link(bauds[b], 1024, 16, 0.01);
+    }
+    if (s_bad_payloads) {
+        printf("FAIL: %u frames delivered with another frame's payload\n", s_bad_payloads);
+        return 1;
+    }
+    return 0;
+}
@@ -1,7 +1,6 @@
 #include "esp_log.h"
 #include "core/app.h"
-#include "comm_wifi.h"
-#include "comm_ble.h"
+#include "core/boot_timeline.h"
 
 static const char* kTag = "APP_MAIN";
 
@@ -21,7 +20,10 @@ lcd_fill(LCD_BLACK);
 #endif
 
 
-    CommBle_InitOnce();
+    BootTimeline_Mark("app_main");
+
+    // BT/WiFi stacks are brought up on first use by the experiments
+    // (CommBle_InitOnce in BLE on_enter, comm_wifi_start / RemoteWeb_Start in WIFI)
     ESP_LOGI(kTag, "start");
     esp_log_level_set("comm_wifi", ESP_LOG_INFO);
     esp_log_level_set("comm_ble",  ESP_LOG_INFO);
@@ -0,0 +1,505 @@
+#include "audio/audio_out.h"
+#include "audio/spk_i2s.h"
+#include "core/spsc_ring.h"
+#include "dsp/audio_asset.h"
+#include "dsp/audio_mix.h"
+#include "dsp/dsp_q15.h"
+
+#include <stdatomic.h>
+#include <string.h>
+
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "evtrace.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "freertos/event_groups.h"
+
+static const char* TAG = "AUDIO_OUT";
+
+#define EVT_CLOSED          (1u << 0)
+#define CLOSE_TIMEOUT_MS    1000
+#define WRITE_TIMEOUT_MS    200
+#define HANDLE_SLOT_BITS    4
+#define EQ_FRAC_BITS        8       // fraction bits the mix carries through the EQ
+#define EQ_MAX_SECTIONS     2
+
+typedef enum {
+    kVoiceFree = 0,
+    kVoiceSetup,            // claimed by a caller, not yet visible to the writer
+    kVoiceActive,
+} VoiceState;
+
+typedef enum {
+    kSrcClip = 0,
+    kSrcStream,
+    kSrcAsset,
+} VoiceSrc;
+
+typedef struct {
+    atomic_int state;
+    uint32_t gen;
+    VoiceSrc src;
+    const int16_t* clip;
+    uint32_t clip_left;
+    SpscRing ring;
+    AudioAssetReader asset;
+    int16_t dec[AUDIO_ASSET_CHUNK_MAX];     // current decoded asset chunk
+    uint16_t dec_n;
+    uint16_t dec_pos;
+    AudioMixVoice mix;
+    atomic_bool stop_req;
+    atomic_bool end_req;
+    volatile int16_t gain_req;
+    bool fading;            // writer only: source finished or stopped
+} Voice;
+
+static Voice s_voices[AUDIO_OUT_VOICES];
+static AudioOutConfig s_cfg;
+static SemaphoreHandle_t s_lock = NULL;
+static EventGroupHandle_t s_evt = NULL;
+static TaskHandle_t s_task = NULL;
+static int s_users = 0;
+static volatile bool s_open = false;
+static volatile bool s_close_req = false;
+
+// Writer task scratch
+static int32_t s_acc[AUDIO_OUT_MAX_BLOCK];
+static int16_t s_tmp[AUDIO_OUT_MAX_BLOCK];
+static int16_t s_out[AUDIO_OUT_MAX_BLOCK];
+
+// EQ: designs per preset at Open; the writer owns the running cascade
+static DspBiquadCoef s_eq_coef[kAudioOutEqCount][EQ_MAX_SECTIONS];
+static uint8_t s_eq_sections[kAudioOutEqCount];
+static volatile int s_eq_req = kAudioOutEqFlat;
+static int s_eq_cur = -1;       // writer only
+static DspCascadeQ31 s_eq;
+
+static const char* const kEqNames[kAudioOutEqCount] = { "FLAT", "SPEAKER" };
+
+static AudioOutStats s_stats;
+static bool s_starved;          // this block, writer only
+static uint64_t s_busy_us;
+static int64_t s_load_t0;
+static uint64_t s_load_busy0;
+
+// -------------------- writer --------------------
+
+// Longest run of source samples available right now
+static int source_span(Voice* v, const int16_t** out)
+{
+    if (v->src == kSrcClip) {
+        *out = v->clip;
+        return (int)v->clip_left;
+    }
+    if (v->src == kSrcAsset) {
+        if (v->dec_pos == v->dec_n) {
+            int64_t t0 = esp_timer_get_time();
+            v->dec_n = (uint16_t)AudioAsset_Decode(&v->asset, v->dec);
+            v->dec_pos = 0;
+            s_stats.decode_us += (uint32_t)(esp_timer_get_time() - t0);
+            s_stats.decoded_samples += v->dec_n;
+        }
+        *out = v->dec + v->dec_pos;
+        return v->dec_n - v->dec_pos;
+    }
+    const uint8_t* p;
+    uint32_t n = SpscRing_Peek(&v->ring, &p);
+    *out = (const int16_t*)p;
+    return (int)(n / sizeof(int16_t));
+}
+
+static void source_consume(Voice* v, int n)
+{
+    if (v->src == kSrcClip) {
+        v->clip += n;
+        v->clip_left -= (uint32_t)n;
+    } else if (v->src == kSrcAsset) {
+        v->dec_pos = (uint16_t)(v->dec_pos + n);
+    } else {
+        SpscRing_Commit(&v->ring, (uint32_t)n * sizeof(int16_t));
+    }
+}
+
+static void hold_last(Voice* v, int16_t* out, int n)
+{
+    for (int i = 0; i < n; i++) out[i] = v->mix.last;
+}
+
+// Resamples one block of the voice into s_tmp and adds it to s_acc
+static void mix_voice(Voice* v, int n)
+{
+    if (!v->fading && atomic_load(&v->stop_req)) v->fading = true;
+    if (v->fading) AudioMix_SetTarget(&v->mix, 0);
+    else AudioMix_SetTarget(&v->mix, v->gain_req);
+
+    int got = 0;
+    // Span by span: a ring wraps, an asset decodes its next chunk. Every
+    // call either fills output or uses up the span, so this terminates.
+    while (got < n) {
+        const int16_t* src;
+        int avail = source_span(v, &src);
+        if (avail == 0) break;
+        int used = 0;
+        got += AudioMix_Resample(&v->mix, src, avail, s_tmp + got, n - got, &used);
+        source_consume(v, used);
+    }
+
+    if (got < n) {
+        // A finished source fades out on its last sample; a stream that
+        // is merely late holds it and counts the gap
+        if (v->src != kSrcStream || atomic_load(&v->end_req)) {
+            v->fading = true;
+            AudioMix_SetTarget(&v->mix, 0);
+        } else if (!v->fading) {
+            s_stats.starved_samples += (uint32_t)(n - got);
+            s_starved = true;
+        }
+        hold_last(v, s_tmp + got, n - got);
+    }
+
+    AudioMix_Accumulate(&v->mix, s_tmp, s_acc, n);
+}
+
+// Reloads the cascade when a new preset was asked for, then filters the
+// mix with EQ_FRAC_BITS of fraction so the rounding stays below the LSB
+static void apply_eq(int n)
+{
+    int req = s_eq_req;
+    if (req != s_eq_cur) {
+        DspCascadeQ31_Init(&s_eq, s_eq_coef[req], s_eq_sections[req]);
+        s_eq_cur = req;
+    }
+    if (s_eq.count == 0) return;
+
+    int64_t t0 = esp_timer_get_time();
+    for (int i = 0; i < n; i++) s_acc[i] *= 1 << EQ_FRAC_BITS;
+    DspCascadeQ31_Process(&s_eq, s_acc, n);
+    for (int i = 0; i < n; i++) s_acc[i] = (s_acc[i] + (1 << (EQ_FRAC_BITS - 1))) >> EQ_FRAC_BITS;
+    s_stats.eq_us += (uint32_t)(esp_timer_get_time() - t0);
+    s_stats.eq_samples += (uint32_t)n;
+}
+
+static void mix_block(int n)
+{
+    memset(s_acc, 0, (size_t)n * sizeof(int32_t));
+    s_starved = false;
+
+    uint32_t active = 0;
+    for (int i = 0; i < AUDIO_OUT_VOICES; i++) {
+        Voice* v = &s_voices[i];
+        if (atomic_load_explicit(&v->state, memory_order_acquire) != kVoiceActive) continue;
+        if (s_close_req) atomic_store(&v->stop_req, true);
+
+        mix_voice(v, n);
+        if (v->fading && AudioMix_IsSilent(&v->mix)) {
+            atomic_store_explicit(&v->state, kVoiceFree, memory_order_release);
+        } else {
+            active++;
+        }
+    }
+
+    apply_eq(n);
+    s_stats.clipped_samples += AudioMix_Saturate(s_acc, s_out, n);
+    if (s_starved) s_stats.starved_blocks++;
+    s_stats.voices_active = active;
+    if (active > s_stats.voices_peak) s_stats.voices_peak = active;
+}
+
+// Silence through the whole DMA ring so the last real samples play out
+static void drain_and_close(void)
+{
+    uint32_t left = (uint32_t)s_cfg.dma_desc_num * s_cfg.dma_frame_num;
+    memset(s_out, 0, sizeof(s_out));
+    while (left > 0) {
+        uint32_t n = left < s_cfg.block_samples ? left : s_cfg.block_samples;
+        if (SpkI2s_Write(s_out, n, WRITE_TIMEOUT_MS) == 0) break;
+        left -= n;
+    }
+    s_stats.underruns = SpkI2s_Underruns();
+    SpkI2s_Close();
+    s_open = false;
+    s_close_req = false;
+    xEventGroupSetBits(s_evt, EVT_CLOSED);
+}
+
+static void writer_task(void* arg)
+{
+    (void)arg;
+    EVTRACE_TASK("audio_out");
+
+    for (;;) {
+        if (!s_open) {
+            ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+            continue;
+        }
+
+        const int n = s_cfg.block_samples;
+        int64_t t0 = esp_timer_get_time();
+        mix_block(n);
+        uint32_t dt = (uint32_t)(esp_timer_get_time() - t0);
+        s_busy_us += dt;
+        if (dt > s_stats.mix_us_max) s_stats.mix_us_max = dt;
+        s_stats.blocks++;
+
+        // Blocks until a DMA descriptor frees up: this paces the loop
+        SpkI2s_Write(s_out, (size_t)n, WRITE_TIMEOUT_MS);
+
+        if (s_close_req && s_stats.voices_active == 0) drain_and_close();
+    }
+}
+
+// -------------------- control --------------------
+
+static void design_eq(uint32_t rate)
+{
+    s_eq_sections[kAudioOutEqFlat] = 0;
+    DspBiquadCoef* c = s_eq_coef[kAudioOutEqSpeaker];
+    bool ok = DspBiquad_Design(kDspBiquadHighPass, rate, 150, 71, 0, &c[0]) &&
+              DspBiquad_Design(kDspBiquadPeak, rate, 3000, 100, 40, &c[1]);
+    s_eq_sections[kAudioOutEqSpeaker] = ok ? 2 : 0;
+}
+
+bool AudioOut_Open(const AudioOutConfig* cfg)
+{
+    // Lazily created: the first Open always comes from the app task
+    if (!s_lock) s_lock = xSemaphoreCreateMutex();
+    if (!s_evt) s_evt = xEventGroupCreate();
+    if (!s_lock || !s_evt) return false;
+
+    xSemaphoreTake(s_lock, portMAX_DELAY);
+    if (s_users > 0) {
+        s_users++;
+        xSemaphoreGive(s_lock);
+        return true;
+    }
+
+    AudioOutConfig c = AUDIO_OUT_DEFAULT_CONFIG();
+    if (cfg) c = *cfg;
+    if (c.sample_rate == 0 || c.block_samples == 0 || c.block_samples > AUDIO_OUT_MAX_BLOCK) {
+        ESP_LOGE(TAG, "bad config");
+        xSemaphoreGive(s_lock);
+        return false;
+    }
+
+    if (!s_task && xTaskCreate(writer_task, "audio_out", 3072, NULL, c.priority, &s_task) != pdPASS) {
+        s_task = NULL;
+        xSemaphoreGive(s_lock);
+        return false;
+    }
+    vTaskPrioritySet(s_task, c.priority);
+
+    SpkI2sConfig sc = {
+        .sample_rate = c.sample_rate,
+        .dma_desc_num = c.dma_desc_num,
+        .dma_frame_num = c.dma_frame_num,
+    };
+    if (!SpkI2s_Open(&sc)) {
+        xSemaphoreGive(s_lock);
+        return false;
+    }
+
+    s_cfg = c;
+    design_eq(c.sample_rate);
+    s_eq_req = kAudioOutEqFlat;
+    s_eq_cur = -1;
+    memset(&s_stats, 0, sizeof(s_stats));
+    s_stats.block_us = (uint32_t)((uint64_t)c.block_samples * 1000000u / c.sample_rate);
+    s_busy_us = 0;
+    s_load_busy0 = 0;
+    s_load_t0 = esp_timer_get_time();
+    for (int i = 0; i < AUDIO_OUT_VOICES; i++) atomic_store(&s_voices[i].state, kVoiceFree);
+
+    s_users = 1;
+    s_close_req = false;
+    xEventGroupClearBits(s_evt, EVT_CLOSED);
+    s_open = true;
+    xTaskNotifyGive(s_task);
+    xSemaphoreGive(s_lock);
+
+    ESP_LOGI(TAG, "%lu Hz, block %u, dma %ux%u", (unsigned long)c.sample_rate, (unsigned)c.block_samples,
+             (unsigned)c.dma_desc_num, (unsigned)c.dma_frame_num);
+    return true;
+}
+
+void AudioOut_Close(void)
+{
+    if (!s_lock) return;
+    xSemaphoreTake(s_lock, portMAX_DELAY);
+    if (s_users == 0 || --s_users > 0) {
+        xSemaphoreGive(s_lock);
+        return;
+    }
+
+    s_close_req = true;
+    if (!(xEventGroupWaitBits(s_evt, EVT_CLOSED, pdTRUE, pdTRUE, pdMS_TO_TICKS(CLOSE_TIMEOUT_MS)) & EVT_CLOSED)) {
+        ESP_LOGE(TAG, "writer did not drain");
+    }
+
+    AudioOutStats st;
+    AudioOut_GetStats(&st);
+    ESP_LOGI(TAG, "closed: blocks=%lu underruns=%lu starved=%lu clipped=%lu peak_voices=%lu mix_max=%lu us",
+             (unsigned long)st.blocks, (unsigned long)st.underruns, (unsigned long)st.starved_samples,
+             (unsigned long)st.clipped_samples, (unsigned long)st.voices_peak, (unsigned long)st.mix_us_max);
+    xSemaphoreGive(s_lock);
+}
+
+bool AudioOut_IsOpen(void)
+{
+    return s_open;
+}
+
+uint32_t AudioOut_SampleRate(void)
+{
+    return s_open ? s_cfg.sample_rate : 0;
+}
+
+// -------------------- voices --------------------
+
+static Voice* claim_voice(AudioVoice* out_handle)
+{
+    if (!s_open || s_close_req) return NULL;
+    for (int i = 0; i < AUDIO_OUT_VOICES; i++) {
+        Voice* v = &s_voices[i];
+        int expected = kVoiceFree;
+        if (!atomic_compare_exchange_strong(&v->state, &expected, kVoiceSetup)) continue;
+
+        v->gen = (v->gen + 1) & (0x7FFFFFFFu >> HANDLE_SLOT_BITS);
+        if (v->gen == 0) v->gen = 1;
+        atomic_store(&v->stop_req, false);
+        atomic_store(&v->end_req, false);
+        v->fading = false;
+        *out_handle = (AudioVoice)((v->gen << HANDLE_SLOT_BITS) | (uint32_t)i);
+        return v;
+    }
+    return NULL;
+}
+
+static Voice* lookup(AudioVoice h)
+{
+    if (h < 0) return NULL;
+    uint32_t slot = (uint32_t)h & ((1u << HANDLE_SLOT_BITS) - 1);
+    if (slot >= AUDIO_OUT_VOICES) return NULL;
+    Voice* v = &s_voices[slot];
+    if (atomic_load(&v->state) != kVoiceActive || v->gen != ((uint32_t)h >> HANDLE_SLOT_BITS)) return NULL;
+    return v;
+}
+
+AudioVoice AudioOut_PlayClip(const int16_t* pcm, uint32_t samples, uint32_t rate, int16_t gain_q15)
+{
+    if (!pcm || samples == 0) return -1;
+    AudioVoice h;
+    Voice* v = claim_voice(&h);
+    if (!v) return -1;
+
+    v->src = kSrcClip;
+    v->clip = pcm;
+    v->clip_left = samples;
+    v->gain_req = gain_q15;
+    AudioMix_VoiceInit(&v->mix, rate, s_cfg.sample_rate, gain_q15);
+    atomic_store_explicit(&v->state, kVoiceActive, memory_order_release);
+    return h;
+}
+
+AudioVoice AudioOut_PlayAsset(const uint8_t* asset, uint32_t bytes, int16_t gain_q15)
+{
+    AudioAssetReader r;
+    if (!AudioAsset_Open(&r, asset, bytes)) return -1;
+    AudioVoice h;
+    Voice* v = claim_voice(&h);
+    if (!v) return -1;
+
+    v->src = kSrcAsset;
+    v->asset = r;
+    v->dec_n = 0;
+    v->dec_pos = 0;
+    v->gain_req = gain_q15;
+    AudioMix_VoiceInit(&v->mix, r.sample_rate, s_cfg.sample_rate, gain_q15);
+    atomic_store_explicit(&v->state, kVoiceActive, memory_order_release);
+    return h;
+}
+
+AudioVoice AudioOut_StreamOpen(uint32_t rate, int16_t gain_q15, uint8_t* ring_mem, uint32_t ring_bytes)
+{
+    if (!ring_mem || ring_bytes < 2 * sizeof(int16_t) || (ring_bytes & (ring_bytes - 1))) return -1;
+    AudioVoice h;
+    Voice* v = claim_voice(&h);
+    if (!v) return -1;
+
+    v->src = kSrcStream;
+    SpscRing_Init(&v->ring, ring_mem, ring_bytes);
+    v->gain_req = gain_q15;
+    AudioMix_VoiceInit(&v->mix, rate, s_cfg.sample_rate, gain_q15);
+    atomic_store_explicit(&v->state, kVoiceActive, memory_order_release);
+    return h;
+}
+
+uint32_t AudioOut_StreamWrite(AudioVoice h, const int16_t* samples, uint32_t count)
+{
+    Voice* v = lookup(h);
+    if (!v || v->src != kSrcStream || atomic_load(&v->end_req)) return 0;
+    // Whole samples only, so the writer never sees half of one
+    uint32_t n = SpscRing_Free(&v->ring) / sizeof(int16_t);
+    if (n > count) n = count;
+    return SpscRing_Write(&v->ring, (const uint8_t*)samples, n * sizeof(int16_t)) / sizeof(int16_t);
+}
+
+uint32_t AudioOut_StreamFree(AudioVoice h)
+{
+    Voice* v = lookup(h);
+    if (!v || v->src != kSrcStream) return 0;
+    return SpscRing_Free(&v->ring) / sizeof(int16_t);
+}
+
+void AudioOut_StreamEnd(AudioVoice h)
+{
+    Voice* v = lookup(h);
+    if (v) atomic_store(&v->end_req, true);
+}
+
+void AudioOut_SetEq(AudioOutEq eq)
+{
+    if (eq >= 0 && eq < kAudioOutEqCount) s_eq_req = eq;
+}
+
+AudioOutEq AudioOut_GetEq(void)
+{
+    return (AudioOutEq)s_eq_req;
+}
+
+const char* AudioOut_EqName(AudioOutEq eq)
+{
+    return (eq >= 0 && eq < kAudioOutEqCount) ? kEqNames[eq] : "?";
+}
+
+void AudioOut_SetGain(AudioVoice h, int16_t gain_q15)
+{
+    Voice* v = lookup(h);
+    if (v) v->gain_req = gain_q15;
+}
+
+void AudioOut_Stop(AudioVoice h)
+{
+    Voice* v = lookup(h);
+    if (v) atomic_store(&v->stop_req, true);
+}
+
+bool AudioOut_IsActive(AudioVoice h)
+{
+    return lookup(h) != NULL;
+}
+
+void AudioOut_GetStats(AudioOutStats* out)
+{
+    *out = s_stats;
+    out->underruns = SpkI2s_IsOpen() ? SpkI2s_Underruns() : s_stats.underruns;
+    s_stats.underruns = out->underruns;
+
+    int64_t now = esp_timer_get_time();
+    uint64_t wall = (uint64_t)(now - s_load_t0);
+    uint64_t busy = s_busy_us - s_load_busy0;
+    out->cpu_permille = wall ? (uint32_t)(busy * 1000u / wall) : 0;
+    s_load_t0 = now;
+    s_load_busy0 = s_busy_us;
+}
@@ -0,0 +1,93 @@
+#pragma once
+#include <stdbool.h>
+#include <stdint.h>
+
+// Speaker output engine: one persistent writer task mixes up to
+// AUDIO_OUT_VOICES voices (dsp/audio_mix.h) into the I2S1 DMA ring
+// (audio/spk_i2s.h). Every call below is non-blocking except Open/Close.
+//
+// Voices play a clip from memory, a compressed asset (dsp/audio_asset.h,
+// decoded one chunk at a time inside the mix) or a stream the caller feeds
+// through a lock-free ring it owns. Each voice has its own source rate and a ramped
+// gain; stopping fades out instead of cutting. A voice is freed once it is
+// silent, and a handle that outlived its voice is simply ignored.
+//
+// While open the task keeps the DMA ring full (silence when idle), so the
+// block size sets the mixing granularity and dma_desc_num x dma_frame_num
+// the output latency.
+//
+// An optional EQ (dsp/dsp_q15.h biquads) runs on the mixed block before
+// it is saturated, so its boost shows up in clipped_samples.
+
+#define AUDIO_OUT_VOICES     4
+#define AUDIO_OUT_MAX_BLOCK  256
+#define AUDIO_OUT_GAIN_UNITY 32767      // Q15
+
+typedef int32_t AudioVoice;     // < 0: no voice
+
+typedef enum {
+    kAudioOutEqFlat = 0,
+    kAudioOutEqSpeaker,         // 150 Hz high-pass, +4 dB presence at 3 kHz: small drivers
+    kAudioOutEqCount,
+} AudioOutEq;
+
+typedef struct {
+    uint32_t sample_rate;
+    uint16_t block_samples;     // mixed per pass, <= AUDIO_OUT_MAX_BLOCK
+    uint16_t dma_desc_num;
+    uint16_t dma_frame_num;
+    uint8_t priority;           // writer task
+} AudioOutConfig;
+
+// 8 ms blocks into a 4 x 128 ring: 32 ms of output buffering at 16 kHz
+#define AUDIO_OUT_DEFAULT_CONFIG() {    \
+    .sample_rate = 16000,               \
+    .block_samples = 128,               \
+    .dma_desc_num = 4,                  \
+    .dma_frame_num = 128,               \
+    .priority = 12,                     \
+}
+
+typedef struct {
+    uint32_t blocks;
+    uint32_t underruns;         // DMA descriptors sent without fresh data
+    uint32_t starved_samples;   // stream voices that ran dry (held their last sample)
+    uint32_t starved_blocks;    // mixed blocks with at least one dry stream
+    uint32_t clipped_samples;
+    uint32_t voices_active;
+    uint32_t voices_peak;
+    uint32_t decode_us;         // total spent decoding assets
+    uint32_t decoded_samples;
+    uint32_t eq_us;             // total spent in the EQ
+    uint32_t eq_samples;
+    uint32_t mix_us_max;        // worst single block, decoding included
+    uint32_t cpu_permille;      // mixing time over wall time, since the last call
+    uint32_t block_us;          // block_samples at sample_rate
+} AudioOutStats;
+
+// Reference counted; the first caller's config (NULL: default) applies.
+bool AudioOut_Open(const AudioOutConfig* cfg);
+// The last Close fades every voice out and lets the DMA ring drain.
+void AudioOut_Close(void);
+bool AudioOut_IsOpen(void);
+uint32_t AudioOut_SampleRate(void);
+
+AudioVoice AudioOut_PlayClip(const int16_t* pcm, uint32_t samples, uint32_t rate, int16_t gain_q15);
+AudioVoice AudioOut_PlayAsset(const uint8_t* asset, uint32_t bytes, int16_t gain_q15);
+
+// ring_mem: power-of-two bytes, owned by the caller until the voice ends
+AudioVoice AudioOut_StreamOpen(uint32_t rate, int16_t gain_q15, uint8_t* ring_mem, uint32_t ring_bytes);
+uint32_t AudioOut_StreamWrite(AudioVoice v, const int16_t* samples, uint32_t count);    // samples taken
+uint32_t AudioOut_StreamFree(AudioVoice v);                                             // in samples
+void AudioOut_StreamEnd(AudioVoice v);      // plays what is queued, then fades out
+
+// Takes effect at the next block; every Open starts flat
+void AudioOut_SetEq(AudioOutEq eq);
+AudioOutEq AudioOut_GetEq(void);
+const char* AudioOut_EqName(AudioOutEq eq);
+
+void AudioOut_SetGain(AudioVoice v, int16_t gain_q15);
+void AudioOut_Stop(AudioVoice v);
+bool AudioOut_IsActive(AudioVoice v);
+
+void AudioOut_GetStats(AudioOutStats* out);
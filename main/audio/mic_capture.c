@@ -0,0 +1,317 @@
+#include "audio/mic_capture.h"
+#include "core/hot_path.h"
+#include "dsp/mic_convert.h"
+
+#include <stdatomic.h>
+#include <string.h>
+
+#include "driver/i2s_std.h"
+#include "esp_attr.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "evtrace.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/event_groups.h"
+
+static const char* TAG = "MIC_CAP";
+
+#define MIC_I2S_PORT      I2S_NUM_0
+#define MIC_BITS          I2S_DATA_BIT_WIDTH_32BIT
+#define MIC_WS_GPIO       4
+#define MIC_SCK_GPIO      5
+#define MIC_SD_GPIO       6
+
+#define EVT_BLOCK         (1u << 0)     // a block was published
+#define EVT_EXITED        (1u << 1)     // capture task is gone
+#define READ_TIMEOUT_MS   100
+
+static MicCaptureConfig s_cfg;
+static i2s_chan_handle_t s_rx_chan = NULL;
+static EventGroupHandle_t s_evt = NULL;
+static TaskHandle_t s_task = NULL;
+static volatile bool s_run = false;
+static bool s_running = false;
+
+static int16_t* s_ring = NULL;          // block_count * block_samples
+static int32_t* s_raw = NULL;           // block_samples * decimate, I2S words
+static MicConvert s_conv;
+static uint32_t s_ring_samples;
+static atomic_uint s_produced;          // samples published, wraps at 2^32
+
+static MicCaptureStats s_stats;
+static volatile uint32_t s_dma_overruns;
+static uint64_t s_busy_us;
+static int64_t s_load_t0;
+static uint64_t s_load_busy0;
+
+// One per completed DMA descriptor
+static IRAM_ATTR bool on_recv(i2s_chan_handle_t handle, i2s_event_data_t* event, void* user_ctx)
+{
+    (void)handle;
+    (void)event;
+    (void)user_ctx;
+    BaseType_t woken = pdFALSE;
+    if (s_task) vTaskNotifyGiveFromISR(s_task, &woken);
+    return woken == pdTRUE;
+}
+
+static IRAM_ATTR bool on_recv_q_ovf(i2s_chan_handle_t handle, i2s_event_data_t* event, void* user_ctx)
+{
+    (void)handle;
+    (void)event;
+    (void)user_ctx;
+    s_dma_overruns++;
+    return false;
+}
+
+static bool start_driver(void)
+{
+    i2s_chan_config_t chan_cfg = I2S_CHANNEL_DEFAULT_CONFIG(MIC_I2S_PORT, I2S_ROLE_MASTER);
+    chan_cfg.dma_desc_num = s_cfg.dma_desc_num;
+    chan_cfg.dma_frame_num = s_cfg.dma_frame_num;
+    if (i2s_new_channel(&chan_cfg, NULL, &s_rx_chan) != ESP_OK) return false;
+
+    i2s_std_config_t std_cfg = {
+        .clk_cfg = I2S_STD_CLK_DEFAULT_CONFIG(s_cfg.sample_rate),
+        .slot_cfg = I2S_STD_MSB_SLOT_DEFAULT_CONFIG(MIC_BITS, I2S_SLOT_MODE_MONO),
+        .gpio_cfg = {
+            .mclk = I2S_GPIO_UNUSED,
+            .bclk = MIC_SCK_GPIO,
+            .ws = MIC_WS_GPIO,
+            .dout = I2S_GPIO_UNUSED,
+            .din = MIC_SD_GPIO,
+            .invert_flags = {
+                .mclk_inv = false,
+                .bclk_inv = false,
+                .ws_inv = false,
+            },
+        },
+    };
+    std_cfg.slot_cfg.slot_mask = I2S_STD_SLOT_LEFT;
+
+    i2s_event_callbacks_t cbs = {
+        .on_recv = on_recv,
+        .on_recv_q_ovf = on_recv_q_ovf,
+    };
+
+    if (i2s_channel_init_std_mode(s_rx_chan, &std_cfg) != ESP_OK ||
+        i2s_channel_register_event_callback(s_rx_chan, &cbs, NULL) != ESP_OK ||
+        i2s_channel_enable(s_rx_chan) != ESP_OK) {
+        i2s_del_channel(s_rx_chan);
+        s_rx_chan = NULL;
+        return false;
+    }
+    return true;
+}
+
+static void stop_driver(void)
+{
+    if (s_rx_chan) {
+        i2s_channel_disable(s_rx_chan);
+        i2s_del_channel(s_rx_chan);
+        s_rx_chan = NULL;
+    }
+}
+
+static void publish_block(void)
+{
+    uint32_t produced = atomic_load_explicit(&s_produced, memory_order_relaxed);
+    uint32_t slot = (produced / s_cfg.block_samples) & (s_cfg.block_count - 1);
+    MicConvert_Process(&s_conv, s_raw, s_ring + slot * s_cfg.block_samples,
+                       (uint32_t)s_cfg.block_samples * s_cfg.decimate);
+    atomic_store_explicit(&s_produced, produced + s_cfg.block_samples, memory_order_release);
+    s_stats.blocks++;
+    xEventGroupSetBits(s_evt, EVT_BLOCK);
+}
+
+static void capture_task(void* arg)
+{
+    (void)arg;
+    EVTRACE_TASK("mic_capture");
+
+    const uint32_t block_bytes = (uint32_t)s_cfg.block_samples * s_cfg.decimate * sizeof(int32_t);
+    uint32_t got = 0;
+
+    while (s_run) {
+        // Woken per DMA descriptor, then reads never block: everything from
+        // here to the end of the loop is CPU time spent on capture
+        if (ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(READ_TIMEOUT_MS)) == 0) continue;
+
+        int64_t t0 = esp_timer_get_time();
+        EVTRACE_BEGIN(kEvtI2sRead);
+
+        for (;;) {
+            size_t n = 0;
+            esp_err_t err = i2s_channel_read(s_rx_chan, (uint8_t*)s_raw + got, block_bytes - got, &n, 0);
+            got += (uint32_t)n;
+            if (got == block_bytes) {
+                publish_block();
+                got = 0;
+            }
+            if (err == ESP_ERR_TIMEOUT) break;      // DMA queue drained
+            if (err != ESP_OK) {
+                s_stats.read_errors++;
+                break;
+            }
+        }
+
+        EVTRACE_END(kEvtI2sRead);
+        s_busy_us += (uint64_t)(esp_timer_get_time() - t0);
+    }
+
+    s_task = NULL;
+    xEventGroupSetBits(s_evt, EVT_EXITED);
+    vTaskDelete(NULL);
+}
+
+static bool is_pow2(uint32_t v)
+{
+    return v && (v & (v - 1)) == 0;
+}
+
+bool MicCapture_Start(const MicCaptureConfig* cfg, ExpArena* arena)
+{
+    if (s_running || !cfg || !arena) return false;
+    if (cfg->dma_desc_num < 2 || cfg->dma_frame_num == 0 || cfg->block_samples == 0 ||
+        !is_pow2(cfg->block_count) || cfg->block_count > MIC_CAPTURE_MAX_BLOCKS ||
+        !MicConvert_Init(&s_conv, MIC_CONVERT_POLE_SHIFT, cfg->decimate)) {
+        ESP_LOGE(TAG, "bad config");
+        return false;
+    }
+    s_cfg = *cfg;
+    s_ring_samples = (uint32_t)s_cfg.block_count * s_cfg.block_samples;
+
+    s_ring = (int16_t*)ExpArena_Alloc(arena, kExpArenaNormal, s_ring_samples * sizeof(int16_t));
+    s_raw = (int32_t*)ExpArena_Alloc(arena, kExpArenaNormal,
+                                     (size_t)s_cfg.block_samples * s_cfg.decimate * sizeof(int32_t));
+    if (!s_ring || !s_raw) {
+        ESP_LOGE(TAG, "no memory for %lu ring samples", (unsigned long)s_ring_samples);
+        return false;
+    }
+
+    if (!s_evt) s_evt = xEventGroupCreate();
+    if (!s_evt) return false;
+    xEventGroupClearBits(s_evt, EVT_BLOCK | EVT_EXITED);
+
+    memset(&s_stats, 0, sizeof(s_stats));
+    s_stats.dma_latency_us = (uint32_t)((uint64_t)s_cfg.dma_desc_num * s_cfg.dma_frame_num * 1000000u /
+                                        s_cfg.sample_rate);
+    s_dma_overruns = 0;
+    s_busy_us = 0;
+    s_load_busy0 = 0;
+    s_load_t0 = esp_timer_get_time();
+    atomic_store(&s_produced, 0u);
+
+    if (!start_driver()) {
+        ESP_LOGE(TAG, "i2s init failed");
+        return false;
+    }
+
+    s_run = true;
+    if (xTaskCreate(capture_task, "mic_capture", 3072, NULL, s_cfg.priority, &s_task) != pdPASS) {
+        s_task = NULL;
+        s_run = false;
+        stop_driver();
+        return false;
+    }
+    s_running = true;
+
+    ESP_LOGI(TAG, "%lu Hz /%u, dma %ux%u (%lu us), ring %ux%u", (unsigned long)s_cfg.sample_rate,
+             (unsigned)s_cfg.decimate, (unsigned)s_cfg.dma_desc_num, (unsigned)s_cfg.dma_frame_num,
+             (unsigned long)s_stats.dma_latency_us, (unsigned)s_cfg.block_count, (unsigned)s_cfg.block_samples);
+    return true;
+}
+
+void MicCapture_Stop(void)
+{
+    if (!s_running) return;
+
+    s_run = false;
+    // The task notices within one read timeout
+    xEventGroupWaitBits(s_evt, EVT_EXITED, pdTRUE, pdTRUE, pdMS_TO_TICKS(READ_TIMEOUT_MS * 3));
+    stop_driver();
+
+    s_running = false;
+    s_ring = NULL;
+    s_raw = NULL;
+}
+
+bool MicCapture_IsRunning(void)
+{
+    return s_running;
+}
+
+uint32_t MicCapture_SampleRate(void)
+{
+    return s_cfg.decimate ? s_cfg.sample_rate / s_cfg.decimate : 0;
+}
+
+void MicCapture_ReaderInit(MicCaptureReader* r)
+{
+    memset(r, 0, sizeof(*r));
+    r->pos = atomic_load_explicit(&s_produced, memory_order_acquire);
+}
+
+HOT_PATH static void copy_out(int16_t* out, uint32_t pos, uint32_t n)
+{
+    uint32_t off = pos % s_ring_samples;
+    uint32_t first = s_ring_samples - off;
+    if (first > n) first = n;
+    memcpy(out, s_ring + off, first * sizeof(int16_t));
+    if (n > first) memcpy(out + first, s_ring, (n - first) * sizeof(int16_t));
+}
+
+bool MicCapture_ReadWindow(MicCaptureReader* r, int16_t* out, uint32_t window, uint32_t hop,
+                           uint32_t timeout_ms)
+{
+    if (!s_running || !r || !out || window == 0 || hop == 0) return false;
+    // One block may be in the middle of being rewritten by the producer
+    if (window > s_ring_samples - s_cfg.block_samples) return false;
+
+    TickType_t deadline = xTaskGetTickCount() + pdMS_TO_TICKS(timeout_ms);
+
+    for (;;) {
+        uint32_t produced = atomic_load_explicit(&s_produced, memory_order_acquire);
+        uint32_t oldest = produced - (s_ring_samples - s_cfg.block_samples);
+
+        // Lapped: the window start is no longer in the ring, skip to the newest data
+        if ((int32_t)(r->pos - oldest) < 0) {
+            uint32_t skip_to = produced - window;
+            r->overruns++;
+            r->lost_samples += skip_to - r->pos;
+            r->pos = skip_to;
+        }
+
+        if ((int32_t)(produced - (r->pos + window)) >= 0) {
+            copy_out(out, r->pos, window);
+
+            // The producer may have lapped us during the copy
+            uint32_t after = atomic_load_explicit(&s_produced, memory_order_acquire);
+            if ((int32_t)(r->pos - (after - (s_ring_samples - s_cfg.block_samples))) < 0) continue;
+
+            r->pos += hop;
+            return true;
+        }
+
+        TickType_t now = xTaskGetTickCount();
+        if (timeout_ms == 0 || (int32_t)(deadline - now) <= 0) return false;
+        xEventGroupWaitBits(s_evt, EVT_BLOCK, pdTRUE, pdFALSE, deadline - now);
+    }
+}
+
+void MicCapture_GetStats(MicCaptureStats* out)
+{
+    if (!out) return;
+
+    int64_t now = esp_timer_get_time();
+    uint64_t busy = s_busy_us;
+    uint64_t wall = (uint64_t)(now - s_load_t0);
+
+    s_stats.dma_overruns = s_dma_overruns;
+    s_stats.cpu_permille = wall ? (uint32_t)((busy - s_load_busy0) * 1000u / wall) : 0;
+    s_load_t0 = now;
+    s_load_busy0 = busy;
+
+    *out = s_stats;
+}
@@ -0,0 +1,75 @@
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+#include "core/exp_arena.h"
+
+// Continuous INMP441 capture (I2S0, mono left, 32-bit words).
+//
+// A capture task drains the I2S DMA queue block by block into a ring of
+// fixed int16 blocks, so no audio is lost between UI ticks. The ring never
+// blocks the producer: a reader that falls more than a ring behind loses the
+// oldest samples and has the loss counted.
+//
+// Latency vs. overhead: the DMA queue holds dma_desc_num x dma_frame_num
+// samples and raises one interrupt per descriptor. Small frames mean low
+// latency and many interrupts; large frames the opposite. block_samples
+// sets how much the task moves per wakeup.
+//
+// Blocks hold DC-free int16 at sample_rate / decimate (dsp/mic_convert.h),
+// converted by the capture task straight from the DMA words.
+//
+// Wiring: WS -> GPIO4, SCK -> GPIO5, SD -> GPIO6, LR -> GND (left).
+
+#define MIC_CAPTURE_MAX_BLOCKS 64
+
+typedef struct {
+    uint32_t sample_rate;
+    uint16_t dma_desc_num;      // I2S DMA descriptors (2..)
+    uint16_t dma_frame_num;     // samples per descriptor, one interrupt each
+    uint16_t block_samples;     // samples per ring block / per task wakeup
+    uint16_t block_count;       // ring depth in blocks, power of two
+    uint8_t priority;           // capture task
+    uint8_t decimate;           // 1, 2 or 4; block_samples counts output samples
+} MicCaptureConfig;
+
+// 16 ms of DMA buffering, 16 ms blocks, 256 ms of ring
+#define MIC_CAPTURE_DEFAULT_CONFIG() {  \
+    .sample_rate = 16000,               \
+    .dma_desc_num = 4,                  \
+    .dma_frame_num = 64,                \
+    .block_samples = 256,               \
+    .block_count = 16,                  \
+    .priority = 14,                     \
+    .decimate = 1,                      \
+}
+
+typedef struct {
+    uint32_t blocks;            // written into the ring
+    uint32_t dma_overruns;      // I2S RX queue overflows: samples lost before the task ran
+    uint32_t read_errors;
+    uint32_t cpu_permille;      // capture task busy time over wall time, since the last call
+    uint32_t dma_latency_us;    // dma_desc_num x dma_frame_num at sample_rate
+} MicCaptureStats;
+
+// One per analysis consumer. Windows overlap when hop < window.
+typedef struct {
+    uint32_t pos;               // absolute index of the next window's first sample
+    uint32_t overruns;          // times this reader was lapped and skipped ahead
+    uint32_t lost_samples;
+} MicCaptureReader;
+
+// Ring and scratch come from the arena, so call from start()
+bool MicCapture_Start(const MicCaptureConfig* cfg, ExpArena* arena);
+void MicCapture_Stop(void);
+bool MicCapture_IsRunning(void);
+uint32_t MicCapture_SampleRate(void);     // of the ring, after decimation
+
+// Starts at the newest complete block
+void MicCapture_ReaderInit(MicCaptureReader* r);
+
+// Copies `window` samples starting at the reader position and advances it
+// by `hop`. Waits up to timeout_ms for the samples; false if not there yet.
+bool MicCapture_ReadWindow(MicCaptureReader* r, int16_t* out, uint32_t window, uint32_t hop,
+                           uint32_t timeout_ms);
+
+void MicCapture_GetStats(MicCaptureStats* out);
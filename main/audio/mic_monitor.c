@@ -0,0 +1,365 @@
+#include "audio/mic_monitor.h"
+#include "audio/mic_capture.h"
+#include "audio/audio_out.h"
+
+#include <stdatomic.h>
+#include <string.h>
+
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "evtrace.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/event_groups.h"
+
+static const char* TAG = "MIC_MON";
+
+#define MON_MIC_RING_SAMPLES    1024        // capture ring, 64 ms at 16 kHz
+#define MON_READ_TIMEOUT_MS     50
+#define MON_STOP_TIMEOUT_MS     (MON_READ_TIMEOUT_MS * 3)
+#define MON_PING_CLICK          32          // samples of square wave, 2 ms at 16 kHz
+#define MON_PING_HALF_PERIOD    4           // 2 kHz at 16 kHz
+#define MON_PING_AMPL           8000
+#define MON_PING_MIN_LEVEL      600         // the mic must hear at least this...
+#define MON_PING_NOISE_MULT     8           // ...and this many times the recent peak
+#define MON_PING_TIMEOUT_DIV    4           // give up after a quarter second
+
+#define EVT_EXITED              (1u << 0)
+
+typedef enum {
+    kPingIdle = 0,
+    kPingSend,
+    kPingWait,
+} PingState;
+
+static const int16_t kSilence[MIC_MONITOR_MAX_BLOCK / 2];
+
+static MicMonitorConfig s_cfg;
+static bool s_running = false;
+static volatile bool s_run = false;
+static EventGroupHandle_t s_evt = NULL;
+static TaskHandle_t s_task = NULL;
+
+// From the arena
+static int16_t* s_buf;
+static uint8_t* s_ring;
+static uint32_t s_ring_bytes;
+
+// Monitor task only
+static MicCaptureReader s_reader;
+static AudioFx s_fx;
+static AudioVoice s_voice = -1;
+static int s_gain_db;
+static AudioFxPreset s_preset;
+static PingState s_ping;
+static uint32_t s_ping_src;         // mic index of the input the click replaced
+static int32_t s_ping_thr;
+static int32_t s_noise;             // decaying input peak
+
+// Requests from the app task
+static atomic_int s_gain_req;
+static atomic_int s_preset_req;
+static atomic_bool s_ping_req;
+static atomic_int s_peak;
+
+// Written by the monitor task, windowed by GetStats
+static MicMonitorStats s_stats;
+static uint64_t s_lat_sum;
+static uint32_t s_lat_n;
+static uint64_t s_lat_sum0;
+static uint32_t s_lat_n0;
+static uint64_t s_busy_us;
+static uint64_t s_load_busy0;
+static int64_t s_load_t0;
+
+static uint32_t pow2_at_least(uint32_t v)
+{
+    uint32_t p = 1;
+    while (p < v) p <<= 1;
+    return p;
+}
+
+static uint32_t samples_to_us(uint64_t samples)
+{
+    return (uint32_t)(samples * 1000000u / s_cfg.sample_rate);
+}
+
+static int32_t block_peak(const int16_t* x, uint32_t n)
+{
+    int32_t peak = 0;
+    for (uint32_t i = 0; i < n; i++) {
+        int32_t a = x[i] < 0 ? -(int32_t)x[i] : x[i];
+        if (a > peak) peak = a;
+    }
+    return peak;
+}
+
+// Looks for the click in the raw input. `start` is the mic index of x[0].
+static void ping_listen(const int16_t* x, uint32_t n, uint32_t start)
+{
+    for (uint32_t i = 0; i < n; i++) {
+        int32_t a = x[i] < 0 ? -(int32_t)x[i] : x[i];
+        if (a < s_ping_thr) continue;
+        s_stats.ping_us = samples_to_us(start + i - s_ping_src);
+        s_ping = kPingIdle;
+        ESP_LOGI(TAG, "ping %lu us", (unsigned long)s_stats.ping_us);
+        return;
+    }
+    if (start + n - s_ping_src > s_cfg.sample_rate / MON_PING_TIMEOUT_DIV) {
+        s_stats.ping_fails++;
+        s_ping = kPingIdle;
+        ESP_LOGW(TAG, "ping not heard (threshold %ld)", (long)s_ping_thr);
+    }
+}
+
+// Replaces the block with the click, or silence while listening for it
+static void ping_output(int16_t* out, uint32_t n)
+{
+    memset(out, 0, n * sizeof(int16_t));
+    if (s_ping != kPingSend) return;
+    for (uint32_t i = 0; i < MON_PING_CLICK && i < n; i++) {
+        out[i] = ((i / MON_PING_HALF_PERIOD) & 1) ? -MON_PING_AMPL : MON_PING_AMPL;
+    }
+    s_ping = kPingWait;
+}
+
+static void apply_requests(uint32_t start)
+{
+    int gain = atomic_load(&s_gain_req);
+    if (gain != s_gain_db) {
+        s_gain_db = gain;
+        AudioFx_SetGainDb(&s_fx, gain);
+    }
+    AudioFxPreset preset = (AudioFxPreset)atomic_load(&s_preset_req);
+    if (preset != s_preset) {
+        s_preset = preset;
+        AudioFx_SetPreset(&s_fx, preset);
+    }
+    if (s_ping == kPingIdle && atomic_exchange(&s_ping_req, false)) {
+        int32_t thr = s_noise * MON_PING_NOISE_MULT;
+        s_ping_thr = thr > MON_PING_MIN_LEVEL ? thr : MON_PING_MIN_LEVEL;
+        s_ping_src = start;
+        s_ping = kPingSend;
+    }
+}
+
+// Queues one processed block, or drops it when the queue is already deep
+static void queue_block(const int16_t* x, uint32_t n)
+{
+    const uint32_t ring_samples = s_ring_bytes / sizeof(int16_t);
+
+    if (s_voice < 0) {
+        // First block: open the voice primed with half a block of silence,
+        // so the writer's first pull does not find it empty
+        s_voice = AudioOut_StreamOpen(s_cfg.sample_rate, AUDIO_OUT_GAIN_UNITY, s_ring, s_ring_bytes);
+        if (s_voice < 0) return;
+        AudioOut_StreamWrite(s_voice, kSilence, n / 2);
+    }
+
+    uint32_t queued = ring_samples - AudioOut_StreamFree(s_voice);
+    if (queued >= (uint32_t)s_cfg.queue_blocks * n) {
+        s_stats.resyncs++;
+        return;
+    }
+    queued += AudioOut_StreamWrite(s_voice, x, n);
+
+    // The oldest sample of this block: everything queued up to it, its own
+    // wait in the mic descriptor, and the output side at its fullest
+    uint32_t est = queued + ((uint32_t)s_cfg.out_dma_desc + 1u) * n;
+    s_lat_sum += est;
+    s_lat_n++;
+    uint32_t est_us = samples_to_us(est);
+    if (est_us > s_stats.latency_max_us) s_stats.latency_max_us = est_us;
+}
+
+static void monitor_task(void* arg)
+{
+    (void)arg;
+    EVTRACE_TASK("mic_monitor");
+
+    const uint32_t n = s_cfg.block_samples;
+
+    while (s_run) {
+        // Woken by the capture task once per block
+        if (!MicCapture_ReadWindow(&s_reader, s_buf, n, n, MON_READ_TIMEOUT_MS)) continue;
+
+        int64_t t0 = esp_timer_get_time();
+        uint32_t start = s_reader.pos - n;
+        s_stats.blocks++;
+
+        int32_t peak = block_peak(s_buf, n);
+        if (peak > atomic_load(&s_peak)) atomic_store(&s_peak, peak);
+        s_noise = peak > s_noise ? peak : s_noise - (s_noise >> 3);
+
+        if (s_ping == kPingWait) ping_listen(s_buf, n, start);
+        apply_requests(start);
+
+        if (s_ping != kPingIdle) {
+            ping_output(s_buf, n);
+        } else {
+            int64_t f0 = esp_timer_get_time();
+            s_stats.clipped_samples += AudioFx_Process(&s_fx, s_buf, (int)n);
+            uint32_t fx_us = (uint32_t)(esp_timer_get_time() - f0);
+            if (fx_us > s_stats.fx_us_max) s_stats.fx_us_max = fx_us;
+        }
+
+        queue_block(s_buf, n);
+        s_busy_us += (uint64_t)(esp_timer_get_time() - t0);
+    }
+
+    if (s_voice >= 0) AudioOut_Stop(s_voice);
+    s_voice = -1;
+    s_task = NULL;
+    xEventGroupSetBits(s_evt, EVT_EXITED);
+    vTaskDelete(NULL);
+}
+
+bool MicMonitor_Start(const MicMonitorConfig* cfg, ExpArena* arena)
+{
+    if (s_running || !cfg || !arena) return false;
+    uint32_t n = cfg->block_samples;
+    if (n < MIC_MONITOR_MIN_BLOCK || n > MIC_MONITOR_MAX_BLOCK || (n & (n - 1)) || cfg->out_dma_desc < 2 ||
+        cfg->in_dma_desc < 2 || cfg->queue_blocks == 0 || cfg->sample_rate == 0) {
+        ESP_LOGE(TAG, "bad config");
+        return false;
+    }
+    s_cfg = *cfg;
+
+    // Room for the resync threshold plus the block being written
+    s_ring_bytes = pow2_at_least(((uint32_t)s_cfg.queue_blocks + 1u) * n * sizeof(int16_t));
+    s_ring = (uint8_t*)ExpArena_Alloc(arena, kExpArenaNormal, s_ring_bytes);
+    s_buf = (int16_t*)ExpArena_Alloc(arena, kExpArenaNormal, n * sizeof(int16_t));
+    int16_t* delay = (int16_t*)ExpArena_Alloc(arena, kExpArenaNormal, AudioFx_DelayBytes(s_cfg.sample_rate));
+    if (!s_ring || !s_buf || !delay) return false;
+
+    if (!s_evt) s_evt = xEventGroupCreate();
+    if (!s_evt) return false;
+    xEventGroupClearBits(s_evt, EVT_EXITED);
+
+    MicCaptureConfig mc = MIC_CAPTURE_DEFAULT_CONFIG();
+    mc.sample_rate = s_cfg.sample_rate;
+    mc.dma_desc_num = s_cfg.in_dma_desc;
+    mc.dma_frame_num = (uint16_t)n;
+    mc.block_samples = (uint16_t)n;
+    mc.block_count = (uint16_t)(MON_MIC_RING_SAMPLES / n);
+    if (!MicCapture_Start(&mc, arena)) return false;
+
+    AudioOutConfig oc = AUDIO_OUT_DEFAULT_CONFIG();
+    oc.sample_rate = s_cfg.sample_rate;
+    oc.block_samples = (uint16_t)n;
+    oc.dma_desc_num = s_cfg.out_dma_desc;
+    oc.dma_frame_num = (uint16_t)n;
+    if (!AudioOut_Open(&oc)) {
+        MicCapture_Stop();
+        return false;
+    }
+
+    AudioFx_Init(&s_fx, s_cfg.sample_rate, delay);
+    s_gain_db = 0;
+    s_preset = kAudioFxClean;
+    atomic_store(&s_gain_req, 0);
+    atomic_store(&s_preset_req, (int)kAudioFxClean);
+    atomic_store(&s_ping_req, false);
+    atomic_store(&s_peak, 0);
+    s_ping = kPingIdle;
+    s_noise = 0;
+    s_voice = -1;
+
+    memset(&s_stats, 0, sizeof(s_stats));
+    s_lat_sum = 0;
+    s_lat_n = 0;
+    s_lat_sum0 = 0;
+    s_lat_n0 = 0;
+    s_busy_us = 0;
+    s_load_busy0 = 0;
+    s_load_t0 = esp_timer_get_time();
+
+    MicCapture_ReaderInit(&s_reader);
+    s_run = true;
+    if (xTaskCreate(monitor_task, "mic_monitor", 3072, NULL, s_cfg.priority, &s_task) != pdPASS) {
+        s_task = NULL;
+        s_run = false;
+        AudioOut_Close();
+        MicCapture_Stop();
+        return false;
+    }
+    s_running = true;
+
+    ESP_LOGI(TAG, "block %u (%lu us), mic dma %u, spk dma %u, stream ring %lu B", (unsigned)n,
+             (unsigned long)samples_to_us(n), (unsigned)s_cfg.in_dma_desc, (unsigned)s_cfg.out_dma_desc,
+             (unsigned long)s_ring_bytes);
+    return true;
+}
+
+void MicMonitor_Stop(void)
+{
+    if (!s_running) return;
+
+    s_run = false;
+    // The task notices within one read timeout and fades its voice out
+    xEventGroupWaitBits(s_evt, EVT_EXITED, pdTRUE, pdTRUE, pdMS_TO_TICKS(MON_STOP_TIMEOUT_MS));
+    AudioOut_Close();
+    MicCapture_Stop();
+
+    s_running = false;
+    s_ring = NULL;
+    s_buf = NULL;
+}
+
+bool MicMonitor_IsRunning(void)
+{
+    return s_running;
+}
+
+void MicMonitor_SetGainDb(int gain_db)
+{
+    if (gain_db < AUDIO_FX_GAIN_DB_MIN) gain_db = AUDIO_FX_GAIN_DB_MIN;
+    if (gain_db > AUDIO_FX_GAIN_DB_MAX) gain_db = AUDIO_FX_GAIN_DB_MAX;
+    atomic_store(&s_gain_req, gain_db);
+}
+
+void MicMonitor_SetPreset(AudioFxPreset preset)
+{
+    if (preset < 0 || preset >= kAudioFxCount) return;
+    atomic_store(&s_preset_req, (int)preset);
+}
+
+void MicMonitor_Ping(void)
+{
+    if (s_running) atomic_store(&s_ping_req, true);
+}
+
+bool MicMonitor_IsPinging(void)
+{
+    return s_running && (s_ping != kPingIdle || atomic_load(&s_ping_req));
+}
+
+void MicMonitor_GetStats(MicMonitorStats* out)
+{
+    if (!out) return;
+    *out = s_stats;
+
+    uint64_t lat_sum = s_lat_sum;
+    uint32_t lat_n = s_lat_n;
+    out->latency_us = lat_n != s_lat_n0 ? samples_to_us((lat_sum - s_lat_sum0) / (lat_n - s_lat_n0)) : 0;
+    s_lat_sum0 = lat_sum;
+    s_lat_n0 = lat_n;
+    out->peak = (int16_t)atomic_exchange(&s_peak, 0);
+
+    MicCaptureStats mc;
+    AudioOutStats ao;
+    MicCapture_GetStats(&mc);
+    AudioOut_GetStats(&ao);
+    out->mic_overruns = mc.dma_overruns;
+    out->lapped = s_reader.overruns;
+    out->underruns = ao.underruns;
+    out->starved_blocks = ao.starved_blocks;
+    out->glitches = out->mic_overruns + out->lapped + out->resyncs + out->underruns + out->starved_blocks;
+
+    int64_t now = esp_timer_get_time();
+    uint64_t wall = (uint64_t)(now - s_load_t0);
+    uint64_t busy = s_busy_us - s_load_busy0;
+    out->cpu_permille = (wall ? (uint32_t)(busy * 1000u / wall) : 0) + mc.cpu_permille + ao.cpu_permille;
+    s_load_t0 = now;
+    s_load_busy0 = s_busy_us;
+}
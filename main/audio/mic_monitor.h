@@ -0,0 +1,81 @@
+#pragma once
+#include <stdbool.h>
+#include <stdint.h>
+#include "core/exp_arena.h"
+#include "dsp/audio_fx.h"
+
+// Live mic -> speaker path (full duplex: I2S0 in, I2S1 out).
+//
+// A monitor task wakes on every captured block (audio/mic_capture.h, one
+// I2S descriptor per block), runs it through the effect chain
+// (dsp/audio_fx.h) and queues it on a stream voice of the output engine
+// (audio/audio_out.h), which is opened with the same block size.
+//
+// End-to-end latency of the oldest sample in a block is one block in the
+// mic descriptor, whatever is queued ahead of it in the stream, and up to
+// (out_dma_desc + 1) blocks on the output side: the DMA ring plus the block
+// the writer has mixed and holds while it waits for a descriptor. At
+// 16 kHz with 32-sample blocks, half a block queued and two output
+// descriptors that is at most 2 + 1 + 6 = 9 ms; 16-sample blocks halve it.
+// The queue starts half a block deep; if it grows past queue_blocks (the
+// two I2S clocks drift, or the writer stalled) a whole block is dropped to
+// pull the latency back, and counted.
+//
+// Two latency figures come out: an estimate from the buffer occupancy
+// measured after every block, and MicMonitor_Ping(), which plays a click
+// instead of the mic and times how long until the mic hears it. The
+// ping is counted in mic samples, so it includes the I2S and acoustic
+// path but not any timing jitter of the tasks.
+
+#define MIC_MONITOR_MIN_BLOCK   16
+#define MIC_MONITOR_MAX_BLOCK   128
+
+typedef struct {
+    uint32_t sample_rate;
+    uint16_t block_samples;     // power of two, MIN..MAX_BLOCK: capture, effects and mixing
+    uint8_t in_dma_desc;        // mic descriptors of block_samples each
+    uint8_t out_dma_desc;       // speaker descriptors of block_samples each (2..)
+    uint8_t queue_blocks;       // stream backlog that triggers a resync
+    uint8_t priority;           // between capture (14) and the output writer (12)
+} MicMonitorConfig;
+
+#define MIC_MONITOR_DEFAULT_CONFIG(block) {     \
+    .sample_rate = 16000,                       \
+    .block_samples = (block),                   \
+    .in_dma_desc = 4,                           \
+    .out_dma_desc = 2,                          \
+    .queue_blocks = 2,                          \
+    .priority = 13,                             \
+}
+
+typedef struct {
+    uint32_t blocks;
+    uint32_t latency_us;        // estimate, average since the last call
+    uint32_t latency_max_us;    // estimate, since Start
+    uint32_t ping_us;           // last click measurement, 0: none yet
+    uint32_t ping_fails;        // clicks the mic never heard
+    uint32_t glitches;          // every event below
+    uint32_t mic_overruns;      // I2S RX queue overflows
+    uint32_t lapped;            // monitor task fell a ring behind the capture
+    uint32_t resyncs;           // blocks dropped because the queue grew too deep
+    uint32_t underruns;         // I2S TX descriptors sent empty
+    uint32_t starved_blocks;    // output blocks mixed with the queue empty
+    uint32_t clipped_samples;   // by the effect chain
+    uint32_t fx_us_max;         // slowest block through the effect chain
+    uint32_t cpu_permille;      // capture + monitor + output mixing, since the last call
+    int16_t peak;               // input, since the last call
+} MicMonitorStats;
+
+// Buffers come from the arena, so call from start(). Opens the mic and the
+// output engine; on failure everything is closed again.
+bool MicMonitor_Start(const MicMonitorConfig* cfg, ExpArena* arena);
+void MicMonitor_Stop(void);
+bool MicMonitor_IsRunning(void);
+
+// Applied by the monitor task at the next block
+void MicMonitor_SetGainDb(int gain_db);
+void MicMonitor_SetPreset(AudioFxPreset preset);
+void MicMonitor_Ping(void);
+bool MicMonitor_IsPinging(void);
+
+void MicMonitor_GetStats(MicMonitorStats* out);
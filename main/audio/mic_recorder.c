@@ -0,0 +1,422 @@
+#include "audio/mic_recorder.h"
+#include "audio/mic_capture.h"
+#include "audio/audio_out.h"
+#include "dsp/ima_adpcm.h"
+
+#include <fcntl.h>
+#include <stdatomic.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "esp_log.h"
+#include "esp_spiffs.h"
+#include "esp_timer.h"
+#include "evtrace.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include "freertos/event_groups.h"
+
+static const char* TAG = "MIC_REC";
+
+#define REC_PARTITION       "spiffs"
+#define REC_BUF_BYTES       4096        // per flash buffer, 16 blocks (~0.5 s at 16 kHz)
+#define REC_WRITER_PRIO     4           // below the UI and capture, above idle
+#define REC_PLAYER_PRIO     6
+#define REC_STOP_TIMEOUT_MS 5000        // worst case SPIFFS GC on the last buffer; logged, then wait on
+#define REC_PLAY_GAIN_SHIFT 2           // INMP441 speech sits around -40 dBFS
+#define REC_PLAY_POLL_MS    10          // while the output ring is full
+
+#define EVT_WRITER_EXITED   (1u << 0)
+#define EVT_PLAYER_EXITED   (1u << 1)
+
+typedef struct {
+    uint8_t idx;
+    uint16_t len;               // 0: end of recording
+} RecChunk;
+
+static bool s_ready = false;
+static volatile MicRecStorage s_storage = kMicRecStorageNone;
+static EventGroupHandle_t s_evt = NULL;
+static QueueHandle_t s_queue = NULL;
+
+// Recording (s_buf / s_pcm from the arena)
+static uint8_t* s_buf[2];
+static atomic_bool s_busy[2];           // queued to / being written by the writer
+static int s_cur = -1;                  // buffer being filled, -1 for none
+static uint32_t s_fill;
+static int16_t* s_pcm;
+static ImaAdpcmState s_enc;
+static MicCaptureReader s_reader;
+static TaskHandle_t s_writer = NULL;
+static bool s_recording = false;
+static int64_t s_t0_us;
+static MicRecStats s_stats;
+
+// Written by the writer task only
+static volatile uint32_t s_write_us;
+static volatile uint32_t s_write_max_us;
+static volatile uint32_t s_limit_bytes;  // 0 until the partition is mounted
+static volatile bool s_write_error;
+
+// Playback
+static TaskHandle_t s_player = NULL;
+static volatile bool s_play_stop = false;
+static volatile bool s_playing = false;
+
+// Formatting the partition the first time takes far longer than a stop may
+// wait, so it happens once, up front, in its own task rather than in the
+// writer; Start and PlayStart refuse until it is done.
+static void mount_task(void* arg)
+{
+    (void)arg;
+    esp_vfs_spiffs_conf_t conf = {
+        .base_path = MIC_REC_BASE_PATH,
+        .partition_label = REC_PARTITION,
+        .max_files = 2,
+        .format_if_mount_failed = true,
+    };
+    int64_t t0 = esp_timer_get_time();
+    esp_err_t err = esp_vfs_spiffs_register(&conf);
+    if (err != ESP_OK && err != ESP_ERR_INVALID_STATE) {
+        ESP_LOGE(TAG, "mount failed: %s", esp_err_to_name(err));
+        s_storage = kMicRecStorageFailed;
+    } else {
+        ESP_LOGI(TAG, "%s mounted in %lu ms", MIC_REC_BASE_PATH,
+                 (unsigned long)((esp_timer_get_time() - t0) / 1000));
+        s_storage = kMicRecStorageReady;
+    }
+    vTaskDelete(NULL);
+}
+
+// Waits as long as it takes: the task still uses s_buf[] until it exits
+static void wait_exit(EventBits_t bit, const char* what)
+{
+    while (!(xEventGroupWaitBits(s_evt, bit, pdTRUE, pdTRUE, pdMS_TO_TICKS(REC_STOP_TIMEOUT_MS)) & bit)) {
+        ESP_LOGW(TAG, "%s still busy, waiting", what);
+    }
+}
+
+// Blocks encoded while a write is slow wait in the two buffers
+static void writer_task(void* arg)
+{
+    (void)arg;
+    EVTRACE_TASK("mic_rec");
+
+    int fd = open(MIC_REC_FILE, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        ESP_LOGE(TAG, "cannot open %s", MIC_REC_FILE);
+        s_write_error = true;
+    } else {
+        size_t total = 0;
+        size_t used = 0;
+        // SPIFFS slows down badly when nearly full: leave it 1/8 spare
+        if (esp_spiffs_info(REC_PARTITION, &total, &used) == ESP_OK && total > used) {
+            s_limit_bytes = (uint32_t)((total - used) / 8 * 7);
+        }
+    }
+
+    for (;;) {
+        RecChunk c;
+        if (xQueueReceive(s_queue, &c, portMAX_DELAY) != pdTRUE) continue;
+        if (c.len == 0) break;
+
+        if (fd >= 0) {
+            int64_t t0 = esp_timer_get_time();
+            EVTRACE_BEGIN_V(kEvtFlashWrite, c.len);
+            ssize_t w = write(fd, s_buf[c.idx], c.len);
+            EVTRACE_END(kEvtFlashWrite);
+            uint32_t dt = (uint32_t)(esp_timer_get_time() - t0);
+            s_write_us += dt;
+            if (dt > s_write_max_us) s_write_max_us = dt;
+            if (w != (ssize_t)c.len) {
+                ESP_LOGE(TAG, "write failed at %u bytes", (unsigned)c.len);
+                s_write_error = true;
+                close(fd);
+                fd = -1;
+            }
+        }
+        atomic_store(&s_busy[c.idx], false);
+    }
+
+    if (fd >= 0) close(fd);
+    s_writer = NULL;
+    xEventGroupSetBits(s_evt, EVT_WRITER_EXITED);
+    vTaskDelete(NULL);
+}
+
+bool MicRec_Init(ExpArena* arena)
+{
+    if (!arena) return false;
+    if (!s_evt) s_evt = xEventGroupCreate();
+    if (!s_queue) s_queue = xQueueCreate(3, sizeof(RecChunk));   // both buffers + end marker
+    s_buf[0] = (uint8_t*)ExpArena_Alloc(arena, kExpArenaNormal, REC_BUF_BYTES);
+    s_buf[1] = (uint8_t*)ExpArena_Alloc(arena, kExpArenaNormal, REC_BUF_BYTES);
+    s_pcm = (int16_t*)ExpArena_Alloc(arena, kExpArenaNormal, IMA_ADPCM_BLOCK_SAMPLES * sizeof(int16_t));
+    s_ready = s_evt && s_queue && s_buf[0] && s_buf[1] && s_pcm;
+    if (!s_ready) {
+        ESP_LOGE(TAG, "no memory");
+        return false;
+    }
+
+    // Once per boot; a failed mount is retried on the next Init
+    if (s_storage == kMicRecStorageNone || s_storage == kMicRecStorageFailed) {
+        s_storage = kMicRecStorageMounting;
+        if (xTaskCreate(mount_task, "mic_mount", 4096, NULL, REC_WRITER_PRIO, NULL) != pdPASS) {
+            s_storage = kMicRecStorageFailed;
+        }
+    }
+    return true;
+}
+
+MicRecStorage MicRec_GetStorage(void)
+{
+    return s_storage;
+}
+
+void MicRec_Deinit(void)
+{
+    MicRec_Stop();
+    MicRec_PlayStop();
+    s_ready = false;
+    s_buf[0] = s_buf[1] = NULL;
+    s_pcm = NULL;
+}
+
+static void submit(void)
+{
+    RecChunk c = {.idx = (uint8_t)s_cur, .len = (uint16_t)s_fill};
+    atomic_store(&s_busy[s_cur], true);
+    xQueueSend(s_queue, &c, 0);      // never full: one slot per buffer plus the end marker
+    s_stats.bytes += s_fill;
+    s_cur = -1;
+    s_fill = 0;
+}
+
+static bool claim_buffer(void)
+{
+    for (int i = 0; i < 2; i++) {
+        if (!atomic_load(&s_busy[i])) {
+            s_cur = i;
+            s_fill = 0;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool MicRec_Start(void)
+{
+    if (!s_ready || s_recording || s_playing || !MicCapture_IsRunning()) return false;
+    if (s_storage != kMicRecStorageReady || s_writer) return false;
+
+    memset(&s_stats, 0, sizeof(s_stats));
+    s_write_us = 0;
+    s_write_max_us = 0;
+    s_limit_bytes = 0;
+    s_write_error = false;
+    atomic_store(&s_busy[0], false);
+    atomic_store(&s_busy[1], false);
+    xQueueReset(s_queue);
+    xEventGroupClearBits(s_evt, EVT_WRITER_EXITED);
+
+    ImaAdpcm_Init(&s_enc);
+    claim_buffer();
+    MicRecFileHeader h = {
+        .magic = {'I', 'M', 'A', '1'},
+        .sample_rate = MicCapture_SampleRate(),
+        .block_bytes = IMA_ADPCM_BLOCK_BYTES,
+        .block_samples = IMA_ADPCM_BLOCK_SAMPLES,
+    };
+    memcpy(s_buf[s_cur], &h, sizeof(h));
+    s_fill = sizeof(h);
+
+    if (xTaskCreate(writer_task, "mic_rec", 4096, NULL, REC_WRITER_PRIO, &s_writer) != pdPASS) {
+        s_writer = NULL;
+        s_cur = -1;
+        return false;
+    }
+    MicCapture_ReaderInit(&s_reader);
+    s_t0_us = esp_timer_get_time();
+    s_recording = true;
+    ESP_LOGI(TAG, "recording to %s at %lu Hz", MIC_REC_FILE, (unsigned long)h.sample_rate);
+    return true;
+}
+
+static void log_stats(void)
+{
+    const MicRecStats* s = &s_stats;
+    uint32_t pcm_bytes = s->samples * 2;
+    uint32_t ratio_x100 = s->bytes ? (uint32_t)((uint64_t)pcm_bytes * 100 / s->bytes) : 0;
+    uint32_t enc_permille = s->elapsed_ms ? (uint32_t)((uint64_t)s->encode_us / s->elapsed_ms) : 0;
+    uint32_t enc_per_block = s->blocks ? s->encode_us / s->blocks : 0;
+    uint32_t flash_kbps = s->write_us ? (uint32_t)((uint64_t)s->bytes * 1000000 / 1024 / s->write_us) : 0;
+    uint32_t avg_bps = s->elapsed_ms ? (uint32_t)((uint64_t)s->bytes * 1000 / s->elapsed_ms) : 0;
+
+    ESP_LOGI(TAG, "%lu ms, %lu samples -> %lu bytes (%lu.%02lu:1)%s%s", (unsigned long)s->elapsed_ms,
+             (unsigned long)s->samples, (unsigned long)s->bytes, (unsigned long)(ratio_x100 / 100),
+             (unsigned long)(ratio_x100 % 100), s->full ? ", partition full" : "", s->error ? ", write error" : "");
+    ESP_LOGI(TAG, "encode %lu us/block cpu=%lu.%lu%%, flash %lu B/s avg, write %lu KB/s max %lu us",
+             (unsigned long)enc_per_block, (unsigned long)(enc_permille / 10), (unsigned long)(enc_permille % 10),
+             (unsigned long)avg_bps, (unsigned long)flash_kbps, (unsigned long)s->write_max_us);
+    ESP_LOGI(TAG, "dropped %lu blocks, lapped %lu samples", (unsigned long)s->dropped_blocks,
+             (unsigned long)s->lost_samples);
+}
+
+void MicRec_Stop(void)
+{
+    if (!s_recording) return;
+    s_recording = false;
+
+    if (s_cur >= 0 && s_fill > 0) submit();
+    RecChunk end = {.idx = 0, .len = 0};
+    xQueueSend(s_queue, &end, portMAX_DELAY);
+    wait_exit(EVT_WRITER_EXITED, "writer");
+    s_cur = -1;
+
+    s_stats.elapsed_ms = (uint32_t)((esp_timer_get_time() - s_t0_us) / 1000);
+    s_stats.write_us = s_write_us;
+    s_stats.write_max_us = s_write_max_us;
+    s_stats.lost_samples = s_reader.lost_samples;
+    s_stats.error = s_stats.error || s_write_error;
+    log_stats();
+}
+
+bool MicRec_IsRecording(void)
+{
+    return s_recording;
+}
+
+void MicRec_Poll(void)
+{
+    if (!s_recording) return;
+
+    if (s_write_error || (s_limit_bytes && s_stats.bytes + s_fill + IMA_ADPCM_BLOCK_BYTES > s_limit_bytes)) {
+        if (!s_write_error) s_stats.full = true;
+        MicRec_Stop();
+        return;
+    }
+
+    while (MicCapture_ReadWindow(&s_reader, s_pcm, IMA_ADPCM_BLOCK_SAMPLES, IMA_ADPCM_BLOCK_SAMPLES, 0)) {
+        if (s_cur < 0 && !claim_buffer()) {
+            s_stats.dropped_blocks++;
+            continue;
+        }
+
+        int64_t t0 = esp_timer_get_time();
+        ImaAdpcm_EncodeBlock(&s_enc, s_pcm, s_buf[s_cur] + s_fill);
+        s_stats.encode_us += (uint32_t)(esp_timer_get_time() - t0);
+
+        s_fill += IMA_ADPCM_BLOCK_BYTES;
+        s_stats.blocks++;
+        s_stats.samples += IMA_ADPCM_BLOCK_SAMPLES;
+        if (s_fill + IMA_ADPCM_BLOCK_BYTES > REC_BUF_BYTES) submit();
+    }
+}
+
+void MicRec_GetStats(MicRecStats* out)
+{
+    *out = s_stats;
+    if (s_recording) {
+        out->elapsed_ms = (uint32_t)((esp_timer_get_time() - s_t0_us) / 1000);
+        out->write_us = s_write_us;
+        out->write_max_us = s_write_max_us;
+        out->lost_samples = s_reader.lost_samples;
+    }
+}
+
+// -------------------- Playback --------------------
+
+// Queues all of pcm into the voice, waiting while its ring is full
+static bool stream_out(AudioVoice voice, const int16_t* pcm, uint32_t n)
+{
+    while (n > 0 && !s_play_stop) {
+        uint32_t k = AudioOut_StreamWrite(voice, pcm, n);
+        if (k == 0) {
+            if (!AudioOut_IsActive(voice)) return false;
+            vTaskDelay(pdMS_TO_TICKS(REC_PLAY_POLL_MS));
+        }
+        pcm += k;
+        n -= k;
+    }
+    return n == 0;
+}
+
+// Decodes into an output engine stream voice; the first flash buffer (idle
+// while not recording) is the voice's ring.
+static void player_task(void* arg)
+{
+    (void)arg;
+    EVTRACE_TASK("mic_play");
+
+    uint8_t block[IMA_ADPCM_BLOCK_BYTES];
+    int16_t pcm[IMA_ADPCM_BLOCK_SAMPLES];
+    MicRecFileHeader h;
+    uint32_t blocks = 0;
+    AudioVoice voice = -1;
+
+    int fd = open(MIC_REC_FILE, O_RDONLY);
+    if (fd < 0) {
+        ESP_LOGW(TAG, "nothing recorded yet");
+    } else if (read(fd, &h, sizeof(h)) != (ssize_t)sizeof(h) || memcmp(h.magic, MIC_REC_MAGIC, 4) != 0 ||
+               h.block_bytes != IMA_ADPCM_BLOCK_BYTES || h.block_samples != IMA_ADPCM_BLOCK_SAMPLES) {
+        ESP_LOGE(TAG, "bad header in %s", MIC_REC_FILE);
+    } else if (AudioOut_Open(NULL)) {
+        voice = AudioOut_StreamOpen(h.sample_rate, AUDIO_OUT_GAIN_UNITY, s_buf[0], REC_BUF_BYTES);
+        while (voice >= 0 && !s_play_stop && read(fd, block, sizeof(block)) == (ssize_t)sizeof(block)) {
+            ImaAdpcm_DecodeBlock(block, pcm);
+            for (int i = 0; i < IMA_ADPCM_BLOCK_SAMPLES; i++) {
+                int32_t v = (int32_t)pcm[i] << REC_PLAY_GAIN_SHIFT;
+                if (v > 32767) v = 32767;
+                if (v < -32768) v = -32768;
+                pcm[i] = (int16_t)v;
+            }
+            if (!stream_out(voice, pcm, IMA_ADPCM_BLOCK_SAMPLES)) break;
+            blocks++;
+        }
+        // Let the queued tail play out, or fade it when stopped
+        if (s_play_stop) AudioOut_Stop(voice);
+        else AudioOut_StreamEnd(voice);
+        while (AudioOut_IsActive(voice)) {
+            if (s_play_stop) AudioOut_Stop(voice);
+            vTaskDelay(pdMS_TO_TICKS(REC_PLAY_POLL_MS));
+        }
+        AudioOut_Close();
+        ESP_LOGI(TAG, "played %lu blocks", (unsigned long)blocks);
+    }
+    if (fd >= 0) close(fd);
+
+    s_player = NULL;
+    s_playing = false;
+    xEventGroupSetBits(s_evt, EVT_PLAYER_EXITED);
+    vTaskDelete(NULL);
+}
+
+bool MicRec_PlayStart(void)
+{
+    if (!s_ready || s_recording || s_playing || s_storage != kMicRecStorageReady) return false;
+
+    s_play_stop = false;
+    s_playing = true;
+    xEventGroupClearBits(s_evt, EVT_PLAYER_EXITED);
+    if (xTaskCreate(player_task, "mic_play", 4096, NULL, REC_PLAYER_PRIO, &s_player) != pdPASS) {
+        s_player = NULL;
+        s_playing = false;
+        return false;
+    }
+    return true;
+}
+
+void MicRec_PlayStop(void)
+{
+    if (!s_playing) return;
+    s_play_stop = true;
+    // Usually one block (~32 ms) of I2S backlog plus a flash read; the
+    // player streams from s_buf[0], so it must be gone before Deinit
+    wait_exit(EVT_PLAYER_EXITED, "player");
+}
+
+bool MicRec_IsPlaying(void)
+{
+    return s_playing;
+}
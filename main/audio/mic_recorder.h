@@ -0,0 +1,68 @@
+#pragma once
+#include <stdbool.h>
+#include <stdint.h>
+#include "core/exp_arena.h"
+
+// Mic recording to flash, IMA-ADPCM compressed (dsp/ima_adpcm.h).
+//
+// MicRec_Poll() runs from the owner's tick: it drains its own capture reader
+// in 505-sample blocks and encodes them into one of two flash buffers. A
+// full buffer is handed to a writer task, so a slow flash write (sector
+// erase, SPIFFS GC) never stalls the tick or the capture task. If both
+// buffers are still queued the block is dropped and counted.
+//
+// The file on the spiffs partition (mounted at MIC_REC_BASE_PATH) is a
+// 16-byte MicRecFileHeader followed by 256-byte ADPCM blocks, written
+// strictly sequentially. host/adpcm_decode.c turns it into a WAV.
+
+#define MIC_REC_BASE_PATH   "/rec"
+#define MIC_REC_FILE        MIC_REC_BASE_PATH "/mic.ima"
+#define MIC_REC_MAGIC       "IMA1"
+
+typedef struct {
+    char magic[4];              // MIC_REC_MAGIC
+    uint32_t sample_rate;       // little endian, like everything below
+    uint16_t block_bytes;
+    uint16_t block_samples;
+    uint32_t reserved;
+} MicRecFileHeader;
+
+typedef struct {
+    uint32_t samples;           // encoded
+    uint32_t bytes;             // handed to the writer, header included
+    uint32_t blocks;
+    uint32_t dropped_blocks;    // both flash buffers busy
+    uint32_t lost_samples;      // capture reader lapped
+    uint32_t encode_us;         // total, in MicRec_Poll
+    uint32_t write_us;          // total, in the writer task
+    uint32_t write_max_us;      // slowest single buffer write
+    uint32_t elapsed_ms;
+    bool full;                  // stopped at the end of the partition
+    bool error;                 // mount / open / write failed
+} MicRecStats;
+
+typedef enum {
+    kMicRecStorageNone = 0,
+    kMicRecStorageMounting,     // first use formats the partition: seconds
+    kMicRecStorageReady,
+    kMicRecStorageFailed,
+} MicRecStorage;
+
+// Buffers come from the arena, so call from start(), after MicCapture_Start.
+// The first call also mounts the partition from a task of its own; Start and
+// PlayStart refuse until MicRec_GetStorage() says ready.
+bool MicRec_Init(ExpArena* arena);
+// Stops recording and playback (waiting for both tasks), forgets the buffers
+void MicRec_Deinit(void);
+MicRecStorage MicRec_GetStorage(void);
+
+bool MicRec_Start(void);
+void MicRec_Stop(void);                 // flushes and waits for the writer to exit
+bool MicRec_IsRecording(void);
+void MicRec_Poll(void);
+void MicRec_GetStats(MicRecStats* out);
+
+// Plays MIC_REC_FILE through the speaker (a stream voice of audio/audio_out.h)
+bool MicRec_PlayStart(void);
+void MicRec_PlayStop(void);
+bool MicRec_IsPlaying(void);
@@ -0,0 +1,108 @@
+#include "audio/spk_i2s.h"
+
+#include "driver/i2s_std.h"
+#include "esp_attr.h"
+#include "esp_log.h"
+#include "evtrace.h"
+#include "freertos/FreeRTOS.h"
+
+static const char* TAG = "SPK_I2S";
+
+#define SPK_I2S_PORT     I2S_NUM_1
+#define SPK_BITS         I2S_DATA_BIT_WIDTH_16BIT
+#define SPK_DIN_GPIO     7
+#define SPK_BCLK_GPIO    15
+#define SPK_LRCLK_GPIO   16
+
+static i2s_chan_handle_t s_tx_chan = NULL;
+static volatile uint32_t s_underruns;
+
+// The DMA finished a descriptor nobody refilled: it goes out as silence
+static IRAM_ATTR bool on_send_q_ovf(i2s_chan_handle_t handle, i2s_event_data_t* event, void* user_ctx)
+{
+    (void)handle;
+    (void)event;
+    (void)user_ctx;
+    s_underruns++;
+    return false;
+}
+
+bool SpkI2s_Open(const SpkI2sConfig* cfg)
+{
+    if (s_tx_chan) return true;
+    if (!cfg || cfg->dma_desc_num < 2 || cfg->dma_frame_num == 0) return false;
+
+    i2s_chan_config_t chan_cfg = I2S_CHANNEL_DEFAULT_CONFIG(SPK_I2S_PORT, I2S_ROLE_MASTER);
+    chan_cfg.dma_desc_num = cfg->dma_desc_num;
+    chan_cfg.dma_frame_num = cfg->dma_frame_num;
+    chan_cfg.auto_clear = true;
+    if (i2s_new_channel(&chan_cfg, &s_tx_chan, NULL) != ESP_OK) {
+        s_tx_chan = NULL;
+        ESP_LOGE(TAG, "no channel");
+        return false;
+    }
+
+    i2s_std_config_t std_cfg = {
+        .clk_cfg = I2S_STD_CLK_DEFAULT_CONFIG(cfg->sample_rate),
+        .slot_cfg = I2S_STD_MSB_SLOT_DEFAULT_CONFIG(SPK_BITS, I2S_SLOT_MODE_MONO),
+        .gpio_cfg = {
+            .mclk = I2S_GPIO_UNUSED,
+            .bclk = SPK_BCLK_GPIO,
+            .ws = SPK_LRCLK_GPIO,
+            .dout = SPK_DIN_GPIO,
+            .din = I2S_GPIO_UNUSED,
+            .invert_flags = {
+                .mclk_inv = false,
+                .bclk_inv = false,
+                .ws_inv = false,
+            },
+        },
+    };
+    std_cfg.slot_cfg.slot_mask = I2S_STD_SLOT_LEFT;
+
+    i2s_event_callbacks_t cbs = {
+        .on_send_q_ovf = on_send_q_ovf,
+    };
+
+    s_underruns = 0;
+    if (i2s_channel_init_std_mode(s_tx_chan, &std_cfg) != ESP_OK ||
+        i2s_channel_register_event_callback(s_tx_chan, &cbs, NULL) != ESP_OK ||
+        i2s_channel_enable(s_tx_chan) != ESP_OK) {
+        i2s_del_channel(s_tx_chan);
+        s_tx_chan = NULL;
+        ESP_LOGE(TAG, "init failed");
+        return false;
+    }
+    return true;
+}
+
+void SpkI2s_Close(void)
+{
+    if (!s_tx_chan) return;
+    i2s_channel_disable(s_tx_chan);
+    i2s_del_channel(s_tx_chan);
+    s_tx_chan = NULL;
+}
+
+bool SpkI2s_IsOpen(void)
+{
+    return s_tx_chan != NULL;
+}
+
+size_t SpkI2s_Write(const int16_t* samples, size_t count, uint32_t timeout_ms)
+{
+    if (!s_tx_chan || !samples || count == 0) return 0;
+
+    size_t written = 0;
+    EVTRACE_BEGIN_V(kEvtI2sWrite, count * sizeof(int16_t));
+    esp_err_t r = i2s_channel_write(s_tx_chan, samples, count * sizeof(int16_t), &written,
+                                    timeout_ms == UINT32_MAX ? portMAX_DELAY : pdMS_TO_TICKS(timeout_ms));
+    EVTRACE_END(kEvtI2sWrite);
+    if (r != ESP_OK && r != ESP_ERR_TIMEOUT) return 0;
+    return written / sizeof(int16_t);
+}
+
+uint32_t SpkI2s_Underruns(void)
+{
+    return s_underruns;
+}
@@ -0,0 +1,36 @@
+#pragma once
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// MAX98357 on I2S1, 16-bit mono (left slot).
+//
+// The DMA ring is dma_desc_num x dma_frame_num samples; a write blocks until
+// a descriptor frees up, so it also paces the writer. When the ring runs dry
+// the driver sends silence (auto_clear) and counts an underrun.
+//
+// Wiring: DIN -> GPIO7, BCLK -> GPIO15, LRCLK -> GPIO16.
+
+typedef struct {
+    uint32_t sample_rate;
+    uint16_t dma_desc_num;      // 2..
+    uint16_t dma_frame_num;     // samples per descriptor
+} SpkI2sConfig;
+
+// 6 x 240 samples: 90 ms at 16 kHz, the driver default
+#define SPK_I2S_DEFAULT_CONFIG(rate) {  \
+    .sample_rate = (rate),              \
+    .dma_desc_num = 6,                  \
+    .dma_frame_num = 240,               \
+}
+
+bool SpkI2s_Open(const SpkI2sConfig* cfg);
+void SpkI2s_Close(void);
+bool SpkI2s_IsOpen(void);
+
+// Blocks until the samples are queued for DMA or timeout_ms passes.
+// Returns the number of samples queued.
+size_t SpkI2s_Write(const int16_t* samples, size_t count, uint32_t timeout_ms);
+
+// Descriptors the DMA had to send without fresh data, since Open
+uint32_t SpkI2s_Underruns(void);
@@ -1,6 +1,11 @@
 #include "core/app.h"
 #include "core/app_state.h"
 #include "core/app_events.h"
+#include "core/exp_arena.h"
+#include "core/boot_timeline.h"
+#include "mem_track.h"
+#include "evtrace.h"
+#include "dlog.h"
 
 #include "ui/ui.h"
 #include "input/input.h"
@@ -24,11 +29,22 @@ void App_Run(void)
     AppState st;
     AppState_Init(&st);
 
+    EvTrace_Init();
+    Dlog_Init();
+    EVTRACE_TASK("app_main");
+
+    // Panel bring-up runs in its own task while the rest initializes
     Ui_Init();
+    BootTimeline_Mark("panel_init_started");
+
     Input_Init();
     DrvInputGpioKeys_Init();
+    BootTimeline_Mark("input_ready");
 
-    ExperimentContext ctx = (ExperimentContext){0};
+    static ExperimentContext ctx;
+    ExpArena_Init(&ctx.arena);
+
+    Ui_WaitReady(UINT32_MAX);
 
     st.page = kPageMainMenu;
     st.main_index = 0;
@@ -36,6 +52,9 @@ void App_Run(void)
     st.desc_scroll = 0;
 
     Ui_DrawMainMenu(st.main_index, Experiments_Count());
+    BootTimeline_Mark("first_menu_frame");
+    BootTimeline_Log();
+    MemTrack_Log();
 
     TickType_t last_gpio_poll = xTaskGetTickCount();
 
@@ -46,16 +65,30 @@ void App_Run(void)
             DrvInputGpioKeys_Poll();
         }
 
+        // Idle ticks come from the poll timeout, so it sets the tick rate
+        uint32_t poll_ms = APP_TICK_MS;
+        if (st.page == kPageExperimentRun || st.page == kPageMazeRun) {
+            const Experiment* exp = Experiments_GetById(st.selected_exp_id);
+            if (exp && exp->tick_ms) poll_ms = exp->tick_ms;
+        }
+
         AppEvent ev;
-        if (!AppEvents_Poll(&ev, 50)) {
+        if (!AppEvents_Poll(&ev, poll_ms)) {
             if (st.page == kPageExperimentRun || st.page == kPageMazeRun) {
                 const Experiment* exp = Experiments_GetById(st.selected_exp_id);
-                if (exp && exp->tick) exp->tick(&ctx);
+                if (exp && exp->tick) {
+                    EVTRACE_BEGIN_V(kEvtAppTick, exp->id);
+                    exp->tick(&ctx);
+                    EVTRACE_END(kEvtAppTick);
+                }
             }
             vTaskDelay(pdMS_TO_TICKS(1));
             continue;
         }
 
+        // Dispatch span covers the page handler below (early exits end it too)
+        EVTRACE_BEGIN_V(kEvtAppKey, ev.key);
+
         // -----------------------------
         // Main menu
         // -----------------------------
@@ -77,6 +110,7 @@ void App_Run(void)
                     st.desc_scroll = 0;
                     st.page = kPageExperimentMenu; // description page
 
+                    ExpArena_Acquire(&ctx.arena);
                     if (exp->on_enter) exp->on_enter(&ctx);
 
                     Ui_DrawExperimentMenu(exp->title, exp, st.desc_scroll);
@@ -92,6 +126,7 @@ void App_Run(void)
             if (!exp) {
                 st.page = kPageMainMenu;
                 Ui_DrawMainMenu(st.main_index, Experiments_Count());
+                EVTRACE_END(kEvtAppKey);
                 vTaskDelay(pdMS_TO_TICKS(1));
                 continue;
             }
@@ -107,6 +142,8 @@ void App_Run(void)
             }
             else if (ev.key == kInputBack) {
                 if (exp->on_exit) exp->on_exit(&ctx);
+                ExpArena_ReleaseAll(&ctx.arena);
+                ExpArena_RecordPeak(&ctx.arena, exp->id, exp->title);
                 st.page = kPageMainMenu;
                 Ui_DrawMainMenu(st.main_index, Experiments_Count());
             }
@@ -115,10 +152,12 @@ void App_Run(void)
                 if (exp->id == 12) {   // TODO: replace with your real maze id
                     st.page = kPageMazeRun;
                     Ui_DrawMazeFullScreen();
+                    ExpArena_MarkRun(&ctx.arena);
                     if (exp->start) exp->start(&ctx);
                 } else {
                     st.page = kPageExperimentRun;
                     Ui_DrawExperimentRun(exp->title);
+                    ExpArena_MarkRun(&ctx.arena);
                     if (exp->start) exp->start(&ctx);
                 }
             }
@@ -132,12 +171,14 @@ void App_Run(void)
             if (!exp) {
                 st.page = kPageMainMenu;
                 Ui_DrawMainMenu(st.main_index, Experiments_Count());
+                EVTRACE_END(kEvtAppKey);
                 vTaskDelay(pdMS_TO_TICKS(1));
                 continue;
             }
 
             if (ev.key == kInputBack) {
                 if (exp->stop) exp->stop(&ctx);
+                ExpArena_ReleaseRun(&ctx.arena);
                 st.page = kPageExperimentMenu;
                 Ui_DrawExperimentMenu(exp->title, exp, st.desc_scroll);
             } else {
@@ -153,12 +194,14 @@ void App_Run(void)
             if (!exp) {
                 st.page = kPageMainMenu;
                 Ui_DrawMainMenu(st.main_index, Experiments_Count());
+                EVTRACE_END(kEvtAppKey);
                 vTaskDelay(pdMS_TO_TICKS(1));
                 continue;
             }
 
             if (ev.key == kInputBack) {
                 if (exp->stop) exp->stop(&ctx);
+                ExpArena_ReleaseRun(&ctx.arena);
                 st.page = kPageExperimentMenu;
                 Ui_DrawExperimentMenu(exp->title, exp, st.desc_scroll);
             } else {
@@ -166,6 +209,7 @@ void App_Run(void)
             }
         }
 
+        EVTRACE_END(kEvtAppKey);
         vTaskDelay(pdMS_TO_TICKS(1));
     }
 }
\ No newline at end of file
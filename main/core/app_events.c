@@ -1,12 +1,17 @@
 #include "core/app_events.h"
+#include "core/input_replay.h"
 #include "input/input.h"
 
 bool AppEvents_Poll(AppEvent* out_event, uint32_t timeout_ms)
 {
+    InputReplay_OnPoll();
+
     InputKey key = kInputNone;
     if (!Input_Poll(&key, timeout_ms)) {
         return false;
     }
-    out_event->key = key;
+    out_event->key = (InputKey)(key & ~INPUT_KEY_REPLAYED);
+    out_event->replayed = (key & INPUT_KEY_REPLAYED) != 0;
+    InputReplay_OnEvent(out_event);
     return true;
 }
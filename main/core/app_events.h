@@ -10,8 +10,13 @@ typedef enum {
     kInputBack
 } InputKey;
 
+// Or'ed into the queued key by the input replayer so its keys can be told
+// from real presses; AppEvents_Poll() moves it into AppEvent.replayed.
+#define INPUT_KEY_REPLAYED 0x80
+
 typedef struct {
     InputKey key;
+    bool replayed;
 } AppEvent;
 
 bool AppEvents_Poll(AppEvent* out_event, uint32_t timeout_ms);
@@ -0,0 +1,55 @@
+#include "core/boot_timeline.h"
+
+#include <string.h>
+
+#include "esp_log.h"
+#include "esp_timer.h"
+
+static const char* TAG = "BOOT";
+
+typedef struct {
+    const char* phase;
+    uint32_t ms;
+} BootPhase;
+
+static BootPhase s_phases[BOOT_TIMELINE_MAX_PHASES];
+static int s_count = 0;
+
+void BootTimeline_Mark(const char* phase)
+{
+    // esp_timer starts counting right after the bootloader hands over
+    uint32_t ms = (uint32_t)(esp_timer_get_time() / 1000ULL);
+
+    int idx = __atomic_fetch_add(&s_count, 1, __ATOMIC_RELAXED);
+    if (idx >= BOOT_TIMELINE_MAX_PHASES) return;
+
+    s_phases[idx].ms = ms;
+    __atomic_store_n(&s_phases[idx].phase, phase, __ATOMIC_RELEASE);
+}
+
+uint32_t BootTimeline_GetMs(const char* phase)
+{
+    int n = s_count;
+    if (n > BOOT_TIMELINE_MAX_PHASES) n = BOOT_TIMELINE_MAX_PHASES;
+    for (int i = 0; i < n; i++) {
+        const char* p = __atomic_load_n(&s_phases[i].phase, __ATOMIC_ACQUIRE);
+        if (p && strcmp(p, phase) == 0) return s_phases[i].ms;
+    }
+    return 0;
+}
+
+void BootTimeline_Log(void)
+{
+    int n = s_count;
+    if (n > BOOT_TIMELINE_MAX_PHASES) n = BOOT_TIMELINE_MAX_PHASES;
+
+    ESP_LOGI(TAG, "boot timeline (ms since reset):");
+    uint32_t prev = 0;
+    for (int i = 0; i < n; i++) {
+        const char* p = __atomic_load_n(&s_phases[i].phase, __ATOMIC_ACQUIRE);
+        if (!p) continue;
+        ESP_LOGI(TAG, "  %6lu  +%4lu  %s", (unsigned long)s_phases[i].ms,
+                 (unsigned long)(s_phases[i].ms - prev), p);
+        prev = s_phases[i].ms;
+    }
+}
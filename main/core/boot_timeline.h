@@ -0,0 +1,11 @@
+#pragma once
+#include <stdint.h>
+
+// Boot phase timeline: ms since reset for each named phase.
+// Safe to call from any task during startup; logged once by BootTimeline_Log().
+
+#define BOOT_TIMELINE_MAX_PHASES 16
+
+void BootTimeline_Mark(const char* phase);
+uint32_t BootTimeline_GetMs(const char* phase);
+void BootTimeline_Log(void);
@@ -0,0 +1,15 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+// CRC helpers shared by the UART protocols.
+//   Crc16: CRC-16/CCITT-FALSE (poly 0x1021, init 0xFFFF, no reflection)
+//   Crc32: CRC-32 as used by zlib/Ethernet (reflected 0xEDB88320)
+// Both can be chained: pass the previous result as crc, start with the
+// CRC16_INIT / CRC32_INIT value.
+
+#define CRC16_INIT 0xFFFFu
+#define CRC32_INIT 0u
+
+uint16_t Crc16_Update(uint16_t crc, const uint8_t* data, size_t len);
+uint32_t Crc32_Update(uint32_t crc, const uint8_t* data, size_t len);
@@ -0,0 +1,180 @@
+#include "core/exp_arena.h"
+
+#include <string.h>
+
+#include "esp_heap_caps.h"
+#include "esp_log.h"
+#include "mem_track.h"
+
+static const char* TAG = "EXP_ARENA";
+
+typedef struct {
+    const char* title;
+    uint32_t peak[kExpArenaRegionCount];
+} ExpArenaPeak;
+
+static ExpArenaPeak s_peaks[EXP_ARENA_MAX_EXP_ID];
+
+static size_t align_up(size_t v)
+{
+    return (v + (EXP_ARENA_ALIGN - 1)) & ~(size_t)(EXP_ARENA_ALIGN - 1);
+}
+
+static const size_t k_pool_cap[kExpArenaRegionCount] = {
+    [kExpArenaNormal] = EXP_ARENA_NORMAL_BYTES,
+};
+
+static const uint32_t k_pool_caps[kExpArenaRegionCount] = {
+    [kExpArenaNormal] = MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT,
+};
+
+void ExpArena_Init(ExpArena* a)
+{
+    if (!a) return;
+    memset(a, 0, sizeof(*a));
+}
+
+bool ExpArena_Acquire(ExpArena* a)
+{
+    if (!a) return false;
+
+    bool ok = true;
+    for (int r = 0; r < kExpArenaRegionCount; r++) {
+        ExpArenaPool* p = &a->pool[r];
+        p->used = 0;
+        a->run_mark[r] = 0;
+        if (p->base) continue;
+
+        p->base = (uint8_t*)MemTrack_AlignedAlloc(kMemTagArena, EXP_ARENA_ALIGN,
+                                                  k_pool_cap[r], k_pool_caps[r]);
+        p->cap = p->base ? k_pool_cap[r] : 0;
+        if (!p->base) {
+            // Experiments see NULL from ExpArena_Alloc() and show NO MEMORY
+            ESP_LOGE(TAG, "acquire region=%d %u failed", r, (unsigned)k_pool_cap[r]);
+            ok = false;
+        }
+    }
+    return ok;
+}
+
+void* ExpArena_Alloc(ExpArena* a, ExpArenaRegion region, size_t bytes)
+{
+    if (!a || region < 0 || region >= kExpArenaRegionCount) return NULL;
+
+    ExpArenaPool* p = &a->pool[region];
+    size_t need = align_up(bytes);
+    if (!p->base || need == 0 || need > p->cap - p->used) {
+        a->fail_count++;
+        ESP_LOGE(TAG, "alloc %u failed (region=%d used=%u cap=%u)",
+                 (unsigned)bytes, (int)region, (unsigned)p->used, (unsigned)p->cap);
+        return NULL;
+    }
+
+    void* out = p->base + p->used;
+    p->used += need;
+    if (p->used > p->peak) p->peak = p->used;
+
+    memset(out, 0, need);
+    return out;
+}
+
+ExpArenaMark ExpArena_Mark(const ExpArena* a)
+{
+    ExpArenaMark m;
+    memset(&m, 0, sizeof(m));
+    if (!a) return m;
+    for (int r = 0; r < kExpArenaRegionCount; r++) {
+        m.used[r] = a->pool[r].used;
+    }
+    return m;
+}
+
+void ExpArena_Release(ExpArena* a, ExpArenaMark mark)
+{
+    if (!a) return;
+    for (int r = 0; r < kExpArenaRegionCount; r++) {
+        // Never below the run mark, and never forward
+        size_t to = mark.used[r];
+        if (to < a->run_mark[r]) to = a->run_mark[r];
+        if (to < a->pool[r].used) a->pool[r].used = to;
+    }
+}
+
+void ExpArena_MarkRun(ExpArena* a)
+{
+    if (!a) return;
+    for (int r = 0; r < kExpArenaRegionCount; r++) {
+        a->run_mark[r] = a->pool[r].used;
+    }
+}
+
+void ExpArena_ReleaseRun(ExpArena* a)
+{
+    if (!a) return;
+    for (int r = 0; r < kExpArenaRegionCount; r++) {
+        a->pool[r].used = a->run_mark[r];
+    }
+}
+
+void ExpArena_ReleaseAll(ExpArena* a)
+{
+    if (!a) return;
+    for (int r = 0; r < kExpArenaRegionCount; r++) {
+        ExpArenaPool* p = &a->pool[r];
+        MemTrack_Free(p->base);
+        p->base = NULL;
+        p->cap = 0;
+        p->used = 0;
+        a->run_mark[r] = 0;
+    }
+}
+
+size_t ExpArena_Used(const ExpArena* a, ExpArenaRegion region)
+{
+    if (!a || region < 0 || region >= kExpArenaRegionCount) return 0;
+    return a->pool[region].used;
+}
+
+size_t ExpArena_Peak(const ExpArena* a, ExpArenaRegion region)
+{
+    if (!a || region < 0 || region >= kExpArenaRegionCount) return 0;
+    return a->pool[region].peak;
+}
+
+void ExpArena_RecordPeak(ExpArena* a, int exp_id, const char* title)
+{
+    if (!a) return;
+
+    if (exp_id >= 0 && exp_id < EXP_ARENA_MAX_EXP_ID) {
+        ExpArenaPeak* e = &s_peaks[exp_id];
+        e->title = title;
+        for (int r = 0; r < kExpArenaRegionCount; r++) {
+            if (a->pool[r].peak > e->peak[r]) e->peak[r] = (uint32_t)a->pool[r].peak;
+        }
+    }
+
+    ESP_LOGI(TAG, "%s peak normal=%u/%u",
+             title ? title : "?",
+             (unsigned)a->pool[kExpArenaNormal].peak, (unsigned)EXP_ARENA_NORMAL_BYTES);
+
+    // Peak is per visit; the table above keeps the max over the session
+    for (int r = 0; r < kExpArenaRegionCount; r++) a->pool[r].peak = 0;
+
+    ExpArena_LogPeaks();
+}
+
+void ExpArena_LogPeaks(void)
+{
+    uint32_t max_normal = 0;
+
+    for (int i = 0; i < EXP_ARENA_MAX_EXP_ID; i++) {
+        const ExpArenaPeak* e = &s_peaks[i];
+        if (!e->title) continue;
+        ESP_LOGI(TAG, "  id=%2d %-10s normal=%5u", i, e->title,
+                 (unsigned)e->peak[kExpArenaNormal]);
+        if (e->peak[kExpArenaNormal] > max_normal) max_normal = e->peak[kExpArenaNormal];
+    }
+
+    ESP_LOGI(TAG, "largest need normal=%u (sized %u)",
+             (unsigned)max_normal, (unsigned)EXP_ARENA_NORMAL_BYTES);
+}
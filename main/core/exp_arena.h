@@ -0,0 +1,70 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+// Per-experiment scratch memory (bump allocator).
+// Only one experiment runs at a time, so working buffers live here instead of
+// static .bss: RAM cost is the largest single experiment, not the sum.
+//
+// Lifetime:
+//   - the pool is taken from the heap when an experiment is entered and
+//     returned after on_exit(), so the main menu holds none of it
+//   - allocations made in start()    are released after stop()
+//   - allocations made in on_enter() are released after on_exit()
+// app.c owns those two; an experiment that rebuilds its buffers mid-run takes
+// an ExpArena_Mark() and rolls back with ExpArena_Release().
+// Memory returned by ExpArena_Alloc() is zeroed and 16-byte aligned.
+//
+// DMA buffers (LCD lines, I2S descriptors) stay with their drivers.
+
+// Sized from the ExpArena_LogPeaks() "largest need" line, default config:
+//   MIC 22544 (capture 8192+1024, recorder 2x4096+1024, window/FFT 4112)
+//   MONITOR ~13K, UART ~5.6K, DSP ~2.7K, others < 2K
+#define EXP_ARENA_NORMAL_BYTES  (23 * 1024)
+#define EXP_ARENA_ALIGN         16
+#define EXP_ARENA_MAX_EXP_ID    32
+
+typedef enum {
+    kExpArenaNormal = 0,    // internal RAM
+    kExpArenaRegionCount
+} ExpArenaRegion;
+
+typedef struct {
+    uint8_t* base;
+    size_t cap;
+    size_t used;
+    size_t peak;
+} ExpArenaPool;
+
+typedef struct {
+    ExpArenaPool pool[kExpArenaRegionCount];
+    size_t run_mark[kExpArenaRegionCount];
+    uint32_t fail_count;
+} ExpArena;
+
+typedef struct {
+    size_t used[kExpArenaRegionCount];
+} ExpArenaMark;
+
+void ExpArena_Init(ExpArena* a);
+
+bool ExpArena_Acquire(ExpArena* a);     // before on_enter()
+
+void* ExpArena_Alloc(ExpArena* a, ExpArenaRegion region, size_t bytes);
+
+// Nested scopes inside a run: everything allocated after the mark is dropped
+ExpArenaMark ExpArena_Mark(const ExpArena* a);
+void ExpArena_Release(ExpArena* a, ExpArenaMark mark);
+
+// Run lifecycle, called by app.c only
+void ExpArena_MarkRun(ExpArena* a);     // before start()
+void ExpArena_ReleaseRun(ExpArena* a);  // after stop()
+void ExpArena_ReleaseAll(ExpArena* a);  // after on_exit(), frees the pool
+
+size_t ExpArena_Used(const ExpArena* a, ExpArenaRegion region);
+size_t ExpArena_Peak(const ExpArena* a, ExpArenaRegion region);
+
+// Peak bookkeeping per experiment id (logged on on_exit)
+void ExpArena_RecordPeak(ExpArena* a, int exp_id, const char* title);
+void ExpArena_LogPeaks(void);
@@ -0,0 +1,17 @@
+#pragma once
+
+// HOT_PATH marks the inner loops that run per pixel, per sample or per
+// received byte. With CONFIG_APP_HOT_IN_IRAM (perf profile, see
+// sdkconfig.perf) they are linked into IRAM so they do not compete with the
+// rest of the app for the flash cache. Expands to nothing on the host.
+
+#if defined(ESP_PLATFORM)
+#include "sdkconfig.h"
+#endif
+
+#if defined(ESP_PLATFORM) && CONFIG_APP_HOT_IN_IRAM
+#include "esp_attr.h"
+#define HOT_PATH IRAM_ATTR
+#else
+#define HOT_PATH
+#endif
@@ -0,0 +1,370 @@
+#include "core/input_replay.h"
+#include "core/lat_stats.h"
+#include "input/uart1_router.h"
+#include "display/st7735.h"
+#include "mem_track.h"
+
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "esp_heap_caps.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "nvs.h"
+#include "nvs_flash.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+static const char* TAG = "REPLAY";
+
+#define REPLAY_NVS_NS       "replay"
+#define REPLAY_NVS_KEY      "journey"
+#define REPLAY_MAGIC        0x59504C52u    // "RLPY"
+#define REPLAY_VERSION      1
+#define REPLAY_KEY_TIMEOUT  2000            // ms to wait for the app to dispatch one key
+
+typedef struct {
+    uint32_t t_ms;          // since the recording started
+    uint8_t key;            // InputKey
+    uint8_t pad[3];
+} ReplayEvent;
+
+typedef struct {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t count;
+    ReplayEvent ev[INPUT_REPLAY_MAX_EVENTS];
+} ReplayJourney;
+
+// Heap, only while recording or replaying: idle holds just the saved totals
+static ReplayJourney* s_journey = NULL;
+static uint32_t* s_lat_mem = NULL;      // samples, then percentile scratch
+static uint32_t s_saved_count = 0;
+static uint32_t s_saved_ms = 0;
+static bool s_loaded = false;
+
+static volatile InputReplayState s_state = kReplayIdle;
+static int64_t s_rec_t0;
+
+static TaskHandle_t s_task = NULL;
+static InputReplayMode s_mode;
+static volatile bool s_abort = false;
+
+// Fast mode handshake: the replay task bumps s_injected before queueing a key,
+// the app loop bumps s_consumed when it receives one tagged INPUT_KEY_REPLAYED.
+// Real presses during a replay are dispatched but not counted. The loop coming
+// back to poll with s_consumed caught up means the last key has been handled.
+static atomic_uint s_injected;
+static atomic_uint s_consumed;
+
+static LatStats s_lat;
+
+static InputReplayResult s_result;
+static bool s_have_result = false;
+
+// -------------------- storage --------------------
+
+static bool nvs_ready(void)
+{
+    static bool s_inited = false;
+    if (s_inited) return true;
+
+    esp_err_t err = nvs_flash_init();
+    if (err == ESP_ERR_NVS_NO_FREE_PAGES || err == ESP_ERR_NVS_NEW_VERSION_FOUND) {
+        nvs_flash_erase();
+        err = nvs_flash_init();
+    }
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "nvs init failed: %s", esp_err_to_name(err));
+        return false;
+    }
+    s_inited = true;
+    return true;
+}
+
+static size_t journey_bytes(uint32_t count)
+{
+    return offsetof(ReplayJourney, ev) + count * sizeof(ReplayEvent);
+}
+
+static void buffers_free(void)
+{
+    MemTrack_Free(s_journey);
+    MemTrack_Free(s_lat_mem);
+    s_journey = NULL;
+    s_lat_mem = NULL;
+}
+
+static bool journey_alloc(void)
+{
+    if (!s_journey) {
+        s_journey = (ReplayJourney*)MemTrack_Malloc(kMemTagInput, sizeof(ReplayJourney),
+                                                    MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    }
+    if (!s_journey) ESP_LOGE(TAG, "no memory for the journey");
+    return s_journey != NULL;
+}
+
+static void note_saved(const ReplayJourney* j)
+{
+    s_saved_count = j->count;
+    s_saved_ms = j->count ? j->ev[j->count - 1].t_ms : 0;
+    s_loaded = true;
+}
+
+// Reads the saved journey into j (count 0 if there is none)
+static void load_journey(ReplayJourney* j)
+{
+    j->count = 0;
+
+    nvs_handle_t h;
+    if (!nvs_ready() || nvs_open(REPLAY_NVS_NS, NVS_READONLY, &h) != ESP_OK) {
+        note_saved(j);
+        return;
+    }
+
+    size_t len = sizeof(*j);
+    esp_err_t err = nvs_get_blob(h, REPLAY_NVS_KEY, j, &len);
+    nvs_close(h);
+
+    if (err != ESP_OK || j->magic != REPLAY_MAGIC || j->version != REPLAY_VERSION ||
+        j->count > INPUT_REPLAY_MAX_EVENTS || len != journey_bytes(j->count)) {
+        if (err != ESP_ERR_NVS_NOT_FOUND) ESP_LOGW(TAG, "saved journey ignored (%s)", esp_err_to_name(err));
+        j->count = 0;
+    } else {
+        ESP_LOGI(TAG, "loaded journey: %u events", (unsigned)j->count);
+    }
+    note_saved(j);
+}
+
+// Totals for the UI without keeping the journey around
+static void load_saved_info(void)
+{
+    if (s_loaded || !journey_alloc()) return;
+    load_journey(s_journey);
+    buffers_free();
+}
+
+static bool save_journey(const ReplayJourney* j)
+{
+    nvs_handle_t h;
+    if (!nvs_ready()) return false;
+
+    esp_err_t err = nvs_open(REPLAY_NVS_NS, NVS_READWRITE, &h);
+    if (err == ESP_OK) {
+        err = nvs_set_blob(h, REPLAY_NVS_KEY, j, journey_bytes(j->count));
+        if (err == ESP_OK) err = nvs_commit(h);
+        nvs_close(h);
+    }
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "save failed: %s", esp_err_to_name(err));
+        return false;
+    }
+    return true;
+}
+
+// -------------------- app loop hooks --------------------
+
+void InputReplay_OnPoll(void)
+{
+    if (s_state != kReplayPlaying || !s_task) return;
+    if (atomic_load(&s_consumed) >= atomic_load(&s_injected)) xTaskNotifyGive(s_task);
+}
+
+void InputReplay_OnEvent(const AppEvent* ev)
+{
+    if (s_state == kReplayPlaying) {
+        if (ev->replayed) atomic_fetch_add(&s_consumed, 1u);
+        return;
+    }
+    if (s_state != kReplayRecording) return;
+
+    if (s_journey->count >= INPUT_REPLAY_MAX_EVENTS) {
+        ESP_LOGW(TAG, "journey full, recording stopped");
+        InputReplay_StopRecording();
+        return;
+    }
+
+    ReplayEvent* e = &s_journey->ev[s_journey->count++];
+    e->t_ms = (uint32_t)((esp_timer_get_time() - s_rec_t0) / 1000);
+    e->key = (uint8_t)ev->key;
+}
+
+// -------------------- recording --------------------
+
+InputReplayState InputReplay_GetState(void)
+{
+    return s_state;
+}
+
+bool InputReplay_StartRecording(void)
+{
+    if (s_state != kReplayIdle || !journey_alloc()) return false;
+
+    s_journey->magic = REPLAY_MAGIC;
+    s_journey->version = REPLAY_VERSION;
+    s_journey->count = 0;
+    s_rec_t0 = esp_timer_get_time();
+    s_state = kReplayRecording;
+    ESP_LOGI(TAG, "recording");
+    return true;
+}
+
+bool InputReplay_StopRecording(void)
+{
+    if (s_state != kReplayRecording) return false;
+    s_state = kReplayIdle;
+
+    note_saved(s_journey);
+    ESP_LOGI(TAG, "recorded %u events, %lu ms", (unsigned)s_saved_count, (unsigned long)s_saved_ms);
+    bool ok = save_journey(s_journey);
+    if (!ok) s_loaded = false;  // re-read whatever NVS still holds
+    buffers_free();
+    return ok;
+}
+
+uint32_t InputReplay_SavedCount(void)
+{
+    if (s_state == kReplayRecording) return s_journey->count;
+    load_saved_info();
+    return s_saved_count;
+}
+
+uint32_t InputReplay_SavedDurationMs(void)
+{
+    if (s_state == kReplayRecording) {
+        return s_journey->count ? s_journey->ev[s_journey->count - 1].t_ms : 0;
+    }
+    load_saved_info();
+    return s_saved_ms;
+}
+
+// -------------------- replay --------------------
+
+static bool wait_dispatched(void)
+{
+    // Notified from InputReplay_OnPoll once the loop is idle again
+    return ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(REPLAY_KEY_TIMEOUT)) != 0;
+}
+
+static void replay_task(void* arg)
+{
+    (void)arg;
+
+    LatStats_Reset(&s_lat);
+    St7735_Flush();
+    St7735Stats s0;
+    St7735_GetStats(&s0);
+    int64_t t0 = esp_timer_get_time();
+
+    uint32_t sent = 0;
+    for (; sent < s_journey->count && !s_abort; sent++) {
+        const ReplayEvent* e = &s_journey->ev[sent];
+
+        if (s_mode == kReplayTimed) {
+            int64_t due = t0 + (int64_t)e->t_ms * 1000;
+            int64_t now = esp_timer_get_time();
+            if (due > now) vTaskDelay(pdMS_TO_TICKS((uint32_t)((due - now) / 1000)));
+        }
+
+        (void)ulTaskNotifyTake(pdTRUE, 0);
+        int64_t k0 = esp_timer_get_time();
+        atomic_fetch_add(&s_injected, 1u);
+        Uart1Router_InjectKey((InputKey)(e->key | INPUT_KEY_REPLAYED));
+
+        if (s_mode == kReplayFast) {
+            if (!wait_dispatched()) {
+                ESP_LOGW(TAG, "event %lu not dispatched, replay aborted", (unsigned long)sent);
+                break;
+            }
+            LatStats_Add(&s_lat, (uint32_t)(esp_timer_get_time() - k0));
+        }
+    }
+
+    // Timed mode: include the last key's dispatch too
+    if (s_mode == kReplayTimed && sent > 0) (void)wait_dispatched();
+    St7735_Flush();
+
+    int64_t t1 = esp_timer_get_time();
+    St7735Stats s1;
+    St7735_GetStats(&s1);
+
+    InputReplayResult r = {0};
+    r.seq = s_result.seq + 1;
+    r.mode = s_mode;
+    r.events = sent;
+    r.wall_ms = (uint32_t)((t1 - t0) / 1000);
+    r.lcd_txns = s1.txns - s0.txns;
+    r.lcd_bytes = s1.bytes - s0.bytes;
+    r.lcd_wait_ms = (uint32_t)((s1.dma_wait_us - s0.dma_wait_us) / 1000);
+
+    LatSummary lat = {0};
+    uint32_t* scratch = s_lat_mem + INPUT_REPLAY_MAX_EVENTS;
+    uint32_t n = LatStats_Snapshot(&s_lat, scratch);
+    if (n) LatStats_Percentiles(scratch, n, &lat);
+    r.key_p50_us = lat.p50;
+    r.key_p99_us = lat.p99;
+    r.key_max_us = lat.max;
+
+    s_result = r;
+    s_have_result = true;
+
+    // One line per run, compared across builds like the BENCH line
+    printf("REPLAY v%d mode=%s events=%lu wall_ms=%lu lcd_txns=%lu lcd_bytes=%lu lcd_wait_ms=%lu "
+           "key_p50_us=%lu key_p99_us=%lu key_max_us=%lu\n",
+           REPLAY_VERSION, r.mode == kReplayFast ? "fast" : "timed", (unsigned long)r.events,
+           (unsigned long)r.wall_ms, (unsigned long)r.lcd_txns, (unsigned long)r.lcd_bytes,
+           (unsigned long)r.lcd_wait_ms, (unsigned long)r.key_p50_us, (unsigned long)r.key_p99_us,
+           (unsigned long)r.key_max_us);
+
+    buffers_free();
+    s_state = kReplayIdle;
+    s_task = NULL;
+    vTaskDelete(NULL);
+}
+
+bool InputReplay_Play(InputReplayMode mode)
+{
+    if (s_state != kReplayIdle || InputReplay_SavedCount() == 0 || !journey_alloc()) return false;
+
+    s_lat_mem = (uint32_t*)MemTrack_Malloc(kMemTagInput, 2u * INPUT_REPLAY_MAX_EVENTS * sizeof(uint32_t),
+                                           MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    if (s_lat_mem) load_journey(s_journey);
+    if (!s_lat_mem || s_journey->count == 0) {
+        buffers_free();
+        return false;
+    }
+    LatStats_Init(&s_lat, s_lat_mem, INPUT_REPLAY_MAX_EVENTS);
+    uint32_t count = s_journey->count;
+
+    s_mode = mode;
+    s_abort = false;
+    atomic_store(&s_injected, 0u);
+    atomic_store(&s_consumed, 0u);
+    s_state = kReplayPlaying;
+
+    // Blocks between keys, so its priority only affects injection jitter
+    if (xTaskCreate(replay_task, "input_replay", 3072, NULL, 4, &s_task) != pdPASS) {
+        buffers_free();
+        s_state = kReplayIdle;
+        s_task = NULL;
+        return false;
+    }
+    // The task frees the journey when it finishes, so log the local count
+    ESP_LOGI(TAG, "replay %u events (%s)", (unsigned)count, mode == kReplayFast ? "fast" : "timed");
+    return true;
+}
+
+void InputReplay_Abort(void)
+{
+    if (s_state == kReplayPlaying) s_abort = true;
+}
+
+bool InputReplay_GetResult(InputReplayResult* out)
+{
+    if (!s_have_result) return false;
+    *out = s_result;
+    return true;
+}
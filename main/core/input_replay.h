@@ -0,0 +1,59 @@
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+#include "core/app_events.h"
+
+// Input journey recorder / replayer for repeatable performance runs.
+//
+// Recording stores every AppEvent the app loop receives with its time since
+// the recording started; the journey is saved to NVS when it stops. Replay
+// feeds the events back through Uart1Router_InjectKey, either with the
+// recorded timing or as fast as the app loop can dispatch them, and measures
+// wall time, LCD bus counters and per-key dispatch latency.
+// The journey and latency buffers are heap-allocated only while recording or
+// replaying.
+
+#define INPUT_REPLAY_MAX_EVENTS 256
+
+typedef enum {
+    kReplayIdle = 0,
+    kReplayRecording,
+    kReplayPlaying,
+} InputReplayState;
+
+typedef enum {
+    kReplayTimed = 0,       // original timing
+    kReplayFast,            // next key as soon as the previous one is dispatched
+} InputReplayMode;
+
+typedef struct {
+    uint32_t seq;           // bumped on every finished replay
+    InputReplayMode mode;
+    uint32_t events;
+    uint32_t wall_ms;
+    uint32_t lcd_txns;
+    uint32_t lcd_bytes;
+    uint32_t lcd_wait_ms;   // blocked on pixel DMA
+    uint32_t key_p50_us;    // inject -> app loop idle again (fast mode only)
+    uint32_t key_p99_us;
+    uint32_t key_max_us;
+} InputReplayResult;
+
+// App loop hooks (core/app_events.c)
+void InputReplay_OnPoll(void);
+void InputReplay_OnEvent(const AppEvent* ev);
+
+InputReplayState InputReplay_GetState(void);
+
+bool InputReplay_StartRecording(void);
+bool InputReplay_StopRecording(void);       // saves to NVS, false on error
+
+// Reads the saved journey's totals on first use
+uint32_t InputReplay_SavedCount(void);
+uint32_t InputReplay_SavedDurationMs(void);
+
+bool InputReplay_Play(InputReplayMode mode);
+void InputReplay_Abort(void);
+
+// Last finished replay, false if none yet
+bool InputReplay_GetResult(InputReplayResult* out);
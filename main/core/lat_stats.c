@@ -0,0 +1,58 @@
+#include "core/lat_stats.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+void LatStats_Init(LatStats* s, uint32_t* buf, uint32_t cap)
+{
+    s->samples = buf;
+    s->cap = cap;
+    LatStats_Reset(s);
+}
+
+void LatStats_Reset(LatStats* s)
+{
+    s->head = 0;
+    s->count = 0;
+    s->min = UINT32_MAX;
+    s->max = 0;
+}
+
+void LatStats_Add(LatStats* s, uint32_t v)
+{
+    s->samples[s->head] = v;
+    s->head = (s->head + 1 == s->cap) ? 0 : s->head + 1;
+    s->count++;
+    if (v < s->min) s->min = v;
+    if (v > s->max) s->max = v;
+}
+
+uint32_t LatStats_Snapshot(const LatStats* s, uint32_t* out)
+{
+    // Order does not matter: the result gets sorted
+    uint32_t n = (s->count < s->cap) ? s->count : s->cap;
+    memcpy(out, s->samples, n * sizeof(uint32_t));
+    return n;
+}
+
+static int cmp_u32(const void* a, const void* b)
+{
+    uint32_t x = *(const uint32_t*)a;
+    uint32_t y = *(const uint32_t*)b;
+    return (x > y) - (x < y);
+}
+
+void LatStats_Percentiles(uint32_t* v, uint32_t n, LatSummary* out)
+{
+    memset(out, 0, sizeof(*out));
+    if (n == 0) return;
+
+    qsort(v, n, sizeof(uint32_t), cmp_u32);
+
+    // Nearest rank
+    out->n = n;
+    out->p50 = v[(n * 50 + 99) / 100 - 1];
+    out->p99 = v[(n * 99 + 99) / 100 - 1];
+    out->min = v[0];
+    out->max = v[n - 1];
+}
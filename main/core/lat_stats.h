@@ -0,0 +1,33 @@
+#pragma once
+#include <stdint.h>
+
+// Latency sample window: the last cap samples are kept for percentiles,
+// min/max/count cover everything since the last reset. Not thread safe:
+// writers and the Snapshot() reader need to serialize themselves.
+
+typedef struct {
+    uint32_t* samples;
+    uint32_t cap;
+    uint32_t head;      // next slot to write
+    uint32_t count;     // total samples since reset
+    uint32_t min;
+    uint32_t max;
+} LatStats;
+
+typedef struct {
+    uint32_t n;         // samples the percentiles were taken from
+    uint32_t p50;
+    uint32_t p99;
+    uint32_t min;
+    uint32_t max;
+} LatSummary;
+
+void LatStats_Init(LatStats* s, uint32_t* buf, uint32_t cap);
+void LatStats_Reset(LatStats* s);
+void LatStats_Add(LatStats* s, uint32_t v);
+
+// Copies the window into out[] (cap entries) and returns how many
+uint32_t LatStats_Snapshot(const LatStats* s, uint32_t* out);
+
+// Sorts v[] in place; min/max are taken from v[] too
+void LatStats_Percentiles(uint32_t* v, uint32_t n, LatSummary* out);
@@ -0,0 +1,109 @@
+#include "core/spsc_ring.h"
+
+#include <string.h>
+
+void SpscRing_Init(SpscRing* r, uint8_t* buf, uint32_t cap_pow2)
+{
+    r->buf = buf;
+    r->cap = cap_pow2;
+    r->mask = cap_pow2 - 1;
+    atomic_store_explicit(&r->head, 0u, memory_order_relaxed);
+    atomic_store_explicit(&r->tail, 0u, memory_order_relaxed);
+}
+
+uint32_t SpscRing_Used(const SpscRing* r)
+{
+    unsigned h = atomic_load_explicit(&((SpscRing*)r)->head, memory_order_acquire);
+    unsigned t = atomic_load_explicit(&((SpscRing*)r)->tail, memory_order_acquire);
+    return (uint32_t)(h - t);
+}
+
+uint32_t SpscRing_Free(const SpscRing* r)
+{
+    return r->cap - SpscRing_Used(r);
+}
+
+uint32_t SpscRing_PeekWrite(SpscRing* r, uint8_t** out)
+{
+    unsigned h = atomic_load_explicit(&r->head, memory_order_relaxed);
+    unsigned t = atomic_load_explicit(&r->tail, memory_order_acquire);
+
+    uint32_t free_bytes = r->cap - (uint32_t)(h - t);
+    uint32_t off = h & r->mask;
+    uint32_t to_end = r->cap - off;
+
+    *out = r->buf + off;
+    return free_bytes < to_end ? free_bytes : to_end;
+}
+
+void SpscRing_CommitWrite(SpscRing* r, uint32_t n)
+{
+    unsigned h = atomic_load_explicit(&r->head, memory_order_relaxed);
+    atomic_store_explicit(&r->head, h + n, memory_order_release);
+}
+
+uint32_t SpscRing_WriteWindow(SpscRing* r, uint32_t* head)
+{
+    unsigned h = atomic_load_explicit(&r->head, memory_order_relaxed);
+    unsigned t = atomic_load_explicit(&r->tail, memory_order_acquire);
+    *head = (uint32_t)h;
+    return r->cap - (uint32_t)(h - t);
+}
+
+uint32_t SpscRing_Write(SpscRing* r, const uint8_t* data, uint32_t len)
+{
+    uint32_t done = 0;
+
+    // At most two spans: up to the end of the buffer, then from the start
+    for (int pass = 0; pass < 2 && done < len; pass++) {
+        uint8_t* dst;
+        uint32_t span = SpscRing_PeekWrite(r, &dst);
+        if (span == 0) break;
+        if (span > len - done) span = len - done;
+        memcpy(dst, data + done, span);
+        SpscRing_CommitWrite(r, span);
+        done += span;
+    }
+    return done;
+}
+
+uint32_t SpscRing_Peek(SpscRing* r, const uint8_t** out)
+{
+    unsigned t = atomic_load_explicit(&r->tail, memory_order_relaxed);
+    unsigned h = atomic_load_explicit(&r->head, memory_order_acquire);
+
+    uint32_t used = (uint32_t)(h - t);
+    uint32_t off = t & r->mask;
+    uint32_t to_end = r->cap - off;
+
+    *out = r->buf + off;
+    return used < to_end ? used : to_end;
+}
+
+void SpscRing_Commit(SpscRing* r, uint32_t n)
+{
+    unsigned t = atomic_load_explicit(&r->tail, memory_order_relaxed);
+    atomic_store_explicit(&r->tail, t + n, memory_order_release);
+}
+
+uint32_t SpscRing_Read(SpscRing* r, uint8_t* out, uint32_t len)
+{
+    uint32_t done = 0;
+
+    for (int pass = 0; pass < 2 && done < len; pass++) {
+        const uint8_t* src;
+        uint32_t span = SpscRing_Peek(r, &src);
+        if (span == 0) break;
+        if (span > len - done) span = len - done;
+        memcpy(out + done, src, span);
+        SpscRing_Commit(r, span);
+        done += span;
+    }
+    return done;
+}
+
+void SpscRing_Drain(SpscRing* r)
+{
+    unsigned h = atomic_load_explicit(&r->head, memory_order_acquire);
+    atomic_store_explicit(&r->tail, h, memory_order_release);
+}
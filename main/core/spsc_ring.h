@@ -0,0 +1,41 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <stdatomic.h>
+
+// Lock-free single-producer / single-consumer byte ring.
+// Capacity must be a power of two. head is written only by the producer,
+// tail only by the consumer; both run free and are masked on access.
+//
+// Consumers work on spans: Peek() returns the longest contiguous readable
+// region, Commit() releases bytes once they are processed. Producers can do
+// the same with PeekWrite()/CommitWrite() or just call Write().
+
+typedef struct {
+    uint8_t* buf;
+    uint32_t cap;
+    uint32_t mask;
+    atomic_uint head;
+    atomic_uint tail;
+} SpscRing;
+
+void SpscRing_Init(SpscRing* r, uint8_t* buf, uint32_t cap_pow2);
+
+uint32_t SpscRing_Used(const SpscRing* r);
+uint32_t SpscRing_Free(const SpscRing* r);
+
+// Producer side
+uint32_t SpscRing_Write(SpscRing* r, const uint8_t* data, uint32_t len);   // returns bytes stored
+uint32_t SpscRing_PeekWrite(SpscRing* r, uint8_t** out);
+void     SpscRing_CommitWrite(SpscRing* r, uint32_t n);
+
+// Producer-side random access for in-place decoders: returns the free space
+// and the head position. Bytes stored at buf[(head + i) & mask] become
+// visible to the consumer on CommitWrite().
+uint32_t SpscRing_WriteWindow(SpscRing* r, uint32_t* head);
+
+// Consumer side
+uint32_t SpscRing_Peek(SpscRing* r, const uint8_t** out);
+void     SpscRing_Commit(SpscRing* r, uint32_t n);
+uint32_t SpscRing_Read(SpscRing* r, uint8_t* out, uint32_t len);           // copy + commit
+void     SpscRing_Drain(SpscRing* r);                                       // consumer drops all
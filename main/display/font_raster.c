@@ -0,0 +1,86 @@
+#include "display/font_raster.h"
+#include "core/hot_path.h"
+
+#include <stddef.h>
+
+#include "display/font8x16.h"
+#include "display/font5x7.h"
+
+#define F8_W 8
+#define F8_H 16
+#define F5_W 5
+#define F5_H 7
+
+HOT_PATH void FontRaster_Char8x16(uint16_t* buf, int bw, int bh, int x, int y, char c, uint16_t fg)
+{
+    if (!buf) return;
+    if (x < 0 || y < 0) return;
+    if (x + F8_W > bw) return;
+    if (y + F8_H > bh) return;
+
+    const uint8_t* rows = Font8x16_Get(c);
+    if (!rows) rows = Font8x16_Get('?');
+    if (!rows) return;
+
+    for (int ry = 0; ry < F8_H; ry++) {
+        uint8_t bits = rows[ry];
+        uint16_t* dst = buf + (y + ry) * bw + x;
+        for (int rx = 0; rx < F8_W; rx++) {
+            if (bits & (0x80U >> rx)) dst[rx] = fg;
+        }
+    }
+}
+
+HOT_PATH void FontRaster_Text8x16(uint16_t* buf, int bw, int bh, int x, int y, const char* s, uint16_t fg,
+                         int advance, int line_h)
+{
+    int px = x;
+    for (const char* p = s; *p; p++) {
+        char c = *p;
+
+        if (c == '\n') {
+            y += line_h;
+            px = x;
+            continue;
+        }
+
+        FontRaster_Char8x16(buf, bw, bh, px, y, c, fg);
+        px += advance;
+
+        if (px > bw - advance) {
+            y += line_h;
+            px = x;
+        }
+    }
+}
+
+void FontRaster_Char5x7(uint16_t* buf, int bw, int bh, int x, int y, char c, uint16_t fg)
+{
+    if (!buf) return;
+    const uint8_t* cols = Font5x7_Get(c);
+    if (!cols) return;
+
+    for (int cx = 0; cx < F5_W; cx++) {
+        uint8_t bits = cols[cx];
+        for (int cy = 0; cy < F5_H; cy++) {
+            if (bits & (1U << cy)) {
+                int px = x + cx;
+                int py = y + cy;
+                if (px >= 0 && px < bw && py >= 0 && py < bh) {
+                    buf[py * bw + px] = fg;
+                }
+            }
+        }
+    }
+}
+
+void FontRaster_Text5x7(uint16_t* buf, int bw, int bh, int x, int y, const char* s, uint16_t fg,
+                        int advance)
+{
+    int px = x;
+    for (const char* p = s; *p; p++) {
+        FontRaster_Char5x7(buf, bw, bh, px, y, *p, fg);
+        px += advance;
+        if (px >= bw) break;
+    }
+}
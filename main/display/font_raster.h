@@ -0,0 +1,16 @@
+#pragma once
+#include <stdint.h>
+
+// Glyph rasterizers into RGB565 line buffers (bw x bh pixels, row major).
+// Only foreground pixels are written. Pure C, used by ui_lcd.c.
+
+// 8x16: glyphs that do not fit entirely are skipped. Text wraps to the next
+// line (line_h) when the next glyph would not fit, and on '\n'.
+void FontRaster_Char8x16(uint16_t* buf, int bw, int bh, int x, int y, char c, uint16_t fg);
+void FontRaster_Text8x16(uint16_t* buf, int bw, int bh, int x, int y, const char* s, uint16_t fg,
+                         int advance, int line_h);
+
+// 5x7: clipped per pixel, single line, stops at the right edge
+void FontRaster_Char5x7(uint16_t* buf, int bw, int bh, int x, int y, char c, uint16_t fg);
+void FontRaster_Text5x7(uint16_t* buf, int bw, int bh, int x, int y, const char* s, uint16_t fg,
+                        int advance);
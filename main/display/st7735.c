@@ -10,6 +10,10 @@
 #include "esp_heap_caps.h"
 #include "esp_log.h"
 #include "esp_err.h"
+#include "esp_timer.h"
+#include "mem_track.h"
+#include "evtrace.h"
+#include "core/hot_path.h"
 
 // Pins (adjust if needed)
 #define PIN_SCK   21
@@ -36,6 +40,9 @@ static SemaphoreHandle_t s_lcd_mutex;
 static bool s_sw_invert = ST7735_SW_INVERT_DEFAULT;
 static bool s_sw_rb_swap = ST7735_SW_RB_SWAP_DEFAULT;
 static bool s_hw_invert = ST7735_HW_INVERT_DEFAULT;
+static int s_scroll_top, s_scroll_bottom, s_scroll_row;    // all 0 = no scroll
+
+static St7735Stats s_stats;
 
 static inline void lcd_lock(void)   { xSemaphoreTake(s_lcd_mutex, portMAX_DELAY); }
 static inline void lcd_unlock(void) { xSemaphoreGive(s_lcd_mutex); }
@@ -67,6 +74,8 @@ static void spi_write_polling(const void* data, int len)
     t.length = len * 8;
     t.tx_buffer = data;
     ESP_ERROR_CHECK(spi_device_polling_transmit(s_spi, &t));
+    s_stats.txns++;
+    s_stats.bytes += (uint32_t)len;
 }
 
 static void write_cmd(uint8_t cmd)
@@ -123,8 +132,12 @@ static void lcd_dma_wait_one(void)
 {
     spi_transaction_t* rt = NULL;
     if (s_dma_inflight > 0) {
+        EVTRACE_BEGIN(kEvtLcdWait);
+        int64_t t0 = esp_timer_get_time();
         ESP_ERROR_CHECK(spi_device_get_trans_result(s_spi, &rt, portMAX_DELAY));
+        s_stats.dma_wait_us += (uint64_t)(esp_timer_get_time() - t0);
         s_dma_inflight--;
+        EVTRACE_END(kEvtLcdWait);
     }
 }
 
@@ -140,7 +153,7 @@ static void lcd_dma_wait_all_locked(void)
     while (s_dma_inflight > 0) lcd_dma_wait_one();
 }
 
-static void lcd_dma_queue_pixels_be16(const uint16_t* pixels, int count_words)
+HOT_PATH static void lcd_dma_queue_pixels_be16(const uint16_t* pixels, int count_words)
 {
     dc_data();
 
@@ -170,6 +183,9 @@ static void lcd_dma_queue_pixels_be16(const uint16_t* pixels, int count_words)
 
         ESP_ERROR_CHECK(spi_device_queue_trans(s_spi, t, portMAX_DELAY));
         s_dma_inflight++;
+        s_stats.txns++;
+        s_stats.bytes += (uint32_t)(nwords * 2);
+        EVTRACE_INSTANT(kEvtLcdQueue, nwords * 2);
 
         s_dma_buf_idx = (s_dma_buf_idx + 1) % LCD_DMA_QUEUE;
         src += nwords;
@@ -177,7 +193,7 @@ static void lcd_dma_queue_pixels_be16(const uint16_t* pixels, int count_words)
     }
 }
 
-static void lcd_dma_queue_color565(uint16_t color565, int count_words)
+HOT_PATH static void lcd_dma_queue_color565(uint16_t color565, int count_words)
 {
     dc_data();
 
@@ -208,6 +224,9 @@ static void lcd_dma_queue_color565(uint16_t color565, int count_words)
 
         ESP_ERROR_CHECK(spi_device_queue_trans(s_spi, t, portMAX_DELAY));
         s_dma_inflight++;
+        s_stats.txns++;
+        s_stats.bytes += (uint32_t)(nwords * 2);
+        EVTRACE_INSTANT(kEvtLcdQueue, nwords * 2);
 
         s_dma_buf_idx = (s_dma_buf_idx + 1) % LCD_DMA_QUEUE;
         remaining -= nwords;
@@ -255,7 +274,7 @@ void St7735_Init(void)
     s_lcd_mutex = xSemaphoreCreateMutex();
 
     for (int i = 0; i < LCD_DMA_QUEUE; i++) {
-        s_dma_buf[i] = (uint8_t*)heap_caps_malloc(LCD_DMA_CHUNK_BYTES, MALLOC_CAP_DMA);
+        s_dma_buf[i] = (uint8_t*)MemTrack_Malloc(kMemTagLcd, LCD_DMA_CHUNK_BYTES, MALLOC_CAP_DMA);
         memset(&s_dma_trans[i], 0, sizeof(spi_transaction_t));
     }
 
@@ -297,6 +316,7 @@ void St7735_DrawPixel(int x, int y, uint16_t color565)
     if (x < 0 || y < 0) return;
     if (x >= ST7735_W || y >= ST7735_H) return;
 
+    EVTRACE_INSTANT(kEvtLcdPixel, ((uint32_t)x << 16) | (uint32_t)y);
     lcd_lock();
     lcd_dma_wait_all_locked();
 
@@ -318,6 +338,7 @@ void St7735_BlitRect(int x, int y, int w, int h, const uint16_t* pixels565)
     if (y + h > ST7735_H) return;
     if (!pixels565) return;
 
+    EVTRACE_BEGIN_V(kEvtLcdBlit, w * h);
     lcd_lock();
     lcd_dma_wait_all_locked();
 
@@ -325,6 +346,7 @@ void St7735_BlitRect(int x, int y, int w, int h, const uint16_t* pixels565)
     lcd_dma_queue_pixels_be16(pixels565, w * h);
 
     lcd_unlock();
+    EVTRACE_END(kEvtLcdBlit);
 }
 
 void St7735_FillRect(int x, int y, int w, int h, uint16_t color565)
@@ -334,6 +356,7 @@ void St7735_FillRect(int x, int y, int w, int h, uint16_t color565)
     if (x + w > ST7735_W) return;
     if (y + h > ST7735_H) return;
 
+    EVTRACE_BEGIN_V(kEvtLcdFill, w * h);
     lcd_lock();
     lcd_dma_wait_all_locked();
 
@@ -341,10 +364,12 @@ void St7735_FillRect(int x, int y, int w, int h, uint16_t color565)
     lcd_dma_queue_color565(color565, w * h);
 
     lcd_unlock();
+    EVTRACE_END(kEvtLcdFill);
 }
 
 void St7735_Fill(uint16_t color565)
 {
+    EVTRACE_BEGIN_V(kEvtLcdFill, ST7735_W * ST7735_H);
     lcd_lock();
     lcd_dma_wait_all_locked();
 
@@ -352,6 +377,7 @@ void St7735_Fill(uint16_t color565)
     lcd_dma_queue_color565(color565, ST7735_W * ST7735_H);
 
     lcd_unlock();
+    EVTRACE_END(kEvtLcdFill);
 }
 
 void St7735_SetInversion(bool on)
@@ -363,8 +389,49 @@ void St7735_SetInversion(bool on)
     lcd_unlock();
 }
 
+void St7735_SetScrollArea(int top_fixed, int bottom_fixed)
+{
+    if (top_fixed < 0 || bottom_fixed < 0 || top_fixed + bottom_fixed >= ST7735_H) return;
+
+    lcd_lock();
+    lcd_dma_wait_all_locked();
+    write_cmd(0x33);    // VSCRDEF: top fixed, scroll area, bottom fixed
+    write_u16_be((uint16_t)top_fixed);
+    write_u16_be((uint16_t)(ST7735_H - top_fixed - bottom_fixed));
+    write_u16_be((uint16_t)bottom_fixed);
+    s_scroll_top = top_fixed;
+    s_scroll_bottom = bottom_fixed;
+    lcd_unlock();
+}
+
+void St7735_ScrollTo(int row)
+{
+    if (row < 0 || row >= ST7735_H) return;
+
+    lcd_lock();
+    lcd_dma_wait_all_locked();
+    write_cmd(0x37);    // VSCSAD
+    write_u16_be((uint16_t)row);
+    s_scroll_row = row;
+    lcd_unlock();
+}
+
+void St7735_ScrollReset(void)
+{
+    if (s_scroll_top == 0 && s_scroll_bottom == 0 && s_scroll_row == 0) return;
+    St7735_SetScrollArea(0, 0);
+    St7735_ScrollTo(0);
+}
+
 void St7735_SetSoftwareInvert(bool on) { s_sw_invert = on; }
 void St7735_SetSoftwareRBSwap(bool on) { s_sw_rb_swap = on; }
 bool St7735_GetSoftwareInvert(void) { return s_sw_invert; }
 bool St7735_GetSoftwareRBSwap(void) { return s_sw_rb_swap; }
 bool St7735_GetInversion(void) { return s_hw_invert; }
+
+void St7735_GetStats(St7735Stats* out)
+{
+    lcd_lock();
+    *out = s_stats;
+    lcd_unlock();
+}
@@ -23,3 +23,21 @@ void St7735_SetSoftwareInvert(bool on);
 void St7735_SetSoftwareRBSwap(bool on);
 bool St7735_GetSoftwareInvert(void);
 bool St7735_GetSoftwareRBSwap(void);
+
+// Hardware vertical scroll (VSCRDEF / VSCSAD). Rows between the fixed top
+// and bottom bands form a ring: St7735_ScrollTo(row) shows memory row `row`
+// on the first line of the band, and the rows after it below, wrapping.
+// Drawing still addresses memory rows. Reset restores the identity mapping
+// (and costs nothing when it is already in place).
+void St7735_SetScrollArea(int top_fixed, int bottom_fixed);
+void St7735_ScrollTo(int row);
+void St7735_ScrollReset(void);
+
+// Bus counters since boot, for benchmarks (see exp_bench.c)
+typedef struct {
+    uint32_t txns;          // SPI transactions: commands, params and pixel chunks
+    uint32_t bytes;         // bytes on the wire
+    uint64_t dma_wait_us;   // time blocked waiting for queued pixel DMA
+} St7735Stats;
+
+void St7735_GetStats(St7735Stats* out);
@@ -0,0 +1,107 @@
+#include "dsp/audio_asset.h"
+#include "dsp/ima_adpcm.h"
+#include "core/hot_path.h"
+
+#include <string.h>
+
+#define ULAW_CHUNK   256
+#define PCM_CHUNK    256
+#define ULAW_BIAS    0x84
+#define ULAW_CLIP    32635
+
+static uint32_t rd32(const uint8_t* p)
+{
+    return (uint32_t)p[0] | (uint32_t)p[1] << 8 | (uint32_t)p[2] << 16 | (uint32_t)p[3] << 24;
+}
+
+static uint32_t payload_bytes(uint8_t format, uint32_t samples)
+{
+    switch (format) {
+    case kAudioAssetPcm16: return samples * 2;
+    case kAudioAssetUlaw: return samples;
+    case kAudioAssetImaAdpcm:
+        return (samples + IMA_ADPCM_BLOCK_SAMPLES - 1) / IMA_ADPCM_BLOCK_SAMPLES * IMA_ADPCM_BLOCK_BYTES;
+    default: return UINT32_MAX;
+    }
+}
+
+bool AudioAsset_Open(AudioAssetReader* r, const uint8_t* asset, uint32_t len)
+{
+    if (!r || !asset || len < AUDIO_ASSET_HEADER_BYTES || memcmp(asset, AUDIO_ASSET_MAGIC, 4) != 0) return false;
+
+    r->format = asset[4];
+    r->sample_rate = rd32(asset + 8);
+    r->samples = rd32(asset + 12);
+    r->data = asset + AUDIO_ASSET_HEADER_BYTES;
+    r->data_bytes = len - AUDIO_ASSET_HEADER_BYTES;
+    if (r->sample_rate == 0 || payload_bytes(r->format, r->samples) > r->data_bytes) return false;
+
+    AudioAsset_Rewind(r);
+    return true;
+}
+
+void AudioAsset_Rewind(AudioAssetReader* r)
+{
+    r->offset = 0;
+    r->samples_left = r->samples;
+}
+
+// G.711: sign, 3-bit segment, 4-bit mantissa, stored inverted
+int16_t AudioAsset_UlawDecode(uint8_t u)
+{
+    u = (uint8_t)~u;
+    int32_t t = (((int32_t)(u & 0x0F) << 3) + ULAW_BIAS) << ((u & 0x70) >> 4);
+    return (int16_t)((u & 0x80) ? ULAW_BIAS - t : t - ULAW_BIAS);
+}
+
+uint8_t AudioAsset_UlawEncode(int16_t s)
+{
+    int32_t v = s;
+    uint8_t sign = 0;
+    if (v < 0) {
+        v = -v;
+        sign = 0x80;
+    }
+    if (v > ULAW_CLIP) v = ULAW_CLIP;
+    v += ULAW_BIAS;
+
+    int seg = 7;
+    for (int32_t mask = 0x4000; seg > 0 && !(v & mask); mask >>= 1) seg--;
+    uint8_t mant = (uint8_t)((v >> (seg + 3)) & 0x0F);
+    return (uint8_t)~(sign | (seg << 4) | mant);
+}
+
+HOT_PATH static void ulaw_block(const uint8_t* in, int16_t* out, uint32_t n)
+{
+    for (uint32_t i = 0; i < n; i++) out[i] = AudioAsset_UlawDecode(in[i]);
+}
+
+uint32_t AudioAsset_Decode(AudioAssetReader* r, int16_t* out)
+{
+    uint32_t n = 0;
+    if (r->samples_left == 0) return 0;
+
+    switch (r->format) {
+    case kAudioAssetImaAdpcm:
+        ImaAdpcm_DecodeBlock(r->data + r->offset, out);
+        r->offset += IMA_ADPCM_BLOCK_BYTES;
+        n = IMA_ADPCM_BLOCK_SAMPLES;
+        break;
+    case kAudioAssetUlaw:
+        n = r->samples_left < ULAW_CHUNK ? r->samples_left : ULAW_CHUNK;
+        ulaw_block(r->data + r->offset, out, n);
+        r->offset += n;
+        break;
+    case kAudioAssetPcm16:
+        n = r->samples_left < PCM_CHUNK ? r->samples_left : PCM_CHUNK;
+        memcpy(out, r->data + r->offset, n * sizeof(int16_t));
+        r->offset += n * sizeof(int16_t);
+        break;
+    default:
+        return 0;
+    }
+
+    if (n > r->samples_left) n = r->samples_left;
+    r->samples_left -= n;
+    return n;
+}
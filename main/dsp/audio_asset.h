@@ -0,0 +1,48 @@
+#pragma once
+#include <stdbool.h>
+#include <stdint.h>
+
+// Embedded sound clips, stored compressed and decoded a chunk at a time, so
+// playing one never needs a RAM copy of the clip. Pure C.
+//
+// tools/audio_pack.py writes the asset at build time: a 16-byte header
+// (little endian) followed by the payload.
+//
+//   0  "SND1"
+//   4  format (AudioAssetFormat), 1 byte; 3 reserved bytes
+//   8  sample_rate u32
+//  12  samples u32      (the last ADPCM block is padded past this)
+//
+// kAudioAssetImaAdpcm payload is dsp/ima_adpcm.h blocks (~3.95:1),
+// kAudioAssetUlaw is G.711 mu-law, one byte per sample (2:1).
+
+#define AUDIO_ASSET_MAGIC        "SND1"
+#define AUDIO_ASSET_HEADER_BYTES 16
+#define AUDIO_ASSET_CHUNK_MAX    505    // samples per Decode call, at most
+
+typedef enum {
+    kAudioAssetPcm16 = 0,
+    kAudioAssetImaAdpcm = 1,
+    kAudioAssetUlaw = 2,
+} AudioAssetFormat;
+
+typedef struct {
+    const uint8_t* data;        // payload
+    uint32_t data_bytes;
+    uint32_t sample_rate;
+    uint32_t samples;
+    uint32_t offset;            // into data
+    uint32_t samples_left;
+    uint8_t format;
+} AudioAssetReader;
+
+// false if the header is bad or the payload is shorter than it claims
+bool AudioAsset_Open(AudioAssetReader* r, const uint8_t* asset, uint32_t len);
+void AudioAsset_Rewind(AudioAssetReader* r);
+
+// Decodes the next chunk into out (AUDIO_ASSET_CHUNK_MAX samples of room).
+// Returns the samples written, 0 at the end.
+uint32_t AudioAsset_Decode(AudioAssetReader* r, int16_t* out);
+
+int16_t AudioAsset_UlawDecode(uint8_t u);
+uint8_t AudioAsset_UlawEncode(int16_t s);
@@ -0,0 +1,157 @@
+#include "dsp/audio_fx.h"
+#include "dsp/audio_mix.h"
+#include "core/hot_path.h"
+
+#include <stdbool.h>
+#include <string.h>
+
+#define FX_CHUNK            64
+#define GATE_ATTACK_STEP    2048        // 0 -> 1 in 16 samples
+#define GATE_RELEASE_STEP   32          // 1 -> 0 in 1024 samples
+#define GATE_ENV_SHIFT      8           // peak follower decay per sample: env / 256, at least 1
+#define ECHO_FEEDBACK_Q15   14746       // 0.45
+#define ECHO_MIX_Q15        19661       // 0.6
+
+// One turn, 64 steps, plus the wrap point for the interpolation
+static const int16_t kSine64[65] = {
+         0,   3212,   6393,   9512,  12539,  15446,  18204,  20787,
+     23170,  25329,  27245,  28898,  30273,  31356,  32137,  32609,
+     32767,  32609,  32137,  31356,  30273,  28898,  27245,  25329,
+     23170,  20787,  18204,  15446,  12539,   9512,   6393,   3212,
+         0,  -3212,  -6393,  -9512, -12539, -15446, -18204, -20787,
+    -23170, -25329, -27245, -28898, -30273, -31356, -32137, -32609,
+    -32767, -32609, -32137, -31356, -30273, -28898, -27245, -25329,
+    -23170, -20787, -18204, -15446, -12539,  -9512,  -6393,  -3212,
+         0,
+};
+
+// 10^(dB/20) in Q12 for 0..5 dB; every 6 dB more is one bit (6.02 dB)
+static const int32_t kDbQ12[6] = { 4096, 4596, 5157, 5786, 6492, 7284 };
+
+static const char* const kPresetNames[kAudioFxCount] = { "CLEAN", "GATE", "ECHO", "ROBOT" };
+
+uint32_t AudioFx_DelayBytes(uint32_t sample_rate)
+{
+    return sample_rate * AUDIO_FX_ECHO_MS / 1000u * (uint32_t)sizeof(int16_t);
+}
+
+void AudioFx_Init(AudioFx* fx, uint32_t sample_rate, int16_t* delay_mem)
+{
+    memset(fx, 0, sizeof(*fx));
+    fx->gain_q12 = 4096;
+    fx->ring_step = sample_rate ? (uint32_t)(((uint64_t)AUDIO_FX_RING_HZ << 32) / sample_rate) : 0;
+    fx->delay = delay_mem;
+    fx->delay_len = delay_mem ? AudioFx_DelayBytes(sample_rate) / sizeof(int16_t) : 0;
+    AudioFx_SetPreset(fx, kAudioFxClean);
+}
+
+void AudioFx_SetPreset(AudioFx* fx, AudioFxPreset preset)
+{
+    fx->preset = (preset >= 0 && preset < kAudioFxCount) ? preset : kAudioFxClean;
+    fx->env = 0;
+    fx->gate_q15 = 0;
+    fx->ring_phase = 0;
+    fx->delay_pos = 0;
+    if (fx->delay) memset(fx->delay, 0, fx->delay_len * sizeof(int16_t));
+}
+
+void AudioFx_SetGainDb(AudioFx* fx, int gain_db)
+{
+    if (gain_db < AUDIO_FX_GAIN_DB_MIN) gain_db = AUDIO_FX_GAIN_DB_MIN;
+    if (gain_db > AUDIO_FX_GAIN_DB_MAX) gain_db = AUDIO_FX_GAIN_DB_MAX;
+
+    // Floor division so -1 dB is -6 + 5
+    int octaves = gain_db >= 0 ? gain_db / 6 : -((5 - gain_db) / 6);
+    int32_t g = kDbQ12[gain_db - octaves * 6];
+    fx->gain_q12 = octaves >= 0 ? g << octaves : g >> -octaves;
+}
+
+const char* AudioFx_PresetName(AudioFxPreset preset)
+{
+    return (preset >= 0 && preset < kAudioFxCount) ? kPresetNames[preset] : "?";
+}
+
+// Gain, or gain times the gate when it is on. Gate x gain stays within
+// Q12 65536, and x times that within int32.
+HOT_PATH static void stage_gain(AudioFx* fx, const int16_t* in, int32_t* acc, int n, bool gate)
+{
+    const int32_t g = fx->gain_q12;
+    if (!gate) {
+        for (int i = 0; i < n; i++) acc[i] = ((int32_t)in[i] * g) >> 12;
+        return;
+    }
+
+    int32_t env = fx->env;
+    int32_t gg = fx->gate_q15;
+    for (int i = 0; i < n; i++) {
+        int32_t x = in[i];
+        int32_t a = x < 0 ? -x : x;
+        env = a > env ? a : env - ((env + (1 << GATE_ENV_SHIFT) - 1) >> GATE_ENV_SHIFT);
+        if (env > AUDIO_FX_GATE_LEVEL) {
+            gg += GATE_ATTACK_STEP;
+            if (gg > AUDIO_MIX_UNITY_Q15) gg = AUDIO_MIX_UNITY_Q15;
+        } else {
+            gg -= GATE_RELEASE_STEP;
+            if (gg < 0) gg = 0;
+        }
+        acc[i] = (x * ((g * gg) >> 15)) >> 12;
+    }
+    fx->env = env;
+    fx->gate_q15 = gg;
+}
+
+// acc is at most 20 bits after the gain; dropping 4 keeps the product in int32
+HOT_PATH static void stage_ring(AudioFx* fx, int32_t* acc, int n)
+{
+    uint32_t ph = fx->ring_phase;
+    const uint32_t step = fx->ring_step;
+    for (int i = 0; i < n; i++) {
+        uint32_t k = ph >> 26;
+        int32_t frac = (int32_t)((ph >> 11) & 0x7FFF);
+        int32_t s = kSine64[k] + (((kSine64[k + 1] - kSine64[k]) * frac) >> 15);
+        acc[i] = ((acc[i] >> 4) * s) >> 11;
+        ph += step;
+    }
+    fx->ring_phase = ph;
+}
+
+static inline int16_t sat16(int32_t v)
+{
+    if (v > 32767) return 32767;
+    if (v < -32768) return -32768;
+    return (int16_t)v;
+}
+
+// y = x + mix * d, and the line takes x + feedback * d
+HOT_PATH static void stage_echo(AudioFx* fx, int32_t* acc, int n)
+{
+    int16_t* line = fx->delay;
+    const uint32_t len = fx->delay_len;
+    uint32_t pos = fx->delay_pos;
+    for (int i = 0; i < n; i++) {
+        int32_t d = line[pos];
+        int32_t x = acc[i];
+        acc[i] = x + ((d * ECHO_MIX_Q15) >> 15);
+        line[pos] = sat16(x + ((d * ECHO_FEEDBACK_Q15) >> 15));
+        if (++pos == len) pos = 0;
+    }
+    fx->delay_pos = pos;
+}
+
+uint32_t AudioFx_Process(AudioFx* fx, int16_t* buf, int n)
+{
+    const bool gate = fx->preset != kAudioFxClean;
+    const bool ring = fx->preset == kAudioFxRobot;
+    const bool echo = fx->preset == kAudioFxEcho && fx->delay_len > 0;
+
+    int32_t acc[FX_CHUNK];
+    uint32_t clipped = 0;
+    for (int off = 0; off < n; off += FX_CHUNK) {
+        int k = n - off < FX_CHUNK ? n - off : FX_CHUNK;
+        stage_gain(fx, buf + off, acc, k, gate);
+        if (ring) stage_ring(fx, acc, k);
+        if (echo) stage_echo(fx, acc, k);
+        clipped += AudioMix_Saturate(acc, buf + off, k);
+    }
+    return clipped;
+}
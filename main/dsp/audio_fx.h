@@ -0,0 +1,54 @@
+#pragma once
+#include <stdint.h>
+
+// Small in-place effect chain for live audio (audio/mic_monitor.c). Pure C.
+//
+// Every preset runs the same fixed order, skipping the stages it does not
+// use: input gain -> noise gate -> ring modulator -> feedback echo ->
+// saturation. Samples are int16 in and out; the stages work on int32 so a
+// boost only clips once, at the end.
+//
+// The gate follows the peak of the input (before the gain), so its
+// threshold does not move with the volume. It opens in about 1 ms and,
+// once the input has stayed below the threshold, closes over about 64 ms.
+
+#define AUDIO_FX_GAIN_DB_MIN    (-24)
+#define AUDIO_FX_GAIN_DB_MAX    24
+#define AUDIO_FX_GATE_LEVEL     100     // input peak, ~-50 dBFS
+#define AUDIO_FX_ECHO_MS        120
+#define AUDIO_FX_RING_HZ        50
+
+typedef enum {
+    kAudioFxClean = 0,      // gain only
+    kAudioFxGate,           // + noise gate
+    kAudioFxEcho,           // + gate, echo
+    kAudioFxRobot,          // + gate, ring modulator
+    kAudioFxCount,
+} AudioFxPreset;
+
+typedef struct {
+    AudioFxPreset preset;
+    int32_t gain_q12;       // 4096 = 0 dB
+    // Noise gate
+    int32_t env;            // input peak follower
+    int32_t gate_q15;       // current gate gain
+    // Ring modulator
+    uint32_t ring_phase;    // Q32 turns
+    uint32_t ring_step;
+    // Echo; no delay line means no echo
+    int16_t* delay;
+    uint32_t delay_len;
+    uint32_t delay_pos;
+} AudioFx;
+
+// Delay line bytes for AUDIO_FX_ECHO_MS at sample_rate
+uint32_t AudioFx_DelayBytes(uint32_t sample_rate);
+
+// delay_mem: AudioFx_DelayBytes() bytes, or NULL; starts CLEAN at 0 dB
+void AudioFx_Init(AudioFx* fx, uint32_t sample_rate, int16_t* delay_mem);
+void AudioFx_SetPreset(AudioFx* fx, AudioFxPreset preset);     // clears the gate and echo state
+void AudioFx_SetGainDb(AudioFx* fx, int gain_db);
+const char* AudioFx_PresetName(AudioFxPreset preset);
+
+// In place; returns how many samples clipped
+uint32_t AudioFx_Process(AudioFx* fx, int16_t* buf, int n);
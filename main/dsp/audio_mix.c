@@ -0,0 +1,107 @@
+#include "dsp/audio_mix.h"
+#include "core/hot_path.h"
+
+#define RAMP_STEP   (32768 / AUDIO_MIX_RAMP_SAMPLES)
+
+void AudioMix_VoiceInit(AudioMixVoice* v, uint32_t src_rate, uint32_t out_rate, int16_t gain_q15)
+{
+    v->step_q16 = out_rate ? (uint32_t)(((uint64_t)src_rate << 16) / out_rate) : 1u << 16;
+    if (v->step_q16 == 0) v->step_q16 = 1;
+    // Starting one sample in puts the first output on src[0], not on `last`
+    v->pos_q16 = 1u << 16;
+    v->last = 0;
+    v->gain_q15 = 0;
+    v->target_q15 = gain_q15 < 0 ? 0 : gain_q15;
+}
+
+void AudioMix_SetTarget(AudioMixVoice* v, int16_t gain_q15)
+{
+    v->target_q15 = gain_q15 < 0 ? 0 : gain_q15;
+}
+
+bool AudioMix_IsSilent(const AudioMixVoice* v)
+{
+    return v->gain_q15 == 0 && v->target_q15 == 0;
+}
+
+// Interpolates between y[i] and y[i + 1], where y[0] is `last` and y[j] is
+// src[j - 1]. The difference of two int16 times a Q15 fraction fits int32.
+HOT_PATH int AudioMix_Resample(AudioMixVoice* v, const int16_t* src, int src_n, int16_t* out, int out_n,
+                               int* consumed)
+{
+    uint32_t pos = v->pos_q16;
+    const uint32_t step = v->step_q16;
+    const uint32_t n = src_n > 0 ? (uint32_t)src_n : 0;
+    int k = 0;
+
+    if (step == (1u << 16) && (pos & 0xFFFF) == 0) {
+        // Same rate: a straight copy
+        uint32_t i = pos >> 16;
+        if (i == 0 && out_n > 0) {
+            out[k++] = v->last;
+            i = 1;
+        }
+        while (k < out_n && i <= n) out[k++] = src[i++ - 1];
+        pos = i << 16;
+    } else {
+        int32_t prev = v->last;
+        while (k < out_n) {
+            uint32_t i = pos >> 16;
+            if (i >= n) break;
+            int32_t y0 = i ? src[i - 1] : prev;
+            int32_t y1 = src[i];
+            int32_t frac = (int32_t)((pos & 0xFFFF) >> 1);
+            out[k++] = (int16_t)(y0 + (((y1 - y0) * frac) >> 15));
+            pos += step;
+        }
+    }
+
+    uint32_t used = pos >> 16;
+    if (used > n) used = n;
+    if (used) v->last = src[used - 1];
+    v->pos_q16 = pos - (used << 16);
+    *consumed = (int)used;
+    return k;
+}
+
+HOT_PATH void AudioMix_Accumulate(AudioMixVoice* v, const int16_t* in, int32_t* acc, int n)
+{
+    int32_t g = v->gain_q15;
+    const int32_t t = v->target_q15;
+    int i = 0;
+
+    // Ramp one step per sample until the target is reached
+    for (; i < n && g != t; i++) {
+        if (g < t) g = g + RAMP_STEP > t ? t : g + RAMP_STEP;
+        else g = g - RAMP_STEP < t ? t : g - RAMP_STEP;
+        acc[i] += (in[i] * g) >> 15;
+    }
+    v->gain_q15 = (int16_t)g;
+    if (g == 0) return;
+
+    // Steady gain: a plain multiply-accumulate, four at a time
+    for (; i + 4 <= n; i += 4) {
+        acc[i] += (in[i] * g) >> 15;
+        acc[i + 1] += (in[i + 1] * g) >> 15;
+        acc[i + 2] += (in[i + 2] * g) >> 15;
+        acc[i + 3] += (in[i + 3] * g) >> 15;
+    }
+    for (; i < n; i++) acc[i] += (in[i] * g) >> 15;
+}
+
+HOT_PATH uint32_t AudioMix_Saturate(const int32_t* acc, int16_t* out, int n)
+{
+    uint32_t clipped = 0;
+    for (int i = 0; i < n; i++) {
+        int32_t s = acc[i];
+        if (s > INT16_MAX) {
+            s = INT16_MAX;
+            clipped++;
+        } else if (s < INT16_MIN) {
+            s = INT16_MIN;
+            clipped++;
+        }
+        out[i] = (int16_t)s;
+    }
+    return clipped;
+}
@@ -0,0 +1,41 @@
+#pragma once
+#include <stdbool.h>
+#include <stdint.h>
+
+// Per-voice building blocks of the speaker mixer (audio/audio_out.c). Pure C.
+//
+// A voice resamples its source to the output rate with linear interpolation
+// (a Q16 phase accumulator; the previous sample is kept, so sources can be
+// fed in spans of any length), then is scaled by a Q15 gain and summed into
+// an int32 block. The gain moves toward its target by a fixed slope, so
+// starts, stops and volume changes never step. One saturation per output
+// sample at the end turns the sum back into int16.
+//
+// There is no anti-alias filter: a source well above the output rate should
+// be band-limited before it gets here.
+
+#define AUDIO_MIX_RAMP_SAMPLES  256     // 0 -> full scale (16 ms at 16 kHz)
+#define AUDIO_MIX_UNITY_Q15     32767
+
+typedef struct {
+    uint32_t step_q16;      // source samples per output sample
+    uint32_t pos_q16;       // next output, relative to `last`
+    int16_t last;           // most recent source sample consumed
+    int16_t gain_q15;       // current
+    int16_t target_q15;
+} AudioMixVoice;
+
+// Starts silent and ramps up to gain_q15
+void AudioMix_VoiceInit(AudioMixVoice* v, uint32_t src_rate, uint32_t out_rate, int16_t gain_q15);
+void AudioMix_SetTarget(AudioMixVoice* v, int16_t gain_q15);
+bool AudioMix_IsSilent(const AudioMixVoice* v);     // at and heading to 0
+
+// Resamples from src (src_n samples) into out, up to out_n samples.
+// Returns the samples written; *consumed says how much of src was used up.
+int AudioMix_Resample(AudioMixVoice* v, const int16_t* src, int src_n, int16_t* out, int out_n, int* consumed);
+
+// acc[i] += in[i] * gain, ramping the gain toward its target
+void AudioMix_Accumulate(AudioMixVoice* v, const int16_t* in, int32_t* acc, int n);
+
+// Returns how many samples clipped
+uint32_t AudioMix_Saturate(const int32_t* acc, int16_t* out, int n);
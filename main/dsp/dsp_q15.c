@@ -0,0 +1,362 @@
+#include "dsp/dsp_q15.h"
+#include "core/hot_path.h"
+
+#include <math.h>
+#include <string.h>
+
+#define Q30_ONE         (1 << 30)
+#define POWER_DB_Q16    197283      // 10 * log10(2) in 1/65536 dB
+
+// log2(1 + i / 32) in Q16, plus the end point for the interpolation
+static const int32_t k_log2_q16[33] = {
+        0,  2909,  5732,  8473, 11136, 13727, 16248, 18704,
+    21098, 23433, 25711, 27936, 30109, 32234, 34312, 36346,
+    38336, 40286, 42196, 44068, 45904, 47705, 49472, 51207,
+    52911, 54584, 56229, 57845, 59434, 60997, 62534, 64047,
+    65536,
+};
+
+static inline int16_t sat16(int32_t v)
+{
+    if (v > 32767) return 32767;
+    if (v < -32768) return -32768;
+    return (int16_t)v;
+}
+
+static inline int32_t sat32(int64_t v)
+{
+    if (v > INT32_MAX) return INT32_MAX;
+    if (v < INT32_MIN) return INT32_MIN;
+    return (int32_t)v;
+}
+
+// -------------------- design --------------------
+
+static bool to_q30(double v, int32_t* out)
+{
+    double q = floor(v * Q30_ONE + 0.5);
+    if (q < -2.0 * Q30_ONE || q >= 2.0 * Q30_ONE) return false;
+    *out = (int32_t)q;
+    return true;
+}
+
+bool DspBiquad_Design(DspBiquadType type, uint32_t fs, uint32_t f0_hz, int q_x100, int gain_db_x10,
+                      DspBiquadCoef* out)
+{
+    if (fs == 0 || f0_hz == 0 || f0_hz * 2 >= fs || q_x100 <= 0) return false;
+
+    const double w0 = 2.0 * M_PI * f0_hz / fs;
+    const double cw = cos(w0);
+    const double alpha = sin(w0) / (2.0 * q_x100 / 100.0);
+    const double a = pow(10.0, gain_db_x10 / 400.0);
+    const double sq = 2.0 * sqrt(a) * alpha;
+    double b0, b1, b2, a0, a1, a2;
+
+    switch (type) {
+    case kDspBiquadLowPass:
+        b0 = (1.0 - cw) / 2.0;
+        b1 = 1.0 - cw;
+        b2 = b0;
+        a0 = 1.0 + alpha;
+        a1 = -2.0 * cw;
+        a2 = 1.0 - alpha;
+        break;
+    case kDspBiquadHighPass:
+        b0 = (1.0 + cw) / 2.0;
+        b1 = -(1.0 + cw);
+        b2 = b0;
+        a0 = 1.0 + alpha;
+        a1 = -2.0 * cw;
+        a2 = 1.0 - alpha;
+        break;
+    case kDspBiquadPeak:
+        b0 = 1.0 + alpha * a;
+        b1 = -2.0 * cw;
+        b2 = 1.0 - alpha * a;
+        a0 = 1.0 + alpha / a;
+        a1 = -2.0 * cw;
+        a2 = 1.0 - alpha / a;
+        break;
+    case kDspBiquadLowShelf:
+        b0 = a * ((a + 1.0) - (a - 1.0) * cw + sq);
+        b1 = 2.0 * a * ((a - 1.0) - (a + 1.0) * cw);
+        b2 = a * ((a + 1.0) - (a - 1.0) * cw - sq);
+        a0 = (a + 1.0) + (a - 1.0) * cw + sq;
+        a1 = -2.0 * ((a - 1.0) + (a + 1.0) * cw);
+        a2 = (a + 1.0) + (a - 1.0) * cw - sq;
+        break;
+    case kDspBiquadHighShelf:
+        b0 = a * ((a + 1.0) + (a - 1.0) * cw + sq);
+        b1 = -2.0 * a * ((a - 1.0) + (a + 1.0) * cw);
+        b2 = a * ((a + 1.0) + (a - 1.0) * cw - sq);
+        a0 = (a + 1.0) - (a - 1.0) * cw + sq;
+        a1 = 2.0 * ((a - 1.0) - (a + 1.0) * cw);
+        a2 = (a + 1.0) - (a - 1.0) * cw - sq;
+        break;
+    default:
+        return false;
+    }
+
+    return to_q30(b0 / a0, &out->b0) && to_q30(b1 / a0, &out->b1) && to_q30(b2 / a0, &out->b2) &&
+           to_q30(a1 / a0, &out->a1) && to_q30(a2 / a0, &out->a2);
+}
+
+static bool q30_to_q14(int32_t v, int16_t* out)
+{
+    int32_t r = (int32_t)(((int64_t)v + (1 << 15)) >> 16);
+    if (r < -32768 || r > 32767) return false;
+    *out = (int16_t)r;
+    return true;
+}
+
+bool DspBiquad_ToQ14(const DspBiquadCoef* c, DspBiquadQ15* out)
+{
+    memset(out, 0, sizeof(*out));
+    return q30_to_q14(c->b0, &out->b0) && q30_to_q14(c->b1, &out->b1) && q30_to_q14(c->b2, &out->b2) &&
+           q30_to_q14(c->a1, &out->a1) && q30_to_q14(c->a2, &out->a2);
+}
+
+int32_t DspBiquad_ResponseDbQ8(const DspBiquadCoef* c, int count, uint32_t fs, uint32_t f_hz)
+{
+    const double w = 2.0 * M_PI * f_hz / fs;
+    const double c1 = cos(w), s1 = -sin(w), c2 = cos(2.0 * w), s2 = -sin(2.0 * w);
+    double mag2 = 1.0;
+    for (int i = 0; i < count; i++) {
+        // H(e^jw) = (b0 + b1 z^-1 + b2 z^-2) / (1 + a1 z^-1 + a2 z^-2)
+        const double k = 1.0 / Q30_ONE;
+        double nr = c[i].b0 * k + c[i].b1 * k * c1 + c[i].b2 * k * c2;
+        double ni = c[i].b1 * k * s1 + c[i].b2 * k * s2;
+        double dr = 1.0 + c[i].a1 * k * c1 + c[i].a2 * k * c2;
+        double di = c[i].a1 * k * s1 + c[i].a2 * k * s2;
+        mag2 *= (nr * nr + ni * ni) / (dr * dr + di * di);
+    }
+    if (mag2 <= 0.0) return DSP_DB_FLOOR_Q8;
+    return (int32_t)floor(10.0 * log10(mag2) * 256.0 + 0.5);
+}
+
+// -------------------- biquad cascades --------------------
+
+bool DspCascadeQ15_Init(DspCascadeQ15* f, const DspBiquadCoef* c, int count)
+{
+    memset(f, 0, sizeof(*f));
+    if (count < 0 || count > DSP_BIQUAD_MAX_SECTIONS) return false;
+    for (int i = 0; i < count; i++) {
+        if (!DspBiquad_ToQ14(&c[i], &f->s[i])) return false;
+    }
+    f->count = (uint8_t)count;
+    return true;
+}
+
+bool DspCascadeQ31_Init(DspCascadeQ31* f, const DspBiquadCoef* c, int count)
+{
+    memset(f, 0, sizeof(*f));
+    if (count < 0 || count > DSP_BIQUAD_MAX_SECTIONS) return false;
+    for (int i = 0; i < count; i++) {
+        DspBiquadQ31* s = &f->s[i];
+        s->b0 = c[i].b0;
+        s->b1 = c[i].b1;
+        s->b2 = c[i].b2;
+        s->a1 = c[i].a1;
+        s->a2 = c[i].a2;
+    }
+    f->count = (uint8_t)count;
+    return true;
+}
+
+void DspCascadeQ15_Reset(DspCascadeQ15* f)
+{
+    for (int i = 0; i < f->count; i++) {
+        DspBiquadQ15* s = &f->s[i];
+        s->x1 = s->x2 = s->y1 = s->y2 = 0;
+    }
+}
+
+void DspCascadeQ31_Reset(DspCascadeQ31* f)
+{
+    for (int i = 0; i < f->count; i++) {
+        DspBiquadQ31* s = &f->s[i];
+        s->x1 = s->x2 = s->y1 = s->y2 = 0;
+    }
+}
+
+// One section over the whole block keeps its state in registers. The sum is
+// unsigned so a wrap on the way is defined; see the header for the bound.
+HOT_PATH static void biquad_q15(DspBiquadQ15* s, int16_t* buf, int n)
+{
+    const int32_t b0 = s->b0, b1 = s->b1, b2 = s->b2, a1 = s->a1, a2 = s->a2;
+    int32_t x1 = s->x1, x2 = s->x2, y1 = s->y1, y2 = s->y2;
+    for (int i = 0; i < n; i++) {
+        int32_t x = buf[i];
+        uint32_t acc = (uint32_t)(b0 * x) + (uint32_t)(b1 * x1) + (uint32_t)(b2 * x2) - (uint32_t)(a1 * y1) -
+                       (uint32_t)(a2 * y2) + (1u << 13);
+        int32_t y = sat16((int32_t)acc >> 14);
+        x2 = x1;
+        x1 = x;
+        y2 = y1;
+        y1 = y;
+        buf[i] = (int16_t)y;
+    }
+    s->x1 = (int16_t)x1;
+    s->x2 = (int16_t)x2;
+    s->y1 = (int16_t)y1;
+    s->y2 = (int16_t)y2;
+}
+
+HOT_PATH static void biquad_q31(DspBiquadQ31* s, int32_t* buf, int n)
+{
+    const int64_t b0 = s->b0, b1 = s->b1, b2 = s->b2, a1 = s->a1, a2 = s->a2;
+    int32_t x1 = s->x1, x2 = s->x2, y1 = s->y1, y2 = s->y2;
+    for (int i = 0; i < n; i++) {
+        int32_t x = buf[i];
+        int64_t acc = b0 * x + b1 * x1 + b2 * x2 - a1 * y1 - a2 * y2;
+        int32_t y = sat32((acc + (1 << 29)) >> 30);
+        x2 = x1;
+        x1 = x;
+        y2 = y1;
+        y1 = y;
+        buf[i] = y;
+    }
+    s->x1 = x1;
+    s->x2 = x2;
+    s->y1 = y1;
+    s->y2 = y2;
+}
+
+void DspCascadeQ15_Process(DspCascadeQ15* f, int16_t* buf, int n)
+{
+    for (int i = 0; i < f->count; i++) biquad_q15(&f->s[i], buf, n);
+}
+
+void DspCascadeQ31_Process(DspCascadeQ31* f, int32_t* buf, int n)
+{
+    for (int i = 0; i < f->count; i++) biquad_q31(&f->s[i], buf, n);
+}
+
+// -------------------- FIR --------------------
+
+HOT_PATH int32_t Dsp_DotQ15(const int16_t* a, const int16_t* b, int n)
+{
+    int32_t s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+        s0 += (int32_t)a[i] * b[i];
+        s1 += (int32_t)a[i + 1] * b[i + 1];
+        s2 += (int32_t)a[i + 2] * b[i + 2];
+        s3 += (int32_t)a[i + 3] * b[i + 3];
+    }
+    for (; i < n; i++) s0 += (int32_t)a[i] * b[i];
+    return s0 + s1 + s2 + s3;
+}
+
+void DspFirQ15_Init(DspFirQ15* f, const int16_t* h, int taps, int16_t* hist_mem)
+{
+    f->h = h;
+    f->hist = hist_mem;
+    f->taps = (uint16_t)taps;
+    f->pos = 0;
+    memset(hist_mem, 0, (size_t)taps * 2 * sizeof(int16_t));
+}
+
+HOT_PATH void DspFirQ15_Process(DspFirQ15* f, const int16_t* in, int16_t* out, int n)
+{
+    const int taps = f->taps;
+    int16_t* hist = f->hist;
+    int pos = f->pos;
+    for (int i = 0; i < n; i++) {
+        // Newest sample first: the window is hist[pos .. pos + taps)
+        pos = pos ? pos - 1 : taps - 1;
+        hist[pos] = in[i];
+        hist[pos + taps] = in[i];
+        int32_t acc = Dsp_DotQ15(hist + pos, f->h, taps);
+        out[i] = sat16((acc + (1 << 14)) >> 15);
+    }
+    f->pos = (uint16_t)pos;
+}
+
+// -------------------- block stats and logs --------------------
+
+// Two squares fit uint32, so pairs are summed before the 64-bit add
+HOT_PATH uint64_t Dsp_SumSquaresQ15(const int16_t* s, int n)
+{
+    uint64_t sum = 0;
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+        int32_t a = s[i], b = s[i + 1], c = s[i + 2], d = s[i + 3];
+        uint32_t p0 = (uint32_t)(a * a) + (uint32_t)(b * b);
+        uint32_t p1 = (uint32_t)(c * c) + (uint32_t)(d * d);
+        sum += (uint64_t)p0 + p1;
+    }
+    for (; i < n; i++) sum += (uint32_t)((int32_t)s[i] * s[i]);
+    return sum;
+}
+
+HOT_PATH int32_t Dsp_PeakQ15(const int16_t* s, int n)
+{
+    int32_t lo = 0, hi = 0;
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+        int32_t a = s[i] < s[i + 1] ? s[i] : s[i + 1];
+        int32_t b = s[i + 2] < s[i + 3] ? s[i + 2] : s[i + 3];
+        int32_t c = s[i] > s[i + 1] ? s[i] : s[i + 1];
+        int32_t d = s[i + 2] > s[i + 3] ? s[i + 2] : s[i + 3];
+        if (a < lo) lo = a;
+        if (b < lo) lo = b;
+        if (c > hi) hi = c;
+        if (d > hi) hi = d;
+    }
+    for (; i < n; i++) {
+        if (s[i] < lo) lo = s[i];
+        if (s[i] > hi) hi = s[i];
+    }
+    return -lo > hi ? -lo : hi;
+}
+
+uint32_t Dsp_Isqrt64(uint64_t x)
+{
+    uint64_t rem = x;
+    uint64_t root = 0;
+    uint64_t bit = 1ull << 62;
+    while (bit > x) bit >>= 2;
+    while (bit) {
+        if (rem >= root + bit) {
+            rem -= root + bit;
+            root = (root >> 1) + bit;
+        } else {
+            root >>= 1;
+        }
+        bit >>= 2;
+    }
+    return (uint32_t)root;
+}
+
+int32_t Dsp_RmsQ15(const int16_t* s, int n)
+{
+    if (n <= 0) return 0;
+    return (int32_t)Dsp_Isqrt64(Dsp_SumSquaresQ15(s, n) / (uint32_t)n);
+}
+
+// Integer part from the top bit; the next 5 bits pick a table entry and
+// 16 more interpolate between it and the next one
+int32_t Dsp_Log2Q16(uint64_t x)
+{
+    if (x <= 1) return 0;
+    int msb = 63 - __builtin_clzll(x);
+    uint32_t m = (uint32_t)(msb >= 31 ? x >> (msb - 31) : x << (31 - msb));
+    uint32_t idx = (m >> 26) & 31;
+    int32_t t = (int32_t)((m >> 10) & 0xFFFF);
+    int32_t lo = k_log2_q16[idx];
+    int32_t frac = lo + (int32_t)(((int64_t)(k_log2_q16[idx + 1] - lo) * t) >> 16);
+    return (msb << 16) + frac;
+}
+
+int32_t Dsp_PowerDbQ8(uint64_t p)
+{
+    if (p == 0) return DSP_DB_FLOOR_Q8;
+    return (int32_t)(((int64_t)Dsp_Log2Q16(p) * POWER_DB_Q16 + (1 << 23)) >> 24);
+}
+
+int32_t Dsp_AmpDbQ8(uint64_t a)
+{
+    if (a == 0) return DSP_DB_FLOOR_Q8;
+    return 2 * Dsp_PowerDbQ8(a);
+}
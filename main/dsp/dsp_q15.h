@@ -0,0 +1,111 @@
+#pragma once
+#include <stdbool.h>
+#include <stdint.h>
+
+// Fixed-point DSP kernels shared by the audio code: biquad cascades, FIR,
+// block RMS/peak and fast log2/dB. Pure C, no float in anything that runs
+// per sample; filter design uses double and belongs in control paths only.
+//
+// Two biquad flavours, both direct form I:
+//   Q15 - int16 samples, Q14 coefficients, int32 sums. Cheap; good for
+//         corners above ~fs/100 and gains up to +12 dB. The sum may wrap
+//         on the way, which two's complement forgives as long as the true
+//         output stays within 4x full scale, so keep the peak gain
+//         (overshoot included) under +12 dB.
+//   Q31 - int32 samples, Q30 coefficients, int64 sums. For low corners and
+//         long cascades: feed int16 data shifted up by 14 bits (keep samples
+//         within +-2^29 so five products fit int64) and the rounding noise
+//         stays far below the input LSB.
+// Every coefficient is in [-2, 2); y = b0 x + b1 x1 + b2 x2 - a1 y1 - a2 y2.
+//
+// The FIR and block loops are unrolled by four with independent
+// accumulators so the MAC pipeline stays busy. There is no PIE vector path:
+// the same source runs on the target and on Linux (host/golden_check.c,
+// host/host_microbench.c), and the DSP experiment measures it in cycles.
+
+#define DSP_BIQUAD_MAX_SECTIONS 4
+#define DSP_DB_FLOOR_Q8         (-200 * 256)    // what the dB helpers return for 0
+
+typedef enum {
+    kDspBiquadLowPass = 0,
+    kDspBiquadHighPass,
+    kDspBiquadPeak,
+    kDspBiquadLowShelf,
+    kDspBiquadHighShelf,
+} DspBiquadType;
+
+// Q30 coefficients as designed; convert for the Q15 cascade with DspBiquad_ToQ14
+typedef struct {
+    int32_t b0, b1, b2, a1, a2;
+} DspBiquadCoef;
+
+typedef struct {
+    int16_t b0, b1, b2, a1, a2;     // Q14
+    int16_t x1, x2, y1, y2;
+} DspBiquadQ15;
+
+typedef struct {
+    int32_t b0, b1, b2, a1, a2;     // Q30
+    int32_t x1, x2, y1, y2;
+} DspBiquadQ31;
+
+typedef struct {
+    DspBiquadQ15 s[DSP_BIQUAD_MAX_SECTIONS];
+    uint8_t count;
+} DspCascadeQ15;
+
+typedef struct {
+    DspBiquadQ31 s[DSP_BIQUAD_MAX_SECTIONS];
+    uint8_t count;
+} DspCascadeQ31;
+
+// RBJ cookbook designs. q_x100: 71 is Butterworth; gain only for peak and
+// shelves. false if f0 is not below Nyquist.
+bool DspBiquad_Design(DspBiquadType type, uint32_t fs, uint32_t f0_hz, int q_x100, int gain_db_x10,
+                      DspBiquadCoef* out);
+// Q30 -> Q14, rounded; false if a coefficient rounds up to 2
+bool DspBiquad_ToQ14(const DspBiquadCoef* c, DspBiquadQ15* out);
+// Magnitude at f_hz in 1/256 dB, for checks and UI
+int32_t DspBiquad_ResponseDbQ8(const DspBiquadCoef* c, int count, uint32_t fs, uint32_t f_hz);
+
+// Sections are copied in with their state cleared; false past the limit or
+// (Q15) for a coefficient out of range
+bool DspCascadeQ15_Init(DspCascadeQ15* f, const DspBiquadCoef* c, int count);
+bool DspCascadeQ31_Init(DspCascadeQ31* f, const DspBiquadCoef* c, int count);
+void DspCascadeQ15_Reset(DspCascadeQ15* f);
+void DspCascadeQ31_Reset(DspCascadeQ31* f);
+
+// In place; output saturates
+void DspCascadeQ15_Process(DspCascadeQ15* f, int16_t* buf, int n);
+void DspCascadeQ31_Process(DspCascadeQ31* f, int32_t* buf, int n);
+
+// -------------------- FIR --------------------
+// Taps are Q15 with sum |h| <= 1, which keeps every partial sum inside
+// int32. The history is stored twice so the newest `taps` samples are
+// always contiguous: one write per sample and no wrap inside the dot product.
+
+typedef struct {
+    const int16_t* h;       // h[0] applies to the newest sample
+    int16_t* hist;          // 2 * taps
+    uint16_t taps;
+    uint16_t pos;
+} DspFirQ15;
+
+void DspFirQ15_Init(DspFirQ15* f, const int16_t* h, int taps, int16_t* hist_mem);
+void DspFirQ15_Process(DspFirQ15* f, const int16_t* in, int16_t* out, int n);
+
+// sum a[i] * b[i] in Q30; same bound as the FIR (sum |b| <= 1 in Q15)
+int32_t Dsp_DotQ15(const int16_t* a, const int16_t* b, int n);
+
+// -------------------- block stats and logs --------------------
+
+uint64_t Dsp_SumSquaresQ15(const int16_t* s, int n);
+int32_t Dsp_PeakQ15(const int16_t* s, int n);          // max |s|, 0..32768
+int32_t Dsp_RmsQ15(const int16_t* s, int n);
+uint32_t Dsp_Isqrt64(uint64_t x);
+
+// log2(x) in Q16, within 0.0002; 0 for x <= 1
+int32_t Dsp_Log2Q16(uint64_t x);
+// 10 log10(p) and 20 log10(a) in 1/256 dB; DSP_DB_FLOOR_Q8 for 0
+int32_t Dsp_PowerDbQ8(uint64_t p);
+int32_t Dsp_AmpDbQ8(uint64_t a);
@@ -0,0 +1,311 @@
+#include "dsp/fft_q15.h"
+#include "core/hot_path.h"
+
+#include <math.h>
+#include <string.h>
+
+// sin(2 pi k / 1024) * 32767, k = 0..256 (first quadrant)
+static const int16_t k_sin_q15[257] = {
+        0,   201,   402,   603,   804,  1005,  1206,  1407,  1608,  1809,  2009,  2210,
+     2410,  2611,  2811,  3012,  3212,  3412,  3612,  3811,  4011,  4210,  4410,  4609,
+     4808,  5007,  5205,  5404,  5602,  5800,  5998,  6195,  6393,  6590,  6786,  6983,
+     7179,  7375,  7571,  7767,  7962,  8157,  8351,  8545,  8739,  8933,  9126,  9319,
+     9512,  9704,  9896, 10087, 10278, 10469, 10659, 10849, 11039, 11228, 11417, 11605,
+    11793, 11980, 12167, 12353, 12539, 12725, 12910, 13094, 13279, 13462, 13645, 13828,
+    14010, 14191, 14372, 14553, 14732, 14912, 15090, 15269, 15446, 15623, 15800, 15976,
+    16151, 16325, 16499, 16673, 16846, 17018, 17189, 17360, 17530, 17700, 17869, 18037,
+    18204, 18371, 18537, 18703, 18868, 19032, 19195, 19357, 19519, 19680, 19841, 20000,
+    20159, 20317, 20475, 20631, 20787, 20942, 21096, 21250, 21403, 21554, 21705, 21856,
+    22005, 22154, 22301, 22448, 22594, 22739, 22884, 23027, 23170, 23311, 23452, 23592,
+    23731, 23870, 24007, 24143, 24279, 24413, 24547, 24680, 24811, 24942, 25072, 25201,
+    25329, 25456, 25582, 25708, 25832, 25955, 26077, 26198, 26319, 26438, 26556, 26674,
+    26790, 26905, 27019, 27133, 27245, 27356, 27466, 27575, 27683, 27790, 27896, 28001,
+    28105, 28208, 28310, 28411, 28510, 28609, 28706, 28803, 28898, 28992, 29085, 29177,
+    29268, 29358, 29447, 29534, 29621, 29706, 29791, 29874, 29956, 30037, 30117, 30195,
+    30273, 30349, 30424, 30498, 30571, 30643, 30714, 30783, 30852, 30919, 30985, 31050,
+    31113, 31176, 31237, 31297, 31356, 31414, 31470, 31526, 31580, 31633, 31685, 31736,
+    31785, 31833, 31880, 31926, 31971, 32014, 32057, 32098, 32137, 32176, 32213, 32250,
+    32285, 32318, 32351, 32382, 32412, 32441, 32469, 32495, 32521, 32545, 32567, 32589,
+    32609, 32628, 32646, 32663, 32678, 32692, 32705, 32717, 32728, 32737, 32745, 32752,
+    32757, 32761, 32765, 32766, 32767,};
+
+// 10 * log10(1 + i / 256) in 1/256 dB
+static const uint16_t k_log_frac_q8[256] = {
+        0,     4,     9,    13,    17,    22,    26,    30,    34,    38,    43,    47,    51,    55,    59,    63,
+       67,    71,    76,    80,    84,    88,    92,    96,   100,   104,   108,   111,   115,   119,   123,   127,
+      131,   135,   139,   142,   146,   150,   154,   158,   161,   165,   169,   173,   176,   180,   184,   187,
+      191,   195,   198,   202,   206,   209,   213,   216,   220,   223,   227,   231,   234,   238,   241,   245,
+      248,   252,   255,   258,   262,   265,   269,   272,   276,   279,   282,   286,   289,   292,   296,   299,
+      302,   306,   309,   312,   315,   319,   322,   325,   328,   332,   335,   338,   341,   345,   348,   351,
+      354,   357,   360,   363,   367,   370,   373,   376,   379,   382,   385,   388,   391,   394,   397,   400,
+      403,   406,   410,   413,   415,   418,   421,   424,   427,   430,   433,   436,   439,   442,   445,   448,
+      451,   454,   457,   459,   462,   465,   468,   471,   474,   477,   479,   482,   485,   488,   491,   493,
+      496,   499,   502,   504,   507,   510,   513,   515,   518,   521,   524,   526,   529,   532,   534,   537,
+      540,   542,   545,   548,   550,   553,   556,   558,   561,   564,   566,   569,   571,   574,   577,   579,
+      582,   584,   587,   589,   592,   595,   597,   600,   602,   605,   607,   610,   612,   615,   617,   620,
+      622,   625,   627,   630,   632,   635,   637,   639,   642,   644,   647,   649,   652,   654,   656,   659,
+      661,   664,   666,   668,   671,   673,   675,   678,   680,   683,   685,   687,   690,   692,   694,   697,
+      699,   701,   704,   706,   708,   710,   713,   715,   717,   720,   722,   724,   726,   729,   731,   733,
+      735,   738,   740,   742,   744,   746,   749,   751,   753,   755,   758,   760,   762,   764,   766,   768,};
+
+#define LOG2_DB_Q16     197284      // 10 * log10(2) in 1/65536 dB
+#define AMP_EXP_DB_Q8   1541        // one bit of amplitude = 20 * log10(2) dB
+#define NORM_MAX        8191        // normalized input / no-shift stage limit
+
+static inline int16_t sin_q15(int idx)
+{
+    idx &= 1023;
+    if (idx < 256) return k_sin_q15[idx];
+    if (idx < 512) return k_sin_q15[512 - idx];
+    if (idx < 768) return (int16_t)-k_sin_q15[idx - 512];
+    return (int16_t)-k_sin_q15[1024 - idx];
+}
+
+static inline int16_t cos_q15(int idx)
+{
+    return sin_q15(idx + 256);
+}
+
+static int ilog2(int v)
+{
+    int r = 0;
+    while ((1 << (r + 1)) <= v) r++;
+    return r;
+}
+
+size_t FftQ15_MemBytes(int n)
+{
+    return (size_t)n * sizeof(int16_t) * 2;
+}
+
+bool FftQ15_Init(FftQ15* f, int n, void* mem)
+{
+    if (!f || !mem) return false;
+    if (n != 256 && n != 512 && n != 1024) return false;
+
+    f->n = n;
+    f->log2_half = ilog2(n / 2);
+    f->window = (int16_t*)mem;
+    f->work = f->window + n;
+
+    // Hann: (1 - cos(2 pi i / n)) / 2, straight from the sine table
+    int step = 1024 / n;
+    for (int i = 0; i < n; i++) {
+        int32_t w = (32768 - cos_q15(i * step) + 1) >> 1;
+        f->window[i] = (int16_t)(w > 32767 ? 32767 : w);
+    }
+
+    // Full-scale sine, Hann coherent gain 1/2: |X| = 32767 * n / 4
+    uint64_t amp = (uint64_t)32767 * (uint64_t)n / 4;
+    f->ref_db_q8 = FftQ15_DbQ8(amp * amp);
+    return true;
+}
+
+int32_t FftQ15_DbQ8(uint64_t p)
+{
+    if (p == 0) return FFT_Q15_DB_FLOOR;
+
+    int msb = 63 - __builtin_clzll(p);
+    uint32_t frac = (uint32_t)((msb >= 8) ? (p >> (msb - 8)) : (p << (8 - msb))) & 0xFF;
+    return (int32_t)(((int64_t)msb * LOG2_DB_Q16 + 128) >> 8) + k_log_frac_q8[frac];
+}
+
+int32_t FftQ15_BinDbfs(const FftQ15* f, uint32_t power, int exp)
+{
+    if (power == 0) return FFT_Q15_DB_FLOOR;
+    return FftQ15_DbQ8(power) + exp * AMP_EXP_DB_Q8 - f->ref_db_q8;
+}
+
+// Window, then scale so the largest value is just under NORM_MAX.
+// Returns the amplitude exponent of the scaling.
+HOT_PATH static int window_in(const FftQ15* f, const int16_t* in)
+{
+    int32_t peak = 0;
+    for (int i = 0; i < f->n; i++) {
+        int32_t v = (int32_t)in[i] * f->window[i];
+        if (v < 0) v = -v;
+        if (v > peak) peak = v;
+    }
+
+    // Largest sh with peak * 2^(sh - 15) <= NORM_MAX; the product is at
+    // most 2^30, so sh ends up in -2..14
+    const int64_t limit = (int64_t)NORM_MAX << 15;
+    int sh = 14;
+    while (sh > -2 && (sh >= 0 ? (int64_t)peak << sh : (int64_t)peak >> -sh) > limit) sh--;
+
+    int rshift = 15 - sh;
+    int32_t round = (int32_t)1 << (rshift - 1);
+    for (int i = 0; i < f->n; i++) {
+        int32_t v = (int32_t)in[i] * f->window[i];
+        f->work[i] = (int16_t)((v + round) >> rshift);
+    }
+    return -sh;
+}
+
+static void bit_reverse(int16_t* z, int m, int bits)
+{
+    for (int i = 0; i < m; i++) {
+        int r = 0;
+        for (int b = 0; b < bits; b++) r |= ((i >> b) & 1) << (bits - 1 - b);
+        if (r > i) {
+            int16_t tr = z[2 * i];
+            int16_t ti = z[2 * i + 1];
+            z[2 * i] = z[2 * r];
+            z[2 * i + 1] = z[2 * r + 1];
+            z[2 * r] = tr;
+            z[2 * r + 1] = ti;
+        }
+    }
+}
+
+static int32_t max_abs(const int16_t* v, int count)
+{
+    int32_t m = 0;
+    for (int i = 0; i < count; i++) {
+        int32_t a = v[i] < 0 ? -v[i] : v[i];
+        if (a > m) m = a;
+    }
+    return m;
+}
+
+// One radix-2 DIT stage of span len over m complex points, returns the
+// largest |component| written. A stage runs unshifted only when its input
+// components are <= NORM_MAX (magnitude <= 11585), so magnitudes stay under
+// 23170 either way and nothing saturates.
+HOT_PATH static int32_t fft_stage(int16_t* z, int m, int len, int shift)
+{
+    int half = len >> 1;
+    int tw_step = 1024 / len;
+    int32_t peak = 0;
+
+    for (int j = 0; j < half; j++) {
+        int32_t c = cos_q15(j * tw_step);
+        int32_t s = sin_q15(j * tw_step);
+
+        for (int i = j; i < m; i += len) {
+            int16_t* a = z + 2 * i;
+            int16_t* b = z + 2 * (i + half);
+
+            // b * exp(-i theta)
+            int32_t tr = ((int32_t)b[0] * c + (int32_t)b[1] * s + 0x4000) >> 15;
+            int32_t ti = ((int32_t)b[1] * c - (int32_t)b[0] * s + 0x4000) >> 15;
+
+            int32_t ar = a[0];
+            int32_t ai = a[1];
+            int32_t r0 = (ar + tr) >> shift;
+            int32_t i0 = (ai + ti) >> shift;
+            int32_t r1 = (ar - tr) >> shift;
+            int32_t i1 = (ai - ti) >> shift;
+
+            a[0] = (int16_t)r0;
+            a[1] = (int16_t)i0;
+            b[0] = (int16_t)r1;
+            b[1] = (int16_t)i1;
+
+            if (r0 < 0) r0 = -r0;
+            if (i0 < 0) i0 = -i0;
+            if (r1 < 0) r1 = -r1;
+            if (i1 < 0) i1 = -i1;
+            if (r0 > peak) peak = r0;
+            if (i0 > peak) peak = i0;
+            if (r1 > peak) peak = r1;
+            if (i1 > peak) peak = i1;
+        }
+    }
+    return peak;
+}
+
+// Unpack the n/2-point complex FFT of the even/odd packed input into the
+// real spectrum, one extra halving for headroom
+HOT_PATH static void split_power(const FftQ15* f, uint32_t* power)
+{
+    const int16_t* z = f->work;
+    int m = f->n / 2;
+    int tw_step = 1024 / f->n;
+
+    for (int k = 0; k <= m; k++) {
+        int ka = (k == m) ? 0 : k;
+        int kb = (k == 0) ? 0 : m - k;
+
+        int32_t ar = z[2 * ka];
+        int32_t ai = z[2 * ka + 1];
+        int32_t br = z[2 * kb];
+        int32_t bi = -z[2 * kb + 1];        // conj
+
+        int32_t er = ar + br;
+        int32_t ei = ai + bi;
+        int32_t or_ = ar - br;
+        int32_t oi = ai - bi;
+
+        int32_t c = cos_q15(k * tw_step);
+        int32_t s = sin_q15(k * tw_step);
+
+        int32_t xr = (er + ((c * oi + 0x4000) >> 15) - ((s * or_ + 0x4000) >> 15)) >> 2;
+        int32_t xi = (ei - ((c * or_ + 0x4000) >> 15) - ((s * oi + 0x4000) >> 15)) >> 2;
+
+        power[k] = (uint32_t)(xr * xr) + (uint32_t)(xi * xi);
+    }
+}
+
+int FftQ15_Power(FftQ15* f, const int16_t* in, uint32_t* power)
+{
+    int m = f->n / 2;
+    int exp = window_in(f, in);
+
+    bit_reverse(f->work, m, f->log2_half);
+
+    int32_t peak = max_abs(f->work, f->n);
+    for (int len = 2; len <= m; len <<= 1) {
+        int shift = peak > NORM_MAX ? 1 : 0;
+        peak = fft_stage(f->work, m, len, shift);
+        exp += shift;
+    }
+
+    split_power(f, power);
+    return exp + 1;
+}
+
+void FftQ15_LogBandEdges(int n, int sample_rate, int f_lo, int f_hi, int count, uint16_t* edges)
+{
+    int nyq_bin = n / 2;
+    float ratio = (float)f_hi / (float)f_lo;
+
+    for (int i = 0; i <= count; i++) {
+        float hz = (float)f_lo * powf(ratio, (float)i / (float)count);
+        int bin = (int)(hz * (float)n / (float)sample_rate + 0.5f);
+        if (bin < 1) bin = 1;
+        if (i > 0 && bin <= edges[i - 1]) bin = edges[i - 1] + 1;
+        if (bin > nyq_bin + 1) bin = nyq_bin + 1;
+        edges[i] = (uint16_t)bin;
+    }
+}
+
+void FftQ15_BandsDbfs(const FftQ15* f, const uint32_t* power, int exp, const uint16_t* edges, int count,
+                      int32_t* out_q8)
+{
+    for (int b = 0; b < count; b++) {
+        uint64_t sum = 0;
+        for (int k = edges[b]; k < edges[b + 1] && k <= f->n / 2; k++) sum += power[k];
+        out_q8[b] = sum ? FftQ15_DbQ8(sum) + exp * AMP_EXP_DB_Q8 - f->ref_db_q8 : FFT_Q15_DB_FLOOR;
+    }
+}
+
+int FftQ15_PeakHz(const FftQ15* f, const uint32_t* power, int sample_rate, int min_bin)
+{
+    int m = f->n / 2;
+    if (min_bin < 1) min_bin = 1;
+
+    int best = min_bin;
+    for (int k = min_bin + 1; k < m; k++) {
+        if (power[k] > power[best]) best = k;
+    }
+    if (power[best] == 0) return 0;
+
+    int32_t a = FftQ15_DbQ8(power[best - 1]);
+    int32_t b = FftQ15_DbQ8(power[best]);
+    int32_t c = FftQ15_DbQ8(power[best + 1]);
+    int32_t den = a - 2 * b + c;
+    int32_t delta_q8 = den < 0 ? (128 * (a - c)) / den : 0;     // -128..128 bins/256
+
+    return (int)((((int64_t)best * 256 + delta_q8) * sample_rate / f->n + 128) >> 8);
+}
@@ -0,0 +1,50 @@
+#pragma once
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Fixed-point real FFT for spectrum display. Pure C, bit-exact between the
+// target and the host tools (integer arithmetic and constant tables only).
+//
+// n real samples (256, 512 or 1024) are Hann windowed, normalized to 13 bits
+// and packed as n/2 complex points. A radix-2 complex FFT follows, with block
+// floating point: a stage halves its outputs only when its input could
+// overflow. A split pass then unpacks the n/2 + 1 bins of the real spectrum.
+// Bins come out as power in fixed point plus one shared exponent:
+// |X[k]| = sqrt(power[k]) * 2^exp.
+//
+// Levels are in 1/256 dB from a log2 lookup table. A "dBFS" level is
+// relative to a full-scale int16 sine at that bin.
+
+#define FFT_Q15_MIN_N       256
+#define FFT_Q15_MAX_N       1024
+#define FFT_Q15_DB_FLOOR    (-200 * 256)
+
+typedef struct {
+    int n;              // real input length
+    int log2_half;      // log2(n / 2), number of FFT stages
+    int32_t ref_db_q8;  // level of a full-scale sine's peak bin
+    int16_t* window;    // n, Hann in Q15
+    int16_t* work;      // n: n/2 complex points as (re, im)
+} FftQ15;
+
+// Memory for FftQ15_Init, 4-byte aligned
+size_t FftQ15_MemBytes(int n);
+bool FftQ15_Init(FftQ15* f, int n, void* mem);
+
+// power[0..n/2] (n/2 + 1 entries). Returns exp.
+int FftQ15_Power(FftQ15* f, const int16_t* in, uint32_t* power);
+
+// 10 * log10(p) in 1/256 dB, FFT_Q15_DB_FLOOR for 0
+int32_t FftQ15_DbQ8(uint64_t p);
+int32_t FftQ15_BinDbfs(const FftQ15* f, uint32_t power, int exp);
+
+// count log-spaced bands between f_lo and f_hi. Band i covers bins
+// [edges[i], edges[i + 1]), so edges holds count + 1 entries. Every band
+// gets at least one bin.
+void FftQ15_LogBandEdges(int n, int sample_rate, int f_lo, int f_hi, int count, uint16_t* edges);
+void FftQ15_BandsDbfs(const FftQ15* f, const uint32_t* power, int exp, const uint16_t* edges, int count,
+                      int32_t* out_q8);
+
+// Strongest bin at or above min_bin, refined by parabolic interpolation of the dB levels
+int FftQ15_PeakHz(const FftQ15* f, const uint32_t* power, int sample_rate, int min_bin);
@@ -0,0 +1,111 @@
+#include "dsp/ima_adpcm.h"
+#include "core/hot_path.h"
+
+static const int16_t k_step[89] = {
+        7,     8,     9,    10,    11,    12,    13,    14,    16,    17,    19,    21,    23,    25,    28,
+       31,    34,    37,    41,    45,    50,    55,    60,    66,    73,    80,    88,    97,   107,   118,
+      130,   143,   157,   173,   190,   209,   230,   253,   279,   307,   337,   371,   408,   449,   494,
+      544,   598,   658,   724,   796,   876,   963,  1060,  1166,  1282,  1411,  1552,  1707,  1878,  2066,
+     2272,  2499,  2749,  3024,  3327,  3660,  4026,  4428,  4871,  5358,  5894,  6484,  7132,  7845,  8630,
+     9493, 10442, 11487, 12635, 13899, 15289, 16818, 18500, 20350, 22385, 24623, 27086, 29794, 32767,
+};
+
+static const int8_t k_index_adj[8] = { -1, -1, -1, -1, 2, 4, 6, 8 };
+
+void ImaAdpcm_Init(ImaAdpcmState* st)
+{
+    st->predictor = 0;
+    st->index = 0;
+}
+
+static inline int clamp_index(int i)
+{
+    return i < 0 ? 0 : i > 88 ? 88 : i;
+}
+
+static inline int32_t clamp16(int32_t v)
+{
+    return v > INT16_MAX ? INT16_MAX : v < INT16_MIN ? INT16_MIN : v;
+}
+
+// Reconstructs the difference exactly as the decoder will, so both sides
+// track the same predictor
+HOT_PATH static uint8_t encode_one(int32_t* pred, int* index, int32_t sample)
+{
+    int32_t step = k_step[*index];
+    int32_t diff = sample - *pred;
+    uint8_t nib = 0;
+    if (diff < 0) {
+        nib = 8;
+        diff = -diff;
+    }
+
+    int32_t vpdiff = step >> 3;
+    if (diff >= step) {
+        nib |= 4;
+        diff -= step;
+        vpdiff += step;
+    }
+    step >>= 1;
+    if (diff >= step) {
+        nib |= 2;
+        diff -= step;
+        vpdiff += step;
+    }
+    step >>= 1;
+    if (diff >= step) {
+        nib |= 1;
+        vpdiff += step;
+    }
+
+    *pred = clamp16((nib & 8) ? *pred - vpdiff : *pred + vpdiff);
+    *index = clamp_index(*index + k_index_adj[nib & 7]);
+    return nib;
+}
+
+HOT_PATH static int32_t decode_one(int32_t pred, int* index, uint8_t nib)
+{
+    int32_t step = k_step[*index];
+    int32_t vpdiff = step >> 3;
+    if (nib & 4) vpdiff += step;
+    if (nib & 2) vpdiff += step >> 1;
+    if (nib & 1) vpdiff += step >> 2;
+
+    *index = clamp_index(*index + k_index_adj[nib & 7]);
+    return clamp16((nib & 8) ? pred - vpdiff : pred + vpdiff);
+}
+
+void ImaAdpcm_EncodeBlock(ImaAdpcmState* st, const int16_t* in, uint8_t* out)
+{
+    int32_t pred = in[0];
+    int index = st->index;
+
+    out[0] = (uint8_t)(pred & 0xFF);
+    out[1] = (uint8_t)((pred >> 8) & 0xFF);
+    out[2] = (uint8_t)index;
+    out[3] = 0;
+
+    for (int i = 0; i < IMA_ADPCM_BLOCK_BYTES - 4; i++) {
+        uint8_t lo = encode_one(&pred, &index, in[1 + i * 2]);
+        uint8_t hi = encode_one(&pred, &index, in[2 + i * 2]);
+        out[4 + i] = (uint8_t)(lo | (hi << 4));
+    }
+
+    st->predictor = (int16_t)pred;
+    st->index = (uint8_t)index;
+}
+
+void ImaAdpcm_DecodeBlock(const uint8_t* in, int16_t* out)
+{
+    int32_t pred = (int16_t)(in[0] | (in[1] << 8));
+    int index = clamp_index(in[2]);
+
+    out[0] = (int16_t)pred;
+    for (int i = 0; i < IMA_ADPCM_BLOCK_BYTES - 4; i++) {
+        uint8_t b = in[4 + i];
+        pred = decode_one(pred, &index, b & 0x0F);
+        out[1 + i * 2] = (int16_t)pred;
+        pred = decode_one(pred, &index, b >> 4);
+        out[2 + i * 2] = (int16_t)pred;
+    }
+}
@@ -0,0 +1,25 @@
+#pragma once
+#include <stdint.h>
+
+// IMA-ADPCM (4 bits per sample) in the WAV mono block layout: a 4-byte header
+// holding the first sample and the step index, then two samples per byte,
+// low nibble first. A 256-byte block carries 505 samples (~3.95:1). Pure C.
+//
+// Blocks decode on their own, so a stream can be cut or resumed at any block
+// boundary; the encoder carries its step index across blocks.
+
+#define IMA_ADPCM_BLOCK_BYTES    256
+#define IMA_ADPCM_BLOCK_SAMPLES  (1 + (IMA_ADPCM_BLOCK_BYTES - 4) * 2)
+
+typedef struct {
+    int16_t predictor;
+    uint8_t index;          // step table index, 0..88
+} ImaAdpcmState;
+
+void ImaAdpcm_Init(ImaAdpcmState* st);
+
+// in: IMA_ADPCM_BLOCK_SAMPLES samples, out: IMA_ADPCM_BLOCK_BYTES bytes
+void ImaAdpcm_EncodeBlock(ImaAdpcmState* st, const int16_t* in, uint8_t* out);
+
+// in: IMA_ADPCM_BLOCK_BYTES bytes, out: IMA_ADPCM_BLOCK_SAMPLES samples
+void ImaAdpcm_DecodeBlock(const uint8_t* in, int16_t* out);
@@ -0,0 +1,50 @@
+#include "dsp/mic_convert.h"
+#include "core/hot_path.h"
+
+#define MIC_CONVERT_FRAC    4           // extra state bits against leak rounding bias
+#define MIC_CONVERT_SHIFT   7           // 24-bit -> int16 scale, as MicLevels_Condition
+
+bool MicConvert_Init(MicConvert* c, int pole_shift, int decim)
+{
+    if (!c || pole_shift < 1 || pole_shift > 15) return false;
+    if (decim != 1 && decim != 2 && decim != 4) return false;
+
+    c->x1 = 0;
+    c->y1 = 0;
+    c->pole_shift = (uint8_t)pole_shift;
+    c->decim = (uint8_t)decim;
+    c->out_shift = (uint8_t)(MIC_CONVERT_FRAC + MIC_CONVERT_SHIFT + (decim == 4 ? 2 : decim == 2 ? 1 : 0));
+    return true;
+}
+
+// The recurrence is serial, so this is one tight loop with the state in
+// registers rather than SIMD: load, shift, subtract, leak, accumulate and one
+// clamp per output. y stays below 2^29 for any 24-bit input.
+HOT_PATH uint32_t MicConvert_Process(MicConvert* c, const int32_t* raw, int16_t* out, uint32_t n_in)
+{
+    const int k = c->pole_shift;
+    const int sh = c->out_shift;
+    const int32_t round = 1 << (sh - 1);
+    const uint32_t decim = c->decim;
+    const uint32_t n_out = n_in / decim;
+    int32_t x1 = c->x1;
+    int32_t y = c->y1;
+
+    for (uint32_t o = 0; o < n_out; o++) {
+        int32_t acc = 0;
+        for (uint32_t j = 0; j < decim; j++) {
+            int32_t x = *raw++ >> 8;
+            y += ((x - x1) << MIC_CONVERT_FRAC) - (y >> k);
+            x1 = x;
+            acc += y;
+        }
+        int32_t v = (acc + round) >> sh;
+        if (v > INT16_MAX) v = INT16_MAX;
+        if (v < INT16_MIN) v = INT16_MIN;
+        out[o] = (int16_t)v;
+    }
+
+    c->x1 = x1;
+    c->y1 = y;
+    return n_out;
+}
@@ -0,0 +1,29 @@
+#pragma once
+#include <stdbool.h>
+#include <stdint.h>
+
+// Streaming front end for the INMP441: 24-bit samples left aligned in 32-bit
+// I2S words -> DC-free int16, in one pass over the DMA buffer. Pure C.
+//
+// The DC blocker is a one-pole high-pass, y[n] = x[n] - x[n-1] + a * y[n-1]
+// with a = 1 - 2^-pole_shift, so its state carries across blocks and there
+// is no step at block boundaries. Optional decimation by 2 or 4 averages
+// each group of outputs (a boxcar; good enough for level and spectrum work).
+// Output scale matches MicLevels_Condition (sample >> 7).
+
+#define MIC_CONVERT_POLE_SHIFT  10      // ~2.5 Hz corner at 16 kHz
+#define MIC_CONVERT_MAX_DECIM   4
+
+typedef struct {
+    int32_t x1;             // previous input, 24-bit scale
+    int32_t y1;             // high-pass state, 24-bit scale with 4 fraction bits
+    uint8_t pole_shift;
+    uint8_t decim;          // 1, 2 or 4
+    uint8_t out_shift;
+} MicConvert;
+
+// false for an unsupported decim or pole_shift (1..15)
+bool MicConvert_Init(MicConvert* c, int pole_shift, int decim);
+
+// n_in must be a multiple of decim. Returns the n_in / decim samples written.
+uint32_t MicConvert_Process(MicConvert* c, const int32_t* raw, int16_t* out, uint32_t n_in);
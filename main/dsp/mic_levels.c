@@ -0,0 +1,120 @@
+#include "dsp/mic_levels.h"
+#include "dsp/dsp_q15.h"
+#include "core/hot_path.h"
+
+#include <math.h>
+#include <stddef.h>
+
+#define FULL_SCALE_DB_Q8    23120       // 20 * log10(32768)
+#define GOERTZEL_FRAC       4
+
+static const int k_centers[MIC_LEVELS_BANDS] = { 63, 125, 250, 500, 1000, 2000, 3000, 4000, 6000, 8000 };
+
+// Goertzel 2 cos(w) per band in Q30, redone only when the rate changes
+static int32_t s_coef_q30[MIC_LEVELS_BANDS];
+static int s_coef_rate = 0;
+
+// (db_q8 - lo) mapped onto 0..100 over span_db, rounded
+static int db_to_pct(int32_t db_q8, int lo_db, int span_db)
+{
+    int32_t v = db_q8 - lo_db * 256;
+    if (v <= 0) return 0;
+    int32_t pct = (v * 100 + span_db * 128) / (span_db * 256);
+    return pct > 100 ? 100 : (int)pct;
+}
+
+HOT_PATH void MicLevels_Condition(const int32_t* raw, int n, int16_t* out)
+{
+    if (!raw || !out || n <= 0) return;
+
+    int64_t sum = 0;
+    for (int i = 0; i < n; i++) {
+        int32_t v = raw[i] >> 8; // 24-bit signed
+        sum += v;
+    }
+    int32_t mean = (int32_t)(sum / n);
+
+    for (int i = 0; i < n; i++) {
+        int32_t v = (raw[i] >> 8) - mean;
+        out[i] = (int16_t)(v >> 7);
+    }
+}
+
+int MicLevels_ZeroCrossHz(const int16_t* s, int n, int sample_rate)
+{
+    if (!s || n < 4) return 0;
+
+    int crossings = 0;
+    int prev = s[0];
+    for (int i = 1; i < n; i++) {
+        int cur = s[i];
+        if ((prev <= 0 && cur > 0) || (prev >= 0 && cur < 0)) crossings++;
+        prev = cur;
+    }
+
+    // crossings / 2 cycles over n / sample_rate seconds, rounded
+    int64_t freq = ((int64_t)crossings * sample_rate + n) / (2 * (int64_t)n);
+    return freq > 20000 ? 20000 : (int)freq;
+}
+
+int MicLevels_VolumePct(const int16_t* s, int n)
+{
+    if (!s || n <= 0) return 0;
+
+    uint64_t mean_sq = Dsp_SumSquaresQ15(s, n) / (uint32_t)n;
+    if (mean_sq == 0) return 0;
+    return db_to_pct(Dsp_PowerDbQ8(mean_sq) - FULL_SCALE_DB_Q8, -50, 50);
+}
+
+static void update_coefs(int sample_rate)
+{
+    if (sample_rate == s_coef_rate) return;
+    for (int b = 0; b < MIC_LEVELS_BANDS; b++) {
+        double w = 2.0 * M_PI * k_centers[b] / sample_rate;
+        double c = floor(2.0 * cos(w) * (1 << 30) + 0.5);
+        s_coef_q30[b] = c >= 2147483647.0 ? INT32_MAX : (int32_t)c;
+    }
+    s_coef_rate = sample_rate;
+}
+
+HOT_PATH void MicLevels_OctaveBands(const int16_t* s, int n, int sample_rate, int* out_levels, int out_count)
+{
+    if (!s || n <= 0 || !out_levels || out_count <= 0) return;
+    if (out_count > MIC_LEVELS_BANDS) out_count = MIC_LEVELS_BANDS;
+
+    update_coefs(sample_rate);
+
+    // Input carries 4 fraction bits through the recursion so its rounding
+    // stays under the quiet bands. The state grows to about n * amplitude / 2,
+    // which keeps it in int32 for windows up to 4K samples.
+    for (int b = 0; b < out_count; b++) {
+        const int64_t coeff = s_coef_q30[b];
+        int32_t q1 = 0;
+        int32_t q2 = 0;
+
+        for (int i = 0; i < n; i++) {
+            int32_t q0 = (int32_t)((coeff * q1 + (1 << 29)) >> 30) - q2 + s[i] * (1 << GOERTZEL_FRAC);
+            q2 = q1;
+            q1 = q0;
+        }
+
+        int64_t mag = (int64_t)q1 * q1 + (int64_t)q2 * q2 - (((coeff * q1 + (1 << 29)) >> 30) * q2);
+        if (mag < 0) mag = 0;
+        out_levels[b] = db_to_pct(Dsp_PowerDbQ8(((uint64_t)mag >> (2 * GOERTZEL_FRAC)) + 1), 20, 40);
+    }
+}
+
+int MicLevels_BandCenterHz(int band)
+{
+    if (band < 0 || band >= MIC_LEVELS_BANDS) return 0;
+    return k_centers[band];
+}
+
+int MicLevels_PeakBandHz(const int* bands, int band_count)
+{
+    int best = 0;
+    for (int i = 1; i < band_count; i++) {
+        if (bands[i] > bands[best]) best = i;
+    }
+    return k_centers[best];
+}
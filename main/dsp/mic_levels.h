@@ -0,0 +1,18 @@
+#pragma once
+#include <stdint.h>
+
+// Level analysis behind the MIC page: sample conditioning, RMS volume,
+// zero-crossing pitch and Goertzel octave bands. Pure C.
+
+#define MIC_LEVELS_BANDS 10
+
+// INMP441 words (24 bits, left aligned in 32) to DC-free int16
+void MicLevels_Condition(const int32_t* raw, int n, int16_t* out);
+
+int MicLevels_VolumePct(const int16_t* s, int n);                // -50..0 dBFS -> 0..100
+int MicLevels_ZeroCrossHz(const int16_t* s, int n, int sample_rate);
+
+// One Goertzel per band centre, mapped to 0..100 (20..60 dB)
+void MicLevels_OctaveBands(const int16_t* s, int n, int sample_rate, int* out_levels, int out_count);
+int MicLevels_BandCenterHz(int band);
+int MicLevels_PeakBandHz(const int* bands, int band_count);
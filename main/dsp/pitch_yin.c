@@ -0,0 +1,195 @@
+#include "dsp/pitch_yin.h"
+#include "core/hot_path.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+static int ceil_log2(uint32_t v)
+{
+    int n = 0;
+    while ((1u << n) < v) n++;
+    return n;
+}
+
+size_t PitchYin_MemBytes(int window, int tau_max)
+{
+    size_t scaled = ((size_t)(window + tau_max) * sizeof(int16_t) + 3) & ~(size_t)3;
+    return scaled + (size_t)(tau_max + 2) * sizeof(uint32_t);
+}
+
+bool PitchYin_Init(PitchYin* p, int sample_rate, int window, int f_min_hz, int f_max_hz, void* mem)
+{
+    if (!p || !mem || sample_rate <= 0 || f_min_hz <= 0 || f_max_hz <= f_min_hz) return false;
+    if (window < 32 || window > PITCH_YIN_MAX_WINDOW) return false;
+
+    p->sample_rate = sample_rate;
+    p->window = window;
+    p->tau_min = sample_rate / f_max_hz;
+    p->tau_max = (sample_rate + f_min_hz - 1) / f_min_hz;
+    if (p->tau_min < 2) p->tau_min = 2;
+    if (p->tau_max <= p->tau_min + 2) return false;
+
+    size_t scaled = ((size_t)(window + p->tau_max) * sizeof(int16_t) + 3) & ~(size_t)3;
+    p->scaled = (int16_t*)mem;
+    p->dn = (uint32_t*)((uint8_t*)mem + scaled);
+    return true;
+}
+
+int PitchYin_FrameSamples(const PitchYin* p)
+{
+    return p->window + p->tau_max;
+}
+
+// Scales the frame so |x| < 2^peak_bits: then window * (2 * 2^peak_bits)^2
+// stays below 2^32 for every difference sum. Returns the input peak.
+static int scale_frame(PitchYin* p, const int16_t* in, int n)
+{
+    int peak = 0;
+    for (int i = 0; i < n; i++) {
+        int a = abs(in[i]);
+        if (a > peak) peak = a;
+    }
+    if (peak == 0) return 0;
+
+    int peak_bits = (30 - ceil_log2((uint32_t)p->window)) / 2;
+    int bits = 32 - __builtin_clz((uint32_t)peak);     // peak < 2^bits
+    int shift = bits - peak_bits;
+
+    if (shift > 0) {
+        for (int i = 0; i < n; i++) p->scaled[i] = (int16_t)(in[i] >> shift);
+    } else {
+        for (int i = 0; i < n; i++) p->scaled[i] = (int16_t)(in[i] * (1 << -shift));
+    }
+    return peak;
+}
+
+HOT_PATH static uint32_t diff_at(const int16_t* x, int window, int tau)
+{
+    const int16_t* y = x + tau;
+    uint32_t acc = 0;
+    for (int j = 0; j < window; j++) {
+        int32_t d = x[j] - y[j];
+        acc += (uint32_t)(d * d);
+    }
+    return acc;
+}
+
+static inline uint32_t norm_q15(uint32_t d, int tau, uint64_t sum)
+{
+    if (sum == 0) return 1u << 15;
+    return (uint32_t)(((uint64_t)d * (uint64_t)tau << 15) / sum);
+}
+
+bool PitchYin_Estimate(PitchYin* p, const int16_t* frame, PitchYinResult* out)
+{
+    PitchYinResult r = { 0, 0, 0 };
+    uint32_t* dn = p->dn;
+
+    if (scale_frame(p, frame, PitchYin_FrameSamples(p)) < PITCH_YIN_MIN_PEAK) {
+        if (out) *out = r;
+        return false;
+    }
+
+    uint64_t sum = 0;
+    int best = 0;
+    bool dipped = false;
+    dn[0] = 1u << 15;
+
+    int tau = 1;
+    for (; tau <= p->tau_max; tau++) {
+        uint32_t d = diff_at(p->scaled, p->window, tau);
+        sum += d;
+        dn[tau] = norm_q15(d, tau, sum);
+
+        if (dipped) {
+            // Follow the dip to its bottom, then stop
+            if (dn[tau] >= dn[tau - 1]) {
+                best = tau - 1;
+                break;
+            }
+        } else if (tau >= p->tau_min && dn[tau] < PITCH_YIN_THRESHOLD_Q15) {
+            dipped = true;
+        }
+    }
+    r.lags = (uint16_t)(tau > p->tau_max ? p->tau_max : tau);
+    if (dipped && best == 0) best = p->tau_max;
+
+    if (!dipped) {
+        if (out) *out = r;
+        return false;
+    }
+
+    // Parabola through the raw differences around the dip (the normalized
+    // curve is skewed by its running mean), offset in 1/256 sample
+    int32_t off_q8 = 0;
+    if (best > 1 && best < p->tau_max) {
+        int64_t a = diff_at(p->scaled, p->window, best - 1);
+        int64_t b = diff_at(p->scaled, p->window, best);
+        int64_t c = diff_at(p->scaled, p->window, best + 1);
+        int64_t den = a - 2 * b + c;
+        if (den > 0) {
+            off_q8 = (int32_t)(((a - c) * 128) / den);
+            if (off_q8 > 128) off_q8 = 128;
+            if (off_q8 < -128) off_q8 = -128;
+        }
+    }
+
+    uint32_t period_q8 = (uint32_t)(best * 256 + off_q8);
+    r.freq_centihz = (uint32_t)(((uint64_t)p->sample_rate * 100u * 256u + period_q8 / 2) / period_q8);
+    r.clarity_q15 = (uint16_t)(dn[best] >= (1u << 15) ? 0 : (1u << 15) - dn[best]);
+
+    if (out) *out = r;
+    return true;
+}
+
+// log2(v / 2^16) in Q16, v > 0: integer part by normalizing, then one
+// fraction bit per squaring
+static int32_t log2_q16(uint64_t v)
+{
+    int32_t ip = 0;
+    while (v >= (2ull << 16)) {
+        v >>= 1;
+        ip++;
+    }
+    while (v < (1ull << 16)) {
+        v <<= 1;
+        ip--;
+    }
+
+    int32_t frac = 0;
+    for (int i = 15; i >= 0; i--) {
+        v = (v * v) >> 16;
+        if (v >= (2ull << 16)) {
+            v >>= 1;
+            frac |= 1 << i;
+        }
+    }
+    return ip * 65536 + frac;
+}
+
+int PitchYin_NoteCents(uint32_t freq_centihz, int* cents)
+{
+    if (freq_centihz == 0) {
+        if (cents) *cents = 0;
+        return 0;
+    }
+
+    // Cents above A4 (440 Hz)
+    int64_t l = log2_q16(((uint64_t)freq_centihz << 16) / 44000u);
+    int32_t c = (int32_t)((l * 1200 + (l >= 0 ? 32768 : -32768)) / 65536);
+
+    int semis = (c >= 0 ? c + 50 : c - 49) / 100;
+    if (cents) *cents = c - semis * 100;
+    return 69 + semis;
+}
+
+void PitchYin_NoteName(int midi, char* out, size_t len)
+{
+    static const char* const k_names[12] = { "C", "C#", "D", "D#", "E", "F", "F#", "G", "G#", "A", "A#", "B" };
+    if (!out || len == 0) return;
+    if (midi <= 0) {
+        snprintf(out, len, "--");
+        return;
+    }
+    snprintf(out, len, "%s%d", k_names[midi % 12], midi / 12 - 1);
+}
@@ -0,0 +1,52 @@
+#pragma once
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// YIN pitch detector in fixed point. Pure C, bit-exact on the host.
+//
+// For each lag tau the squared difference d(tau) = sum (x[j] - x[j + tau])^2
+// over a window is normalized by its running mean (YIN's cumulative mean
+// normalized difference). The first lag that dips under the threshold,
+// followed down to its local minimum, is the period; a parabola through
+// the neighbours refines it below one sample.
+//
+// Cost: one subtract/multiply/add per sample per lag, and the lag scan stops
+// right after the dip, so high notes are cheap and only unvoiced frames pay
+// for the full lag range. The frame is scaled to a fixed peak first so every
+// sum fits in 32 bits.
+
+#define PITCH_YIN_MAX_WINDOW    512
+#define PITCH_YIN_THRESHOLD_Q15 4915    // 0.15
+#define PITCH_YIN_MIN_PEAK      64      // frames quieter than this (about -54 dBFS) are unvoiced
+
+typedef struct {
+    int sample_rate;
+    int window;             // samples per difference sum
+    int tau_min;            // sample_rate / f_max
+    int tau_max;            // sample_rate / f_min
+    int16_t* scaled;        // window + tau_max
+    uint32_t* dn;           // tau_max + 2, normalized difference in Q15
+} PitchYin;
+
+typedef struct {
+    uint32_t freq_centihz;  // 0 = no pitch
+    uint16_t clarity_q15;   // 1 - normalized difference at the chosen lag
+    uint16_t lags;          // lags evaluated, for cost accounting
+} PitchYinResult;
+
+size_t PitchYin_MemBytes(int window, int tau_max);
+bool PitchYin_Init(PitchYin* p, int sample_rate, int window, int f_min_hz, int f_max_hz, void* mem);
+
+// Samples per analysis frame: window + tau_max
+int PitchYin_FrameSamples(const PitchYin* p);
+
+// frame holds PitchYin_FrameSamples() samples. Returns true when voiced.
+bool PitchYin_Estimate(PitchYin* p, const int16_t* frame, PitchYinResult* out);
+
+// Nearest equal-tempered note (MIDI number, A4 = 69) and the offset from
+// it in cents (-50..49). 0 for freq 0.
+int PitchYin_NoteCents(uint32_t freq_centihz, int* cents);
+
+// "A4", "C#5"
+void PitchYin_NoteName(int midi, char* out, size_t len);
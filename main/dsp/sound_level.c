@@ -0,0 +1,149 @@
+#include "dsp/sound_level.h"
+#include "core/hot_path.h"
+
+#include <math.h>
+#include <string.h>
+
+#define SL_CHUNK        64
+#define SL_IN_SHIFT     14          // int16 into the Q31 cascade
+#define SL_OUT_SHIFT    8           // back out, 6 fraction bits kept for the squares
+#define SL_LEQ_SHIFT    16
+#define SL_K_ONE        4096        // block weight, Q12
+
+// IEC 61672 pole frequencies
+#define AW_F1   20.598997
+#define AW_F2   107.65265
+#define AW_F3   737.86223
+#define AW_F4   12194.217
+
+// Bilinear transform of s^2 / ((s + pa)(s + pb)) or pa pb / ((s + pa)(s + pb)):
+// high-pass with unity gain at Nyquist, low-pass with unity gain at DC.
+// c = { b0, b1, b2, a1, a2 }
+static void bilinear_section(double fs, double pa, double pb, bool high, double c[5])
+{
+    const double k = 2.0 * fs;
+    const double d0 = (k + pa) * (k + pb);
+    const double g = high ? k * k / d0 : pa * pb / d0;
+    c[0] = g;
+    c[1] = high ? -2.0 * g : 2.0 * g;
+    c[2] = g;
+    c[3] = ((k + pa) * (pb - k) + (pa - k) * (k + pb)) / d0;
+    c[4] = (pa - k) * (pb - k) / d0;
+}
+
+static double section_mag(const double c[5], double w)
+{
+    double nr = c[0] + c[1] * cos(w) + c[2] * cos(2.0 * w);
+    double ni = -c[1] * sin(w) - c[2] * sin(2.0 * w);
+    double dr = 1.0 + c[3] * cos(w) + c[4] * cos(2.0 * w);
+    double di = -c[3] * sin(w) - c[4] * sin(2.0 * w);
+    return sqrt((nr * nr + ni * ni) / (dr * dr + di * di));
+}
+
+static bool to_q30(double v, int32_t* out)
+{
+    double q = floor(v * (1 << 30) + 0.5);
+    if (q < -2.0 * (1 << 30) || q >= 2.0 * (1 << 30)) return false;
+    *out = (int32_t)q;
+    return true;
+}
+
+bool SoundLevel_DesignAWeighting(uint32_t sample_rate, DspBiquadCoef out[SOUND_LEVEL_SECTIONS])
+{
+    if (sample_rate < 8000 || sample_rate > 48000) return false;
+
+    const double fs = sample_rate;
+    const double w = 2.0 * M_PI;
+    double c[SOUND_LEVEL_SECTIONS][5];
+    bilinear_section(fs, w * AW_F1, w * AW_F1, true, c[0]);
+    bilinear_section(fs, w * AW_F2, w * AW_F3, true, c[1]);
+    bilinear_section(fs, w * AW_F4, w * AW_F4, false, c[2]);
+
+    // 0 dB at 1 kHz, taken up by the last section
+    const double w1k = 2.0 * M_PI * 1000.0 / fs;
+    double g = 1.0;
+    for (int i = 0; i < SOUND_LEVEL_SECTIONS; i++) g *= section_mag(c[i], w1k);
+    for (int i = 0; i < 3; i++) c[SOUND_LEVEL_SECTIONS - 1][i] /= g;
+
+    for (int i = 0; i < SOUND_LEVEL_SECTIONS; i++) {
+        if (!to_q30(c[i][0], &out[i].b0) || !to_q30(c[i][1], &out[i].b1) || !to_q30(c[i][2], &out[i].b2) ||
+            !to_q30(c[i][3], &out[i].a1) || !to_q30(c[i][4], &out[i].a2)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool SoundLevel_Init(SoundLevel* m, uint32_t sample_rate)
+{
+    memset(m, 0, sizeof(*m));
+    DspBiquadCoef c[SOUND_LEVEL_SECTIONS];
+    if (!SoundLevel_DesignAWeighting(sample_rate, c)) return false;
+    if (!DspCascadeQ31_Init(&m->aw, c, SOUND_LEVEL_SECTIONS)) return false;
+
+    m->sample_rate = sample_rate;
+    m->fast_k_q24 = (uint32_t)((1000ull << 24) / ((uint64_t)SOUND_LEVEL_FAST_MS * sample_rate));
+    // Mean square of a full-scale sine in the units of fast_ms
+    m->ref_db_q8 = Dsp_PowerDbQ8(((uint64_t)32767 * 32767 / 2) << (2 * (SL_IN_SHIFT - SL_OUT_SHIFT)));
+    return true;
+}
+
+void SoundLevel_Reset(SoundLevel* m)
+{
+    DspCascadeQ31_Reset(&m->aw);
+    m->fast_ms = 0;
+    m->leq_sum = 0;
+    m->leq_samples = 0;
+    m->peak = 0;
+}
+
+HOT_PATH void SoundLevel_Process(SoundLevel* m, const int16_t* s, int n)
+{
+    if (n <= 0) return;
+
+    int32_t w[SL_CHUNK];
+    uint64_t sum = 0;
+    for (int off = 0; off < n; off += SL_CHUNK) {
+        int k = n - off < SL_CHUNK ? n - off : SL_CHUNK;
+        for (int i = 0; i < k; i++) w[i] = (int32_t)s[off + i] * (1 << SL_IN_SHIFT);
+        DspCascadeQ31_Process(&m->aw, w, k);
+        for (int i = 0; i < k; i++) {
+            int32_t y = w[i] >> SL_OUT_SHIFT;
+            sum += (uint64_t)((int64_t)y * y);
+        }
+    }
+
+    int32_t pk = Dsp_PeakQ15(s, n);
+    if (pk > m->peak) m->peak = pk;
+
+    // One exponential step for the whole block
+    uint64_t kb = ((uint64_t)n * m->fast_k_q24) >> 12;
+    if (kb > SL_K_ONE) kb = SL_K_ONE;
+    int64_t delta = (int64_t)(sum / (uint32_t)n) - (int64_t)m->fast_ms;
+    m->fast_ms = (uint64_t)((int64_t)m->fast_ms + delta * (int64_t)kb / SL_K_ONE);
+
+    m->leq_sum += sum >> SL_LEQ_SHIFT;
+    m->leq_samples += (uint32_t)n;
+}
+
+static int32_t floor_db(int32_t db_q8)
+{
+    return db_q8 < SOUND_LEVEL_FLOOR_Q8 ? SOUND_LEVEL_FLOOR_Q8 : db_q8;
+}
+
+void SoundLevel_GetLevels(SoundLevel* m, SoundLevels* out)
+{
+    out->fast_db_q8 = m->fast_ms ? floor_db(Dsp_PowerDbQ8(m->fast_ms) - m->ref_db_q8) : SOUND_LEVEL_FLOOR_Q8;
+
+    if (m->leq_sum && m->leq_samples) {
+        // Mean square = leq_sum << SHIFT / samples, taken apart in dB
+        int32_t db = Dsp_PowerDbQ8(m->leq_sum) + Dsp_PowerDbQ8(1ull << SL_LEQ_SHIFT) -
+                     Dsp_PowerDbQ8(m->leq_samples) - m->ref_db_q8;
+        out->leq_db_q8 = floor_db(db);
+    } else {
+        out->leq_db_q8 = SOUND_LEVEL_FLOOR_Q8;
+    }
+
+    out->peak_db_q8 = m->peak ? floor_db(Dsp_AmpDbQ8((uint64_t)m->peak) - Dsp_AmpDbQ8(32767)) : SOUND_LEVEL_FLOOR_Q8;
+    m->peak = 0;
+}
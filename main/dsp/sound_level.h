@@ -0,0 +1,55 @@
+#pragma once
+#include <stdbool.h>
+#include <stdint.h>
+#include "dsp/dsp_q15.h"
+
+// A-weighted sound level meter on top of dsp/dsp_q15.h. Pure C.
+//
+// The IEC 61672 A curve (two poles at 20.6 Hz, one each at 107.7 and
+// 737.9 Hz, two at 12194 Hz, four zeros at DC) goes through the bilinear
+// transform into three Q31 biquads, normalised to 0 dB at 1 kHz. From
+// 31.5 Hz to 4 kHz it tracks the analog curve within 0.5 dB; above that the
+// warp pulls it down toward the zero at Nyquist, so at 16 kHz sampling the
+// top octave reads low (host/golden/sound_level.txt).
+//
+// Levels come out in 1/256 dB re a full-scale sine on the int16 input:
+//   fast  - exponential F time weighting (125 ms), updated per block
+//   leq   - energy average since Init/Reset
+//   peak  - unweighted sample peak since the last GetLevels
+// SOUND_LEVEL_SPL_OFFSET_Q8 turns these into dB SPL for the INMP441 path:
+// 94 dB SPL is -26 dBFS at 24 bits, and our int16 (24-bit >> 7) full scale
+// sits 6 dB under the 24-bit one.
+
+#define SOUND_LEVEL_SECTIONS        3
+#define SOUND_LEVEL_FAST_MS         125
+#define SOUND_LEVEL_SPL_OFFSET_Q8   29179       // 113.98 dB
+#define SOUND_LEVEL_FLOOR_Q8        (-120 * 256)
+
+typedef struct {
+    DspCascadeQ31 aw;
+    uint32_t sample_rate;
+    uint64_t fast_ms;       // mean square of the weighted signal, int16 scale x 64
+    uint32_t fast_k_q24;    // time weighting per sample
+    uint64_t leq_sum;       // sum of squares, scaled down to last for days
+    uint64_t leq_samples;
+    int32_t peak;
+    int32_t ref_db_q8;      // full-scale sine in the same units as fast_ms
+} SoundLevel;
+
+typedef struct {
+    int32_t fast_db_q8;     // LAF
+    int32_t leq_db_q8;      // LAeq
+    int32_t peak_db_q8;     // unweighted
+} SoundLevels;
+
+// false for a sample rate the design cannot handle (8..48 kHz)
+bool SoundLevel_Init(SoundLevel* m, uint32_t sample_rate);
+void SoundLevel_Reset(SoundLevel* m);          // clears the filters and every average
+
+// Any block length; the F weighting steps once per block, so keep blocks
+// well under 125 ms
+void SoundLevel_Process(SoundLevel* m, const int16_t* s, int n);
+void SoundLevel_GetLevels(SoundLevel* m, SoundLevels* out);
+
+// The A-weighting design, for response checks (DspBiquad_ResponseDbQ8)
+bool SoundLevel_DesignAWeighting(uint32_t sample_rate, DspBiquadCoef out[SOUND_LEVEL_SECTIONS]);
@@ -0,0 +1,348 @@
+#include "experiments/experiment.h"
+#include "experiments/experiments_registry.h"
+#include "ui/ui.h"
+#include "display/st7735.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#if defined(ESP_PLATFORM)
+#include "sdkconfig.h"
+#endif
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+static const char* TAG = "EXP_BENCH";
+
+// Fixed rendering script. Bump BENCH_VERSION whenever a workload or its op
+// count changes so lines from different scripts are never compared.
+#define BENCH_VERSION   2
+#define BENCH_ROWS      12
+#define BENCH_MIC_BANDS 10
+#define BENCH_WF_BINS   256
+
+// Build profile tag for the serial line, so A/B logs label themselves
+#if CONFIG_COMPILER_OPTIMIZATION_PERF
+#define BENCH_OPT "O2"
+#elif CONFIG_COMPILER_OPTIMIZATION_SIZE
+#define BENCH_OPT "Os"
+#elif CONFIG_COMPILER_OPTIMIZATION_NONE
+#define BENCH_OPT "O0"
+#else
+#define BENCH_OPT "Og"
+#endif
+
+#if CONFIG_APP_HOT_IN_IRAM
+#define BENCH_IRAM "-iram"
+#else
+#define BENCH_IRAM ""
+#endif
+
+#if CONFIG_APP_PERF_LTO
+#define BENCH_LTO "-lto"
+#else
+#define BENCH_LTO ""
+#endif
+
+#define BENCH_STR_(x) #x
+#define BENCH_STR(x)  BENCH_STR_(x)
+
+#if defined(CONFIG_ESP_DEFAULT_CPU_FREQ_MHZ)
+#define BENCH_BUILD BENCH_OPT "-" BENCH_STR(CONFIG_ESP_DEFAULT_CPU_FREQ_MHZ) "mhz" BENCH_IRAM BENCH_LTO
+#else
+#define BENCH_BUILD "host"
+#endif
+
+extern const Experiment g_exp_maze;
+
+typedef struct {
+    const char* name;
+    int ops;
+    void (*setup)(ExperimentContext* ctx);      // untimed
+    void (*op)(ExperimentContext* ctx, int i);
+} BenchWorkload;
+
+typedef struct {
+    uint32_t ops;
+    uint32_t wall_us;
+    uint32_t bytes;
+    uint32_t txns;
+    uint32_t busy_us;       // wall time not spent blocked on pixel DMA
+} BenchResult;
+
+static uint32_t s_seed;
+
+static uint32_t bench_rand(void)
+{
+    // xorshift32: the pixel storm hits the same pixels on every run
+    uint32_t x = s_seed;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    s_seed = x;
+    return x;
+}
+
+// -------------------- workloads --------------------
+
+static void op_fill(ExperimentContext* ctx, int i)
+{
+    (void)ctx;
+    St7735_Fill((i & 1) ? Ui_ColorRGB(20, 20, 60) : Ui_ColorRGB(60, 20, 20));
+}
+
+static void setup_rows(ExperimentContext* ctx)
+{
+    (void)ctx;
+    Ui_DrawFrame("BENCH", "TEXT ROWS");
+}
+
+static void op_text_row(ExperimentContext* ctx, int i)
+{
+    (void)ctx;
+    char line[32];
+    snprintf(line, sizeof(line), "ROW %02d  OP %04d", i % BENCH_ROWS, i);
+    Ui_DrawBodyTextRowColor(i % BENCH_ROWS, line, Ui_ColorRGB(230, 230, 230));
+}
+
+static void setup_menu(ExperimentContext* ctx)
+{
+    (void)ctx;
+    Ui_DrawMainMenu(0, Experiments_Count());
+}
+
+static void op_menu(ExperimentContext* ctx, int i)
+{
+    (void)ctx;
+    int count = Experiments_Count();
+    Ui_DrawMainMenu((i + 1) % count, count);
+}
+
+static void setup_mic(ExperimentContext* ctx)
+{
+    (void)ctx;
+    Ui_DrawFrame("MIC", "BACK");
+    Ui_DrawMicBody(NULL, 0, 0, 0);
+}
+
+static void op_mic(ExperimentContext* ctx, int i)
+{
+    (void)ctx;
+    // A moving peak so every bar changes height between frames
+    int bands[BENCH_MIC_BANDS];
+    for (int b = 0; b < BENCH_MIC_BANDS; b++) {
+        int d = (b - (i % BENCH_MIC_BANDS));
+        if (d < 0) d = -d;
+        bands[b] = 100 - d * 10;
+    }
+    Ui_DrawMicBody(bands, BENCH_MIC_BANDS, 100 + (i % 50) * 10, i % 101);
+}
+
+static void setup_waterfall(ExperimentContext* ctx)
+{
+    (void)ctx;
+    s_seed = 0x89ABCDEu;
+    Ui_DrawFrame("MIC", "BACK");
+    Ui_BeginMicWaterfall(8000);
+}
+
+static void op_waterfall(ExperimentContext* ctx, int i)
+{
+    (void)ctx;
+    // A drifting tone with two harmonics over a noise floor
+    uint8_t line[BENCH_WF_BINS];
+    int peak = 8 + (i * 3) % (BENCH_WF_BINS / 3);
+    for (int k = 0; k < BENCH_WF_BINS; k++) {
+        int v = (int)(bench_rand() & 31);
+        for (int h = 1; h <= 3; h++) {
+            int d = k - peak * h;
+            if (d < 0) d = -d;
+            if (d < 4) v += (255 - d * 50) / h;
+        }
+        line[k] = (uint8_t)(v > 255 ? 255 : v);
+    }
+    Ui_DrawMicWaterfallLine(line, BENCH_WF_BINS);
+}
+
+static void op_maze(ExperimentContext* ctx, int i)
+{
+    (void)i;
+    // start() marks the map dirty, the first tick() clears and draws it all
+    ExpArenaMark mark = ExpArena_Mark(&ctx->arena);
+    g_exp_maze.start(ctx);
+    g_exp_maze.tick(ctx);
+    g_exp_maze.stop(ctx);
+    ExpArena_Release(&ctx->arena, mark);
+}
+
+static void setup_pixels(ExperimentContext* ctx)
+{
+    (void)ctx;
+    s_seed = 0x1234567u;
+}
+
+static void op_pixel(ExperimentContext* ctx, int i)
+{
+    (void)ctx;
+    uint32_t r = bench_rand();
+    St7735_DrawPixel((int)(r % (uint32_t)St7735_Width()), (int)((r >> 16) % (uint32_t)St7735_Height()),
+                     (uint16_t)(i * 0x0841));
+}
+
+static const BenchWorkload kScript[] = {
+    { "fill",        10,   NULL,         op_fill },
+    { "text_row",    240,  setup_rows,   op_text_row },
+    { "menu_scroll", 60,   setup_menu,   op_menu },
+    { "mic_page",    100,  setup_mic,    op_mic },
+    { "waterfall",   264,  setup_waterfall, op_waterfall },
+    { "maze_full",   5,    NULL,         op_maze },
+    { "pixel_storm", 2000, setup_pixels, op_pixel },
+};
+
+#define BENCH_COUNT ((int)(sizeof(kScript) / sizeof(kScript[0])))
+
+static BenchResult s_results[BENCH_COUNT];
+static bool s_have_results = false;
+
+// -------------------- runner --------------------
+
+static void run_one(ExperimentContext* ctx, const BenchWorkload* w, BenchResult* out)
+{
+    if (w->setup) w->setup(ctx);
+    St7735_Flush();
+
+    St7735Stats s0;
+    St7735_GetStats(&s0);
+    int64_t t0 = esp_timer_get_time();
+
+    for (int i = 0; i < w->ops; i++) w->op(ctx, i);
+    St7735_Flush();
+
+    int64_t t1 = esp_timer_get_time();
+    St7735Stats s1;
+    St7735_GetStats(&s1);
+
+    uint32_t wall = (uint32_t)(t1 - t0);
+    uint32_t wait = (uint32_t)(s1.dma_wait_us - s0.dma_wait_us);
+
+    out->ops = (uint32_t)w->ops;
+    out->wall_us = wall ? wall : 1;
+    out->bytes = s1.bytes - s0.bytes;
+    out->txns = s1.txns - s0.txns;
+    out->busy_us = wait < wall ? wall - wait : 0;
+}
+
+// ms/op with three decimals, MB/s with two, CPU % as an integer
+static void fmt_result(const BenchResult* r, char* ms, size_t ms_cap, char* mbs, size_t mbs_cap, unsigned* cpu)
+{
+    uint32_t ns_op = (uint32_t)((uint64_t)r->wall_us * 1000u / r->ops);
+    snprintf(ms, ms_cap, "%lu.%03lu", (unsigned long)(ns_op / 1000000u), (unsigned long)((ns_op / 1000u) % 1000u));
+
+    uint32_t kbs = (uint32_t)((uint64_t)r->bytes * 1000u / r->wall_us);   // bytes/us * 1000 = kB/s
+    snprintf(mbs, mbs_cap, "%lu.%02lu", (unsigned long)(kbs / 1000u), (unsigned long)((kbs % 1000u) / 10u));
+
+    *cpu = (unsigned)((uint64_t)r->busy_us * 100u / r->wall_us);
+}
+
+// One line, "BENCH v<n> build=<profile> name=ms_per_op,MB/s,cpu% ...", for
+// tools/bench_compare.py
+static void print_line(void)
+{
+    char line[384];
+    int n = snprintf(line, sizeof(line), "BENCH v%d build=%s", BENCH_VERSION, BENCH_BUILD);
+    for (int i = 0; i < BENCH_COUNT && n > 0 && n < (int)sizeof(line); i++) {
+        char ms[16];
+        char mbs[16];
+        unsigned cpu;
+        fmt_result(&s_results[i], ms, sizeof(ms), mbs, sizeof(mbs), &cpu);
+        n += snprintf(line + n, sizeof(line) - (size_t)n, " %s=%s,%s,%u", kScript[i].name, ms, mbs, cpu);
+    }
+    printf("%s\n", line);
+}
+
+static void draw_results(void)
+{
+    Ui_DrawFrame("BENCH", "OK:RUN  BACK");
+
+    uint16_t head = Ui_ColorRGB(200, 200, 200);
+    uint16_t fg = Ui_ColorRGB(230, 230, 230);
+
+    if (!s_have_results) {
+        Ui_DrawBodyTextRowColor(0, "Rendering script:", head);
+        for (int i = 0; i < BENCH_COUNT; i++) {
+            char line[32];
+            snprintf(line, sizeof(line), " %-11s x%d", kScript[i].name, kScript[i].ops);
+            Ui_DrawBodyTextRowColor(1 + i, line, fg);
+        }
+        Ui_DrawBodyTextRowColor(BENCH_COUNT + 2, "OK runs it (~3 s)", head);
+        return;
+    }
+
+    Ui_DrawBodyTextRowColor(0, "TEST       MS/OP MB/S CPU", head);
+    for (int i = 0; i < BENCH_COUNT; i++) {
+        char ms[16];
+        char mbs[16];
+        unsigned cpu;
+        fmt_result(&s_results[i], ms, sizeof(ms), mbs, sizeof(mbs), &cpu);
+
+        char line[48];
+        snprintf(line, sizeof(line), "%-9.9s%7s%5s%4u", kScript[i].name, ms, mbs, cpu);
+        Ui_DrawBodyTextRowColor(1 + i, line, fg);
+    }
+    Ui_DrawBodyTextRowColor(BENCH_COUNT + 2, "Line on serial: BENCH", head);
+}
+
+static void run_script(ExperimentContext* ctx)
+{
+    ESP_LOGI(TAG, "script v%d: %d workloads", BENCH_VERSION, BENCH_COUNT);
+
+    for (int i = 0; i < BENCH_COUNT; i++) {
+        run_one(ctx, &kScript[i], &s_results[i]);
+        ESP_LOGI(TAG, "%-11s ops=%lu wall=%lu us bytes=%lu txns=%lu busy=%lu us", kScript[i].name,
+                 (unsigned long)s_results[i].ops, (unsigned long)s_results[i].wall_us,
+                 (unsigned long)s_results[i].bytes, (unsigned long)s_results[i].txns,
+                 (unsigned long)s_results[i].busy_us);
+        // Let IDLE run between workloads (task watchdog)
+        vTaskDelay(1);
+    }
+
+    s_have_results = true;
+    print_line();
+    draw_results();
+}
+
+// -------------------- experiment --------------------
+
+static void show_requirements(ExperimentContext* ctx)
+{
+    (void)ctx;
+    Ui_DrawFrame("BENCH", "OK:START  BACK");
+    Ui_Println("Rendering benchmark");
+    Ui_Println("OK: run the script");
+    Ui_Println("Result line on serial");
+}
+
+static void start(ExperimentContext* ctx)
+{
+    (void)ctx;
+    draw_results();
+}
+
+static void on_key(ExperimentContext* ctx, InputKey key)
+{
+    if (key == kInputEnter) run_script(ctx);
+}
+
+const Experiment g_exp_bench = {
+    .id = 15,
+    .title = "BENCH",
+    .on_enter = 0,
+    .on_exit = 0,
+    .show_requirements = show_requirements,
+    .start = start,
+    .stop = 0,
+    .on_key = on_key,
+    .tick = 0,
+};
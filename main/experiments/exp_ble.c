@@ -1,5 +1,6 @@
 #include "experiments/experiment.h"
 #include "ui/ui.h"
+#include "ui/ui_console.h"
 
 #include "comm_ble.h"
 #include "esp_timer.h"
@@ -14,14 +15,9 @@ static bool s_ui_dirty = true;
 static CommBleState s_last_state = (CommBleState)(-1);
 // -------------------- console (ring of lines) --------------------
 
-#define BLE_LOG_MAX_LINES  64
-#define BLE_LOG_LINE_CAP   64
+#define BLE_LOG_ROWS  3
 
-static char s_log[BLE_LOG_MAX_LINES][BLE_LOG_LINE_CAP];
-static int  s_log_head = 0;     // next write index
-static int  s_log_count = 0;    // valid lines
-static int  s_log_first = 0;    // first visible line (0=oldest)
-static bool s_log_follow = true;
+static UiConsole* s_log = NULL;  // from ctx arena while running
 
 static void draw_requirements(void)
 {
@@ -30,113 +26,6 @@ static void draw_requirements(void)
     Ui_Println("GOAL: Write -> +1 notify");
     Ui_Println("NOTE: BLE enabled only in RUN");
 }
-static void ble_log_clear(void)
-{
-    memset(s_log, 0, sizeof(s_log));
-    s_log_head = 0;
-    s_log_count = 0;
-    s_log_first = 0;
-    s_log_follow = true;
-}
-
-static int ble_log_oldest_index(void)
-{
-    int oldest = s_log_head - s_log_count;
-    while (oldest < 0) oldest += BLE_LOG_MAX_LINES;
-    return oldest;
-}
-
-static int ble_log_ring_index_from_oldest(int index_from_oldest)
-{
-    int idx = ble_log_oldest_index() + index_from_oldest;
-    idx %= BLE_LOG_MAX_LINES;
-    return idx;
-}
-
-static const char* ble_log_get_line(int index_from_oldest)
-{
-    if (index_from_oldest < 0 || index_from_oldest >= s_log_count) return "";
-    return s_log[ble_log_ring_index_from_oldest(index_from_oldest)];
-}
-
-static void ble_log_push_line(const char* s)
-{
-    if (!s) s = "";
-
-    strncpy(s_log[s_log_head], s, BLE_LOG_LINE_CAP - 1);
-    s_log[s_log_head][BLE_LOG_LINE_CAP - 1] = 0;
-
-    s_log_head = (s_log_head + 1) % BLE_LOG_MAX_LINES;
-    if (s_log_count < BLE_LOG_MAX_LINES) s_log_count++;
-
-    if (s_log_follow) {
-        // keep pinned (first will be adjusted on draw based on visible rows)
-        if (s_log_count > 0) s_log_first = s_log_count - 1;
-        else s_log_first = 0;
-    }
-}
-
-// simple wrap (space preferred) into multiple lines
-static const char* wrap_next(const char* p, int cols, char* out, int cap)
-{
-    if (!p) p = "";
-    if (cols < 1) cols = 1;
-    if (cap < 2) { if (cap == 1) out[0] = 0; return p; }
-
-    while (*p == ' ' || *p == '\t') p++;
-
-    if (*p == '\n') {
-        out[0] = 0;
-        return p + 1;
-    }
-
-    int maxc = cols;
-    if (maxc > cap - 1) maxc = cap - 1;
-
-    int n = 0;
-    int last_sp_out = -1;
-    const char* last_sp_p = NULL;
-
-    while (*p && *p != '\n' && n < maxc) {
-        char ch = *p;
-        out[n++] = ch;
-        if (ch == ' ' || ch == '\t') {
-            last_sp_out = n - 1;
-            last_sp_p = p;
-        }
-        p++;
-    }
-
-    if (*p == '\n') {
-        out[n] = 0;
-        return p + 1;
-    }
-
-    if (n == maxc && *p && *p != '\n' && last_sp_out >= 0) {
-        int cut = last_sp_out;
-        while (cut > 0 && (out[cut] == ' ' || out[cut] == '\t')) cut--;
-        out[cut + 1] = 0;
-
-        p = last_sp_p + 1;
-        while (*p == ' ' || *p == '\t') p++;
-        return p;
-    }
-
-    out[n] = 0;
-    return p;
-}
-
-static void ble_log_append_wrapped(const char* text, int cols)
-{
-    if (!text) text = "";
-    const char* p = text;
-    while (*p) {
-        char line[BLE_LOG_LINE_CAP];
-        p = wrap_next(p, cols, line, (int)sizeof(line));
-        ble_log_push_line(line);
-    }
-}
-
 // -------------------- helpers --------------------
 
 static uint32_t now_ms(void)
@@ -172,20 +61,17 @@ static void draw_run_screen(const char* name, const char* addr, const char* st_s
 
     Ui_Println("---- LOG ----");
 
-    // Keep this consistent with your previous approach
-    int rows_for_log = 3;
-
-    int count = s_log_count;
-    int max_first = count - rows_for_log;
+    int count = UiConsole_Count(s_log);
+    int max_first = count - BLE_LOG_ROWS;
     if (max_first < 0) max_first = 0;
 
-    int first = s_log_follow ? max_first : s_log_first;
+    int first = (!s_log || s_log->follow) ? max_first : s_log->first;
     if (first < 0) first = 0;
     if (first > max_first) first = max_first;
 
-    for (int i = 0; i < rows_for_log; i++) {
+    for (int i = 0; i < BLE_LOG_ROWS; i++) {
         int idx = first + i;
-        const char* s = (idx < count) ? ble_log_get_line(idx) : "";
+        const char* s = (idx < count) ? UiConsole_GetLine(s_log, idx) : "";
         Ui_Println(s);
     }    
 }
@@ -212,7 +98,7 @@ static void ble_on_exit(ExperimentContext* ctx)
 
 static void start(ExperimentContext* ctx)
 {
-    (void)ctx;
+    s_log = (UiConsole*)ExpArena_Alloc(&ctx->arena, kExpArenaNormal, sizeof(UiConsole));
 
     CommBle_ClearLastRx();
     CommBle_Enable(true);
@@ -220,8 +106,8 @@ static void start(ExperimentContext* ctx)
     s_last_screen[0] = 0;
     s_last_state = (CommBleState)(-1);
 
-    ble_log_clear();
-    ble_log_push_line("RUN START");
+    UiConsole_Init(s_log);
+    UiConsole_AppendWrapped(s_log, "RUN START", UI_CONSOLE_LINE_CAP);
 
     Ui_Clear();          // clear once
     s_ui_dirty = true;   // force first draw
@@ -234,7 +120,7 @@ static void stop(ExperimentContext* ctx)
     CommBle_ClearLastRx();
 
     s_last_screen[0] = 0;
-    ble_log_clear();
+    s_log = NULL;   // arena is released after stop()
 }
 
 static void on_key(ExperimentContext* ctx, InputKey key)
@@ -242,30 +128,10 @@ static void on_key(ExperimentContext* ctx, InputKey key)
     (void)ctx;
 
     if (key == kInputDown) {
-        int rows_for_log = 3;
-        int max_first = s_log_count - rows_for_log;
-        if (max_first < 0) max_first = 0;
-
-        int first = s_log_follow ? max_first : s_log_first;
-        first -= 1;
-        if (first < 0) first = 0;
-
-        s_log_first = first;
-        s_log_follow = (s_log_first >= max_first);
-
+        UiConsole_ScrollOlder(s_log, BLE_LOG_ROWS);
         s_last_draw_ms = 0;
     } else if (key == kInputEnter) {
-        int rows_for_log = 3;
-        int max_first = s_log_count - rows_for_log;
-        if (max_first < 0) max_first = 0;
-
-        int first = s_log_follow ? max_first : s_log_first;
-        first += 1;
-        if (first > max_first) first = max_first;
-
-        s_log_first = first;
-        s_log_follow = (s_log_first >= max_first);
-
+        UiConsole_ScrollNewer(s_log, BLE_LOG_ROWS);
         s_last_draw_ms = 0;
     }
     s_ui_dirty = true;
@@ -291,7 +157,7 @@ static void tick(ExperimentContext* ctx)
 
         char line[32];
         snprintf(line, sizeof(line), "STATE: %s", st_s);
-        ble_log_push_line(line);
+        UiConsole_AppendWrapped(s_log, line, UI_CONSOLE_LINE_CAP);
     }
 
     // RX as hex
@@ -322,11 +188,11 @@ static void tick(ExperimentContext* ctx)
         s_ui_dirty = true;
 
         if (len > 0) {
-            ble_log_append_wrapped(rxline, 18);
+            UiConsole_AppendWrapped(s_log, rxline, 18);
         } else {
             // OPTIONAL: don't spam "(no rx)" every time, only when state changes.
             // If you keep it here, it will fill the log quickly.
-            // ble_log_push_line("(no rx)");
+            // UiConsole_AppendWrapped(s_log, "(no rx)", 18);
         }
     }
 
@@ -0,0 +1,258 @@
+#include "experiments/experiment.h"
+#include "ui/ui.h"
+
+#include "dsp/dsp_q15.h"
+#include "dsp/mic_levels.h"
+#include "dsp/sound_level.h"
+#include "esp_cpu.h"
+#include "esp_log.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include <stdio.h>
+
+// -------------------- DSP (kernel cycles) --------------------
+// Times the dsp/dsp_q15.c kernels and what is built on them in CPU cycles
+// per sample, so results compare across clock settings and against the
+// host numbers (host/host_microbench.c, dsp.*). Every kernel runs
+// DSP_BLOCKS blocks of DSP_BLOCK samples; the best of DSP_PASSES passes
+// is kept, which drops the ones an interrupt landed in.
+
+#define DSP_BENCH_VERSION   1
+#define DSP_BLOCK           256
+#define DSP_BLOCKS          32
+#define DSP_PASSES          3
+#define DSP_FIR_TAPS        32
+#define DSP_RATE            16000
+
+static const char* TAG = "EXP_DSP";
+
+typedef struct {
+    const char* name;
+    void (*op)(void);       // one block
+} DspKernel;
+
+typedef struct {
+    int16_t in[DSP_BLOCK];
+    int16_t out[DSP_BLOCK];
+    int32_t w[DSP_BLOCK];
+    int16_t taps[DSP_FIR_TAPS];
+    int16_t flat[DSP_BLOCK];
+    int16_t fir_hist[2 * DSP_FIR_TAPS];
+} DspBenchBufs;
+
+static DspBenchBufs* s_buf = NULL;
+static DspCascadeQ15 s_eq15;
+static DspCascadeQ31 s_eq31;
+static DspFirQ15 s_fir;
+static SoundLevel s_slm;
+static volatile uint32_t s_sink;
+
+// -------------------- kernels --------------------
+
+static void op_sumsq(void)
+{
+    s_sink += (uint32_t)Dsp_SumSquaresQ15(s_buf->in, DSP_BLOCK);
+}
+
+static void op_peak(void)
+{
+    s_sink += (uint32_t)Dsp_PeakQ15(s_buf->in, DSP_BLOCK);
+}
+
+static void op_dot(void)
+{
+    s_sink += (uint32_t)Dsp_DotQ15(s_buf->in, s_buf->flat, DSP_BLOCK);
+}
+
+static void op_fir(void)
+{
+    DspFirQ15_Process(&s_fir, s_buf->in, s_buf->out, DSP_BLOCK);
+}
+
+static void op_bq15(void)
+{
+    DspCascadeQ15_Process(&s_eq15, s_buf->out, DSP_BLOCK);
+}
+
+static void op_bq31(void)
+{
+    DspCascadeQ31_Process(&s_eq31, s_buf->w, DSP_BLOCK);
+}
+
+static void op_a_weight(void)
+{
+    SoundLevel_Process(&s_slm, s_buf->in, DSP_BLOCK);
+}
+
+static void op_goertzel(void)
+{
+    int bands[MIC_LEVELS_BANDS];
+    MicLevels_OctaveBands(s_buf->in, DSP_BLOCK, DSP_RATE, bands, MIC_LEVELS_BANDS);
+    s_sink += (uint32_t)bands[0];
+}
+
+static void op_db(void)
+{
+    const int16_t* s = s_buf->in;
+    for (int i = 0; i < DSP_BLOCK; i++) {
+        uint64_t p = (uint64_t)(uint32_t)((int32_t)s[i] * s[i]) * (uint32_t)(i + 1);
+        s_sink += (uint32_t)Dsp_PowerDbQ8(p);
+    }
+}
+
+static const DspKernel kKernels[] = {
+    { "sumsq",    op_sumsq },
+    { "peak",     op_peak },
+    { "dot",      op_dot },
+    { "fir32",    op_fir },
+    { "bq15x2",   op_bq15 },
+    { "bq31x2",   op_bq31 },
+    { "a_weight", op_a_weight },
+    { "goertz10", op_goertzel },
+    { "power_db", op_db },
+};
+
+#define DSP_KERNEL_COUNT ((int)(sizeof(kKernels) / sizeof(kKernels[0])))
+
+static uint32_t s_cps_x10[DSP_KERNEL_COUNT];    // cycles per sample, one decimal
+static bool s_have_results = false;
+
+// -------------------- runner --------------------
+
+static void setup(void)
+{
+    // Noise plus a square-ish tone, so nothing is all zeros or all one value
+    uint32_t seed = 0x2545F491u;
+    for (int i = 0; i < DSP_BLOCK; i++) {
+        seed ^= seed << 13;
+        seed ^= seed >> 17;
+        seed ^= seed << 5;
+        int32_t v = (int32_t)(seed & 0x1FFF) - 0x1000 + ((i & 16) ? 6000 : -6000);
+        s_buf->in[i] = (int16_t)v;
+        s_buf->out[i] = (int16_t)v;
+        s_buf->w[i] = v * (1 << 14);
+        s_buf->flat[i] = 32768 / DSP_BLOCK;
+    }
+    // A boxcar keeps sum |h| at exactly 1
+    for (int i = 0; i < DSP_FIR_TAPS; i++) s_buf->taps[i] = 32768 / DSP_FIR_TAPS;
+    DspFirQ15_Init(&s_fir, s_buf->taps, DSP_FIR_TAPS, s_buf->fir_hist);
+
+    // The speaker EQ of audio/audio_out.c in both formats
+    DspBiquadCoef c[2];
+    DspBiquad_Design(kDspBiquadHighPass, DSP_RATE, 150, 71, 0, &c[0]);
+    DspBiquad_Design(kDspBiquadPeak, DSP_RATE, 3000, 100, 40, &c[1]);
+    DspCascadeQ15_Init(&s_eq15, c, 2);
+    DspCascadeQ31_Init(&s_eq31, c, 2);
+    SoundLevel_Init(&s_slm, DSP_RATE);
+}
+
+static uint32_t run_one(const DspKernel* k)
+{
+    uint32_t best = UINT32_MAX;
+    for (int p = 0; p < DSP_PASSES; p++) {
+        uint32_t c0 = esp_cpu_get_cycle_count();
+        for (int b = 0; b < DSP_BLOCKS; b++) k->op();
+        uint32_t dc = esp_cpu_get_cycle_count() - c0;
+        if (dc < best) best = dc;
+    }
+    return (uint32_t)((uint64_t)best * 10u / (DSP_BLOCKS * DSP_BLOCK));
+}
+
+static void draw_results(void)
+{
+    Ui_DrawFrame("DSP", "OK:RUN  BACK");
+
+    uint16_t head = Ui_ColorRGB(200, 200, 200);
+    uint16_t fg = Ui_ColorRGB(230, 230, 230);
+
+    if (!s_have_results) {
+        Ui_DrawBodyTextRowColor(0, "Fixed-point kernels,", head);
+        char line[32];
+        snprintf(line, sizeof(line), "%d x %d samples each", DSP_BLOCKS, DSP_BLOCK);
+        Ui_DrawBodyTextRowColor(1, line, head);
+        Ui_DrawBodyTextRowColor(3, "OK runs them", head);
+        return;
+    }
+
+    Ui_DrawBodyTextRowColor(0, "KERNEL    CYC/SAMPLE", head);
+    for (int i = 0; i < DSP_KERNEL_COUNT; i++) {
+        char line[32];
+        snprintf(line, sizeof(line), "%-9s %6lu.%lu", kKernels[i].name, (unsigned long)(s_cps_x10[i] / 10),
+                 (unsigned long)(s_cps_x10[i] % 10));
+        Ui_DrawBodyTextRowColor(1 + i, line, fg);
+    }
+    Ui_DrawBodyTextRowColor(DSP_KERNEL_COUNT + 2, "Line on serial: DSP", head);
+}
+
+// One line, "DSP v<n> block=<n> name=cycles_per_sample ...", for logs
+static void print_line(void)
+{
+    char line[256];
+    int n = snprintf(line, sizeof(line), "DSP v%d block=%d", DSP_BENCH_VERSION, DSP_BLOCK);
+    for (int i = 0; i < DSP_KERNEL_COUNT && n > 0 && n < (int)sizeof(line); i++) {
+        n += snprintf(line + n, sizeof(line) - (size_t)n, " %s=%lu.%lu", kKernels[i].name,
+                      (unsigned long)(s_cps_x10[i] / 10), (unsigned long)(s_cps_x10[i] % 10));
+    }
+    printf("%s\n", line);
+}
+
+static void run_all(void)
+{
+    setup();
+    for (int i = 0; i < DSP_KERNEL_COUNT; i++) {
+        s_cps_x10[i] = run_one(&kKernels[i]);
+        ESP_LOGI(TAG, "%-9s %lu.%lu cycles/sample", kKernels[i].name, (unsigned long)(s_cps_x10[i] / 10),
+                 (unsigned long)(s_cps_x10[i] % 10));
+        // Let IDLE run between kernels (task watchdog)
+        vTaskDelay(1);
+    }
+    s_have_results = true;
+    print_line();
+    draw_results();
+}
+
+// -------------------- experiment --------------------
+
+static void show_requirements(ExperimentContext* ctx)
+{
+    (void)ctx;
+    Ui_DrawFrame("DSP", "OK:START  BACK");
+    Ui_Println("DSP kernel benchmark");
+    Ui_Println("No wiring needed");
+    Ui_Println("OK: run, cycles/sample");
+}
+
+static void start(ExperimentContext* ctx)
+{
+    s_buf = (DspBenchBufs*)ExpArena_Alloc(&ctx->arena, kExpArenaNormal, sizeof(DspBenchBufs));
+    if (!s_buf) {
+        Ui_DrawFrame("DSP", "BACK");
+        Ui_Println("NO MEMORY");
+        return;
+    }
+    draw_results();
+}
+
+static void stop(ExperimentContext* ctx)
+{
+    (void)ctx;
+    s_buf = NULL;
+}
+
+static void on_key(ExperimentContext* ctx, InputKey key)
+{
+    (void)ctx;
+    if (key == kInputEnter && s_buf) run_all();
+}
+
+const Experiment g_exp_dsp = {
+    .id = 19,
+    .title = "DSP",
+    .on_enter = 0,
+    .on_exit = 0,
+    .show_requirements = show_requirements,
+    .start = start,
+    .stop = stop,
+    .on_key = on_key,
+    .tick = 0,
+};
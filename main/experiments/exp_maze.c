@@ -72,7 +72,7 @@ static int s_oy = 0;
 static bool s_dirty = false;     // need redraw dirty tiles
 static bool s_full_dirty = false; // need redraw full map
 
-static uint16_t s_tilebuf[TILE_W * TILE_H];
+static uint16_t* s_tilebuf = NULL;   // TILE_W * TILE_H, from ctx arena
 
 // -----------------------------
 // Tile drawing
@@ -232,7 +232,9 @@ static void Maze_ShowRequirements(ExperimentContext* ctx)
 
 static void Maze_Start(ExperimentContext* ctx)
 {
-    (void)ctx;
+    s_tilebuf = (uint16_t*)ExpArena_Alloc(&ctx->arena, kExpArenaNormal,
+                                          TILE_W * TILE_H * sizeof(uint16_t));
+    if (!s_tilebuf) return;
 
     s_running = true;
 
@@ -253,6 +255,7 @@ static void Maze_Stop(ExperimentContext* ctx)
 {
     (void)ctx;
     s_running = false;
+    s_tilebuf = NULL;
 }
 
 static void Maze_OnKey(ExperimentContext* ctx, InputKey key)
@@ -300,4 +303,4 @@ const Experiment g_exp_maze = {
 
     .on_key = Maze_OnKey,
     .tick = Maze_Tick,
-};
\ No newline at end of file
+};
\ No newline at end of file
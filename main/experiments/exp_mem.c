@@ -0,0 +1,152 @@
+#include "experiments/experiment.h"
+#include "ui/ui.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "mem_track.h"
+#include "evtrace.h"
+
+static const char* TAG = "EXP_MEM";
+
+#define MEM_ROWS        12
+#define MEM_REFRESH_MS  1000
+
+typedef enum {
+    kMemViewTags = 0,
+    kMemViewHeaps,
+    kMemViewCount
+} MemView;
+
+static MemView s_view = kMemViewTags;
+static uint32_t s_next_ms = 0;
+static char s_rows[MEM_ROWS][32];
+
+static uint32_t now_ms(void)
+{
+    return (uint32_t)(esp_timer_get_time() / 1000ULL);
+}
+
+static void set_row(int row, const char* text, uint16_t fg)
+{
+    if (row < 0 || row >= MEM_ROWS) return;
+    if (strcmp(text, s_rows[row]) == 0) return;
+
+    snprintf(s_rows[row], sizeof s_rows[row], "%s", text);
+    Ui_DrawBodyTextRowColor(row, s_rows[row], fg);
+}
+
+static int render_tags(void)
+{
+    char line[32];
+    int row = 0;
+
+    set_row(row++, "TAG     LIVE   PEAK", Ui_ColorRGB(200, 200, 200));
+    for (int t = 0; t < kMemTagCount && row < MEM_ROWS; t++) {
+        MemTrackStat s;
+        MemTrack_GetStat((MemTag)t, -1, &s);
+        if (s.allocs == 0 && s.fails == 0) continue;
+
+        snprintf(line, sizeof(line), "%-5s %6u %6u%s", MemTrack_TagName((MemTag)t),
+                 (unsigned)s.live, (unsigned)s.peak, s.fails ? "!" : "");
+        set_row(row++, line, s.fails ? Ui_ColorRGB(255, 120, 120) : Ui_ColorRGB(230, 230, 230));
+    }
+    return row;
+}
+
+static int render_heaps(void)
+{
+    char line[32];
+    int row = 0;
+
+    for (int c = 0; c < kMemClassCount && row + 3 <= MEM_ROWS; c++) {
+        MemTrackHeapInfo hi;
+        MemTrack_GetHeapInfo((MemClass)c, &hi);
+        if (hi.free_bytes == 0) continue;
+
+        uint16_t fg = (hi.frag_pct >= 50) ? Ui_ColorRGB(255, 180, 80) : Ui_ColorRGB(180, 220, 180);
+
+        snprintf(line, sizeof(line), "%-5s FRAG %3u%%", MemTrack_ClassName((MemClass)c),
+                 (unsigned)hi.frag_pct);
+        set_row(row++, line, fg);
+        snprintf(line, sizeof(line), " FREE %7u", (unsigned)hi.free_bytes);
+        set_row(row++, line, Ui_ColorRGB(230, 230, 230));
+        snprintf(line, sizeof(line), " BIG  %7u", (unsigned)hi.largest_block);
+        set_row(row++, line, Ui_ColorRGB(230, 230, 230));
+    }
+    return row;
+}
+
+static void render(void)
+{
+    int used = (s_view == kMemViewTags) ? render_tags() : render_heaps();
+    for (int r = used; r < MEM_ROWS; r++) set_row(r, "", Ui_ColorRGB(230, 230, 230));
+}
+
+static void redraw_all(void)
+{
+    for (int r = 0; r < MEM_ROWS; r++) s_rows[r][0] = 0;
+    Ui_DrawFrame("MEM", "DN:VIEW UP:TRC OK:LOG");
+    Ui_DrawBodyClear();
+    render();
+    s_next_ms = now_ms() + MEM_REFRESH_MS;
+}
+
+static void show_requirements(ExperimentContext* ctx)
+{
+    (void)ctx;
+    Ui_DrawFrame("MEM", "OK:START  BACK");
+    Ui_Println("Heap use per module");
+    Ui_Println("DN: tags / heaps");
+    Ui_Println("OK: dump to serial");
+    Ui_Println("UP: event trace dump");
+}
+
+static void start(ExperimentContext* ctx)
+{
+    (void)ctx;
+    s_view = kMemViewTags;
+    redraw_all();
+    MemTrack_Log();
+}
+
+static void on_key(ExperimentContext* ctx, InputKey key)
+{
+    (void)ctx;
+
+    if (key == kInputDown) {
+        s_view = (MemView)((s_view + 1) % kMemViewCount);
+        redraw_all();
+    } else if (key == kInputUp) {
+        ESP_LOGI(TAG, "trace dump");
+        EvTrace_DumpUart();
+    } else if (key == kInputEnter) {
+        ESP_LOGI(TAG, "dump");
+        MemTrack_Log();
+    }
+}
+
+static void tick(ExperimentContext* ctx)
+{
+    (void)ctx;
+
+    uint32_t t = now_ms();
+    if (t < s_next_ms) return;
+    s_next_ms = t + MEM_REFRESH_MS;
+
+    render();
+}
+
+const Experiment g_exp_mem = {
+    .id = 14,
+    .title = "MEM",
+    .on_enter = 0,
+    .on_exit = 0,
+    .show_requirements = show_requirements,
+    .start = start,
+    .stop = 0,
+    .on_key = on_key,
+    .tick = tick,
+};
@@ -1,10 +1,13 @@
 #include "experiments/experiment.h"
 #include "ui/ui.h"
 
-#include "driver/i2s_std.h"
+#include "audio/mic_capture.h"
+#include "audio/mic_recorder.h"
 #include "esp_log.h"
 #include "esp_timer.h"
-#include <math.h>
+#include "dsp/fft_q15.h"
+#include "dsp/sound_level.h"
+#include <stdio.h>
 #include <string.h>
 
 // -------------------- MIC (INMP441) --------------------
@@ -12,152 +15,63 @@
 // SCK -> GPIO5
 // SD  -> GPIO6
 // LR  -> GND (LEFT)
-
-#define MIC_I2S_PORT      I2S_NUM_0
-#define MIC_SAMPLE_RATE   16000
-#define MIC_BITS          I2S_DATA_BIT_WIDTH_32BIT
-
-#define MIC_WS_GPIO       4
-#define MIC_SCK_GPIO      5
-#define MIC_SD_GPIO       6
-
-#define MIC_SAMPLES       256
-#define MIC_BANDS         10
-#define MIC_UI_PERIOD_MS  2000
-#define MIC_UI_SMOOTH_SHIFT 2
-#define MIC_UI_VOL_SMOOTH_SHIFT 3
+//
+// audio/mic_capture.c records continuously; every window of the stream goes
+// through a 512-point fixed-point FFT (50% overlap). Bins are summed into
+// log-spaced bands and the page redraws at ~30 fps. UP/DOWN switches to a
+// waterfall that scrolls in one spectrum line per window (62.5 lines/s).
+// The volume bar is an A-weighted sound level meter (dsp/sound_level.c,
+// fast time weighting) over the new half of each window; the stats line
+// adds the level and LAeq in dB SPL.
+//
+// OK records the stream to flash as IMA-ADPCM (audio/mic_recorder.c), DOWN
+// plays the last recording through the MAX98357. Status shows in the header.
+
+#define MIC_SAMPLES       512
+#define MIC_HOP           (MIC_SAMPLES / 2)
+#define MIC_BANDS         24
+#define MIC_BAND_LO_HZ    63
+#define MIC_BAND_HI_HZ    8000
+#define MIC_UI_PERIOD_MS  33
+#define MIC_STATS_PERIOD_MS 2000
+
+// Volume bar in dBFS(A)
+#define MIC_VOL_DB_FLOOR  (-50 * 256)
+#define MIC_VOL_DB_TOP    0
+
+// Bar scale in dBFS, and how fast a bar falls (attack is instant)
+#define MIC_DB_FLOOR      (-80 * 256)
+#define MIC_DB_TOP        (-10 * 256)
+#define MIC_DB_DECAY_Q8   (3 * 256 / 2)    // per window: 1.5 dB / 16 ms
+
+// Waterfall colour scale in dBFS, one level per FFT bin above DC
+#define MIC_WF_DB_FLOOR   (-90 * 256)
+#define MIC_WF_DB_TOP     (-20 * 256)
+#define MIC_WF_BINS       (MIC_SAMPLES / 2)
+
+typedef enum {
+    kMicViewBars = 0,
+    kMicViewWaterfall,
+} MicView;
 
 static const char* TAG = "EXP_MIC";
 
 static bool s_running = false;
-static i2s_chan_handle_t s_rx_chan = NULL;
-static int32_t s_i2s_buf[MIC_SAMPLES];
-static int16_t s_wave_buf[MIC_SAMPLES];
+static MicCaptureReader s_reader;
+static int16_t* s_win_buf = NULL;   // MIC_SAMPLES, from ctx arena
+static uint32_t* s_power = NULL;    // MIC_SAMPLES / 2 + 1, from ctx arena
+static FftQ15 s_fft;
+static uint16_t s_edges[MIC_BANDS + 1];
+static int32_t s_band_db[MIC_BANDS];    // falling peak, 1/256 dBFS
 static int s_band_levels[MIC_BANDS];
+static int s_peak_hz = 0;
 static uint32_t s_last_ui_ms = 0;
-static int s_vol_smooth = 0;
-static int s_band_smooth[MIC_BANDS];
-
-static void mic_start_driver(void)
-{
-    i2s_chan_config_t chan_cfg = I2S_CHANNEL_DEFAULT_CONFIG(MIC_I2S_PORT, I2S_ROLE_MASTER);
-    ESP_ERROR_CHECK(i2s_new_channel(&chan_cfg, NULL, &s_rx_chan));
-
-    i2s_std_config_t std_cfg = {
-        .clk_cfg = I2S_STD_CLK_DEFAULT_CONFIG(MIC_SAMPLE_RATE),
-        .slot_cfg = I2S_STD_MSB_SLOT_DEFAULT_CONFIG(MIC_BITS, I2S_SLOT_MODE_MONO),
-        .gpio_cfg = {
-            .mclk = I2S_GPIO_UNUSED,
-            .bclk = MIC_SCK_GPIO,
-            .ws = MIC_WS_GPIO,
-            .dout = I2S_GPIO_UNUSED,
-            .din = MIC_SD_GPIO,
-            .invert_flags = {
-                .mclk_inv = false,
-                .bclk_inv = false,
-                .ws_inv = false,
-            },
-        },
-    };
-    std_cfg.slot_cfg.slot_mask = I2S_STD_SLOT_LEFT;
-
-    ESP_ERROR_CHECK(i2s_channel_init_std_mode(s_rx_chan, &std_cfg));
-    ESP_ERROR_CHECK(i2s_channel_enable(s_rx_chan));
-}
-
-static void mic_stop_driver(void)
-{
-    if (s_rx_chan) {
-        i2s_channel_disable(s_rx_chan);
-        i2s_del_channel(s_rx_chan);
-        s_rx_chan = NULL;
-    }
-}
-
-static int calc_freq_zero_cross(const int16_t* s, int n, int sample_rate)
-{
-    if (!s || n < 4) return 0;
-
-    int crossings = 0;
-    int prev = s[0];
-    for (int i = 1; i < n; i++) {
-        int cur = s[i];
-        if ((prev <= 0 && cur > 0) || (prev >= 0 && cur < 0)) crossings++;
-        prev = cur;
-    }
-
-    float seconds = (float)n / (float)sample_rate;
-    float freq = (crossings / 2.0f) / seconds;
-    if (freq < 0) freq = 0;
-    if (freq > 20000) freq = 20000;
-    return (int)(freq + 0.5f);
-}
-
-static int calc_volume_pct(const int16_t* s, int n)
-{
-    if (!s || n <= 0) return 0;
-
-    int64_t sum_sq = 0;
-    for (int i = 0; i < n; i++) {
-        int32_t v = s[i];
-        sum_sq += (int64_t)v * v;
-    }
-    float rms = sqrtf((float)sum_sq / (float)n);
-    float db = 20.0f * log10f((rms / 32768.0f) + 1e-6f);
-    float pct = (db + 50.0f) * (100.0f / 50.0f);
-    if (pct < 0) pct = 0;
-    if (pct > 100) pct = 100;
-    return (int)(pct + 0.5f);
-}
-
-static void calc_octave_bands(const int16_t* s, int n, int sample_rate, int* out_levels, int out_count)
-{
-    if (!s || n <= 0 || !out_levels || out_count <= 0) return;
-
-    static const int centers[MIC_BANDS] = { 63, 125, 250, 500, 1000, 2000, 3000, 4000, 6000, 8000 };
-    float max_mag = 1.0f;
-
-    for (int b = 0; b < out_count; b++) {
-        float freq = (float)centers[b];
-        float w = 2.0f * 3.1415926f * freq / (float)sample_rate;
-        float cosw = cosf(w);
-        float coeff = 2.0f * cosw;
-
-        float q0 = 0.0f;
-        float q1 = 0.0f;
-        float q2 = 0.0f;
-
-        for (int i = 0; i < n; i++) {
-            q0 = coeff * q1 - q2 + (float)s[i];
-            q2 = q1;
-            q1 = q0;
-        }
-
-        float mag = q1 * q1 + q2 * q2 - coeff * q1 * q2;
-        if (mag < 0) mag = 0;
-        if (mag > max_mag) max_mag = mag;
-        out_levels[b] = (int)mag;
-    }
-
-    for (int b = 0; b < out_count; b++) {
-        float mag = (float)out_levels[b];
-        float db = 10.0f * log10f(mag + 1.0f);
-        float pct = (db - 20.0f) * (100.0f / 40.0f);
-        if (pct < 0) pct = 0;
-        if (pct > 100) pct = 100;
-        out_levels[b] = (int)(pct + 0.5f);
-    }
-}
-
-static int peak_band_freq(const int* bands, int band_count)
-{
-    static const int centers[MIC_BANDS] = { 63, 125, 250, 500, 1000, 2000, 3000, 4000, 6000, 8000 };
-    int best = 0;
-    for (int i = 1; i < band_count; i++) {
-        if (bands[i] > bands[best]) best = i;
-    }
-    return centers[best];
-}
+static uint32_t s_last_stats_ms = 0;
+static SoundLevel s_slm;
+static MicView s_view = kMicViewBars;
+static uint8_t s_wf_line[MIC_WF_BINS];
+static bool s_rec_ok = false;           // recorder buffers fit in the arena
+static char s_title[24];
 
 static void show_requirements(ExperimentContext* ctx)
 {
@@ -181,23 +95,77 @@ static void exp_on_exit(ExperimentContext* ctx)
     (void)ctx;
     ESP_LOGI(TAG, "on_exit");
     if (s_running) {
-        mic_stop_driver();
+        MicRec_Deinit();
+        MicCapture_Stop();
         s_running = false;
     }
 }
 
+static void format_title(char* out, size_t len)
+{
+    MicRecStats rs;
+    if (MicRec_IsRecording()) {
+        MicRec_GetStats(&rs);
+        snprintf(out, len, "MIC  REC %lus%s", (unsigned long)(rs.elapsed_ms / 1000), rs.dropped_blocks ? " !" : "");
+    } else if (MicRec_IsPlaying()) {
+        snprintf(out, len, "MIC  PLAY");
+    } else if (s_rec_ok && MicRec_GetStorage() == kMicRecStorageMounting) {
+        snprintf(out, len, "MIC  FLASH...");
+    } else if (s_rec_ok && MicRec_GetStorage() == kMicRecStorageFailed) {
+        snprintf(out, len, "MIC  NO FLASH");
+    } else {
+        snprintf(out, len, "MIC");
+    }
+}
+
+static void update_title(void)
+{
+    char t[sizeof(s_title)];
+    format_title(t, sizeof(t));
+    if (strcmp(t, s_title) == 0) return;
+    strcpy(s_title, t);
+    Ui_LcdLock();
+    Ui_DrawHeaderTitle(s_title);
+    Ui_LcdUnlock();
+}
+
+static void show_view(void)
+{
+    format_title(s_title, sizeof(s_title));
+    Ui_LcdLock();
+    Ui_DrawFrame(s_title, s_rec_ok ? "UP:VIEW OK:REC DN:PLAY" : "UP/DN:VIEW  BACK");
+    if (s_view == kMicViewWaterfall) Ui_BeginMicWaterfall((int)MicCapture_SampleRate() / 2);
+    else Ui_DrawMicBody(NULL, MIC_BANDS, 0, 0);
+    Ui_LcdUnlock();
+}
+
 static void start(ExperimentContext* ctx)
 {
-    (void)ctx;
     ESP_LOGI(TAG, "start");
-    mic_start_driver();
+
+    s_win_buf = (int16_t*)ExpArena_Alloc(&ctx->arena, kExpArenaNormal, MIC_SAMPLES * sizeof(int16_t));
+    s_power = (uint32_t*)ExpArena_Alloc(&ctx->arena, kExpArenaNormal, (MIC_SAMPLES / 2 + 1) * sizeof(uint32_t));
+    void* fft_mem = ExpArena_Alloc(&ctx->arena, kExpArenaNormal, FftQ15_MemBytes(MIC_SAMPLES));
+
+    MicCaptureConfig cfg = MIC_CAPTURE_DEFAULT_CONFIG();
+    if (!s_win_buf || !s_power || !FftQ15_Init(&s_fft, MIC_SAMPLES, fft_mem) ||
+        !MicCapture_Start(&cfg, &ctx->arena)) {
+        Ui_DrawFrame("MIC", "BACK");
+        Ui_Println("NO MEMORY / NO I2S");
+        return;
+    }
+    MicCapture_ReaderInit(&s_reader);
+    SoundLevel_Init(&s_slm, MicCapture_SampleRate());
+    s_rec_ok = MicRec_Init(&ctx->arena);
+    FftQ15_LogBandEdges(MIC_SAMPLES, (int)MicCapture_SampleRate(), MIC_BAND_LO_HZ, MIC_BAND_HI_HZ, MIC_BANDS,
+                        s_edges);
     s_running = true;
 
-    Ui_DrawFrame("MIC", "BACK");
-    Ui_DrawMicBody(NULL, 0, 0, 0);
+    show_view();
     s_last_ui_ms = 0;
-    s_vol_smooth = 0;
-    for (int i = 0; i < MIC_BANDS; i++) s_band_smooth[i] = 0;
+    s_last_stats_ms = 0;
+    s_peak_hz = 0;
+    for (int i = 0; i < MIC_BANDS; i++) s_band_db[i] = MIC_DB_FLOOR;
 }
 
 static void stop(ExperimentContext* ctx)
@@ -205,15 +173,76 @@ static void stop(ExperimentContext* ctx)
     (void)ctx;
     ESP_LOGI(TAG, "stop");
     if (s_running) {
-        mic_stop_driver();
+        MicRec_Deinit();
+        MicCapture_Stop();
         s_running = false;
     }
+    Ui_LcdLock();
+    Ui_EndMicWaterfall();
+    Ui_LcdUnlock();
+    s_win_buf = NULL;
+    s_power = NULL;
 }
 
 static void on_key(ExperimentContext* ctx, InputKey key)
 {
     (void)ctx;
-    if (key == kInputBack) return;
+    if (!s_running) return;
+    if (key == kInputUp || (key == kInputDown && !s_rec_ok)) {
+        s_view = s_view == kMicViewBars ? kMicViewWaterfall : kMicViewBars;
+        show_view();
+    } else if (key == kInputEnter && s_rec_ok) {
+        if (MicRec_IsRecording()) MicRec_Stop();
+        else MicRec_Start();
+        update_title();
+    } else if (key == kInputDown && s_rec_ok) {
+        if (MicRec_IsPlaying()) MicRec_PlayStop();
+        else MicRec_PlayStart();
+        update_title();
+    }
+}
+
+static void draw_waterfall_line(int exp)
+{
+    for (int k = 0; k < MIC_WF_BINS; k++) {
+        int32_t db = FftQ15_BinDbfs(&s_fft, s_power[k + 1], exp);
+        int v = 0;
+        if (db >= MIC_WF_DB_TOP) v = 255;
+        else if (db > MIC_WF_DB_FLOOR) v = (int)((db - MIC_WF_DB_FLOOR) * 255 / (MIC_WF_DB_TOP - MIC_WF_DB_FLOOR));
+        s_wf_line[k] = (uint8_t)v;
+    }
+
+    Ui_LcdLock();
+    Ui_DrawMicWaterfallLine(s_wf_line, MIC_WF_BINS);
+    Ui_LcdUnlock();
+}
+
+static void analyse_window(void)
+{
+    // Capture already removed DC (dsp/mic_convert.c). Windows overlap by
+    // half, so only the newest hop goes to the meter.
+    SoundLevel_Process(&s_slm, s_win_buf + MIC_SAMPLES - MIC_HOP, MIC_HOP);
+
+    int32_t db[MIC_BANDS];
+    int exp = FftQ15_Power(&s_fft, s_win_buf, s_power);
+    FftQ15_BandsDbfs(&s_fft, s_power, exp, s_edges, MIC_BANDS, db);
+    if (s_view == kMicViewWaterfall) draw_waterfall_line(exp);
+
+    int32_t loudest = MIC_DB_FLOOR;
+    for (int i = 0; i < MIC_BANDS; i++) {
+        int32_t fall = s_band_db[i] - MIC_DB_DECAY_Q8;
+        s_band_db[i] = db[i] > fall ? db[i] : fall;
+        if (db[i] > loudest) loudest = db[i];
+    }
+    // Pitch readout only when something stands out of the noise floor
+    s_peak_hz = loudest > MIC_DB_FLOOR + 20 * 256 ? FftQ15_PeakHz(&s_fft, s_power, (int)MicCapture_SampleRate(), 2) : 0;
+}
+
+static int db_to_pct(int32_t db_q8, int32_t floor_q8, int32_t top_q8)
+{
+    if (db_q8 <= floor_q8) return 0;
+    if (db_q8 >= top_q8) return 100;
+    return (int)((db_q8 - floor_q8) * 100 / (top_q8 - floor_q8));
 }
 
 static void tick(ExperimentContext* ctx)
@@ -221,47 +250,41 @@ static void tick(ExperimentContext* ctx)
     (void)ctx;
     if (!s_running) return;
 
+    // Consume everything captured since the last tick
+    while (MicCapture_ReadWindow(&s_reader, s_win_buf, MIC_SAMPLES, MIC_HOP, 0)) analyse_window();
+    MicRec_Poll();
+
     uint32_t now_ms = (uint32_t)(esp_timer_get_time() / 1000ULL);
     if (s_last_ui_ms && (now_ms - s_last_ui_ms) < MIC_UI_PERIOD_MS) {
         return;
     }
 
-    size_t bytes_read = 0;
-    esp_err_t r = i2s_channel_read(s_rx_chan, s_i2s_buf, sizeof(s_i2s_buf), &bytes_read, 0);
-    if (r != ESP_OK || bytes_read == 0) return;
-
-    int n = (int)(bytes_read / sizeof(int32_t));
-    if (n <= 0) return;
-
-    int64_t sum = 0;
-    for (int i = 0; i < n; i++) {
-        int32_t v = s_i2s_buf[i] >> 8; // 24-bit signed
-        sum += v;
-    }
-    int32_t mean = (int32_t)(sum / n);
-
-    int out_n = n;
-    if (out_n > MIC_SAMPLES) out_n = MIC_SAMPLES;
+    SoundLevels lv;
+    SoundLevel_GetLevels(&s_slm, &lv);
+    int vol_pct = db_to_pct(lv.fast_db_q8, MIC_VOL_DB_FLOOR, MIC_VOL_DB_TOP);
 
-    for (int i = 0; i < out_n; i++) {
-        int32_t v = (s_i2s_buf[i] >> 8) - mean;
-        s_wave_buf[i] = (int16_t)(v >> 7);
-    }
+    if (s_view == kMicViewBars) {
+        for (int i = 0; i < MIC_BANDS; i++) s_band_levels[i] = db_to_pct(s_band_db[i], MIC_DB_FLOOR, MIC_DB_TOP);
 
-    int vol = calc_volume_pct(s_wave_buf, out_n);
-    s_vol_smooth += (vol - s_vol_smooth) >> MIC_UI_VOL_SMOOTH_SHIFT;
-    vol = s_vol_smooth;
-    calc_octave_bands(s_wave_buf, out_n, MIC_SAMPLE_RATE, s_band_levels, MIC_BANDS);
-    for (int i = 0; i < MIC_BANDS; i++) {
-        s_band_smooth[i] += (s_band_levels[i] - s_band_smooth[i]) >> MIC_UI_SMOOTH_SHIFT;
-        s_band_levels[i] = s_band_smooth[i];
+        Ui_LcdLock();
+        Ui_DrawMicBody(s_band_levels, MIC_BANDS, s_peak_hz, vol_pct);
+        Ui_LcdUnlock();
     }
-    int freq = peak_band_freq(s_band_levels, MIC_BANDS);
-
-    Ui_LcdLock();
-    Ui_DrawMicBody(s_band_levels, MIC_BANDS, freq, vol);
-    Ui_LcdUnlock();
     s_last_ui_ms = now_ms;
+    update_title();     // also catches playback ending and a full partition
+
+    if (s_last_stats_ms && (now_ms - s_last_stats_ms) < MIC_STATS_PERIOD_MS) return;
+    s_last_stats_ms = now_ms;
+
+    MicCaptureStats cs;
+    MicCapture_GetStats(&cs);
+    ESP_LOGI(TAG, "capture blocks=%lu dma_ovf=%lu lapped=%lu (%lu samples) cpu=%lu.%lu%% dma=%lu us",
+             (unsigned long)cs.blocks, (unsigned long)cs.dma_overruns, (unsigned long)s_reader.overruns,
+             (unsigned long)s_reader.lost_samples, (unsigned long)(cs.cpu_permille / 10),
+             (unsigned long)(cs.cpu_permille % 10), (unsigned long)cs.dma_latency_us);
+    ESP_LOGI(TAG, "level %ld dB(A) SPL (%ld dBFS), LAeq %ld dB(A) SPL",
+             (long)((lv.fast_db_q8 + SOUND_LEVEL_SPL_OFFSET_Q8 + 128) >> 8), (long)((lv.fast_db_q8 + 128) >> 8),
+             (long)((lv.leq_db_q8 + SOUND_LEVEL_SPL_OFFSET_Q8 + 128) >> 8));
 }
 
 const Experiment g_exp_mic = {
@@ -274,4 +297,5 @@ const Experiment g_exp_mic = {
     .stop = stop,
     .on_key = on_key,
     .tick = tick,
+    .tick_ms = 10,      // paced to MIC_UI_PERIOD_MS in tick()
 };
@@ -0,0 +1,290 @@
+#include "experiments/experiment.h"
+#include "ui/ui.h"
+
+#include "audio/mic_monitor.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include <stdio.h>
+
+// -------------------- MONITOR (INMP441 -> MAX98357) --------------------
+// Mic and speaker at once, same wiring as MIC and SPK. audio/mic_monitor.c
+// sends every captured block through the effect chain to the speaker.
+//
+// DN picks a row, UP/OK change it. BLOCK and DMA restart the pipeline, so
+// each setting is a fresh run of the latency and glitch counters: step the
+// block down until the glitches start to find the smallest usable frame.
+// PING plays a click and times it back through the mic.
+
+#define MON_UI_PERIOD_MS    500
+#define MON_LOG_EVERY       4           // UI periods
+#define MON_DMA_MIN         2
+#define MON_DMA_MAX         6
+#define MON_GAIN_STEP_DB    3
+#define MON_ROW_LIVE        (UI_MONITOR_ROWS + 1)
+
+static const char* TAG = "EXP_MON";
+
+static const uint16_t kBlocks[] = { 16, 32, 64, 128 };
+#define MON_BLOCK_COUNT ((int)(sizeof(kBlocks) / sizeof(kBlocks[0])))
+
+static bool s_running = false;
+static int s_sel = 0;               // 0..4: BLOCK, DMA, GAIN, FX, PING
+static int s_block_idx = 1;         // 32 samples, 2 ms at 16 kHz
+static int s_dma = MON_DMA_MIN;
+static int s_gain_db = 0;
+static AudioFxPreset s_preset = kAudioFxClean;
+static bool s_pinging = false;
+static uint32_t s_last_ui_ms = 0;
+static uint32_t s_ui_periods = 0;
+static ExpArenaMark s_pipe_mark;    // arena before the pipeline buffers
+
+static int clamp_int(int v, int lo, int hi)
+{
+    if (v < lo) return lo;
+    if (v > hi) return hi;
+    return v;
+}
+
+static void draw_body(void)
+{
+    MicMonitorConfig cfg = MIC_MONITOR_DEFAULT_CONFIG(kBlocks[s_block_idx]);
+    int block_us = (int)(cfg.block_samples * 1000000u / cfg.sample_rate);
+    Ui_DrawMonitorBody(s_sel, cfg.block_samples, block_us, s_dma, s_gain_db, AudioFx_PresetName(s_preset),
+                       s_pinging);
+}
+
+static void draw_live(const MicMonitorStats* st)
+{
+    const uint16_t label = Ui_ColorRGB(160, 160, 160);
+    const uint16_t value = Ui_ColorRGB(230, 230, 230);
+    const uint16_t bad = Ui_ColorRGB(255, 120, 120);
+    char line[40];
+
+    snprintf(line, sizeof(line), "%lu.%lu ms  max %lu.%lu", (unsigned long)(st->latency_us / 1000),
+             (unsigned long)(st->latency_us % 1000 / 100), (unsigned long)(st->latency_max_us / 1000),
+             (unsigned long)(st->latency_max_us % 1000 / 100));
+    Ui_DrawBodyTextRowTwoColor(MON_ROW_LIVE, "LAT", line, label, value);
+
+    if (st->ping_us) {
+        snprintf(line, sizeof(line), "%lu.%lu ms  miss %lu", (unsigned long)(st->ping_us / 1000),
+                 (unsigned long)(st->ping_us % 1000 / 100), (unsigned long)st->ping_fails);
+    } else {
+        snprintf(line, sizeof(line), "--  miss %lu", (unsigned long)st->ping_fails);
+    }
+    Ui_DrawBodyTextRowTwoColor(MON_ROW_LIVE + 1, "PING", line, label, value);
+
+    snprintf(line, sizeof(line), "%lu  in %lu out %lu", (unsigned long)st->glitches,
+             (unsigned long)(st->mic_overruns + st->lapped + st->resyncs),
+             (unsigned long)(st->underruns + st->starved_blocks));
+    Ui_DrawBodyTextRowTwoColor(MON_ROW_LIVE + 2, "GLT", line, label, st->glitches ? bad : value);
+
+    snprintf(line, sizeof(line), "%lu.%lu%%  fx %lu us", (unsigned long)(st->cpu_permille / 10),
+             (unsigned long)(st->cpu_permille % 10), (unsigned long)st->fx_us_max);
+    Ui_DrawBodyTextRowTwoColor(MON_ROW_LIVE + 3, "CPU", line, label, value);
+
+    snprintf(line, sizeof(line), "%3d%%  clip %lu", (int)st->peak * 100 / 32767,
+             (unsigned long)st->clipped_samples);
+    Ui_DrawBodyTextRowTwoColor(MON_ROW_LIVE + 4, "PEAK", line, label, value);
+}
+
+static void log_stats(const MicMonitorStats* st)
+{
+    ESP_LOGI(TAG, "block %u dma %d: lat %lu us (max %lu) ping %lu us, glitches %lu "
+             "(mic %lu lap %lu resync %lu under %lu starve %lu) fx_max %lu us cpu %lu.%lu%%",
+             (unsigned)kBlocks[s_block_idx], s_dma, (unsigned long)st->latency_us,
+             (unsigned long)st->latency_max_us, (unsigned long)st->ping_us, (unsigned long)st->glitches,
+             (unsigned long)st->mic_overruns, (unsigned long)st->lapped, (unsigned long)st->resyncs,
+             (unsigned long)st->underruns, (unsigned long)st->starved_blocks, (unsigned long)st->fx_us_max,
+             (unsigned long)(st->cpu_permille / 10), (unsigned long)(st->cpu_permille % 10));
+}
+
+static bool start_pipeline(ExperimentContext* ctx)
+{
+    MicMonitorConfig cfg = MIC_MONITOR_DEFAULT_CONFIG(kBlocks[s_block_idx]);
+    cfg.out_dma_desc = (uint8_t)s_dma;
+    if (!MicMonitor_Start(&cfg, &ctx->arena)) return false;
+    MicMonitor_SetGainDb(s_gain_db);
+    MicMonitor_SetPreset(s_preset);
+    return true;
+}
+
+static void draw_full(void)
+{
+    Ui_DrawFrame("MONITOR", "UP:-  DN:NEXT  OK:+  BACK");
+    draw_body();
+}
+
+static void show_requirements(ExperimentContext* ctx)
+{
+    (void)ctx;
+    Ui_DrawFrame("MONITOR", "OK:START  BACK");
+    Ui_Println("INMP441: WS 4 SCK 5 SD 6");
+    Ui_Println("MAX98357: DIN 7 BCLK 15");
+    Ui_Println("          LRCLK 16");
+    Ui_Println("");
+    Ui_Println("Mic -> FX -> speaker");
+    Ui_Println("Keep the gain low:");
+    Ui_Println("mic and speaker howl");
+}
+
+static void on_enter(ExperimentContext* ctx)
+{
+    (void)ctx;
+    ESP_LOGI(TAG, "on_enter");
+    s_sel = 0;
+    s_block_idx = 1;
+    s_dma = MON_DMA_MIN;
+    s_gain_db = 0;
+    s_preset = kAudioFxClean;
+}
+
+static void exp_on_exit(ExperimentContext* ctx)
+{
+    (void)ctx;
+    ESP_LOGI(TAG, "on_exit");
+    if (s_running) {
+        MicMonitor_Stop();
+        s_running = false;
+    }
+}
+
+static void start(ExperimentContext* ctx)
+{
+    ESP_LOGI(TAG, "start");
+    s_pinging = false;
+    s_last_ui_ms = 0;
+    s_ui_periods = 0;
+
+    s_pipe_mark = ExpArena_Mark(&ctx->arena);
+    if (!start_pipeline(ctx)) {
+        Ui_DrawFrame("MONITOR", "BACK");
+        Ui_Println("NO MEMORY / NO I2S");
+        return;
+    }
+    s_running = true;
+    draw_full();
+}
+
+static void stop(ExperimentContext* ctx)
+{
+    (void)ctx;
+    ESP_LOGI(TAG, "stop");
+    if (s_running) {
+        MicMonitor_Stop();
+        s_running = false;
+    }
+}
+
+// Block size and DMA depth are fixed per I2S channel, so a change means a
+// new pipeline: once the old one has stopped its buffers go back to the arena.
+static void restart(ExperimentContext* ctx)
+{
+    MicMonitor_Stop();
+    ExpArena_Release(&ctx->arena, s_pipe_mark);
+    s_running = start_pipeline(ctx);
+    s_last_ui_ms = 0;
+    s_ui_periods = 0;
+    if (!s_running) {
+        Ui_DrawFrame("MONITOR", "BACK");
+        Ui_Println("RESTART FAILED");
+    }
+}
+
+static void on_key(ExperimentContext* ctx, InputKey key)
+{
+    if (!s_running) return;
+
+    int dir = 0;
+    if (key == kInputDown) {
+        s_sel = (s_sel + 1) % UI_MONITOR_ROWS;
+    } else if (key == kInputUp) {
+        dir = -1;
+    } else if (key == kInputEnter) {
+        dir = 1;
+    } else {
+        return;
+    }
+
+    bool need_restart = false;
+    if (dir != 0) {
+        switch (s_sel) {
+        case 0: {
+            int idx = clamp_int(s_block_idx + dir, 0, MON_BLOCK_COUNT - 1);
+            need_restart = idx != s_block_idx;
+            s_block_idx = idx;
+            break;
+        }
+        case 1: {
+            int dma = clamp_int(s_dma + dir, MON_DMA_MIN, MON_DMA_MAX);
+            need_restart = dma != s_dma;
+            s_dma = dma;
+            break;
+        }
+        case 2:
+            s_gain_db = clamp_int(s_gain_db + dir * MON_GAIN_STEP_DB, AUDIO_FX_GAIN_DB_MIN, AUDIO_FX_GAIN_DB_MAX);
+            MicMonitor_SetGainDb(s_gain_db);
+            break;
+        case 3:
+            s_preset = (AudioFxPreset)((s_preset + kAudioFxCount + dir) % kAudioFxCount);
+            MicMonitor_SetPreset(s_preset);
+            break;
+        default:
+            if (dir > 0) {
+                MicMonitor_Ping();
+                s_pinging = true;
+            }
+            break;
+        }
+    }
+
+    if (need_restart) {
+        restart(ctx);
+        if (!s_running) return;
+        Ui_LcdLock();
+        draw_full();
+        Ui_LcdUnlock();
+        return;
+    }
+
+    Ui_LcdLock();
+    draw_body();
+    Ui_LcdUnlock();
+}
+
+static void tick(ExperimentContext* ctx)
+{
+    (void)ctx;
+    if (!s_running) return;
+
+    uint32_t now_ms = (uint32_t)(esp_timer_get_time() / 1000ULL);
+    bool pinging = MicMonitor_IsPinging();
+    bool ping_done = s_pinging && !pinging;
+
+    if (!ping_done && s_last_ui_ms && (now_ms - s_last_ui_ms) < MON_UI_PERIOD_MS) return;
+    s_last_ui_ms = now_ms;
+
+    MicMonitorStats st;
+    MicMonitor_GetStats(&st);
+
+    Ui_LcdLock();
+    if (ping_done) {
+        s_pinging = false;
+        draw_body();
+    }
+    draw_live(&st);
+    Ui_LcdUnlock();
+
+    if (++s_ui_periods % MON_LOG_EVERY == 0) log_stats(&st);
+}
+
+const Experiment g_exp_monitor = {
+    .id = 18,
+    .title = "MONITOR",
+    .on_enter = on_enter,
+    .on_exit = exp_on_exit,
+    .show_requirements = show_requirements,
+    .start = start,
+    .stop = stop,
+    .on_key = on_key,
+    .tick = tick,
+};
@@ -9,6 +9,8 @@
 #include "nvs_flash.h"
 #include "esp_netif.h"
 #include "esp_http_server.h"
+#include "esp_heap_caps.h"
+#include "mem_track.h"
 
 #include <string.h>
 #include <stdlib.h>
@@ -174,13 +176,14 @@ static esp_err_t http_ws_handler(httpd_req_t* req)
 
     if (frame.len == 0) return ESP_OK;
 
-    char* buf = (char*)calloc(1, frame.len + 1);
+    // Per-frame scratch, accounted to NET on the MEM page
+    char* buf = (char*)MemTrack_Calloc(kMemTagNet, 1, frame.len + 1, MALLOC_CAP_DEFAULT);
     if (!buf) return ESP_ERR_NO_MEM;
 
     frame.payload = (uint8_t*)buf;
     err = httpd_ws_recv_frame(req, &frame, frame.len);
     if (err != ESP_OK) {
-        free(buf);
+        MemTrack_Free(buf);
         return err;
     }
     buf[frame.len] = 0;
@@ -192,7 +195,7 @@ static esp_err_t http_ws_handler(httpd_req_t* req)
         parse_drive_line(buf, &s_state.throttle, &s_state.steer);
     }
 
-    free(buf);
+    MemTrack_Free(buf);
 
     // Optional ack
     // ws_send_text(req->handle, httpd_req_to_sockfd(req), "OK");
@@ -0,0 +1,137 @@
+#include "experiments/experiment.h"
+#include "core/input_replay.h"
+#include "ui/ui.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include "esp_log.h"
+
+static const char* TAG = "EXP_REPLAY";
+
+#define REPLAY_ROWS 12
+
+static char s_rows[REPLAY_ROWS][32];
+static InputReplayState s_drawn_state;
+static uint32_t s_drawn_seq;
+
+static void set_row(int row, const char* text, uint16_t fg)
+{
+    if (row < 0 || row >= REPLAY_ROWS) return;
+    if (strcmp(text, s_rows[row]) == 0) return;
+
+    strncpy(s_rows[row], text, sizeof(s_rows[row]) - 1);
+    s_rows[row][sizeof(s_rows[row]) - 1] = 0;
+    Ui_DrawBodyTextRowColor(row, s_rows[row], fg);
+}
+
+static void render(void)
+{
+    uint16_t head = Ui_ColorRGB(200, 200, 200);
+    uint16_t fg = Ui_ColorRGB(230, 230, 230);
+    char line[32];
+    int row = 0;
+
+    InputReplayState st = InputReplay_GetState();
+    const char* state = (st == kReplayRecording) ? "RECORDING" : (st == kReplayPlaying) ? "PLAYING" : "IDLE";
+    snprintf(line, sizeof(line), "STATE  %s", state);
+    set_row(row++, line, st == kReplayIdle ? fg : Ui_ColorRGB(255, 180, 80));
+
+    snprintf(line, sizeof(line), "SAVED  %lu keys %lu ms", (unsigned long)InputReplay_SavedCount(),
+             (unsigned long)InputReplay_SavedDurationMs());
+    set_row(row++, line, fg);
+    set_row(row++, "", fg);
+
+    InputReplayResult r;
+    if (InputReplay_GetResult(&r)) {
+        snprintf(line, sizeof(line), "LAST RUN #%lu %s", (unsigned long)r.seq, r.mode == kReplayFast ? "FAST" : "TIMED");
+        set_row(row++, line, head);
+        snprintf(line, sizeof(line), " KEYS   %lu", (unsigned long)r.events);
+        set_row(row++, line, fg);
+        snprintf(line, sizeof(line), " WALL   %lu ms", (unsigned long)r.wall_ms);
+        set_row(row++, line, fg);
+        snprintf(line, sizeof(line), " LCD    %lu KB %lu tx", (unsigned long)(r.lcd_bytes / 1024), (unsigned long)r.lcd_txns);
+        set_row(row++, line, fg);
+        snprintf(line, sizeof(line), " DMA    %lu ms", (unsigned long)r.lcd_wait_ms);
+        set_row(row++, line, fg);
+        if (r.mode == kReplayFast) {
+            snprintf(line, sizeof(line), " KEY    p50 %lu us", (unsigned long)r.key_p50_us);
+            set_row(row++, line, fg);
+            snprintf(line, sizeof(line), "        p99 %lu us", (unsigned long)r.key_p99_us);
+            set_row(row++, line, fg);
+        }
+    }
+    for (; row < REPLAY_ROWS; row++) set_row(row, "", fg);
+
+    s_drawn_state = st;
+    s_drawn_seq = InputReplay_GetResult(&r) ? r.seq : 0;
+}
+
+static void redraw_all(void)
+{
+    for (int r = 0; r < REPLAY_ROWS; r++) s_rows[r][0] = 0;
+    Ui_DrawFrame("REPLAY", "UP:REC DN:TIME OK:FAST");
+    Ui_DrawBodyClear();
+    render();
+}
+
+static void show_requirements(ExperimentContext* ctx)
+{
+    (void)ctx;
+    Ui_DrawFrame("REPLAY", "OK:START  BACK");
+    Ui_Println("Record a key journey,");
+    Ui_Println("replay it and time it");
+    Ui_Println("UP: record from here");
+    Ui_Println("Come back here to stop");
+    Ui_Println("DN: replay, real timing");
+    Ui_Println("OK: replay, full speed");
+}
+
+static void start(ExperimentContext* ctx)
+{
+    (void)ctx;
+
+    // A recording ends when the journey returns here, so a replay started
+    // from this page also ends on it.
+    if (InputReplay_GetState() == kReplayRecording) {
+        if (!InputReplay_StopRecording()) ESP_LOGE(TAG, "journey not saved");
+    }
+    redraw_all();
+}
+
+static void on_key(ExperimentContext* ctx, InputKey key)
+{
+    (void)ctx;
+
+    if (InputReplay_GetState() != kReplayIdle) return;
+
+    if (key == kInputUp) {
+        InputReplay_StartRecording();
+    } else if (key == kInputDown || key == kInputEnter) {
+        if (!InputReplay_Play(key == kInputEnter ? kReplayFast : kReplayTimed)) {
+            ESP_LOGW(TAG, "nothing to replay");
+        }
+    }
+    render();
+}
+
+static void tick(ExperimentContext* ctx)
+{
+    (void)ctx;
+
+    InputReplayResult r;
+    uint32_t seq = InputReplay_GetResult(&r) ? r.seq : 0;
+    if (InputReplay_GetState() != s_drawn_state || seq != s_drawn_seq) render();
+}
+
+const Experiment g_exp_replay = {
+    .id = 16,
+    .title = "REPLAY",
+    .on_enter = 0,
+    .on_exit = 0,
+    .show_requirements = show_requirements,
+    .start = start,
+    .stop = 0,
+    .on_key = on_key,
+    .tick = tick,
+};
@@ -1,9 +1,7 @@
 #include "experiments/experiment.h"
 #include "ui/ui.h"
 
-#include "driver/i2s_std.h"
-#include "freertos/FreeRTOS.h"
-#include "freertos/task.h"
+#include "audio/audio_out.h"
 #include "esp_log.h"
 #include <stdint.h>
 
@@ -11,28 +9,27 @@
 // DIN  -> GPIO7
 // BCLK -> GPIO15
 // LRCLK-> GPIO16
+//
+// Playback goes through the shared output engine (audio/audio_out.c): OK
+// queues the clip as a voice, volume changes ramp, and stopping fades out.
+// The clip is embedded IMA-ADPCM (packed at build time, see main/CMakeLists)
+// and decoded a block at a time as it plays. OK during playback switches the
+// engine's EQ between FLAT and SPEAKER for an A/B on the same clip.
 
-#define SPK_I2S_PORT     I2S_NUM_1
-#define SPK_SAMPLE_RATE  16000
-#define SPK_BITS         I2S_DATA_BIT_WIDTH_16BIT
-#define SPK_DIN_GPIO     7
-#define SPK_BCLK_GPIO    15
-#define SPK_LRCLK_GPIO   16
-
-extern const uint8_t _binary_hola_es_pcm_start[] asm("_binary_hola_es_pcm_start");
-extern const uint8_t _binary_hola_es_pcm_end[]   asm("_binary_hola_es_pcm_end");
+extern const uint8_t _binary_hola_es_ima_start[] asm("_binary_hola_es_ima_start");
+extern const uint8_t _binary_hola_es_ima_end[]   asm("_binary_hola_es_ima_end");
 
 static const char* TAG = "EXP_SPK";
 
-static i2s_chan_handle_t s_tx_chan = NULL;
-static TaskHandle_t s_play_task = NULL;
 static bool s_running = false;
 static bool s_playing = false;
-static volatile bool s_stop = false;
+static AudioVoice s_voice = -1;
 static int s_vol_pct = 100;
-static int32_t s_gain_q15 = 0;
+static int16_t s_gain_q15 = 0;
+static AudioOutEq s_eq = kAudioOutEqFlat;
 
 #define VOL_STEP_PCT 5
+#define SPK_FOOTER   "DN:-  UP:+  OK:PLAY/EQ  BACK"
 
 static int clamp_int(int v, int lo, int hi)
 {
@@ -49,74 +46,39 @@ static void update_gain_q15(void)
     int32_t q15 = (int32_t)(g * 32768.0f);
     if (q15 < 0) q15 = 0;
     if (q15 > 32767) q15 = 32767;
-    s_gain_q15 = q15;
+    s_gain_q15 = (int16_t)q15;
+    AudioOut_SetGain(s_voice, s_gain_q15);
 }
 
-static void spk_start_driver(void)
+static void play(void)
 {
-    i2s_chan_config_t chan_cfg = I2S_CHANNEL_DEFAULT_CONFIG(SPK_I2S_PORT, I2S_ROLE_MASTER);
-    ESP_ERROR_CHECK(i2s_new_channel(&chan_cfg, &s_tx_chan, NULL));
-
-    i2s_std_config_t std_cfg = {
-        .clk_cfg = I2S_STD_CLK_DEFAULT_CONFIG(SPK_SAMPLE_RATE),
-        .slot_cfg = I2S_STD_MSB_SLOT_DEFAULT_CONFIG(SPK_BITS, I2S_SLOT_MODE_MONO),
-        .gpio_cfg = {
-            .mclk = I2S_GPIO_UNUSED,
-            .bclk = SPK_BCLK_GPIO,
-            .ws = SPK_LRCLK_GPIO,
-            .dout = SPK_DIN_GPIO,
-            .din = I2S_GPIO_UNUSED,
-            .invert_flags = {
-                .mclk_inv = false,
-                .bclk_inv = false,
-                .ws_inv = false,
-            },
-        },
-    };
-    std_cfg.slot_cfg.slot_mask = I2S_STD_SLOT_LEFT;
-
-    ESP_ERROR_CHECK(i2s_channel_init_std_mode(s_tx_chan, &std_cfg));
-    ESP_ERROR_CHECK(i2s_channel_enable(s_tx_chan));
+    uint32_t bytes = (uint32_t)(_binary_hola_es_ima_end - _binary_hola_es_ima_start);
+    s_voice = AudioOut_PlayAsset(_binary_hola_es_ima_start, bytes, s_gain_q15);
+    s_playing = s_voice >= 0;
 }
 
-static void spk_stop_driver(void)
+static void log_stats(void)
 {
-    if (s_tx_chan) {
-        i2s_channel_disable(s_tx_chan);
-        i2s_del_channel(s_tx_chan);
-        s_tx_chan = NULL;
-    }
+    AudioOutStats st;
+    AudioOut_GetStats(&st);
+    // Decode cost per second of audio played
+    uint32_t dec_us_per_s = st.decoded_samples ? (uint32_t)((uint64_t)st.decode_us * AudioOut_SampleRate() /
+                                                            st.decoded_samples) : 0;
+    ESP_LOGI(TAG, "out blocks=%lu underruns=%lu clipped=%lu mix_max=%lu us (block %lu us) cpu=%lu.%lu%%",
+             (unsigned long)st.blocks, (unsigned long)st.underruns, (unsigned long)st.clipped_samples,
+             (unsigned long)st.mix_us_max, (unsigned long)st.block_us, (unsigned long)(st.cpu_permille / 10),
+             (unsigned long)(st.cpu_permille % 10));
+    ESP_LOGI(TAG, "decode %lu samples in %lu us: %lu us per second of audio", (unsigned long)st.decoded_samples,
+             (unsigned long)st.decode_us, (unsigned long)dec_us_per_s);
+    uint32_t eq_us_per_s = st.eq_samples ? (uint32_t)((uint64_t)st.eq_us * AudioOut_SampleRate() / st.eq_samples) : 0;
+    ESP_LOGI(TAG, "eq %s: %lu samples in %lu us: %lu us per second of audio", AudioOut_EqName(s_eq),
+             (unsigned long)st.eq_samples, (unsigned long)st.eq_us, (unsigned long)eq_us_per_s);
 }
 
-static void spk_play_task(void* arg)
+static void draw(void)
 {
-    (void)arg;
-    const uint8_t* p = _binary_hola_es_pcm_start;
-    size_t len = (size_t)(_binary_hola_es_pcm_end - _binary_hola_es_pcm_start);
-    const size_t chunk = 2048;
-    int16_t temp[chunk / 2];
-
-    while (!s_stop && len > 0) {
-        size_t n = (len > chunk) ? chunk : len;
-        size_t written = 0;
-        int samples = (int)(n / 2);
-        const int16_t* in = (const int16_t*)p;
-        for (int i = 0; i < samples; i++) {
-            int32_t v = (int32_t)in[i] * s_gain_q15;
-            v >>= 15;
-            if (v > 32767) v = 32767;
-            if (v < -32768) v = -32768;
-            temp[i] = (int16_t)v;
-        }
-        esp_err_t r = i2s_channel_write(s_tx_chan, temp, (size_t)(samples * 2), &written, portMAX_DELAY);
-        if (r != ESP_OK || written == 0) break;
-        p += written;
-        len -= written;
-    }
-
-    s_playing = false;
-    s_play_task = NULL;
-    vTaskDelete(NULL);
+    Ui_DrawFrame("SPK", SPK_FOOTER);
+    Ui_DrawSpeakerBody(s_playing, s_vol_pct, AudioOut_EqName(s_eq));
 }
 
 static void show_requirements(ExperimentContext* ctx)
@@ -140,14 +102,10 @@ static void exp_on_exit(ExperimentContext* ctx)
     (void)ctx;
     ESP_LOGI(TAG, "on_exit");
     if (s_running) {
-        s_stop = true;
-        vTaskDelay(pdMS_TO_TICKS(20));
-        if (s_play_task) {
-            vTaskDelete(s_play_task);
-            s_play_task = NULL;
-        }
+        AudioOut_Stop(s_voice);
+        AudioOut_Close();
+        s_voice = -1;
         s_playing = false;
-        spk_stop_driver();
         s_running = false;
     }
 }
@@ -159,15 +117,18 @@ static void start(ExperimentContext* ctx)
 
     if (s_running) return;
 
-    spk_start_driver();
-    s_stop = false;
+    if (!AudioOut_Open(NULL)) {
+        Ui_DrawFrame("SPK", "BACK");
+        Ui_Println("NO I2S");
+        return;
+    }
     s_running = true;
     s_playing = false;
+    s_voice = -1;
     s_vol_pct = 100;
     update_gain_q15();
-
-    Ui_DrawFrame("SPK", "DN:-  UP:+  OK:PLAY  BACK");
-    Ui_DrawSpeakerBody(s_playing, s_vol_pct);
+    AudioOut_SetEq(s_eq);
+    draw();
 }
 
 static void stop(ExperimentContext* ctx)
@@ -176,14 +137,11 @@ static void stop(ExperimentContext* ctx)
     ESP_LOGI(TAG, "stop");
     if (!s_running) return;
 
-    s_stop = true;
-    vTaskDelay(pdMS_TO_TICKS(20));
-    if (s_play_task) {
-        vTaskDelete(s_play_task);
-        s_play_task = NULL;
-    }
+    // Fades out, then the engine drains the DMA ring before closing I2S
+    AudioOut_Stop(s_voice);
+    AudioOut_Close();
+    s_voice = -1;
     s_playing = false;
-    spk_stop_driver();
     s_running = false;
 }
 
@@ -204,30 +162,29 @@ static void on_key(ExperimentContext* ctx, InputKey key)
         changed = true;
     } else if (key == kInputEnter) {
         if (s_playing) {
-            s_stop = true;
-            vTaskDelay(pdMS_TO_TICKS(20));
-            if (s_play_task) {
-                vTaskDelete(s_play_task);
-                s_play_task = NULL;
-            }
-            s_playing = false;
+            s_eq = (AudioOutEq)((s_eq + 1) % kAudioOutEqCount);
+            AudioOut_SetEq(s_eq);
         } else {
-            s_stop = false;
-            s_playing = true;
-            xTaskCreate(spk_play_task, "spk_play", 4096, NULL, 5, &s_play_task);
+            play();
         }
         changed = true;
     } else if (key == kInputBack) {
         return;
     }
 
-    if (changed) {
-        Ui_DrawFrame("SPK", "DN:-  UP:+  OK:PLAY  BACK");
-        Ui_DrawSpeakerBody(s_playing, s_vol_pct);
-    }
+    if (changed) draw();
 }
 
-static void tick(ExperimentContext* ctx) { (void)ctx; }
+static void tick(ExperimentContext* ctx)
+{
+    (void)ctx;
+    if (!s_running || !s_playing || AudioOut_IsActive(s_voice)) return;
+
+    // The clip ran out
+    s_playing = false;
+    log_stats();
+    draw();
+}
 
 const Experiment g_exp_speaker = {
     .id = 7,
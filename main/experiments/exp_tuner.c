@@ -0,0 +1,195 @@
+#include "experiments/experiment.h"
+#include "ui/ui.h"
+
+#include "audio/mic_capture.h"
+#include "dsp/pitch_yin.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include <string.h>
+
+// -------------------- TUNER (INMP441) --------------------
+// Same wiring and capture as MIC. Every hop of the captured stream goes
+// through dsp/pitch_yin.c; the page shows the nearest note and how far off
+// it is in cents.
+
+#define TUNER_FMIN_HZ       55          // A1
+#define TUNER_FMAX_HZ       1000
+#define TUNER_WINDOW        512         // 32 ms at 16 kHz
+#define TUNER_HOP           400         // 40 estimates per second
+#define TUNER_UI_PERIOD_MS  33
+#define TUNER_HOLD_MS       400         // keep the last note through short gaps
+#define TUNER_STATS_PERIOD_MS 2000
+
+static const char* TAG = "EXP_TUNER";
+
+static bool s_running = false;
+static MicCaptureReader s_reader;
+static PitchYin s_yin;
+static int16_t* s_frame = NULL;     // PitchYin_FrameSamples(), from ctx arena
+
+static uint32_t s_freq_centihz = 0; // last voiced estimate
+static int s_cents_smooth = 0;
+static int s_clarity_pct = 0;
+static uint32_t s_last_voiced_ms = 0;
+static uint32_t s_last_ui_ms = 0;
+static uint32_t s_last_stats_ms = 0;
+
+// Cost accounting between stats lines
+static uint32_t s_estimates = 0;
+static uint32_t s_voiced = 0;
+static uint64_t s_yin_us = 0;
+
+static void show_requirements(ExperimentContext* ctx)
+{
+    (void)ctx;
+    Ui_DrawFrame("TUNER", "OK:START  BACK");
+    Ui_Println("INMP441 I2S");
+    Ui_Println("WS  -> GPIO4");
+    Ui_Println("SCK -> GPIO5");
+    Ui_Println("SD  -> GPIO6");
+    Ui_Println("LR  -> GND (LEFT)");
+    Ui_Println("");
+    Ui_Println("55..1000 Hz, A4 = 440");
+}
+
+static void on_enter(ExperimentContext* ctx)
+{
+    (void)ctx;
+    ESP_LOGI(TAG, "on_enter");
+}
+
+static void exp_on_exit(ExperimentContext* ctx)
+{
+    (void)ctx;
+    ESP_LOGI(TAG, "on_exit");
+    if (s_running) {
+        MicCapture_Stop();
+        s_running = false;
+    }
+}
+
+static void start(ExperimentContext* ctx)
+{
+    ESP_LOGI(TAG, "start");
+
+    MicCaptureConfig cfg = MIC_CAPTURE_DEFAULT_CONFIG();
+    int tau_max = (int)((cfg.sample_rate + TUNER_FMIN_HZ - 1) / TUNER_FMIN_HZ);
+    void* yin_mem = ExpArena_Alloc(&ctx->arena, kExpArenaNormal, PitchYin_MemBytes(TUNER_WINDOW, tau_max));
+
+    if (!yin_mem ||
+        !PitchYin_Init(&s_yin, (int)cfg.sample_rate, TUNER_WINDOW, TUNER_FMIN_HZ, TUNER_FMAX_HZ, yin_mem)) {
+        Ui_DrawFrame("TUNER", "BACK");
+        Ui_Println("NO MEMORY");
+        return;
+    }
+    s_frame = (int16_t*)ExpArena_Alloc(&ctx->arena, kExpArenaNormal,
+                                       (size_t)PitchYin_FrameSamples(&s_yin) * sizeof(int16_t));
+    if (!s_frame || !MicCapture_Start(&cfg, &ctx->arena)) {
+        Ui_DrawFrame("TUNER", "BACK");
+        Ui_Println("NO MEMORY / NO I2S");
+        return;
+    }
+    MicCapture_ReaderInit(&s_reader);
+    s_running = true;
+
+    s_freq_centihz = 0;
+    s_cents_smooth = 0;
+    s_clarity_pct = 0;
+    s_last_voiced_ms = 0;
+    s_last_ui_ms = 0;
+    s_last_stats_ms = 0;
+    s_estimates = 0;
+    s_voiced = 0;
+    s_yin_us = 0;
+
+    Ui_DrawFrame("TUNER", "BACK");
+    Ui_DrawTunerBody(NULL, 0, 0, 0);
+}
+
+static void stop(ExperimentContext* ctx)
+{
+    (void)ctx;
+    ESP_LOGI(TAG, "stop");
+    if (s_running) {
+        MicCapture_Stop();
+        s_running = false;
+    }
+    s_frame = NULL;
+}
+
+static void on_key(ExperimentContext* ctx, InputKey key)
+{
+    (void)ctx;
+    (void)key;
+}
+
+static void analyse_frame(uint32_t now_ms)
+{
+    PitchYinResult r;
+    int64_t t0 = esp_timer_get_time();
+    bool voiced = PitchYin_Estimate(&s_yin, s_frame, &r);
+    s_yin_us += (uint64_t)(esp_timer_get_time() - t0);
+    s_estimates++;
+    if (!voiced) return;
+
+    int cents;
+    int prev_note = PitchYin_NoteCents(s_freq_centihz, NULL);
+    int note = PitchYin_NoteCents(r.freq_centihz, &cents);
+
+    // Smooth the needle within a note, jump on a note change
+    if (note != prev_note || s_freq_centihz == 0) s_cents_smooth = cents;
+    else s_cents_smooth += (cents - s_cents_smooth) / 2;
+
+    s_freq_centihz = r.freq_centihz;
+    s_clarity_pct = (int)(((uint32_t)r.clarity_q15 * 100u) >> 15);
+    s_last_voiced_ms = now_ms;
+    s_voiced++;
+}
+
+static void tick(ExperimentContext* ctx)
+{
+    (void)ctx;
+    if (!s_running) return;
+
+    uint32_t now_ms = (uint32_t)(esp_timer_get_time() / 1000ULL);
+    uint32_t frame = (uint32_t)PitchYin_FrameSamples(&s_yin);
+    while (MicCapture_ReadWindow(&s_reader, s_frame, frame, TUNER_HOP, 0)) analyse_frame(now_ms);
+
+    if (s_freq_centihz && (now_ms - s_last_voiced_ms) > TUNER_HOLD_MS) s_freq_centihz = 0;
+
+    if (s_last_ui_ms && (now_ms - s_last_ui_ms) < TUNER_UI_PERIOD_MS) return;
+    s_last_ui_ms = now_ms;
+
+    char name[8];
+    int note = PitchYin_NoteCents(s_freq_centihz, NULL);
+    PitchYin_NoteName(note, name, sizeof(name));
+
+    Ui_LcdLock();
+    Ui_DrawTunerBody(s_freq_centihz ? name : NULL, s_cents_smooth, s_freq_centihz, s_clarity_pct);
+    Ui_LcdUnlock();
+
+    if (s_last_stats_ms && (now_ms - s_last_stats_ms) < TUNER_STATS_PERIOD_MS) return;
+    uint32_t span_ms = s_last_stats_ms ? now_ms - s_last_stats_ms : 0;
+    s_last_stats_ms = now_ms;
+    if (!span_ms || !s_estimates) return;
+
+    ESP_LOGI(TAG, "estimates=%lu/s voiced=%lu yin=%lu us avg lapped=%lu",
+             (unsigned long)(s_estimates * 1000u / span_ms), (unsigned long)s_voiced,
+             (unsigned long)(s_yin_us / s_estimates), (unsigned long)s_reader.overruns);
+    s_estimates = 0;
+    s_voiced = 0;
+    s_yin_us = 0;
+}
+
+const Experiment g_exp_tuner = {
+    .id = 17,
+    .title = "TUNER",
+    .on_enter = on_enter,
+    .on_exit = exp_on_exit,
+    .show_requirements = show_requirements,
+    .start = start,
+    .stop = stop,
+    .on_key = on_key,
+    .tick = tick,
+    .tick_ms = 10,      // paced to TUNER_UI_PERIOD_MS in tick()
+};
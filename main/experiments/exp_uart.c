@@ -2,235 +2,674 @@
 #include "ui/ui.h"
 
 #include "input/uart1_router.h"
+#include "input/uart_pkt.h"
+#include "input/uart_proto2.h"
 #include "core/app_events.h"
+#include "core/lat_stats.h"
 
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
+#include "esp_timer.h"
+#include "evtrace.h"
+#include "dlog.h"
 
 #include <stdint.h>
 #include <stdbool.h>
-
-#define PKT_HEAD 0xBB
-#define PKT_TAIL 0x66
+#include <stdio.h>
+#include <string.h>
+
+#define PKT_MAX_DATA 256
+#define PKT_GAP_MS   20     // idle time that abandons a half-received frame
+#define UI_PERIOD_MS 200
+#define UI_ROWS      10
+#define LAST_SHOWN   12     // payload bytes kept for the screen
+#define V2_ACK_EVERY 4      // cumulative ack after this many frames (or on idle)
+#define TELEM_RING   64     // telemetry requests, power of two
+#define TELEM_VERSION 1
+
+#define BENCH_SAMPLES     256   // RTT window for percentiles
+#define BENCH_HDR         8     // probe payload: id32, t_us32, filler
+#define BENCH_FLOOD_DEPTH 4     // probes in flight at rate MAX
+#define BENCH_MAX_DEPTH   32    // cap for paced rates when the peer stalls
+#define BENCH_LOSS_MS     1000  // no reply for this long: in-flight probes are lost
 
 typedef enum {
-    kWaitHead = 0,
-    kWaitLen,
-    kWaitData,
-    kWaitSum,
-    kWaitTail
-} ParseState;
+    kUartModeV1 = 0,        // BB LEN DATA SUM 66, inverted echo
+    kUartModeV2,            // uart_proto2 receiver with acks
+    kUartModeBench,         // v2 probes out, echoed back by the far end
+    kUartModeLink,          // framing and link counters; data is discarded
+    kUartModeCount,
+} UartMode;
 
-typedef struct {
-    bool running;
-    TaskHandle_t task;
+static const uint32_t k_link_bauds[] = { 115200, 460800, 921600, 1500000, 2000000 };
+#define LINK_NUM_BAUDS (sizeof(k_link_bauds) / sizeof(k_link_bauds[0]))
 
-    ParseState st;
-    uint8_t len;
-    uint8_t pos;
-    uint8_t data[256];
-    uint8_t sum;
+static const uint16_t k_bench_sizes[] = { 16, 64, 256, 1024 };
+static const uint16_t k_bench_rates[] = { 10, 50, 100, 0 };    // probes/s, 0 = MAX
+#define BENCH_NUM_SIZES (sizeof(k_bench_sizes) / sizeof(k_bench_sizes[0]))
+#define BENCH_NUM_RATES (sizeof(k_bench_rates) / sizeof(k_bench_rates[0]))
 
-    uint32_t ok_count;
-    uint32_t err_count;
-    uint32_t drop_count;
+typedef struct {
+    bool ok;
+    const char* status;
+    uint16_t len;
+    uint8_t a;              // V1: sum,  V2: seq
+    uint8_t b;              // V1: tail, V2: ack sent back
+    uint8_t data[LAST_SHOWN];
+} LastPacket;
 
-    uint32_t last_ui_ms;
+typedef struct {
+    volatile bool running;
+    volatile TaskHandle_t task;
+
+    volatile UartMode req_mode;     // set by on_key, applied by the task
+    UartMode mode;
+
+    UartPktParser parser;
+    uint8_t* data;      // PKT_MAX_DATA, from ctx arena
+    uint8_t* tx_data;   // PKT_MAX_DATA, from ctx arena
+
+    Up2Parser v2_parser;
+    Up2Rx v2_rx;
+    uint8_t* v2_data;   // UP2_MAX_PAYLOAD, from ctx arena
+    uint8_t v2_ack_flags;
+    volatile uint32_t good_bytes;
+    volatile uint32_t v2_ooo;
+
+    // Bench mode; the size/rate indexes change from on_key, cfg_gen tells
+    // the task to restart with them
+    volatile uint8_t bench_size_idx;
+    volatile uint8_t bench_rate_idx;
+    volatile uint32_t bench_cfg_gen;
+    uint32_t bench_applied_gen;
+    uint8_t* bench_tx;          // UP2_MAX_FRAME, from ctx arena
+    uint8_t* bench_payload;     // UP2_MAX_PAYLOAD, from ctx arena
+    uint32_t* bench_samples;    // BENCH_SAMPLES, from ctx arena
+    uint32_t* bench_sorted;     // BENCH_SAMPLES, from ctx arena (UI side)
+    LatStats bench_lat;         // under last_mux
+    uint32_t bench_next_id;
+    uint32_t bench_valid_from;  // replies to older ids were written off as lost
+    uint32_t bench_in_flight;
+    uint32_t bench_next_due_us;
+    uint32_t bench_progress_ms;
+    volatile uint32_t bench_sent;
+    volatile uint32_t bench_lost;
+    bool bench_paused;          // link not in COBS framing
+
+    // COBS telemetry channel, answered by the task while the page is open
+    SpscRing telem_ring;
+    uint8_t telem_buf[TELEM_RING];
+    volatile uint32_t telem_replies;
+
+    // LINK page: counters at the last baud change, so drops read per rate
+    Uart1RouterStats link_base;
+    Uart1Framing saved_framing;     // router settings at start(), put back by stop()
+    uint32_t saved_baud;
+
+    // Written by the task, read by tick()
+    volatile uint32_t ok_count;
+    volatile uint32_t err_count;
+    volatile uint32_t drop_count;
+    LastPacket last;
+    uint32_t last_seq;
+    portMUX_TYPE last_mux;
+
+    // UI side
+    uint32_t ui_next_ms;
+    uint32_t ui_prev_ms;
+    uint32_t ui_prev_pkts;
+    uint32_t ui_prev_rx;
+    uint32_t ui_prev_good;
+    uint32_t goodput;
+    uint32_t ui_seen_seq;
+    UartMode ui_mode;
+    uint32_t pkts_per_s;
+    uint32_t bytes_per_s;
+    char rows[UI_ROWS][32];
 } UartExp;
 
-static UartExp s_exp = {0};
+static UartExp s_exp = { .last_mux = portMUX_INITIALIZER_UNLOCKED };
 
 static uint32_t now_ms(void)
 {
     return (uint32_t)(xTaskGetTickCount() * (1000 / configTICK_RATE_HZ));
 }
 
-static uint8_t calc_sum(uint8_t len, const uint8_t* data)
+static uint32_t now_us(void)
 {
-    uint32_t s = 0;
-    for (uint32_t i = 0; i < len; i++) s += data[i];
-    return (uint8_t)(s & 0xFF);
+    return (uint32_t)esp_timer_get_time();
 }
 
-static void send_reply_invert(const uint8_t* data, uint8_t len)
+// Probes are raw binary: only COBS framing carries them intact
+static bool bench_link_ok(void)
 {
-    uint8_t out_data[256];
-    for (uint32_t i = 0; i < len; i++) out_data[i] = (uint8_t)(~data[i]);
-
-    uint8_t out_sum = calc_sum(len, out_data);
+    return Uart1Router_GetFraming() == kUart1FramingCobs;
+}
 
-    uint8_t b0 = PKT_HEAD;
-    uint8_t b1 = len;
-    uint8_t b2 = out_sum;
-    uint8_t b3 = PKT_TAIL;
+static void send_reply_invert(const uint8_t* data, uint8_t len)
+{
+    uint8_t hdr[2];
+    uint8_t trl[2];
+    UartPkt_BuildInvertReply(data, len, hdr, s_exp.tx_data, trl);
+
+    const Uart1Iov iov[3] = {
+        { hdr, sizeof(hdr) },
+        { s_exp.tx_data, len },
+        { trl, sizeof(trl) },
+    };
+    Uart1Router_WriteV(iov, 3);
+}
 
-    Uart1Router_Write(&b0, 1);
-    Uart1Router_Write(&b1, 1);
-    if (len > 0) Uart1Router_Write(out_data, len);
-    Uart1Router_Write(&b2, 1);
-    Uart1Router_Write(&b3, 1);
+// Next rate in k_link_bauds after the current one; the far end has to follow
+static void link_next_baud(void)
+{
+    Uart1RouterStats rs;
+    Uart1Router_GetStats(&rs);
+    size_t i = 0;
+    while (i < LINK_NUM_BAUDS && k_link_bauds[i] <= rs.baudrate) i++;
+    if (i == LINK_NUM_BAUDS) i = 0;
+
+    Uart1Router_SetBaudrate(k_link_bauds[i]);
+    Uart1Router_GetStats(&s_exp.link_base);
 }
+
 static void on_key(ExperimentContext* ctx, InputKey key)
 {
     (void)ctx;
-    if (key == kInputEnter) {
+    bool bench = (s_exp.req_mode == kUartModeBench);
+
+    if (key == kInputEnter && s_exp.req_mode == kUartModeLink) {
+        // The far end has to follow; the new framing applies from the next block
+        bool cobs = Uart1Router_GetFraming() == kUart1FramingCobs;
+        Uart1Router_SetFraming(cobs ? kUart1FramingLegacy : kUart1FramingCobs);
+    } else if (key == kInputDown && s_exp.req_mode == kUartModeLink) {
+        link_next_baud();
+    } else if (key == kInputEnter) {
         s_exp.ok_count = 0;
         s_exp.err_count = 0;
         s_exp.drop_count = 0;
-        // If you have the new UI style, call your redraw here:
-        // ui_draw_static(); or ui_update_status_only();
-        // Otherwise:
-        // ui_draw();
+        s_exp.ui_prev_pkts = 0;
+        if (bench) {
+            s_exp.bench_rate_idx = (uint8_t)((s_exp.bench_rate_idx + 1) % BENCH_NUM_RATES);
+            s_exp.bench_cfg_gen++;
+        }
+    } else if (key == kInputDown && bench) {
+        s_exp.bench_size_idx = (uint8_t)((s_exp.bench_size_idx + 1) % BENCH_NUM_SIZES);
+        s_exp.bench_cfg_gen++;
+    } else if (key == kInputUp) {
+        s_exp.req_mode = (UartMode)((s_exp.req_mode + 1) % kUartModeCount);
     }
 }
 
-static void parser_reset(void)
+static void set_row(int row, const char* text, uint16_t fg)
 {
-    s_exp.st = kWaitHead;
-    s_exp.len = 0;
-    s_exp.pos = 0;
-    s_exp.sum = 0;
+    if (row < 0 || row >= UI_ROWS) return;
+    if (strcmp(text, s_exp.rows[row]) == 0) return;
+
+    strncpy(s_exp.rows[row], text, sizeof(s_exp.rows[row]) - 1);
+    s_exp.rows[row][sizeof(s_exp.rows[row]) - 1] = 0;
+    Ui_DrawBodyTextRowColor(row, s_exp.rows[row], fg);
 }
 
 static void ui_draw_static(void)
 {
-    Ui_Clear();
-    Ui_Println("UART EXP (UART1)");
-    Ui_Println("PKT: BB LEN DATA SUM 66");
-    Ui_Println("");
-
-    Ui_Println("HEAD    :");
-    Ui_Println("LEN     :");
-    Ui_Println("DATA    :");
-    Ui_Println("CHECKSUM:");
-    Ui_Println("TAIL    :");
-    Ui_Println("STATUS  :");
-
-    Ui_Println("");
-    Ui_Println("ENTER=CLR BACK=EXIT");
+    for (int r = 0; r < UI_ROWS; r++) s_exp.rows[r][0] = 0;
+    s_exp.ui_mode = s_exp.req_mode;
+    s_exp.ui_seen_seq = 0;
+    if (s_exp.ui_mode == kUartModeBench) {
+        Ui_DrawFrame("UART BENCH", "UP:MODE DN:SIZE OK:RATE");
+    } else if (s_exp.ui_mode == kUartModeLink) {
+        Ui_DrawFrame("UART LINK", "UP:MODE DN:BAUD OK:FRM");
+    } else {
+        Ui_DrawFrame("UART", "UP:MODE  OK:CLR  BACK");
+    }
+    Ui_DrawBodyClear();
 }
 
-static void ui_update_last_packet(uint8_t head, uint8_t len,
-                                  const uint8_t* data, uint8_t sum,
-                                  uint8_t tail, bool ok)
+static void fmt_ms(char* out, size_t cap, uint32_t us)
 {
-    // Redraw the 6 lines only (simple approach: clear + reprint static + packet)
-    // If you want true partial line redraw later, we can add Ui_DrawTextAt().
-    Ui_Clear();
-    Ui_Println("UART EXP (UART1)");
-    Ui_Println("PKT: BB LEN DATA SUM 66");
-    Ui_Println("");
+    snprintf(out, cap, "%lu.%02lu", (unsigned long)(us / 1000), (unsigned long)((us % 1000) / 10));
+}
+
+static void ui_update_bench(void)
+{
+    uint16_t fg = Ui_ColorRGB(230, 230, 230);
+    char line[32];
+    char a[12];
+    char b[12];
+
+    uint32_t n;
+    uint32_t max;
+    portENTER_CRITICAL(&s_exp.last_mux);
+    n = LatStats_Snapshot(&s_exp.bench_lat, s_exp.bench_sorted);
+    max = s_exp.bench_lat.max;
+    portEXIT_CRITICAL(&s_exp.last_mux);
+
+    // Percentiles over the last BENCH_SAMPLES replies, max since reset
+    LatSummary sum;
+    LatStats_Percentiles(s_exp.bench_sorted, n, &sum);
+
+    if (!bench_link_ok()) {
+        set_row(5, "NEEDS COBS FRAMING", Ui_ColorRGB(255, 160, 120));
+        set_row(6, "SET IT ON LINK (UP)", fg);
+        set_row(7, "", fg);
+        set_row(8, "", fg);
+        return;
+    }
+
+    uint16_t rate = k_bench_rates[s_exp.bench_rate_idx];
+    if (rate) snprintf(a, sizeof(a), "%u/S", (unsigned)rate);
+    else snprintf(a, sizeof(a), "MAX");
+    snprintf(line, sizeof(line), "SIZE %u RATE %s", (unsigned)k_bench_sizes[s_exp.bench_size_idx], a);
+    set_row(5, line, Ui_ColorRGB(120, 220, 255));
+
+    fmt_ms(a, sizeof(a), sum.p50);
+    snprintf(line, sizeof(line), "RTT P50 %s MS", a);
+    set_row(6, line, fg);
+    fmt_ms(a, sizeof(a), sum.p99);
+    fmt_ms(b, sizeof(b), max);
+    snprintf(line, sizeof(line), "P99 %s MAX %s", a, b);
+    set_row(7, line, fg);
+    snprintf(line, sizeof(line), "TX %lu LOST %lu", (unsigned long)s_exp.bench_sent,
+             (unsigned long)s_exp.bench_lost);
+    set_row(8, line, s_exp.bench_lost ? Ui_ColorRGB(255, 160, 120) : fg);
+}
 
-    char line[128];
+static void ui_update_link(const Uart1RouterStats* rs)
+{
+    uint16_t fg = Ui_ColorRGB(230, 230, 230);
+    char line[32];
+
+    const Uart1RouterStats* b = &s_exp.link_base;
+    bool cobs = Uart1Router_GetFraming() == kUart1FramingCobs;
+    snprintf(line, sizeof(line), "%lu %s", (unsigned long)rs->baudrate, cobs ? "COBS" : "LEGACY");
+    set_row(5, line, Ui_ColorRGB(120, 220, 255));
+
+    // Drops since the rate was set
+    uint32_t ovr = rs->ring_overrun_bytes - b->ring_overrun_bytes;
+    uint32_t hw = rs->hw_overruns - b->hw_overruns;
+    uint32_t mux_err = rs->mux_errors - b->mux_errors;
+    snprintf(line, sizeof(line), "@RATE OVR %lu HW %lu", (unsigned long)ovr, (unsigned long)hw);
+    set_row(6, line, (ovr || hw) ? Ui_ColorRGB(255, 120, 120) : fg);
+    snprintf(line, sizeof(line), "MUX OK %lu ERR %lu", (unsigned long)(rs->mux_frames - b->mux_frames),
+             (unsigned long)mux_err);
+    set_row(7, line, mux_err ? Ui_ColorRGB(255, 160, 120) : fg);
+    snprintf(line, sizeof(line), "KEYS %lu TLM %lu", (unsigned long)rs->key_frames,
+             (unsigned long)s_exp.telem_replies);
+    set_row(8, line, fg);
+}
 
-    snprintf(line, sizeof(line), "HEAD    : 0x%02X", (unsigned)head);
-    Ui_Println(line);
+static void ui_update(void)
+{
+    uint16_t fg = Ui_ColorRGB(230, 230, 230);
+    uint16_t dim = Ui_ColorRGB(160, 160, 160);
+    char line[32];
+
+    if (s_exp.req_mode != s_exp.ui_mode) ui_draw_static();
+
+    uint32_t t = now_ms();
+    uint32_t ok = s_exp.ok_count;
+    uint32_t err = s_exp.err_count;
+    uint32_t pkts = ok + err;
+
+    Uart1RouterStats rs;
+    Uart1Router_GetStats(&rs);
+
+    // Rates over the last UI period
+    uint32_t dt = t - s_exp.ui_prev_ms;
+    if (dt > 0 && s_exp.ui_prev_ms) {
+        uint32_t dp = (pkts >= s_exp.ui_prev_pkts) ? pkts - s_exp.ui_prev_pkts : 0;
+        s_exp.pkts_per_s = dp * 1000u / dt;
+        s_exp.bytes_per_s = (rs.rx_bytes - s_exp.ui_prev_rx) * 1000u / dt;
+        // Goodput: in-order V2 or echoed bench payload bytes (restarts on mode switch)
+        uint32_t v2 = s_exp.good_bytes;
+        s_exp.goodput = (v2 >= s_exp.ui_prev_good) ? (v2 - s_exp.ui_prev_good) * 1000u / dt : 0;
+        s_exp.ui_prev_good = v2;
+    }
+    s_exp.ui_prev_ms = t;
+    s_exp.ui_prev_pkts = pkts;
+    s_exp.ui_prev_rx = rs.rx_bytes;
+
+    snprintf(line, sizeof(line), "PKT/S %5lu", (unsigned long)s_exp.pkts_per_s);
+    set_row(0, line, Ui_ColorRGB(120, 220, 255));
+    snprintf(line, sizeof(line), "RX B/S %6lu", (unsigned long)s_exp.bytes_per_s);
+    set_row(1, line, fg);
+    snprintf(line, sizeof(line), "OK %lu", (unsigned long)ok);
+    set_row(2, line, Ui_ColorRGB(180, 220, 180));
+    snprintf(line, sizeof(line), "ERR %lu DROP %lu", (unsigned long)err,
+             (unsigned long)s_exp.drop_count);
+    set_row(3, line, (err || s_exp.drop_count) ? Ui_ColorRGB(255, 160, 120) : fg);
+    snprintf(line, sizeof(line), "OVR %lu HW %lu", (unsigned long)rs.ring_overrun_bytes,
+             (unsigned long)rs.hw_overruns);
+    set_row(4, line, (rs.ring_overrun_bytes || rs.hw_overruns) ? Ui_ColorRGB(255, 120, 120) : dim);
+
+    if (s_exp.req_mode == kUartModeLink) {
+        snprintf(line, sizeof(line), "DLOG DROP %lu", (unsigned long)Dlog_GetDropped());
+    } else if (s_exp.req_mode == kUartModeBench) {
+        snprintf(line, sizeof(line), "GOODPUT %lu B/S", (unsigned long)s_exp.goodput);
+    } else if (s_exp.req_mode == kUartModeV2) {
+        snprintf(line, sizeof(line), "V2 GP %lu OOO %lu", (unsigned long)s_exp.goodput,
+                 (unsigned long)s_exp.v2_ooo);
+    } else {
+        snprintf(line, sizeof(line), "V1 (UP: V2)");
+    }
+    set_row(9, line, Ui_ColorRGB(255, 220, 120));
 
-    snprintf(line, sizeof(line), "LEN     : %u", (unsigned)len);
-    Ui_Println(line);
+    if (s_exp.req_mode == kUartModeBench) {
+        ui_update_bench();
+        return;
+    }
+    if (s_exp.req_mode == kUartModeLink) {
+        ui_update_link(&rs);
+        return;
+    }
 
-    // Show up to first 16 bytes to fit the screen
-    int shown = (len > 16) ? 16 : (int)len;
-    int pos = 0;
-    pos += snprintf(line + pos, sizeof(line) - pos, "DATA    : ");
-    for (int i = 0; i < shown; i++) {
-        pos += snprintf(line + pos, sizeof(line) - pos, "%02X ", (unsigned)data[i]);
-        if (pos > (int)sizeof(line) - 4) break;
+    // Latest packet only; anything in between is just counted
+    LastPacket lp;
+    uint32_t seq;
+    portENTER_CRITICAL(&s_exp.last_mux);
+    lp = s_exp.last;
+    seq = s_exp.last_seq;
+    portEXIT_CRITICAL(&s_exp.last_mux);
+
+    if (seq == 0 || seq == s_exp.ui_seen_seq) return;
+    s_exp.ui_seen_seq = seq;
+
+    snprintf(line, sizeof(line), "LAST %s", lp.status);
+    set_row(5, line, lp.ok ? Ui_ColorRGB(180, 220, 180) : Ui_ColorRGB(255, 120, 120));
+    if (s_exp.mode == kUartModeV2) {
+        snprintf(line, sizeof(line), "LEN %u SEQ %u ACK %u", (unsigned)lp.len, (unsigned)lp.a,
+                 (unsigned)lp.b);
+    } else {
+        snprintf(line, sizeof(line), "LEN %u SUM %02X T %02X", (unsigned)lp.len, (unsigned)lp.a,
+                 (unsigned)lp.b);
     }
-    if (len > 16) {
-        pos += snprintf(line + pos, sizeof(line) - pos, "...");
+    set_row(6, line, fg);
+
+    int shown = lp.len < LAST_SHOWN ? lp.len : LAST_SHOWN;
+    for (int r = 0; r < 2; r++) {
+        int pos = 0;
+        line[0] = 0;
+        for (int i = r * 6; i < shown && i < (r + 1) * 6; i++) {
+            pos += snprintf(line + pos, sizeof(line) - pos, "%02X ", (unsigned)lp.data[i]);
+        }
+        if (r == 1 && lp.len > LAST_SHOWN) snprintf(line + pos, sizeof(line) - pos, "..");
+        set_row(7 + r, line, dim);
     }
-    Ui_Println(line);
+}
 
-    snprintf(line, sizeof(line), "CHECKSUM: 0x%02X", (unsigned)sum);
-    Ui_Println(line);
+static void set_last(bool ok, const char* status, const uint8_t* data, uint16_t len,
+                     uint8_t a, uint8_t b)
+{
+    portENTER_CRITICAL(&s_exp.last_mux);
+    s_exp.last.ok = ok;
+    s_exp.last.status = status;
+    s_exp.last.len = len;
+    s_exp.last.a = a;
+    s_exp.last.b = b;
+    memcpy(s_exp.last.data, data, len < LAST_SHOWN ? len : LAST_SHOWN);
+    s_exp.last_seq++;
+    portEXIT_CRITICAL(&s_exp.last_mux);
+}
 
-    snprintf(line, sizeof(line), "TAIL    : 0x%02X", (unsigned)tail);
-    Ui_Println(line);
+static void on_packet(UartPktResult res)
+{
+    const UartPktParser* p = &s_exp.parser;
 
-    snprintf(line, sizeof(line), "STATUS  : %s", ok ? "OK" : "ERR");
-    Ui_Println(line);
+    if (res == kUartPktOk) {
+        s_exp.ok_count++;
+        send_reply_invert(p->data, p->len);
+    } else {
+        s_exp.err_count++;
+    }
 
-    Ui_Println("");
-    Ui_Println("ENTER=CLR BACK=EXIT");
+    const char* st = (res == kUartPktOk) ? "OK" : (res == kUartPktBadSum) ? "BAD SUM" : "BAD TAIL";
+    set_last(res == kUartPktOk, st, p->data, p->len, p->sum, p->tail);
 }
 
+static void v2_send_ack(void)
+{
+    uint8_t frame[UP2_HDR_LEN + 4];
+    size_t n = Up2Rx_EncodeAck(&s_exp.v2_rx, s_exp.v2_ack_flags, frame, sizeof(frame));
+    const Uart1Iov iov = { frame, (uint32_t)n };
+    if (n) Uart1Router_WriteV(&iov, 1);
+}
 
-static void exp_task(void* arg)
+static void on_frame_v2(Up2Result res)
 {
-    (void)arg;
+    const Up2Frame* f = &s_exp.v2_parser.frame;
 
-    parser_reset();
-    s_exp.last_ui_ms = 0;
-    ui_draw_static();
+    if (res != kUp2Frame) {
+        s_exp.err_count++;
+        set_last(false, (res == kUp2BadCrc) ? "BAD CRC" : "BAD HDR", f->payload, 0, 0, 0);
+        return;
+    }
+    if (f->type != kUp2TypeData) return;
 
-    while (s_exp.running) {
-        // Keys always available via router
-        
-        uint8_t b = 0;
-        bool got = Uart1Router_ReadDataByte(&b, 20);
-        if (!got) {
-            if (s_exp.st != kWaitHead) {
-                s_exp.drop_count++;
-                parser_reset();
-                ui_draw_static();
-            }
-            vTaskDelay(pdMS_TO_TICKS(1));
-            continue;
-        }
+    // Answer in the CRC width the peer uses
+    s_exp.v2_ack_flags = f->flags & UP2_FLAG_CRC32;
 
-        switch (s_exp.st) {
-            case kWaitHead:
-                if (b == PKT_HEAD) s_exp.st = kWaitLen;
-                break;
-
-            case kWaitLen:
-                s_exp.len = b;
-                s_exp.pos = 0;
-                s_exp.st = (s_exp.len == 0) ? kWaitSum : kWaitData;
-                break;
-
-            case kWaitData:
-                s_exp.data[s_exp.pos++] = b;
-                if (s_exp.pos >= s_exp.len) s_exp.st = kWaitSum;
-                break;
-
-            case kWaitSum:
-                s_exp.sum = b;
-                s_exp.st = kWaitTail;
-                break;
-
-            case kWaitTail:
-                bool ok = false;
-uint8_t head = PKT_HEAD;
-uint8_t tail = b; // received tail byte
-
-if (b == PKT_TAIL) {
-    uint8_t expect = calc_sum(s_exp.len, s_exp.data);
-    ok = (expect == s_exp.sum);
-    if (ok) {
-        s_exp.ok_count++;
-        send_reply_invert(s_exp.data, s_exp.len);
-    } else {
+    if (!Up2Rx_Accept(&s_exp.v2_rx, f)) {
+        s_exp.v2_ooo = s_exp.v2_rx.out_of_order;
+        return;
+    }
+    s_exp.ok_count++;
+    s_exp.good_bytes = s_exp.v2_rx.delivered_bytes;
+    set_last(true, "OK", f->payload, f->len, f->seq, s_exp.v2_rx.expected);
+}
+
+static void bench_reset(void)
+{
+    portENTER_CRITICAL(&s_exp.last_mux);
+    LatStats_Reset(&s_exp.bench_lat);
+    portEXIT_CRITICAL(&s_exp.last_mux);
+
+    s_exp.bench_applied_gen = s_exp.bench_cfg_gen;
+    // Replies to probes from a previous run are ignored
+    s_exp.bench_valid_from = s_exp.bench_next_id;
+    s_exp.bench_in_flight = 0;
+    s_exp.bench_next_due_us = now_us();
+    s_exp.bench_progress_ms = now_ms();
+    s_exp.bench_sent = 0;
+    s_exp.bench_lost = 0;
+    s_exp.good_bytes = 0;
+}
+
+static void bench_send_probe(uint16_t size)
+{
+    uint8_t* pl = s_exp.bench_payload;
+    uint32_t id = s_exp.bench_next_id++;
+    uint32_t t = now_us();
+    memcpy(pl, &id, 4);
+    memcpy(pl + 4, &t, 4);
+
+    size_t n = Up2_Encode(s_exp.bench_tx, UP2_MAX_FRAME, 0, kUp2TypeData, (uint8_t)id, 0, pl, size);
+    const Uart1Iov iov = { s_exp.bench_tx, (uint32_t)n };
+    Uart1Router_WriteV(&iov, 1);
+
+    s_exp.bench_in_flight++;
+    s_exp.bench_sent++;
+}
+
+// Sends whatever is due and returns how long the task may block (ms)
+static uint32_t bench_poll(void)
+{
+    // Under legacy framing the router takes any AA xx 55 in a probe's id,
+    // timestamp or CRC for a key frame and cuts it out, so the bench only
+    // runs framed; switching back starts a fresh run
+    if (!bench_link_ok()) {
+        s_exp.bench_paused = true;
+        return PKT_GAP_MS;
+    }
+    if (s_exp.bench_paused || s_exp.bench_cfg_gen != s_exp.bench_applied_gen) {
+        s_exp.bench_paused = false;
+        bench_reset();
+    }
+
+    uint16_t size = k_bench_sizes[s_exp.bench_size_idx];
+    uint16_t rate = k_bench_rates[s_exp.bench_rate_idx];
+    uint32_t t_ms = now_ms();
+
+    if (s_exp.bench_in_flight && (t_ms - s_exp.bench_progress_ms) >= BENCH_LOSS_MS) {
+        s_exp.bench_lost += s_exp.bench_in_flight;
+        s_exp.bench_in_flight = 0;
+        s_exp.bench_valid_from = s_exp.bench_next_id;
+        s_exp.bench_progress_ms = t_ms;
+    }
+
+    if (rate == 0) {
+        // Closed loop: keep a few probes queued so the line never idles
+        while (s_exp.bench_in_flight < BENCH_FLOOD_DEPTH) bench_send_probe(size);
+        return PKT_GAP_MS;
+    }
+
+    // Paced: ticks are 10 ms, so higher rates go out in small bursts
+    uint32_t period_us = 1000000u / rate;
+    uint32_t t = now_us();
+    if ((int32_t)(t - s_exp.bench_next_due_us) > (int32_t)(8 * period_us)) s_exp.bench_next_due_us = t;
+    while ((int32_t)(t - s_exp.bench_next_due_us) >= 0 && s_exp.bench_in_flight < BENCH_MAX_DEPTH) {
+        if (s_exp.bench_in_flight == 0) s_exp.bench_progress_ms = t_ms;
+        bench_send_probe(size);
+        s_exp.bench_next_due_us += period_us;
+    }
+
+    // At least one tick, or a stalled peer would turn this into a spin
+    uint32_t wait = PKT_GAP_MS;
+    if (s_exp.bench_in_flight < BENCH_MAX_DEPTH) {
+        int32_t ahead_us = (int32_t)(s_exp.bench_next_due_us - t);
+        if (ahead_us > 0 && (uint32_t)ahead_us / 1000u < wait) wait = (uint32_t)ahead_us / 1000u;
+        else if (ahead_us <= 0) wait = 0;
+    }
+    return wait < portTICK_PERIOD_MS ? portTICK_PERIOD_MS : wait;
+}
+
+static void on_frame_bench(Up2Result res)
+{
+    const Up2Frame* f = &s_exp.v2_parser.frame;
+
+    if (res != kUp2Frame) {
         s_exp.err_count++;
+        return;
     }
-} else {
-    s_exp.err_count++;
+    if (f->type != kUp2TypeData || f->len < BENCH_HDR) return;
+
+    uint32_t id;
+    uint32_t t;
+    memcpy(&id, f->payload, 4);
+    memcpy(&t, f->payload + 4, 4);
+
+    // Only ids still in flight count; late echoes of written-off probes do not
+    if ((id - s_exp.bench_valid_from) >= (s_exp.bench_next_id - s_exp.bench_valid_from)) return;
+
+    uint32_t rtt = now_us() - t;
+    portENTER_CRITICAL(&s_exp.last_mux);
+    LatStats_Add(&s_exp.bench_lat, rtt);
+    portEXIT_CRITICAL(&s_exp.last_mux);
+
+    if (s_exp.bench_in_flight) s_exp.bench_in_flight--;
+    s_exp.bench_progress_ms = now_ms();
+    s_exp.ok_count++;
+    s_exp.good_bytes += f->len;
 }
 
-ui_update_last_packet(head, s_exp.len, s_exp.data, s_exp.sum, tail, ok);
-parser_reset();
+// Telemetry channel: any request frame is answered with the link counters,
+// TELEM_VERSION then little-endian uint32s (tools/uart_bench_host.py --stats)
+static void telem_poll(void)
+{
+    uint8_t req[16];
+    if (SpscRing_Read(&s_exp.telem_ring, req, sizeof(req)) == 0) return;
+    while (SpscRing_Read(&s_exp.telem_ring, req, sizeof(req))) {
+    }
+
+    Uart1RouterStats rs;
+    Uart1Router_GetStats(&rs);
+    const uint32_t v[] = {
+        rs.baudrate, rs.rx_bytes, rs.key_frames, rs.data_bytes, rs.ring_overrun_bytes,
+        rs.hw_overruns, rs.mux_frames, rs.mux_errors, Dlog_GetDropped(),
+    };
+    uint8_t out[1 + sizeof(v)];
+    out[0] = TELEM_VERSION;
+    memcpy(out + 1, v, sizeof(v));
+    if (Uart1Router_SendFrame(kMuxChanTelemetry, out, sizeof(out)) > 0) s_exp.telem_replies++;
+}
 
-                break;
+static void apply_mode(UartMode mode)
+{
+    s_exp.mode = mode;
+    UartPkt_Reset(&s_exp.parser);
+    Up2Parser_Init(&s_exp.v2_parser, s_exp.v2_data, UP2_MAX_PAYLOAD);
+    Up2Rx_Init(&s_exp.v2_rx, V2_ACK_EVERY);
+    s_exp.v2_ack_flags = 0;
+    s_exp.good_bytes = 0;
+    s_exp.v2_ooo = 0;
+    if (mode == kUartModeBench) bench_reset();
+}
 
-            default:
-                parser_reset();
-                break;
-        }
+static bool parser_in_frame(void)
+{
+    return (s_exp.mode != kUartModeV1) ? Up2Parser_InFrame(&s_exp.v2_parser)
+                                       : UartPkt_InFrame(&s_exp.parser);
+}
 
-        vTaskDelay(pdMS_TO_TICKS(1));
+static void exp_task(void* arg)
+{
+    (void)arg;
+    EVTRACE_TASK("uart_exp");
+
+    UartPkt_Init(&s_exp.parser, s_exp.data);
+    apply_mode(s_exp.req_mode);
+    uint32_t last_rx_ms = now_ms();
+
+    while (s_exp.running) {
+        if (s_exp.req_mode != s_exp.mode) apply_mode(s_exp.req_mode);
+
+        telem_poll();
+
+        uint32_t wait_ms = PKT_GAP_MS;
+        if (s_exp.mode == kUartModeBench) wait_ms = bench_poll();
+
+        // Blocks until the router stores data; no per-byte sleeps
+        const uint8_t* span;
+        uint32_t n = Uart1Router_DataPeek(&span, wait_ms);
+        if (n == 0) {
+            if (parser_in_frame() && (now_ms() - last_rx_ms) >= PKT_GAP_MS) {
+                s_exp.drop_count++;
+                UartPkt_Reset(&s_exp.parser);
+                Up2Parser_Reset(&s_exp.v2_parser);
+            }
+            // Idle line: flush a pending cumulative ack
+            if (s_exp.mode == kUartModeV2 && s_exp.v2_rx.unacked) v2_send_ack();
+            continue;
+        }
+        last_rx_ms = now_ms();
+
+        uint32_t off = (s_exp.mode == kUartModeLink) ? n : 0;
+        while (off < n && s_exp.mode != kUartModeV1) {
+            Up2Result res;
+            off += (uint32_t)Up2Parser_Feed(&s_exp.v2_parser, span + off, n - off, &res);
+            if (res != kUp2None) {
+                EVTRACE_BEGIN_V(kEvtUartPkt, s_exp.v2_parser.frame.len);
+                if (s_exp.mode == kUartModeBench) on_frame_bench(res);
+                else on_frame_v2(res);
+                EVTRACE_END(kEvtUartPkt);
+            }
+        }
+        // One ack per block at most; a gap forces it out right away
+        if (s_exp.mode == kUartModeV2 && Up2Rx_AckDue(&s_exp.v2_rx)) v2_send_ack();
+
+        while (off < n) {
+            UartPktResult res;
+            off += (uint32_t)UartPkt_Feed(&s_exp.parser, span + off, n - off, &res);
+            if (res != kUartPktNone) {
+                EVTRACE_BEGIN_V(kEvtUartPkt, s_exp.parser.len);
+                on_packet(res);
+                EVTRACE_END(kEvtUartPkt);
+            }
+        }
+        Uart1Router_DataCommit(n);
     }
 
+    s_exp.task = NULL;
     vTaskDelete(NULL);
 }
 
@@ -243,19 +682,74 @@ static void show_requirements(ExperimentContext* ctx)
     Ui_Println("RX: BB LEN DATA SUM 66");
     Ui_Println("SUM=sum(DATA)&0xFF");
     Ui_Println("TX: invert(DATA) reply");
-    Ui_Println("");
+    Ui_Println("UP: V2 B2 2B hdr CRC");
+    Ui_Println("    seq + cumulative ack");
+    Ui_Println("UP: BENCH probes (COBS)");
+    Ui_Println("    far end echoes (tools/");
+    Ui_Println("    uart_bench_host.py)");
+    Ui_Println("UP: LINK COBS on/off");
     Ui_Println("ENTER=CLR BACK=RET");
 }
 
 static void start(ExperimentContext* ctx)
 {
-    (void)ctx;
-
     if (s_exp.running) return;
+
+    s_exp.data = (uint8_t*)ExpArena_Alloc(&ctx->arena, kExpArenaNormal, PKT_MAX_DATA);
+    s_exp.tx_data = (uint8_t*)ExpArena_Alloc(&ctx->arena, kExpArenaNormal, PKT_MAX_DATA);
+    s_exp.v2_data = (uint8_t*)ExpArena_Alloc(&ctx->arena, kExpArenaNormal, UP2_MAX_PAYLOAD);
+    s_exp.bench_tx = (uint8_t*)ExpArena_Alloc(&ctx->arena, kExpArenaNormal, UP2_MAX_FRAME);
+    s_exp.bench_payload = (uint8_t*)ExpArena_Alloc(&ctx->arena, kExpArenaNormal, UP2_MAX_PAYLOAD);
+    s_exp.bench_samples = (uint32_t*)ExpArena_Alloc(&ctx->arena, kExpArenaNormal,
+                                                    BENCH_SAMPLES * sizeof(uint32_t));
+    s_exp.bench_sorted = (uint32_t*)ExpArena_Alloc(&ctx->arena, kExpArenaNormal,
+                                                   BENCH_SAMPLES * sizeof(uint32_t));
+    if (!s_exp.data || !s_exp.tx_data || !s_exp.v2_data || !s_exp.bench_tx || !s_exp.bench_payload ||
+        !s_exp.bench_samples || !s_exp.bench_sorted) {
+        Ui_Clear();
+        Ui_Println("UART: NO MEMORY");
+        return;
+    }
+
+    s_exp.ok_count = 0;
+    s_exp.err_count = 0;
+    s_exp.drop_count = 0;
+    s_exp.last_seq = 0;
+    s_exp.ui_seen_seq = 0;
+    s_exp.ui_prev_ms = 0;
+    s_exp.ui_prev_pkts = 0;
+    s_exp.pkts_per_s = 0;
+    s_exp.bytes_per_s = 0;
+    s_exp.ui_prev_good = 0;
+    s_exp.goodput = 0;
+    s_exp.ui_next_ms = 0;
+
+    for (int i = BENCH_HDR; i < UP2_MAX_PAYLOAD; i++) s_exp.bench_payload[i] = (uint8_t)(i & 0x7F);
+    LatStats_Init(&s_exp.bench_lat, s_exp.bench_samples, BENCH_SAMPLES);
+    ui_draw_static();
+
     s_exp.running = true;
 
     Uart1Router_EnableData(true);
-    xTaskCreate(exp_task, "uart_exp", 4096, NULL, 10, &s_exp.task);
+    SpscRing_Init(&s_exp.telem_ring, s_exp.telem_buf, TELEM_RING);
+    s_exp.telem_replies = 0;
+    Uart1Router_GetStats(&s_exp.link_base);
+    s_exp.saved_framing = Uart1Router_GetFraming();
+    s_exp.saved_baud = s_exp.link_base.baudrate;
+    Uart1Router_RegisterChannel(kMuxChanTelemetry, &s_exp.telem_ring, NULL, NULL);
+    xTaskCreate(exp_task, "uart_exp", 4096, NULL, 10, (TaskHandle_t*)&s_exp.task);
+}
+
+static void tick(ExperimentContext* ctx)
+{
+    (void)ctx;
+    if (!s_exp.running) return;
+
+    uint32_t t = now_ms();
+    if (t < s_exp.ui_next_ms) return;
+    s_exp.ui_next_ms = t + UI_PERIOD_MS;
+
+    ui_update();
 }
 
 static void stop(ExperimentContext* ctx)
@@ -264,8 +758,27 @@ static void stop(ExperimentContext* ctx)
 
     if (!s_exp.running) return;
     s_exp.running = false;
-    vTaskDelay(pdMS_TO_TICKS(50));
+
+    // The task wakes at least every PKT_GAP_MS
+    while (s_exp.task) vTaskDelay(pdMS_TO_TICKS(5));
+    Uart1Router_UnregisterChannel(kMuxChanTelemetry);
     Uart1Router_EnableData(false);
+
+    // The LINK page changes router-wide settings; the rest of the app expects
+    // the ones it had before this page
+    Uart1RouterStats rs;
+    Uart1Router_GetStats(&rs);
+    if (rs.baudrate != s_exp.saved_baud) Uart1Router_SetBaudrate(s_exp.saved_baud);
+    if (Uart1Router_GetFraming() != s_exp.saved_framing) Uart1Router_SetFraming(s_exp.saved_framing);
+
+    // Task has exited; buffers go back to the arena after stop()
+    s_exp.data = NULL;
+    s_exp.tx_data = NULL;
+    s_exp.v2_data = NULL;
+    s_exp.bench_tx = NULL;
+    s_exp.bench_payload = NULL;
+    s_exp.bench_samples = NULL;
+    s_exp.bench_sorted = NULL;
 }
 
 const Experiment g_exp_uart = {
@@ -277,5 +790,5 @@ const Experiment g_exp_uart = {
     .start = start,
     .stop = stop,
     .on_key = on_key,
-    .tick = 0,
+    .tick = tick,
 };
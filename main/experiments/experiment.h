@@ -1,6 +1,7 @@
 #pragma once
 #include <stdint.h>
 #include "core/app_events.h"
+#include "core/exp_arena.h"
 
 typedef struct ExperimentContext ExperimentContext;
 
@@ -18,10 +19,13 @@ typedef struct {
 
     void (*on_key)(ExperimentContext* ctx, InputKey key);
     void (*tick)(ExperimentContext* ctx);
+    uint16_t tick_ms;   // tick period on the run page, 0 = APP_TICK_MS
 } Experiment;
 
+#define APP_TICK_MS 50
+
 struct ExperimentContext {
-    int dummy;
+    ExpArena arena;     // scratch memory, see core/exp_arena.h
 };
 
 const Experiment* ExpWifiRemote_Get(void);
\ No newline at end of file
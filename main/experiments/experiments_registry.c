@@ -13,6 +13,12 @@ extern const Experiment g_exp_wifi_sta;
 extern const Experiment g_exp_semaforo;
 extern const Experiment g_exp_maze;
 extern const Experiment g_exp_lcd_color;
+extern const Experiment g_exp_mem;
+extern const Experiment g_exp_bench;
+extern const Experiment g_exp_replay;
+extern const Experiment g_exp_tuner;
+extern const Experiment g_exp_monitor;
+extern const Experiment g_exp_dsp;
 
 static const Experiment* kList[] = {
     &g_exp_gpio,
@@ -28,6 +34,12 @@ static const Experiment* kList[] = {
     &g_exp_semaforo,
     &g_exp_maze,
     &g_exp_lcd_color,
+    &g_exp_mem,
+    &g_exp_bench,
+    &g_exp_replay,
+    &g_exp_tuner,
+    &g_exp_monitor,
+    &g_exp_dsp,
 };
 
 int Experiments_Count(void)
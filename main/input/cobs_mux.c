@@ -0,0 +1,225 @@
+#include "input/cobs_mux.h"
+
+#include <string.h>
+
+#include "core/crc.h"
+#include "core/hot_path.h"
+
+void CobsMux_Init(CobsMux* m)
+{
+    memset(m, 0, sizeof(*m));
+}
+
+bool CobsMux_Register(CobsMux* m, uint8_t chan, SpscRing* ring, CobsMuxNotify notify, void* arg)
+{
+    if (chan >= COBS_MUX_MAX_CHANNELS || !ring) return false;
+
+    CobsMuxChannel* c = &m->ch[chan];
+    c->ring = NULL;
+    c->notify = notify;
+    c->arg = arg;
+    c->ring = ring;     // published last: the decoder checks it at frame start
+    return true;
+}
+
+void CobsMux_Unregister(CobsMux* m, uint8_t chan)
+{
+    if (chan < COBS_MUX_MAX_CHANNELS) m->ch[chan].ring = NULL;
+}
+
+void CobsMux_Reset(CobsMux* m)
+{
+    m->in_frame = false;
+    m->have_chan = false;
+    m->code = 0;
+    m->left = 0;
+    m->pos = 0;
+    m->discard = false;
+    m->ring = NULL;
+}
+
+// First decoded byte: pick the destination ring
+static void begin_channel(CobsMux* m, uint8_t chan)
+{
+    m->have_chan = true;
+    m->chan = chan;
+    m->ring = (chan < COBS_MUX_MAX_CHANNELS) ? m->ch[chan].ring : NULL;
+    if (!m->ring) {
+        m->unknown_chan++;
+        m->discard = true;
+        return;
+    }
+    m->room = SpscRing_WriteWindow(m->ring, &m->head);
+}
+
+// Decoded bytes after the channel byte go straight into the ring
+HOT_PATH static void put_span(CobsMux* m, const uint8_t* src, uint32_t n)
+{
+    if (n == 0) return;
+    if (!m->have_chan) {
+        begin_channel(m, src[0]);
+        src++;
+        n--;
+    }
+    if (m->discard || n == 0) {
+        m->pos += n;
+        return;
+    }
+    if (m->pos + n > m->room) {
+        // The CRC bytes land in the ring too, so they need room as well
+        m->ch[m->chan].overruns++;
+        m->discard = true;
+        m->pos += n;
+        return;
+    }
+
+    SpscRing* r = m->ring;
+    uint32_t off = (m->head + m->pos) & r->mask;
+    uint32_t first = r->cap - off;
+    if (first > n) first = n;
+    memcpy(r->buf + off, src, first);
+    if (n > first) memcpy(r->buf, src + first, n - first);
+    m->pos += n;
+}
+
+static void end_frame(CobsMux* m)
+{
+    if (!m->have_chan) {
+        // "00 00" is just an idle delimiter; a lone code byte is a runt
+        if (m->in_frame) m->framing_errors++;
+        return;
+    }
+    if (m->left) {
+        m->framing_errors++;
+        return;
+    }
+    if (m->discard) return;
+
+    uint32_t n = m->pos;
+    if (n < 2) {
+        m->framing_errors++;
+        return;
+    }
+
+    SpscRing* r = m->ring;
+    uint32_t payload = n - 2;
+    uint32_t start = m->head & r->mask;
+    uint32_t first = r->cap - start;
+    if (first > payload) first = payload;
+
+    uint16_t crc = Crc16_Update(CRC16_INIT, &m->chan, 1);
+    crc = Crc16_Update(crc, r->buf + start, first);
+    if (payload > first) crc = Crc16_Update(crc, r->buf, payload - first);
+
+    uint16_t got = (uint16_t)(r->buf[(m->head + payload) & r->mask] |
+                              (r->buf[(m->head + payload + 1) & r->mask] << 8));
+    if (crc != got) {
+        m->crc_errors++;
+        return;
+    }
+
+    SpscRing_CommitWrite(r, payload);
+    m->frames_ok++;
+
+    CobsMuxChannel* c = &m->ch[m->chan];
+    c->frames++;
+    c->bytes += payload;
+    if (c->notify) c->notify(m->chan, payload, c->arg);
+}
+
+HOT_PATH void CobsMux_Feed(CobsMux* m, const uint8_t* in, size_t len)
+{
+    size_t i = 0;
+
+    while (i < len) {
+        if (m->left) {
+            // Inside a block: no zeros expected, copy the run in bulk
+            size_t n = len - i;
+            if (n > m->left) n = m->left;
+            const uint8_t* z = (const uint8_t*)memchr(in + i, 0, n);
+            if (z) n = (size_t)(z - (in + i));
+
+            put_span(m, in + i, (uint32_t)n);
+            m->left = (uint8_t)(m->left - n);
+            i += n;
+            if (z) {
+                // Truncated frame: count it and resync on this delimiter
+                end_frame(m);
+                CobsMux_Reset(m);
+                i++;
+            }
+            continue;
+        }
+
+        uint8_t b = in[i++];
+        if (b == 0) {
+            end_frame(m);
+            CobsMux_Reset(m);
+            continue;
+        }
+
+        // New block; the previous one implied a zero unless it was full
+        if (m->in_frame && m->code != 0xFF) {
+            const uint8_t zero = 0;
+            put_span(m, &zero, 1);
+        }
+        m->in_frame = true;
+        m->code = b;
+        m->left = (uint8_t)(b - 1);
+    }
+}
+
+// Incremental COBS encoder: out[code_at] holds the pending block code
+typedef struct {
+    uint8_t* out;
+    size_t n;
+    size_t code_at;
+    uint8_t code;
+} CobsEnc;
+
+static void enc_begin(CobsEnc* e, uint8_t* out, size_t n)
+{
+    e->out = out;
+    e->n = n;
+    e->code_at = n;
+    e->code = 1;
+    e->n++;
+}
+
+static void enc_put(CobsEnc* e, const uint8_t* src, size_t len)
+{
+    for (size_t i = 0; i < len; i++) {
+        uint8_t b = src[i];
+        if (b) e->out[e->n++] = b;
+        if (!b || ++e->code == 0xFF) {
+            e->out[e->code_at] = b ? 0xFF : e->code;
+            e->code_at = e->n++;
+            e->code = 1;
+        }
+    }
+}
+
+static size_t enc_end(CobsEnc* e)
+{
+    e->out[e->code_at] = e->code;
+    return e->n;
+}
+
+size_t CobsMux_Encode(uint8_t chan, const uint8_t* payload, size_t len, uint8_t* out, size_t cap)
+{
+    if (cap < COBS_MUX_FRAME_MAX(len)) return 0;
+
+    uint16_t crc = Crc16_Update(CRC16_INIT, &chan, 1);
+    crc = Crc16_Update(crc, payload, len);
+    const uint8_t trailer[2] = { (uint8_t)crc, (uint8_t)(crc >> 8) };
+
+    out[0] = 0;
+    CobsEnc e;
+    enc_begin(&e, out, 1);
+    enc_put(&e, &chan, 1);
+    enc_put(&e, payload, len);
+    enc_put(&e, trailer, 2);
+    size_t n = enc_end(&e);
+    out[n++] = 0;
+    return n;
+}
@@ -0,0 +1,77 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "core/spsc_ring.h"
+
+// Channel multiplexing over a byte link with COBS framing.
+//
+// Wire format:  00 | COBS(chan, payload..., crc16_lo, crc16_hi) | 00
+// COBS removes every 0x00 from the frame, so 0x00 only ever marks a frame
+// boundary and the receiver resyncs at the next one. The CRC is
+// CRC-16/CCITT-FALSE over chan and payload.
+//
+// Decoding is in place: bytes go straight into the ring registered for the
+// channel and are committed only once the CRC checks out. Channels are byte
+// streams; frame boundaries are not kept in the ring. Plain C, host-tested
+// under host/.
+
+#define COBS_MUX_MAX_CHANNELS 8
+
+// Worst case wire size for a payload of len bytes
+#define COBS_MUX_FRAME_MAX(len) ((len) + 3 + ((len) + 3) / 254 + 1 + 2)
+
+typedef enum {
+    kMuxChanKey = 0,        // 1 byte per key, same codes as the AA xx 55 frames
+    kMuxChanData,           // experiment data (Uart1Router_DataPeek)
+    kMuxChanLog,
+    kMuxChanTelemetry,
+} MuxChannel;
+
+// Runs in the decoder's context after a frame was committed to the ring
+typedef void (*CobsMuxNotify)(uint8_t chan, uint32_t len, void* arg);
+
+typedef struct {
+    SpscRing* volatile ring;    // NULL: channel not registered
+    CobsMuxNotify notify;
+    void* arg;
+    uint32_t frames;
+    uint32_t bytes;
+    uint32_t overruns;          // frames dropped because the ring was full
+} CobsMuxChannel;
+
+typedef struct {
+    CobsMuxChannel ch[COBS_MUX_MAX_CHANNELS];
+
+    // Decoder state
+    bool in_frame;
+    bool have_chan;
+    uint8_t code;               // current COBS block code
+    uint8_t left;               // data bytes left in the block
+    uint8_t chan;
+    bool discard;               // rest of the frame is dropped
+    uint32_t pos;               // bytes decoded after the channel byte
+    SpscRing* ring;
+    uint32_t head;
+    uint32_t room;
+
+    uint32_t frames_ok;
+    uint32_t crc_errors;
+    uint32_t framing_errors;    // delimiter inside a block, runt frames
+    uint32_t unknown_chan;
+} CobsMux;
+
+void CobsMux_Init(CobsMux* m);
+
+// The ring belongs to the consumer; registering again replaces it.
+// Takes effect from the next frame.
+bool CobsMux_Register(CobsMux* m, uint8_t chan, SpscRing* ring, CobsMuxNotify notify, void* arg);
+void CobsMux_Unregister(CobsMux* m, uint8_t chan);
+
+// Decoder; single producer for all registered rings
+void CobsMux_Feed(CobsMux* m, const uint8_t* in, size_t len);
+void CobsMux_Reset(CobsMux* m);
+
+// Encodes one frame with both delimiters; returns 0 when it does not fit
+size_t CobsMux_Encode(uint8_t chan, const uint8_t* payload, size_t len, uint8_t* out, size_t cap);
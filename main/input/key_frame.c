@@ -0,0 +1,71 @@
+#include "input/key_frame.h"
+#include "core/hot_path.h"
+
+#include <string.h>
+
+void KeyFrame_Reset(KeyFrameParser* p)
+{
+    p->state = kKeyFrameWaitHead;
+    p->cmd = 0;
+}
+
+HOT_PATH uint32_t KeyFrame_ParseBlock(KeyFrameParser* p, const uint8_t* in, uint32_t len,
+                             uint8_t* out, KeyFrameFn on_key, void* arg)
+{
+    uint32_t o = 0;
+    uint32_t i = 0;
+
+    while (i < len) {
+        switch (p->state) {
+            case kKeyFrameWaitHead: {
+                // Plain data runs are copied in bulk up to the next head byte
+                const uint8_t* h = (const uint8_t*)memchr(in + i, KEY_FRAME_HEAD, len - i);
+                uint32_t run = h ? (uint32_t)(h - (in + i)) : (len - i);
+                memcpy(out + o, in + i, run);
+                o += run;
+                i += run;
+                if (h) {
+                    p->state = kKeyFrameWaitCmd;
+                    i++;
+                }
+                break;
+            }
+
+            case kKeyFrameWaitCmd:
+                p->cmd = in[i++];
+                p->state = kKeyFrameWaitTail;
+                break;
+
+            case kKeyFrameWaitTail: {
+                uint8_t b = in[i++];
+                if (b == KEY_FRAME_TAIL) {
+                    if (on_key) on_key(p->cmd, arg);
+                } else {
+                    // Not a valid key frame, forward bytes as data:
+                    out[o++] = KEY_FRAME_HEAD;
+                    out[o++] = p->cmd;
+                    out[o++] = b;
+                }
+                p->state = kKeyFrameWaitHead;
+                break;
+            }
+
+            default:
+                p->state = kKeyFrameWaitHead;
+                break;
+        }
+    }
+    return o;
+}
+
+bool KeyFrame_CmdToKey(uint8_t cmd, InputKey* out_key)
+{
+    switch (cmd) {
+        case 0x01: *out_key = kInputUp;    return true;
+        case 0x02: *out_key = kInputDown;  return true;
+        case 0x03: *out_key = kInputEnter; return true;
+        case 0x04: *out_key = kInputBack;  return true;
+        case 0x05: *out_key = kInputEnter; return true;
+        default: return false;
+    }
+}
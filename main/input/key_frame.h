@@ -0,0 +1,33 @@
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+#include "core/app_events.h"
+
+// Legacy UART1 key frames: AA <cmd> 55 inline with raw data bytes.
+// Pure logic, shared by the router and the host tools.
+
+#define KEY_FRAME_HEAD 0xAA
+#define KEY_FRAME_TAIL 0x55
+
+typedef enum {
+    kKeyFrameWaitHead = 0,
+    kKeyFrameWaitCmd,
+    kKeyFrameWaitTail
+} KeyFrameState;
+
+typedef struct {
+    KeyFrameState state;
+    uint8_t cmd;
+} KeyFrameParser;
+
+typedef void (*KeyFrameFn)(uint8_t cmd, void* arg);
+
+void KeyFrame_Reset(KeyFrameParser* p);
+
+// Runs the state machine over one block. Data bytes are collected into out[]
+// (which must hold len + 2 bytes for a broken frame carried over from the
+// previous block) and their count returned; complete frames go to on_key.
+uint32_t KeyFrame_ParseBlock(KeyFrameParser* p, const uint8_t* in, uint32_t len,
+                             uint8_t* out, KeyFrameFn on_key, void* arg);
+
+bool KeyFrame_CmdToKey(uint8_t cmd, InputKey* out_key);
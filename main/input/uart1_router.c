@@ -3,114 +3,175 @@
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 #include "freertos/queue.h"
+#include "freertos/semphr.h"
+#include "sdkconfig.h"
+
+#include <string.h>
 
 #include "esp_log.h"
+#include "esp_heap_caps.h"
+#include "mem_track.h"
+#include "evtrace.h"
+#include "dlog.h"
+#include "core/spsc_ring.h"
+#include "input/cobs_mux.h"
+#include "input/key_frame.h"
 static const char* TAG = "U1R";
-static uint32_t s_rx_bytes = 0;
-static uint32_t s_key_hits = 0;
 
 
 
 #define ROUTER_UART_NUM     UART_NUM_1
 #define ROUTER_TX_GPIO      35
 #define ROUTER_RX_GPIO      36
-#define ROUTER_BAUDRATE     115200
-
-#define KEY_HEAD            0xAA
-#define KEY_TAIL            0x55
-
-typedef enum {
-    kWaitHead = 0,
-    kWaitCmd,
-    kWaitTail
-} KeyParseState;
+#define ROUTER_BAUDRATE     CONFIG_APP_UART1_BAUDRATE
+
+#define ROUTER_RX_BUF_BYTES 8192    // driver ring
+#define ROUTER_TX_BUF_BYTES 2048    // writes return once copied here
+#define ROUTER_TX_GATHER    320     // one max-size reply frame plus slack
+#define ROUTER_EVT_DEPTH    32
+#define ROUTER_RX_BLOCK     256     // bytes pulled from the driver per read
+#define DATA_RING_BYTES     8192    // router -> consumer, power of two
+#define KEY_RING_BYTES      64      // COBS key channel, drained right away
+#define ROUTER_FRAME_MAX    512     // largest payload Uart1Router_SendFrame takes
+#if CONFIG_APP_UART1_COBS
+#define ROUTER_FRAMING_DEFAULT kUart1FramingCobs
+#else
+#define ROUTER_FRAMING_DEFAULT kUart1FramingLegacy
+#endif
 
 static QueueHandle_t s_key_q;
-static QueueHandle_t s_data_q;
+static QueueHandle_t s_uart_evt_q;
+static SemaphoreHandle_t s_data_sem;
+static SemaphoreHandle_t s_tx_mutex;
+static uint8_t s_tx_gather[ROUTER_TX_GATHER];
+static SpscRing s_data_ring;
 static volatile bool s_data_enabled = false;
 
-static KeyParseState s_state = kWaitHead;
-static uint8_t s_cmd = 0;
+static CobsMux s_mux;
+static SpscRing s_key_ring;
+static uint8_t s_key_ring_buf[KEY_RING_BYTES];
+static uint8_t s_tx_frame[COBS_MUX_FRAME_MAX(ROUTER_FRAME_MAX)];
+static Uart1Framing s_framing = ROUTER_FRAMING_DEFAULT;
+static volatile Uart1Framing s_framing_req = ROUTER_FRAMING_DEFAULT;
 
-static bool cmd_to_key(uint8_t cmd, InputKey* out_key)
+static KeyFrameParser s_keys;
+
+static Uart1RouterStats s_stats;
+
+static void push_key(uint8_t cmd)
 {
-    uint8_t keycode = 0;
-    switch (cmd) {
-        case 0x01: keycode = 0x11; break;
-        case 0x02: keycode = 0x12; break;
-        case 0x03: keycode = 0x13; break;
-        case 0x04: keycode = 0x14; break;
-        case 0x05: keycode = 0x15; break;
-        default: return false;
-    }
+    InputKey k;
+    if (!KeyFrame_CmdToKey(cmd, &k)) return;
 
-    switch (keycode) {
-        case 0x11: *out_key = kInputUp;    return true;
-        case 0x12: *out_key = kInputDown;  return true;
-        case 0x13: *out_key = kInputEnter; return true;
-        case 0x14: *out_key = kInputBack;  return true;
-        case 0x15: *out_key = kInputEnter; return true;
-        default: return false;
-    }
+    (void)xQueueSend(s_key_q, &k, 0);
+    s_stats.key_frames++;
+    EVTRACE_INSTANT(kEvtUartKey, k);
+    DLOGI(TAG, "key frame: %02X  hits=%lu", cmd, s_stats.key_frames);
 }
 
-static void data_push(uint8_t b)
+static void note_data_stored(uint32_t stored)
 {
-    if (!s_data_enabled) return;
-    (void)xQueueSend(s_data_q, &b, 0);
+    s_stats.data_bytes += stored;
+
+    uint32_t used = SpscRing_Used(&s_data_ring);
+    if (used > s_stats.ring_high_water) s_stats.ring_high_water = used;
+
+    if (stored) xSemaphoreGive(s_data_sem);
 }
 
-static void rx_task(void* arg)
+// COBS channel callbacks, run in the rx task right after a frame is committed
+static void on_key_channel(uint8_t chan, uint32_t len, void* arg)
+{
+    (void)chan;
+    (void)len;
+    (void)arg;
+    uint8_t cmd;
+    while (SpscRing_Read(&s_key_ring, &cmd, 1) == 1) push_key(cmd);
+}
+
+static void on_data_channel(uint8_t chan, uint32_t len, void* arg)
 {
+    (void)chan;
     (void)arg;
+    note_data_stored(len);
+}
+
+static void data_push_block(const uint8_t* data, uint32_t len)
+{
+    if (len == 0 || !s_data_enabled) return;
+
+    uint32_t stored = SpscRing_Write(&s_data_ring, data, len);
+    if (stored < len) s_stats.ring_overrun_bytes += len - stored;
+    note_data_stored(stored);
+}
+
+static void on_key_frame(uint8_t cmd, void* arg)
+{
+    (void)arg;
+    push_key(cmd);
+}
+
+static void read_available(void)
+{
+    static uint8_t in[ROUTER_RX_BLOCK];
+    static uint8_t out[ROUTER_RX_BLOCK + 2];
 
-    uint8_t b = 0;
     while (1) {
-        int n = uart_read_bytes(ROUTER_UART_NUM, &b, 1, pdMS_TO_TICKS(50));
-        if (n <= 0) {
-            vTaskDelay(pdMS_TO_TICKS(1));
+        size_t avail = 0;
+        uart_get_buffered_data_len(ROUTER_UART_NUM, &avail);
+        if (avail == 0) return;
+        if (avail > sizeof(in)) avail = sizeof(in);
+
+        int n = uart_read_bytes(ROUTER_UART_NUM, in, (uint32_t)avail, 0);
+        if (n <= 0) return;
+
+        s_stats.rx_bytes += (uint32_t)n;
+        EVTRACE_COUNTER(kEvtUartRx, s_stats.rx_bytes);
+        DLOGI_RL(TAG, 1000, "rx_bytes=%lu", s_stats.rx_bytes);
+
+        if (s_framing_req != s_framing) {
+            s_framing = s_framing_req;
+            KeyFrame_Reset(&s_keys);
+            CobsMux_Reset(&s_mux);
+        }
+
+        if (s_framing == kUart1FramingCobs) {
+            // Decoded in place into the channel rings, no staging copy
+            CobsMux_Feed(&s_mux, in, (uint32_t)n);
             continue;
         }
 
-        switch (s_state) {
-            case kWaitHead:
-                if (b == KEY_HEAD) {
-                    s_state = kWaitCmd;
-                } else {
-                    data_push(b);
-                }
-                break;
+        uint32_t o = KeyFrame_ParseBlock(&s_keys, in, (uint32_t)n, out, on_key_frame, NULL);
+        data_push_block(out, o);
+    }
+}
 
-            case kWaitCmd:
-                s_cmd = b;
-                s_state = kWaitTail;
+static void rx_task(void* arg)
+{
+    (void)arg;
+    EVTRACE_TASK("uart1_rx_router");
+
+    uart_event_t ev;
+    while (1) {
+        if (xQueueReceive(s_uart_evt_q, &ev, portMAX_DELAY) != pdTRUE) continue;
+
+        switch (ev.type) {
+            case UART_DATA:
+                read_available();
                 break;
 
-            case kWaitTail:
-                if (b == KEY_TAIL) {
-                    InputKey k;
-                    if (cmd_to_key(s_cmd, &k)) {
-                        (void)xQueueSend(s_key_q, &k, 0);
-                        s_key_hits++;
-                        ESP_LOGI(TAG, "key frame: AA %02X 55  hits=%lu", (unsigned)s_cmd, (unsigned long)s_key_hits);
-
-                    }
-                    s_rx_bytes++;
-                    if ((s_rx_bytes % 64) == 0) {
-                        ESP_LOGI(TAG, "rx_bytes=%lu", (unsigned long)s_rx_bytes);
-                    }
-
-                } else {
-                    // Not a valid key frame, forward bytes as data:
-                    data_push(KEY_HEAD);
-                    data_push(s_cmd);
-                    data_push(b);
-                }
-                s_state = kWaitHead;
+            case UART_FIFO_OVF:
+            case UART_BUFFER_FULL:
+                // Driver lost bytes; resync rather than parse a torn stream
+                s_stats.hw_overruns++;
+                DLOGW(TAG, "uart overrun (%lu)", s_stats.hw_overruns);
+                uart_flush_input(ROUTER_UART_NUM);
+                xQueueReset(s_uart_evt_q);
+                KeyFrame_Reset(&s_keys);
+                CobsMux_Reset(&s_mux);
                 break;
 
             default:
-                s_state = kWaitHead;
                 break;
         }
     }
@@ -118,8 +179,17 @@ static void rx_task(void* arg)
 
 void Uart1Router_Init(void)
 {
-    s_key_q  = xQueueCreate(16, sizeof(InputKey));
-    s_data_q = xQueueCreate(1024, sizeof(uint8_t));
+    s_key_q  = MemTrack_QueueCreate(kMemTagInput, 16, sizeof(InputKey));
+    s_data_sem = xSemaphoreCreateBinary();
+    s_tx_mutex = xSemaphoreCreateMutex();
+
+    uint8_t* ring_buf = (uint8_t*)MemTrack_Malloc(kMemTagInput, DATA_RING_BYTES,
+                                                   MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    SpscRing_Init(&s_data_ring, ring_buf, ring_buf ? DATA_RING_BYTES : 0);
+
+    CobsMux_Init(&s_mux);
+    SpscRing_Init(&s_key_ring, s_key_ring_buf, KEY_RING_BYTES);
+    CobsMux_Register(&s_mux, kMuxChanKey, &s_key_ring, on_key_channel, NULL);
 
     uart_config_t cfg = {
         .baud_rate = ROUTER_BAUDRATE,
@@ -130,20 +200,21 @@ void Uart1Router_Init(void)
         .source_clk = UART_SCLK_DEFAULT,
     };
 
-    uart_driver_install(ROUTER_UART_NUM, 4096, 0, 0, NULL, 0);
-    uart_param_config(ROUTER_UART_NUM, &cfg);
-    uart_set_pin(ROUTER_UART_NUM, ROUTER_TX_GPIO, ROUTER_RX_GPIO,
-                 UART_PIN_NO_CHANGE, UART_PIN_NO_CHANGE);
+    esp_err_t e_install = uart_driver_install(ROUTER_UART_NUM, ROUTER_RX_BUF_BYTES, ROUTER_TX_BUF_BYTES,
+                                              ROUTER_EVT_DEPTH, &s_uart_evt_q, 0);
+    esp_err_t e_param = uart_param_config(ROUTER_UART_NUM, &cfg);
+    esp_err_t e_pin = uart_set_pin(ROUTER_UART_NUM, ROUTER_TX_GPIO, ROUTER_RX_GPIO,
+                                   UART_PIN_NO_CHANGE, UART_PIN_NO_CHANGE);
 
-    s_state = kWaitHead;
-    s_cmd = 0;
+    KeyFrame_Reset(&s_keys);
     s_data_enabled = false;
+    memset(&s_stats, 0, sizeof(s_stats));
+    s_stats.baudrate = ROUTER_BAUDRATE;
+    Uart1Router_SetFraming(ROUTER_FRAMING_DEFAULT);
 
 
     ESP_LOGI("UARTDBG", "install=%s param=%s setpin=%s",
-         esp_err_to_name(uart_driver_install(UART_NUM_1, 4096, 0, 0, NULL, 0)),
-         esp_err_to_name(uart_param_config(UART_NUM_1, &cfg)),
-         esp_err_to_name(uart_set_pin(UART_NUM_1, 35, 36, UART_PIN_NO_CHANGE, UART_PIN_NO_CHANGE)));
+         esp_err_to_name(e_install), esp_err_to_name(e_param), esp_err_to_name(e_pin));
 
     xTaskCreate(rx_task, "uart1_rx_router", 4096, NULL, 12, NULL);
 }
@@ -155,22 +226,164 @@ bool Uart1Router_PollKey(InputKey* out_key, uint32_t timeout_ms)
 
 void Uart1Router_EnableData(bool enable)
 {
+    // Stale bytes are dropped on both edges; the consumer must be idle here
+    SpscRing_Drain(&s_data_ring);
     s_data_enabled = enable;
+    if (enable) CobsMux_Register(&s_mux, kMuxChanData, &s_data_ring, on_data_channel, NULL);
+    else CobsMux_Unregister(&s_mux, kMuxChanData);
+    if (!enable) SpscRing_Drain(&s_data_ring);
+}
 
-    if (!enable) {
-        uint8_t b;
-        while (xQueueReceive(s_data_q, &b, 0) == pdTRUE) {}
-    }
+uint32_t Uart1Router_DataPeek(const uint8_t** out, uint32_t timeout_ms)
+{
+    uint32_t n = SpscRing_Peek(&s_data_ring, out);
+    if (n || timeout_ms == 0) return n;
+
+    // The router gives the semaphore after every stored block, so a give that
+    // lands between the peek above and this take is not lost
+    xSemaphoreTake(s_data_sem, pdMS_TO_TICKS(timeout_ms));
+    return SpscRing_Peek(&s_data_ring, out);
+}
+
+void Uart1Router_DataCommit(uint32_t n)
+{
+    SpscRing_Commit(&s_data_ring, n);
+}
+
+uint32_t Uart1Router_ReadData(uint8_t* out, uint32_t len, uint32_t timeout_ms)
+{
+    const uint8_t* p;
+    if (Uart1Router_DataPeek(&p, timeout_ms) == 0) return 0;
+    return SpscRing_Read(&s_data_ring, out, len);
 }
 
 bool Uart1Router_ReadDataByte(uint8_t* out_b, uint32_t timeout_ms)
 {
-    return xQueueReceive(s_data_q, out_b, pdMS_TO_TICKS(timeout_ms)) == pdTRUE;
+    return Uart1Router_ReadData(out_b, 1, timeout_ms) == 1;
+}
+
+// One or more frames on chan, ROUTER_FRAME_MAX payload bytes each; the
+// channels are byte streams, so the peer sees the bytes back to back.
+// Caller holds the tx mutex. Returns payload bytes written.
+static int send_frames_locked(uint8_t chan, const uint8_t* data, uint32_t len)
+{
+    int n = 0;
+    do {
+        uint32_t part = len < ROUTER_FRAME_MAX ? len : ROUTER_FRAME_MAX;
+        size_t fn = CobsMux_Encode(chan, data, part, s_tx_frame, sizeof(s_tx_frame));
+        if (uart_write_bytes(ROUTER_UART_NUM, (const char*)s_tx_frame, fn) < 0) return n ? n : -1;
+        n += (int)part;
+        data += part;
+        len -= part;
+    } while (len);
+    return n;
+}
+
+static bool tx_framed(void)
+{
+    return s_framing_req == kUart1FramingCobs;
 }
 
 int Uart1Router_Write(const uint8_t* data, int len)
 {
-    return uart_write_bytes(ROUTER_UART_NUM, (const char*)data, len);
+    xSemaphoreTake(s_tx_mutex, portMAX_DELAY);
+    int n = tx_framed() ? send_frames_locked(kMuxChanData, data, (uint32_t)len)
+                        : uart_write_bytes(ROUTER_UART_NUM, (const char*)data, len);
+    xSemaphoreGive(s_tx_mutex);
+    return n;
+}
+
+int Uart1Router_WriteV(const Uart1Iov* iov, int count)
+{
+    uint32_t total = 0;
+    for (int i = 0; i < count; i++) total += iov[i].len;
+
+    xSemaphoreTake(s_tx_mutex, portMAX_DELAY);
+
+    int n = 0;
+    if (total <= sizeof(s_tx_gather)) {
+        // Gathered so the frame reaches the driver in one call
+        uint32_t off = 0;
+        for (int i = 0; i < count; i++) {
+            memcpy(s_tx_gather + off, iov[i].base, iov[i].len);
+            off += iov[i].len;
+        }
+        n = tx_framed() ? send_frames_locked(kMuxChanData, s_tx_gather, total)
+                        : uart_write_bytes(ROUTER_UART_NUM, (const char*)s_tx_gather, total);
+    } else {
+        // Still contiguous on the wire: the mutex keeps other writers out
+        for (int i = 0; i < count; i++) {
+            int w = tx_framed() ? send_frames_locked(kMuxChanData, (const uint8_t*)iov[i].base, iov[i].len)
+                                : uart_write_bytes(ROUTER_UART_NUM, (const char*)iov[i].base, iov[i].len);
+            if (w < 0) break;
+            n += w;
+        }
+    }
+
+    xSemaphoreGive(s_tx_mutex);
+    return n;
+}
+
+int Uart1Router_SendFrame(uint8_t chan, const uint8_t* data, uint32_t len)
+{
+    if (len > ROUTER_FRAME_MAX) return -1;
+
+    xSemaphoreTake(s_tx_mutex, portMAX_DELAY);
+    size_t n = CobsMux_Encode(chan, data, len, s_tx_frame, sizeof(s_tx_frame));
+    int w = uart_write_bytes(ROUTER_UART_NUM, (const char*)s_tx_frame, n);
+    xSemaphoreGive(s_tx_mutex);
+    return w;
+}
+
+// Deferred log lines go out on the log channel while the link is framed
+static void log_sink(const char* line, uint32_t len)
+{
+    if (s_framing_req != kUart1FramingCobs) return;
+    (void)Uart1Router_SendFrame(kMuxChanLog, (const uint8_t*)line, len);
+}
+
+void Uart1Router_SetFraming(Uart1Framing framing)
+{
+    // Applied by the rx task before the next block; tx switches right away
+    xSemaphoreTake(s_tx_mutex, portMAX_DELAY);
+    s_framing_req = framing;
+    xSemaphoreGive(s_tx_mutex);
+    Dlog_SetSink(framing == kUart1FramingCobs ? log_sink : NULL);
+}
+
+Uart1Framing Uart1Router_GetFraming(void)
+{
+    return s_framing_req;
+}
+
+bool Uart1Router_RegisterChannel(uint8_t chan, SpscRing* ring, CobsMuxNotify notify, void* arg)
+{
+    // Key and data channels are owned by the router
+    if (chan == kMuxChanKey || chan == kMuxChanData) return false;
+    return CobsMux_Register(&s_mux, chan, ring, notify, arg);
+}
+
+void Uart1Router_UnregisterChannel(uint8_t chan)
+{
+    if (chan == kMuxChanKey || chan == kMuxChanData) return;
+    CobsMux_Unregister(&s_mux, chan);
+}
+
+bool Uart1Router_SetBaudrate(uint32_t baud)
+{
+    if (uart_set_baudrate(ROUTER_UART_NUM, baud) != ESP_OK) return false;
+    s_stats.baudrate = baud;
+    return true;
+}
+
+void Uart1Router_GetStats(Uart1RouterStats* out)
+{
+    if (!out) return;
+    *out = s_stats;
+    out->ring_used = SpscRing_Used(&s_data_ring);
+    out->mux_frames = s_mux.frames_ok;
+    out->mux_errors = s_mux.crc_errors + s_mux.framing_errors + s_mux.unknown_chan;
+    for (int c = 0; c < COBS_MUX_MAX_CHANNELS; c++) out->mux_errors += s_mux.ch[c].overruns;
 }
 
 void Uart1Router_InjectKey(InputKey key)
@@ -1,16 +1,61 @@
-
-
 #pragma once
 #include <stdint.h>
 #include <stdbool.h>
 #include "core/app_events.h"
+#include "core/spsc_ring.h"
+#include "input/cobs_mux.h"
+
+typedef struct {
+    uint32_t rx_bytes;              // everything read from the UART
+    uint32_t key_frames;
+    uint32_t data_bytes;            // bytes handed to the data channel
+    uint32_t ring_overrun_bytes;    // data dropped because the consumer fell behind
+    uint32_t hw_overruns;           // FIFO / driver buffer overflow events
+    uint32_t ring_high_water;
+    uint32_t ring_used;
+    uint32_t baudrate;
+    uint32_t mux_frames;            // COBS framing: frames delivered
+    uint32_t mux_errors;            // COBS framing: CRC, framing, unknown channel, ring full
+} Uart1RouterStats;
+
+typedef enum {
+    kUart1FramingLegacy = 0,        // AA xx 55 key frames inline with raw data bytes
+    kUart1FramingCobs,              // every byte belongs to a COBS frame with a channel id
+} Uart1Framing;
+
+typedef struct {
+    const void* base;
+    uint32_t len;
+} Uart1Iov;
 
 void Uart1Router_Init(void);
 
 bool Uart1Router_PollKey(InputKey* out_key, uint32_t timeout_ms);
 
+// Data channel (bytes that are not key frames), single consumer.
+// Peek returns the longest contiguous readable span, waiting up to
+// timeout_ms when empty; Commit releases bytes once processed.
 void Uart1Router_EnableData(bool enable);
+uint32_t Uart1Router_DataPeek(const uint8_t** out, uint32_t timeout_ms);
+void Uart1Router_DataCommit(uint32_t n);
+uint32_t Uart1Router_ReadData(uint8_t* out, uint32_t len, uint32_t timeout_ms);
 bool Uart1Router_ReadDataByte(uint8_t* out_b, uint32_t timeout_ms);
 
+// In COBS framing these go out as data-channel frames, so experiment code
+// talks the same way in either mode
 int Uart1Router_Write(const uint8_t* data, int len);
+int Uart1Router_WriteV(const Uart1Iov* iov, int count);   // segments go out back to back
+bool Uart1Router_SetBaudrate(uint32_t baud);
+
+// COBS channel mux (see cobs_mux.h). Keys and the data channel above are
+// served by the router itself; other channels (log, telemetry, ...) are
+// registered by their consumers with a ring they own. While framed, the
+// deferred log (dlog) is mirrored out on kMuxChanLog. The boot framing
+// comes from CONFIG_APP_UART1_COBS.
+void Uart1Router_SetFraming(Uart1Framing framing);
+Uart1Framing Uart1Router_GetFraming(void);
+bool Uart1Router_RegisterChannel(uint8_t chan, SpscRing* ring, CobsMuxNotify notify, void* arg);
+void Uart1Router_UnregisterChannel(uint8_t chan);
+int Uart1Router_SendFrame(uint8_t chan, const uint8_t* data, uint32_t len);
+void Uart1Router_GetStats(Uart1RouterStats* out);
 void Uart1Router_InjectKey(InputKey key);
@@ -0,0 +1,105 @@
+#include "input/uart_pkt.h"
+#include "core/hot_path.h"
+
+#include <string.h>
+
+void UartPkt_Init(UartPktParser* p, uint8_t* data_buf)
+{
+    p->data = data_buf;
+    UartPkt_Reset(p);
+}
+
+void UartPkt_Reset(UartPktParser* p)
+{
+    p->st = kUartPktWaitHead;
+    p->len = 0;
+    p->pos = 0;
+    p->sum_calc = 0;
+    p->sum = 0;
+    p->tail = 0;
+}
+
+uint8_t UartPkt_Sum(const uint8_t* data, size_t len)
+{
+    uint32_t s = 0;
+    for (size_t i = 0; i < len; i++) s += data[i];
+    return (uint8_t)(s & 0xFF);
+}
+
+HOT_PATH size_t UartPkt_Feed(UartPktParser* p, const uint8_t* in, size_t len, UartPktResult* res)
+{
+    size_t i = 0;
+    *res = kUartPktNone;
+
+    while (i < len) {
+        switch (p->st) {
+            case kUartPktWaitHead: {
+                const uint8_t* h = (const uint8_t*)memchr(in + i, UART_PKT_HEAD, len - i);
+                if (!h) return len;     // no frame start in this block
+                i = (size_t)(h - in) + 1;
+                p->st = kUartPktWaitLen;
+                break;
+            }
+
+            case kUartPktWaitLen:
+                p->len = in[i++];
+                p->pos = 0;
+                p->sum_calc = 0;
+                p->st = (p->len == 0) ? kUartPktWaitSum : kUartPktWaitData;
+                break;
+
+            case kUartPktWaitData: {
+                size_t n = (size_t)(p->len - p->pos);
+                if (n > len - i) n = len - i;
+
+                // Copy and checksum in one pass over the span
+                uint8_t* dst = p->data + p->pos;
+                uint32_t s = p->sum_calc;
+                for (size_t k = 0; k < n; k++) {
+                    uint8_t b = in[i + k];
+                    dst[k] = b;
+                    s += b;
+                }
+                p->sum_calc = (uint8_t)s;
+                p->pos = (uint8_t)(p->pos + n);
+                i += n;
+                if (p->pos >= p->len) p->st = kUartPktWaitSum;
+                break;
+            }
+
+            case kUartPktWaitSum:
+                p->sum = in[i++];
+                p->st = kUartPktWaitTail;
+                break;
+
+            case kUartPktWaitTail:
+                p->tail = in[i++];
+                if (p->tail != UART_PKT_TAIL) *res = kUartPktBadTail;
+                else if (p->sum != p->sum_calc) *res = kUartPktBadSum;
+                else *res = kUartPktOk;
+                p->st = kUartPktWaitHead;
+                return i;
+
+            default:
+                UartPkt_Reset(p);
+                break;
+        }
+    }
+    return i;
+}
+
+void UartPkt_BuildInvertReply(const uint8_t* data, uint8_t len,
+                              uint8_t hdr[2], uint8_t* out_data, uint8_t trl[2])
+{
+    uint32_t s = 0;
+    for (uint32_t i = 0; i < len; i++) {
+        uint8_t v = (uint8_t)(~data[i]);
+        out_data[i] = v;
+        s += v;
+    }
+
+    hdr[0] = UART_PKT_HEAD;
+    hdr[1] = len;
+    trl[0] = (uint8_t)(s & 0xFF);
+    trl[1] = UART_PKT_TAIL;
+}
@@ -0,0 +1,53 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+// Block parser for the UART experiment frame:  BB LEN DATA[LEN] SUM 66
+// SUM = sum(DATA) & 0xFF. Plain C, no IDF dependencies.
+
+#define UART_PKT_HEAD     0xBB
+#define UART_PKT_TAIL     0x66
+#define UART_PKT_MAX_DATA 255
+#define UART_PKT_OVERHEAD 4
+
+typedef enum {
+    kUartPktWaitHead = 0,
+    kUartPktWaitLen,
+    kUartPktWaitData,
+    kUartPktWaitSum,
+    kUartPktWaitTail
+} UartPktState;
+
+typedef enum {
+    kUartPktNone = 0,   // need more bytes
+    kUartPktOk,
+    kUartPktBadSum,
+    kUartPktBadTail
+} UartPktResult;
+
+typedef struct {
+    UartPktState st;
+    uint8_t len;
+    uint8_t pos;
+    uint8_t sum_calc;   // running sum of DATA
+    uint8_t sum;        // received SUM byte
+    uint8_t tail;       // received tail byte
+    uint8_t* data;      // caller buffer, UART_PKT_MAX_DATA bytes
+} UartPktParser;
+
+void UartPkt_Init(UartPktParser* p, uint8_t* data_buf);
+void UartPkt_Reset(UartPktParser* p);
+
+static inline bool UartPkt_InFrame(const UartPktParser* p) { return p->st != kUartPktWaitHead; }
+
+// Consumes bytes until one frame completes or input runs out. Returns the
+// number of bytes used; *res says whether a frame ended in this call.
+size_t UartPkt_Feed(UartPktParser* p, const uint8_t* in, size_t len, UartPktResult* res);
+
+uint8_t UartPkt_Sum(const uint8_t* data, size_t len);
+
+// Writes the inverted payload into out_data and fills the 2-byte header and
+// trailer, ready for a scatter-gather write (hdr, out_data, trl).
+void UartPkt_BuildInvertReply(const uint8_t* data, uint8_t len,
+                              uint8_t hdr[2], uint8_t* out_data, uint8_t trl[2]);
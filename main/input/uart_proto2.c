@@ -0,0 +1,320 @@
+#include "input/uart_proto2.h"
+
+#include <string.h>
+
+#include "core/crc.h"
+#include "core/hot_path.h"
+
+static inline uint16_t rd16(const uint8_t* p) { return (uint16_t)(p[0] | (p[1] << 8)); }
+
+// hdr[] holds the bytes after SOF: flags type seq ack len_lo len_hi
+#define H_FLAGS 0
+#define H_TYPE  1
+#define H_SEQ   2
+#define H_ACK   3
+#define H_LEN   4
+#define H_COUNT 6
+
+void Up2Parser_Init(Up2Parser* p, uint8_t* buf, uint16_t max_payload)
+{
+    memset(p, 0, sizeof(*p));
+    p->buf = buf;
+    p->max_payload = max_payload;
+}
+
+void Up2Parser_Reset(Up2Parser* p)
+{
+    p->st = kUp2Sof0;
+    p->pos = 0;
+}
+
+bool Up2Parser_InFrame(const Up2Parser* p)
+{
+    return p->st != kUp2Sof0;
+}
+
+static bool header_ok(const Up2Parser* p)
+{
+    uint8_t flags = p->hdr[H_FLAGS];
+    uint8_t type = p->hdr[H_TYPE];
+    uint16_t len = rd16(&p->hdr[H_LEN]);
+
+    if ((flags >> 4) != UP2_VERSION) return false;
+    if (flags & 0x0E) return false;
+    if (type == kUp2TypeData) return len <= p->max_payload;
+    if (type == kUp2TypeAck) return len == 0;
+    return false;
+}
+
+static bool crc_ok(const Up2Parser* p, uint16_t len)
+{
+    if (p->hdr[H_FLAGS] & UP2_FLAG_CRC32) {
+        uint32_t c = Crc32_Update(CRC32_INIT, p->hdr, H_COUNT);
+        c = Crc32_Update(c, p->buf, len);
+        uint32_t got = (uint32_t)p->crc_bytes[0] | ((uint32_t)p->crc_bytes[1] << 8) |
+                       ((uint32_t)p->crc_bytes[2] << 16) | ((uint32_t)p->crc_bytes[3] << 24);
+        return c == got;
+    }
+
+    uint16_t c = Crc16_Update(CRC16_INIT, p->hdr, H_COUNT);
+    c = Crc16_Update(c, p->buf, len);
+    return c == rd16(p->crc_bytes);
+}
+
+HOT_PATH size_t Up2Parser_Feed(Up2Parser* p, const uint8_t* in, size_t len, Up2Result* res)
+{
+    size_t i = 0;
+    *res = kUp2None;
+
+    while (i < len) {
+        switch (p->st) {
+            case kUp2Sof0: {
+                const uint8_t* h = (const uint8_t*)memchr(in + i, UP2_SOF0, len - i);
+                size_t skip = h ? (size_t)(h - (in + i)) : (len - i);
+                p->skipped_bytes += (uint32_t)skip;
+                i += skip;
+                if (h) {
+                    i++;
+                    p->st = kUp2Sof1;
+                }
+                break;
+            }
+
+            case kUp2Sof1:
+                if (in[i] == UP2_SOF1) {
+                    i++;
+                    p->st = kUp2Header;
+                    p->pos = 0;
+                } else {
+                    // Re-examine this byte as a possible SOF0
+                    p->skipped_bytes++;
+                    p->st = kUp2Sof0;
+                }
+                break;
+
+            case kUp2Header:
+                p->hdr[p->pos++] = in[i++];
+                if (p->pos == H_COUNT) {
+                    if (!header_ok(p)) {
+                        p->header_errors++;
+                        p->st = kUp2Sof0;
+                        *res = kUp2BadHeader;
+                        return i;
+                    }
+                    p->pos = 0;
+                    p->st = rd16(&p->hdr[H_LEN]) ? kUp2Payload : kUp2Crc;
+                }
+                break;
+
+            case kUp2Payload: {
+                uint16_t plen = rd16(&p->hdr[H_LEN]);
+                size_t n = (size_t)(plen - p->pos);
+                if (n > len - i) n = len - i;
+                memcpy(p->buf + p->pos, in + i, n);
+                p->pos = (uint16_t)(p->pos + n);
+                i += n;
+                if (p->pos == plen) {
+                    p->pos = 0;
+                    p->st = kUp2Crc;
+                }
+                break;
+            }
+
+            case kUp2Crc: {
+                uint8_t need = (p->hdr[H_FLAGS] & UP2_FLAG_CRC32) ? 4 : 2;
+                p->crc_bytes[p->pos++] = in[i++];
+                if (p->pos < need) break;
+
+                uint16_t plen = rd16(&p->hdr[H_LEN]);
+                p->st = kUp2Sof0;
+                p->pos = 0;
+
+                if (!crc_ok(p, plen)) {
+                    p->crc_errors++;
+                    *res = kUp2BadCrc;
+                    return i;
+                }
+
+                p->frame.flags = p->hdr[H_FLAGS];
+                p->frame.type = p->hdr[H_TYPE];
+                p->frame.seq = p->hdr[H_SEQ];
+                p->frame.ack = p->hdr[H_ACK];
+                p->frame.len = plen;
+                p->frame.payload = p->buf;
+                p->frames_ok++;
+                *res = kUp2Frame;
+                return i;
+            }
+
+            default:
+                Up2Parser_Reset(p);
+                break;
+        }
+    }
+    return i;
+}
+
+size_t Up2_Encode(uint8_t* out, size_t cap, uint8_t flags, uint8_t type,
+                  uint8_t seq, uint8_t ack, const uint8_t* payload, uint16_t len)
+{
+    flags = (uint8_t)((UP2_VERSION << 4) | (flags & UP2_FLAG_CRC32));
+
+    size_t total = Up2_FrameSize(flags, len);
+    if (total > cap) return 0;
+
+    out[0] = UP2_SOF0;
+    out[1] = UP2_SOF1;
+    out[2] = flags;
+    out[3] = type;
+    out[4] = seq;
+    out[5] = ack;
+    out[6] = (uint8_t)(len & 0xFF);
+    out[7] = (uint8_t)(len >> 8);
+    if (len) memcpy(out + UP2_HDR_LEN, payload, len);
+
+    size_t body = (size_t)(H_COUNT + len);
+    uint8_t* c = out + UP2_HDR_LEN + len;
+    if (flags & UP2_FLAG_CRC32) {
+        uint32_t v = Crc32_Update(CRC32_INIT, out + 2, body);
+        c[0] = (uint8_t)v;
+        c[1] = (uint8_t)(v >> 8);
+        c[2] = (uint8_t)(v >> 16);
+        c[3] = (uint8_t)(v >> 24);
+    } else {
+        uint16_t v = Crc16_Update(CRC16_INIT, out + 2, body);
+        c[0] = (uint8_t)v;
+        c[1] = (uint8_t)(v >> 8);
+    }
+    return total;
+}
+
+// ---------------------------------------------------------------------------
+// Sender window
+
+void Up2Tx_Init(Up2Tx* tx, uint8_t* storage, uint16_t slot_size, uint8_t window,
+                uint8_t flags, uint32_t rto_ms)
+{
+    memset(tx, 0, sizeof(*tx));
+    tx->slots = storage;
+    tx->slot_size = slot_size;
+    tx->window = (window == 0) ? 1 : (window > UP2_MAX_WINDOW ? UP2_MAX_WINDOW : window);
+    tx->flags = flags;
+    tx->rto_ms = rto_ms;
+}
+
+uint8_t Up2Tx_InFlight(const Up2Tx* tx)
+{
+    return (uint8_t)(tx->next - tx->base);
+}
+
+bool Up2Tx_CanQueue(const Up2Tx* tx)
+{
+    return Up2Tx_InFlight(tx) < tx->window;
+}
+
+// Slots follow base rather than seq % window: with a window that does not
+// divide 256 the latter puts two frames in flight around the wrap in one slot
+static uint8_t slot_index(const Up2Tx* tx, uint8_t seq)
+{
+    return (uint8_t)((tx->base_slot + (uint8_t)(seq - tx->base)) % tx->window);
+}
+
+static uint8_t* slot_of(const Up2Tx* tx, uint8_t seq)
+{
+    return tx->slots + (size_t)slot_index(tx, seq) * tx->slot_size;
+}
+
+bool Up2Tx_Queue(Up2Tx* tx, const uint8_t* payload, uint16_t len)
+{
+    if (!Up2Tx_CanQueue(tx) || len > tx->slot_size) return false;
+
+    memcpy(slot_of(tx, tx->next), payload, len);
+    tx->slot_len[slot_index(tx, tx->next)] = len;
+    tx->next++;
+    return true;
+}
+
+void Up2Tx_OnAck(Up2Tx* tx, uint8_t ack, uint32_t now_ms)
+{
+    uint8_t acked = (uint8_t)(ack - tx->base);
+    if (acked == 0 || acked > Up2Tx_InFlight(tx)) return;     // stale or bogus
+
+    tx->base = ack;
+    tx->base_slot = (uint8_t)((tx->base_slot + acked) % tx->window);
+    tx->sent_hi = (uint8_t)(tx->sent_hi > acked ? tx->sent_hi - acked : 0);
+    tx->base_sent_ms = now_ms;  // restart the timer for the new oldest frame
+
+    // Frames the peer already has need no retransmission
+    if ((uint8_t)(tx->resend - tx->base) > Up2Tx_InFlight(tx)) tx->resend = tx->base;
+}
+
+size_t Up2Tx_Poll(Up2Tx* tx, uint32_t now_ms, uint8_t rx_ack, uint8_t* out, size_t cap)
+{
+    uint8_t inflight = Up2Tx_InFlight(tx);
+
+    // Only frames already sent once can time out
+    uint8_t sent = (uint8_t)(tx->resend - tx->base);
+    if (inflight && sent && (now_ms - tx->base_sent_ms) >= tx->rto_ms) {
+        tx->timeouts++;
+        tx->resend = tx->base;      // go back N
+        tx->base_sent_ms = now_ms;
+    }
+
+    if (tx->resend == tx->next) return 0;
+
+    uint8_t seq = tx->resend;
+    uint16_t len = tx->slot_len[slot_index(tx, seq)];
+    size_t n = Up2_Encode(out, cap, tx->flags, kUp2TypeData, seq, rx_ack, slot_of(tx, seq), len);
+    if (n == 0) return 0;
+
+    // The timer tracks the oldest outstanding frame
+    if (seq == tx->base) tx->base_sent_ms = now_ms;
+    if ((uint8_t)(seq - tx->base) < tx->sent_hi) tx->retransmits++;
+    else tx->sent_hi = (uint8_t)(seq - tx->base + 1);
+
+    tx->resend++;
+    tx->sent_frames++;
+    return n;
+}
+
+// ---------------------------------------------------------------------------
+// Receiver
+
+void Up2Rx_Init(Up2Rx* rx, uint8_t ack_every)
+{
+    memset(rx, 0, sizeof(*rx));
+    rx->ack_every = ack_every ? ack_every : 1;
+}
+
+bool Up2Rx_Accept(Up2Rx* rx, const Up2Frame* f)
+{
+    if (f->type != kUp2TypeData) return false;
+
+    if (f->seq != rx->expected) {
+        // Duplicate or gap: drop it and re-ack so the sender goes back
+        rx->out_of_order++;
+        rx->ack_now = true;
+        return false;
+    }
+
+    rx->expected++;
+    rx->unacked++;
+    rx->delivered++;
+    rx->delivered_bytes += f->len;
+    return true;
+}
+
+bool Up2Rx_AckDue(const Up2Rx* rx)
+{
+    return rx->ack_now || rx->unacked >= rx->ack_every;
+}
+
+size_t Up2Rx_EncodeAck(Up2Rx* rx, uint8_t flags, uint8_t* out, size_t cap)
+{
+    size_t n = Up2_Encode(out, cap, flags, kUp2TypeAck, 0, rx->expected, NULL, 0);
+    if (n) {
+        rx->unacked = 0;
+        rx->ack_now = false;
+    }
+    return n;
+}
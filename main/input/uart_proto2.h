@@ -0,0 +1,145 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+// UART protocol v2: CRC-protected frames with sequence numbers and a
+// go-back-N sliding window with cumulative acks. Plain C (no IDF calls) so
+// the same code is fuzzed and benchmarked on the host (host/).
+//
+// Frame, little endian:
+//   B2 2B | flags | type | seq | ack | len16 | payload[len] | crc16 or crc32
+//   flags: bits 7..4 = version (2), bit 0 = CRC-32 instead of CRC-16
+//   ack:   next sequence number the sender of this frame expects (cumulative)
+//   crc:   over flags..end of payload
+
+#define UP2_SOF0            0xB2
+#define UP2_SOF1            0x2B
+#define UP2_VERSION         2
+#define UP2_FLAG_CRC32      0x01
+#define UP2_HDR_LEN         8
+#define UP2_MAX_PAYLOAD     1024
+#define UP2_MAX_FRAME       (UP2_HDR_LEN + UP2_MAX_PAYLOAD + 4)
+#define UP2_MAX_WINDOW      16
+
+typedef enum {
+    kUp2TypeData = 1,
+    kUp2TypeAck  = 2,   // len 0, only the ack field matters
+} Up2Type;
+
+typedef enum {
+    kUp2None = 0,       // need more bytes
+    kUp2Frame,          // valid frame in parser->frame
+    kUp2BadCrc,
+    kUp2BadHeader,
+} Up2Result;
+
+typedef struct {
+    uint8_t flags;
+    uint8_t type;
+    uint8_t seq;
+    uint8_t ack;
+    uint16_t len;
+    const uint8_t* payload;     // points into the parser buffer
+} Up2Frame;
+
+typedef enum {
+    kUp2Sof0 = 0,
+    kUp2Sof1,
+    kUp2Header,
+    kUp2Payload,
+    kUp2Crc,
+} Up2State;
+
+typedef struct {
+    Up2State st;
+    uint16_t pos;
+    uint16_t max_payload;
+    uint8_t hdr[UP2_HDR_LEN];
+    uint8_t crc_bytes[4];
+    uint8_t* buf;               // caller buffer, max_payload bytes
+    Up2Frame frame;
+
+    uint32_t frames_ok;
+    uint32_t crc_errors;
+    uint32_t header_errors;
+    uint32_t skipped_bytes;     // bytes discarded while hunting for SOF
+} Up2Parser;
+
+void Up2Parser_Init(Up2Parser* p, uint8_t* buf, uint16_t max_payload);
+void Up2Parser_Reset(Up2Parser* p);
+bool Up2Parser_InFrame(const Up2Parser* p);
+
+// Consumes bytes until a frame ends (good or bad) or the input runs out.
+size_t Up2Parser_Feed(Up2Parser* p, const uint8_t* in, size_t len, Up2Result* res);
+
+// Returns the frame size, or 0 when it does not fit in cap
+size_t Up2_Encode(uint8_t* out, size_t cap, uint8_t flags, uint8_t type,
+                  uint8_t seq, uint8_t ack, const uint8_t* payload, uint16_t len);
+
+static inline size_t Up2_FrameSize(uint8_t flags, uint16_t len)
+{
+    return UP2_HDR_LEN + len + ((flags & UP2_FLAG_CRC32) ? 4u : 2u);
+}
+
+// ---------------------------------------------------------------------------
+// Sender window (go-back-N). Payloads are copied into caller storage of
+// window * slot_size bytes so they can be retransmitted.
+
+typedef struct {
+    uint8_t flags;
+    uint8_t window;
+    uint16_t slot_size;
+    uint8_t* slots;
+    uint16_t slot_len[UP2_MAX_WINDOW];
+
+    uint8_t base;           // oldest unacked seq
+    uint8_t base_slot;      // its slot; seq wraps at 256, which need not divide by window
+    uint8_t next;           // next new seq
+    uint8_t resend;         // next seq to (re)send; == next when caught up
+    uint8_t sent_hi;        // frames past base sent at least once
+    uint32_t rto_ms;
+    uint32_t base_sent_ms;
+
+    uint32_t sent_frames;
+    uint32_t retransmits;
+    uint32_t timeouts;
+} Up2Tx;
+
+void Up2Tx_Init(Up2Tx* tx, uint8_t* storage, uint16_t slot_size, uint8_t window,
+                uint8_t flags, uint32_t rto_ms);
+uint8_t Up2Tx_InFlight(const Up2Tx* tx);
+bool Up2Tx_CanQueue(const Up2Tx* tx);
+
+// Takes a new payload into the window; false when full or too long
+bool Up2Tx_Queue(Up2Tx* tx, const uint8_t* payload, uint16_t len);
+
+// Cumulative ack from the peer: everything before ack is released
+void Up2Tx_OnAck(Up2Tx* tx, uint8_t ack, uint32_t now_ms);
+
+// Encodes the next frame due (new or retransmit) with our ack piggybacked.
+// Returns its size, 0 when nothing is due.
+size_t Up2Tx_Poll(Up2Tx* tx, uint32_t now_ms, uint8_t rx_ack, uint8_t* out, size_t cap);
+
+// ---------------------------------------------------------------------------
+// Receiver: in-order delivery, cumulative ack every ack_every frames or
+// immediately after a gap.
+
+typedef struct {
+    uint8_t expected;
+    uint8_t unacked;
+    uint8_t ack_every;
+    bool ack_now;
+
+    uint32_t delivered;
+    uint32_t delivered_bytes;
+    uint32_t out_of_order;
+} Up2Rx;
+
+void Up2Rx_Init(Up2Rx* rx, uint8_t ack_every);
+
+// True when the frame is the next in sequence and should be delivered
+bool Up2Rx_Accept(Up2Rx* rx, const Up2Frame* f);
+
+bool Up2Rx_AckDue(const Up2Rx* rx);
+size_t Up2Rx_EncodeAck(Up2Rx* rx, uint8_t flags, uint8_t* out, size_t cap);
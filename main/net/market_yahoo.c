@@ -9,6 +9,8 @@
 #include "cJSON.h"
 #include "esp_timer.h"
 #include "esp_crt_bundle.h"
+#include "esp_heap_caps.h"
+#include "mem_track.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 
@@ -63,7 +65,7 @@ static int http_get_all(const char* url, char** io_buf, int* io_cap, int* out_st
     if (content_len > 0) {
         int need = content_len + 1;
         if (!*io_buf || !*io_cap || *io_cap < need) {
-            char* nb = (char*)realloc(*io_buf, (size_t)need);
+            char* nb = (char*)MemTrack_Realloc(kMemTagNet, *io_buf, (size_t)need, MALLOC_CAP_DEFAULT);
             if (!nb) {
                 esp_http_client_close(c);
                 esp_http_client_cleanup(c);
@@ -75,7 +77,7 @@ static int http_get_all(const char* url, char** io_buf, int* io_cap, int* out_st
     } else {
         if (!*io_buf || !*io_cap) {
             *io_cap = 8 * 1024;
-            *io_buf = (char*)malloc((size_t)*io_cap);
+            *io_buf = (char*)MemTrack_Malloc(kMemTagNet, (size_t)*io_cap, MALLOC_CAP_DEFAULT);
             if (!*io_buf) {
                 esp_http_client_close(c);
                 esp_http_client_cleanup(c);
@@ -92,7 +94,7 @@ static int http_get_all(const char* url, char** io_buf, int* io_cap, int* out_st
         int room = (*io_cap) - 1 - total;
         if (room <= 0) {
             int new_cap = (*io_cap) * 2;
-            char* nb = (char*)realloc(*io_buf, (size_t)new_cap);
+            char* nb = (char*)MemTrack_Realloc(kMemTagNet, *io_buf, (size_t)new_cap, MALLOC_CAP_DEFAULT);
             if (!nb) break;
             *io_buf = nb;
             *io_cap = new_cap;
@@ -204,7 +206,7 @@ static bool parse_quote(const char* json, float* out_price, float* out_chg_pct)
 void Markets_Init(const char* const* symbols, int count)
 {
     if (s_list) {
-        free(s_list);
+        MemTrack_Free(s_list);
         s_list = NULL;
     }
     s_count = 0;
@@ -213,7 +215,7 @@ void Markets_Init(const char* const* symbols, int count)
 
     if (!symbols || count <= 0) return;
 
-    s_list = (MarketQuote*)calloc((size_t)count, sizeof(MarketQuote));
+    s_list = (MarketQuote*)MemTrack_Calloc(kMemTagNet, (size_t)count, sizeof(MarketQuote), MALLOC_CAP_DEFAULT);
     if (!s_list) return;
 
     s_count = count;
@@ -1,8 +1,10 @@
 #pragma once
 #include <stdint.h>
+#include <stdbool.h>
 #include "experiments/experiment.h"   
 
-void Ui_Init(void);
+void Ui_Init(void);                       // starts panel bring-up in the background
+bool Ui_WaitReady(uint32_t timeout_ms);   // true once the panel is usable
 void Ui_Clear(void);
 void Ui_Println(const char* s);
 void Ui_Printf(const char* fmt, ...);
@@ -17,6 +19,7 @@ void Ui_LcdLock(void);
 void Ui_LcdUnlock(void);
 
 void Ui_DrawFrame(const char* header_title, const char* footer_hint);
+void Ui_DrawHeaderTitle(const char* title);     // redraw the header text of the current frame
 void Ui_DrawBodyClear(void);
 void Ui_DrawBodyTextRowColor(int row, const char* text, uint16_t fg);
 void Ui_DrawBodyTextRowTwoColor(int row, const char* left, const char* right, uint16_t left_fg, uint16_t right_fg);
@@ -25,6 +28,24 @@ void Ui_DrawTextAt(int x, int y, const char* text, uint16_t fg);
 void Ui_DrawTextAtBg(int x, int y, const char* text, uint16_t fg, uint16_t bg);
 void Ui_DrawGpioBody(int selected, bool red_on, bool green_on, bool yellow_on);
 void Ui_DrawPwmBody(int selected, int red_pct, int green_pct, int yellow_pct, int freq_hz);
+#define UI_MIC_MAX_BARS 32
+// Repaints only bars and text that changed since the previous call
 void Ui_DrawMicBody(const int* bands, int band_count, int freq_hz, int vol_pct);
-void Ui_DrawSpeakerBody(bool playing, int vol_pct);
+// MIC waterfall: an axis row under the header, then a hardware-scrolled
+// band down to the footer. Each line maps `count` levels (0..255) across the
+// width through a heat palette and scrolls it in on top; it costs one row
+// of pixels. Ui_Clear() also ends it.
+void Ui_BeginMicWaterfall(int max_hz);
+void Ui_DrawMicWaterfallLine(const uint8_t* levels, int count);
+void Ui_EndMicWaterfall(void);
+// Note name 4x, frequency, and a -50..+50 cent needle; note == NULL when
+// nothing is voiced. Repaints only what changed.
+void Ui_DrawTunerBody(const char* note, int cents, uint32_t freq_centihz, int clarity_pct);
+void Ui_DrawSpeakerBody(bool playing, int vol_pct, const char* eq);
+// Settings rows 0..4 (BLOCK, DMA, GAIN, FX, PING) with `selected` highlighted;
+// live figures go below with Ui_DrawBodyTextRowTwoColor from row
+// UI_MONITOR_ROWS + 1, on the same grid.
+#define UI_MONITOR_ROWS 5
+void Ui_DrawMonitorBody(int selected, int block_samples, int block_us, int dma_desc, int gain_db,
+                        const char* fx, bool pinging);
 void Ui_DrawColorTestBody(int selected, bool sw_invert, bool sw_rb_swap, bool hw_invert);
@@ -1,4 +1,6 @@
 #include "ui_console.h"
+#include "ui_wrap.h"
+#include <stdio.h>
 #include <string.h>
 
 static int clamp_int(int v, int lo, int hi)
@@ -52,8 +54,7 @@ static void push_line(UiConsole* c, const char* s)
 {
     if (!c) return;
 
-    strncpy(c->lines[c->head], s ? s : "", UI_CONSOLE_LINE_CAP - 1);
-    c->lines[c->head][UI_CONSOLE_LINE_CAP - 1] = 0;
+    snprintf(c->lines[c->head], UI_CONSOLE_LINE_CAP, "%s", s ? s : "");
 
     c->head = (c->head + 1) % UI_CONSOLE_MAX_LINES;
     if (c->count < UI_CONSOLE_MAX_LINES) c->count++;
@@ -64,56 +65,6 @@ static void push_line(UiConsole* c, const char* s)
     }
 }
 
-// Simple wrap: prefer spaces, fallback hard cut, supports '\n'
-static const char* wrap_next(const char* p, int cols, char* out, int cap)
-{
-    if (!p) p = "";
-    if (cols < 1) cols = 1;
-    if (cap < 2) { if (cap == 1) out[0] = 0; return p; }
-
-    while (*p == ' ' || *p == '\t') p++;
-
-    if (*p == '\n') {
-        out[0] = 0;
-        return p + 1;
-    }
-
-    int maxc = cols;
-    if (maxc > cap - 1) maxc = cap - 1;
-
-    int n = 0;
-    int last_sp_out = -1;
-    const char* last_sp_p = NULL;
-
-    while (*p && *p != '\n' && n < maxc) {
-        char ch = *p;
-        out[n++] = ch;
-        if (ch == ' ' || ch == '\t') {
-            last_sp_out = n - 1;
-            last_sp_p = p;
-        }
-        p++;
-    }
-
-    if (*p == '\n') {
-        out[n] = 0;
-        return p + 1;
-    }
-
-    if (n == maxc && *p && *p != '\n' && last_sp_out >= 0) {
-        int cut = last_sp_out;
-        while (cut > 0 && (out[cut] == ' ' || out[cut] == '\t')) cut--;
-        out[cut + 1] = 0;
-
-        p = last_sp_p + 1;
-        while (*p == ' ' || *p == '\t') p++;
-        return p;
-    }
-
-    out[n] = 0;
-    return p;
-}
-
 void UiConsole_AppendWrapped(UiConsole* c, const char* text, int cols)
 {
     if (!c) return;
@@ -122,7 +73,7 @@ void UiConsole_AppendWrapped(UiConsole* c, const char* text, int cols)
     const char* p = text;
     while (*p) {
         char line[UI_CONSOLE_LINE_CAP];
-        p = wrap_next(p, cols, line, (int)sizeof(line));
+        p = UiWrap_NextLine(p, cols, line, (int)sizeof(line));
         push_line(c, line);
     }
 }
@@ -2,6 +2,9 @@
 #include "display/st7735.h"
 #include "display/font8x16.h"
 #include "display/font5x7.h"
+#include "display/font_raster.h"
+#include "ui/ui_wrap.h"
+#include "core/hot_path.h"
 #include "esp_log.h"
 
 #include <stdint.h>
@@ -10,10 +13,14 @@
 #include <stdio.h>
 #include <string.h>
 #include "esp_heap_caps.h"
+#include "mem_track.h"
 #include "experiments/experiment.h"
 #include "experiments/experiments_registry.h"
 #include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
 #include "freertos/semphr.h"
+#include "freertos/event_groups.h"
+#include "core/boot_timeline.h"
 
 
 
@@ -41,6 +48,43 @@
 #define UI_LINEBUF_COUNT 4
 
 static int s_cursor_y = 0;
+static bool s_menu_on_screen = false;   // cleared by any full-page redraw
+
+// MIC page bar heights / text on screen, so 30 fps updates only touch what
+// changed; also invalidated by full-page redraws
+typedef struct {
+    bool valid;
+    int count;
+    int fill_h[UI_MIC_MAX_BARS];
+    int vol_fill_w;
+    char text[40];
+} UiMicCache;
+
+static UiMicCache s_mic;
+
+// TUNER page: note, readout and needle on screen
+typedef struct {
+    bool valid;
+    char note[8];
+    char text[40];
+    int needle_x;
+    uint16_t needle_color;
+} UiTunerCache;
+
+static UiTunerCache s_tuner;
+
+// MIC waterfall: hardware-scrolled band below the axis row, newest line on
+// top. Cleared (and the scroll undone) by full-page redraws.
+typedef struct {
+    bool active;
+    int top;            // first memory row of the ring
+    int rows;
+    int row;            // memory row of the newest line
+} UiWaterfall;
+
+static UiWaterfall s_wf;
+static uint16_t s_heat_lut[256];
+static bool s_heat_lut_ready = false;
 
 static uint16_t* s_linebuf[UI_LINEBUF_COUNT];
 static int s_linebuf_idx = 0;
@@ -66,7 +110,7 @@ static void Ui_LineBufInit(int line_h)
 
     for (int i = 0; i < UI_LINEBUF_COUNT; i++) {
         if (s_linebuf[i]) {
-            heap_caps_free(s_linebuf[i]);
+            MemTrack_Free(s_linebuf[i]);
             s_linebuf[i] = NULL;
         }
     }
@@ -75,7 +119,7 @@ static void Ui_LineBufInit(int line_h)
     int w = St7735_Width();
 
     for (int i = 0; i < UI_LINEBUF_COUNT; i++) {
-        s_linebuf[i] = (uint16_t*)heap_caps_malloc(w * line_h * sizeof(uint16_t), MALLOC_CAP_DMA);
+        s_linebuf[i] = (uint16_t*)MemTrack_Malloc(kMemTagUi, w * line_h * sizeof(uint16_t), MALLOC_CAP_DMA);
     }
 
     s_linebuf_idx = 0;
@@ -150,46 +194,10 @@ static uint16_t Ui_LampColor(uint8_t r, uint8_t g, uint8_t b)
 #define RGB565_WHITE  Ui_LampColor(255, 255, 255)
 #define RGB565_BLACK  Ui_LampColor(0, 0, 0)
 
-static void draw_char8x16_to_buf(uint16_t* buf, int bw, int bh, int x, int y, char c, uint16_t fg)
-{
-    if (!buf) return;
-    if (x < 0 || y < 0) return;
-    if (x + 8 > bw) return;
-    if (y + 16 > bh) return;
-
-    const uint8_t* rows = Font8x16_Get(c);
-    if (!rows) rows = Font8x16_Get('?');
-    if (!rows) return;
-
-    for (int ry = 0; ry < 16; ry++) {
-        uint8_t bits = rows[ry];
-        uint16_t* dst = buf + (y + ry) * bw + x;
-        for (int rx = 0; rx < 8; rx++) {
-            if (bits & (0x80U >> rx)) dst[rx] = fg;
-        }
-    }
-}
-
-static void draw_text8x16_to_buf(uint16_t* buf, int bw, int bh, int x, int y, const char* s, uint16_t fg)
+// Glyph rasterizers live in display/font_raster.c so they build on the host
+HOT_PATH static void draw_text8x16_to_buf(uint16_t* buf, int bw, int bh, int x, int y, const char* s, uint16_t fg)
 {
-    int px = x;
-    for (const char* p = s; *p; p++) {
-        char c = *p;
-
-        if (c == '\n') {
-            y += UI_LINE_H;
-            px = x;
-            continue;
-        }
-
-        draw_char8x16_to_buf(buf, bw, bh, px, y, c, fg);
-        px += (UI_FONT_W + UI_CHAR_GAP);
-
-        if (px > bw - (UI_FONT_W + UI_CHAR_GAP)) {
-            y += UI_LINE_H;
-            px = x;
-        }
-    }
+    FontRaster_Text8x16(buf, bw, bh, x, y, s, fg, UI_FONT_W + UI_CHAR_GAP, UI_LINE_H);
 }
 
 // 5x7 font rendering (used for small label images)
@@ -202,34 +210,9 @@ static void draw_text8x16_to_buf(uint16_t* buf, int bw, int bh, int x, int y, co
 #define LABEL_H      (LABEL_FONT_H + (LABEL_PAD_Y * 2))
 #define LABEL_MAX_W  40
 
-static void draw_char5x7_to_buf(uint16_t* buf, int bw, int bh, int x, int y, char c, uint16_t fg)
-{
-    if (!buf) return;
-    const uint8_t* cols = Font5x7_Get(c);
-    if (!cols) return;
-
-    for (int cx = 0; cx < LABEL_FONT_W; cx++) {
-        uint8_t bits = cols[cx];
-        for (int cy = 0; cy < LABEL_FONT_H; cy++) {
-            if (bits & (1U << cy)) {
-                int px = x + cx;
-                int py = y + cy;
-                if (px >= 0 && px < bw && py >= 0 && py < bh) {
-                    buf[py * bw + px] = fg;
-                }
-            }
-        }
-    }
-}
-
 static void draw_text5x7_to_buf(uint16_t* buf, int bw, int bh, int x, int y, const char* s, uint16_t fg)
 {
-    int px = x;
-    for (const char* p = s; *p; p++) {
-        draw_char5x7_to_buf(buf, bw, bh, px, y, *p, fg);
-        px += (LABEL_FONT_W + LABEL_GAP);
-        if (px >= bw) break;
-    }
+    FontRaster_Text5x7(buf, bw, bh, x, y, s, fg, LABEL_FONT_W + LABEL_GAP);
 }
 
 static int Ui_LabelWidth(const char* text)
@@ -252,12 +235,9 @@ static void Ui_DrawLabelImage(int x, int y, const char* text, uint16_t fg, uint1
     St7735_BlitRect(x, y, w, LABEL_H, buf);
 }
 
-static void Ui_DrawHeader(const char* title)
+void Ui_DrawHeaderTitle(const char* title)
 {
-    St7735_FillRect(0, 0, St7735_Width(), UI_HEADER_H, UI_COLOR_BG);
-    St7735_FillRect(0, UI_HEADER_H - 2, St7735_Width(), 2, UI_COLOR_MUTED);
-
-    // Simple title text using a line buffer
+    // Title line only: the separator and the body cursor stay as they are
     Ui_LineBufInit(UI_LINE_H);
     uint16_t* buf = Ui_LineBufNext();
     int w = St7735_Width();
@@ -265,6 +245,13 @@ static void Ui_DrawHeader(const char* title)
     LineBufFill(buf, w, UI_LINE_H, UI_COLOR_BG);
     draw_text8x16_to_buf(buf, w, UI_LINE_H, UI_PAD_X, 2, title, UI_COLOR_ACCENT);
     St7735_BlitRect(0, 6, w, UI_LINE_H, buf);
+}
+
+static void Ui_DrawHeader(const char* title)
+{
+    St7735_FillRect(0, 0, St7735_Width(), UI_HEADER_H, UI_COLOR_BG);
+    St7735_FillRect(0, UI_HEADER_H - 2, St7735_Width(), 2, UI_COLOR_MUTED);
+    Ui_DrawHeaderTitle(title);
 
     s_cursor_y = UI_HEADER_H + UI_PAD_Y;
 }
@@ -328,21 +315,54 @@ static void Ui_ClearListAreaOnly(void)
 }
 
 
-void Ui_Init(void)
+#define UI_READY_BIT BIT0
+
+static EventGroupHandle_t s_ui_evt = 0;
+
+// Panel bring-up is mostly reset/sleep-out waits, so it runs in its own task
+// and overlaps with input/arena init. Ui_WaitReady() joins it.
+static void Ui_PanelInitTask(void* arg)
 {
-    if (!s_lcd_mutex) {
-        s_lcd_mutex = xSemaphoreCreateMutex();
-    }   
+    (void)arg;
+
     St7735_Init();
     ESP_LOGI(kUiTag, "Lamp color order = %d", (int)LAMP_COLOR_ORDER);
     Ui_LineBufInit(UI_LINE_H);
     St7735_Fill(UI_COLOR_BG);
     St7735_Flush();
+
+    BootTimeline_Mark("panel_ready");
+    xEventGroupSetBits(s_ui_evt, UI_READY_BIT);
+    vTaskDelete(NULL);
+}
+
+void Ui_Init(void)
+{
+    if (!s_lcd_mutex) {
+        s_lcd_mutex = xSemaphoreCreateMutex();
+    }   
+    if (!s_ui_evt) {
+        s_ui_evt = xEventGroupCreate();
+    }
+    xTaskCreate(Ui_PanelInitTask, "ui_panel_init", 4096, NULL, 5, NULL);
+}
+
+bool Ui_WaitReady(uint32_t timeout_ms)
+{
+    if (!s_ui_evt) return false;
+    TickType_t ticks = (timeout_ms == UINT32_MAX) ? portMAX_DELAY : pdMS_TO_TICKS(timeout_ms);
+    EventBits_t bits = xEventGroupWaitBits(s_ui_evt, UI_READY_BIT, pdFALSE, pdTRUE, ticks);
+    return (bits & UI_READY_BIT) != 0;
 }
 
 void Ui_Clear(void)
 {
     s_cursor_y = 0;
+    s_menu_on_screen = false;
+    s_mic.valid = false;
+    s_tuner.valid = false;
+    s_wf.active = false;
+    St7735_ScrollReset();
     St7735_Fill(UI_COLOR_BG);
     St7735_Flush();
 }
@@ -376,7 +396,6 @@ void Ui_Printf(const char* fmt, ...)
 // -----------------------------
 void Ui_DrawMainMenu(int index, int count)
 {
-    static bool s_inited = false;
     static int s_last_index = -1;
     static int s_last_start = -1;
     static int s_last_count = -1;
@@ -386,12 +405,12 @@ void Ui_DrawMainMenu(int index, int count)
     if (count < 0) count = 0;
 
     if (count == 0) {
-        if (!s_inited || s_last_count != 0) {
+        if (!s_menu_on_screen || s_last_count != 0) {
             Ui_Clear();
             Ui_DrawHeader("STEM");
             Ui_DrawFooter("ENTER=OK   BACK=RET");
             St7735_Flush();
-            s_inited = true;
+            s_menu_on_screen = true;
             s_last_count = 0;
             s_last_index = 0;
             s_last_start = 0;
@@ -407,7 +426,7 @@ void Ui_DrawMainMenu(int index, int count)
     int start = Ui_ComputeWindowStart(index, count, rows);
 
     // Full rebuild
-    if (!s_inited || s_last_count != count) {
+    if (!s_menu_on_screen || s_last_count != count) {
         Ui_Clear();
         Ui_DrawHeader("STEM");
         Ui_ClearListAreaOnly();
@@ -429,7 +448,7 @@ void Ui_DrawMainMenu(int index, int count)
         Ui_DrawFooter("ENTER=OK   BACK=RET");
         St7735_Flush();
 
-        s_inited = true;
+        s_menu_on_screen = true;
         s_last_count = count;
         s_last_index = index;
         s_last_start = start;
@@ -753,77 +772,6 @@ static void Ui_DrawListRow(int y, const char* text, bool selected)
     Ui_DrawListRowInRect(r, y, text, selected);
 }
 
-// Copies next wrapped line into out (null-terminated).
-// Returns pointer to the next position in text after this line.
-static const char* Ui_WrapNextLine(const char* p, int cols, char* out, int out_cap)
-{
-    if (!p) p = "";
-    if (cols < 1) cols = 1;
-    if (out_cap < 2) { if (out_cap == 1) out[0] = 0; return p; }
-
-    // Skip leading spaces/tabs (but not newlines)
-    while (*p == ' ' || *p == '\t') p++;
-
-    // If immediate newline, produce empty line and consume it
-    if (*p == '\n') {
-        out[0] = 0;
-        return p + 1;
-    }
-
-    int maxc = cols;
-    if (maxc > out_cap - 1) maxc = out_cap - 1;
-
-    int n = 0;
-    int last_space_out = -1;   // index in out
-    const char* last_space_p = NULL;
-
-    while (*p && *p != '\n' && n < maxc) {
-        char ch = *p;
-        out[n++] = ch;
-
-        if (ch == ' ' || ch == '\t') {
-            last_space_out = n - 1;
-            last_space_p = p;
-        }
-        p++;
-    }
-
-    // If we stopped because of newline, just consume it
-    if (*p == '\n') {
-        out[n] = 0;
-        return p + 1;
-    }
-
-    // If we filled maxc and there is still text on the same logical line,
-    // try to break at last space to avoid cutting a word.
-    if (n == maxc && *p && *p != '\n' && last_space_out >= 0) {
-        // Trim trailing spaces in out
-        int cut = last_space_out;
-        while (cut > 0 && (out[cut] == ' ' || out[cut] == '\t')) cut--;
-        out[cut + 1] = 0;
-
-        // Continue after the space
-        p = last_space_p + 1;
-        while (*p == ' ' || *p == '\t') p++;
-        return p;
-    }
-
-    // Otherwise hard cut
-    out[n] = 0;
-    return p;
-}
-
-static const char* Ui_SkipWrappedLinesEx(const char* text, int cols, int skip_lines)
-{
-    const char* p = text ? text : "";
-    char tmp[64];
-
-    for (int i = 0; i < skip_lines && *p; i++) {
-        p = Ui_WrapNextLine(p, cols, tmp, (int)sizeof(tmp));
-    }
-    return p;
-}
-
 static void Ui_DrawWrappedTextInRect(const char* text, int scroll_line, UiRect body)
 {
     if (!text) text = "";
@@ -840,11 +788,11 @@ static void Ui_DrawWrappedTextInRect(const char* text, int scroll_line, UiRect b
 
     int y = body.y + UI_PAD_Y;
 
-    const char* p = Ui_SkipWrappedLinesEx(text, cols, scroll_line);
+    const char* p = UiWrap_SkipLines(text, cols, scroll_line);
 
     for (int r = 0; r < rows; r++) {
         char line[64];
-        p = Ui_WrapNextLine(p, cols, line, (int)sizeof(line));
+        p = UiWrap_NextLine(p, cols, line, (int)sizeof(line));
 
         Ui_DrawListRowInRect(body, y, line, false);
         y += UI_LINE_H;
@@ -1106,21 +1054,28 @@ void Ui_DrawMicBody(const int* bands, int band_count, int freq_hz, int vol_pct)
     int body_y = UI_HEADER_H;
     int body_h = St7735_Height() - UI_HEADER_H - UI_FOOTER_H;
 
-    int text_y = body_y + UI_PAD_Y;
-    // Clear only the text line area
-    St7735_FillRect(0, text_y, w, UI_LINE_H, UI_COLOR_BG);
+    int count = band_count;
+    if (count < 1) count = 1;
+    if (count > UI_MIC_MAX_BARS) count = UI_MIC_MAX_BARS;
 
-    Ui_LineBufInit(UI_LINE_H);
-    uint16_t* buf = Ui_LineBufNext();
-    LineBufFill(buf, w, UI_LINE_H, UI_COLOR_BG);
+    // Any full-page redraw (Ui_Clear) or a new band count repaints it all
+    bool full = !s_mic.valid || s_mic.count != count;
+
+    int text_y = body_y + UI_PAD_Y;
 
     if (vol_pct < 0) vol_pct = 0;
     if (vol_pct > 100) vol_pct = 100;
 
-    char line[64];
+    char line[40];
     snprintf(line, sizeof(line), "FREQ %4d Hz   VOL %3d%%", freq_hz, vol_pct);
-    draw_text8x16_to_buf(buf, w, UI_LINE_H, UI_PAD_X, 2, line, UI_COLOR_TEXT);
-    St7735_BlitRect(0, text_y, w, UI_LINE_H, buf);
+    if (full || strcmp(line, s_mic.text) != 0) {
+        Ui_LineBufInit(UI_LINE_H);
+        uint16_t* buf = Ui_LineBufNext();
+        LineBufFill(buf, w, UI_LINE_H, UI_COLOR_BG);
+        draw_text8x16_to_buf(buf, w, UI_LINE_H, UI_PAD_X, 2, line, UI_COLOR_TEXT);
+        St7735_BlitRect(0, text_y, w, UI_LINE_H, buf);
+        strcpy(s_mic.text, line);
+    }
 
     int bar_h = 8;
     int bar_y = body_y + body_h - UI_PAD_Y - bar_h;
@@ -1132,16 +1087,15 @@ void Ui_DrawMicBody(const int* bands, int band_count, int freq_hz, int vol_pct)
     }
 
     int spec_h = spec_y1 - spec_y0;
-    int count = band_count;
-    if (count < 1) count = 1;
-    if (count > 16) count = 16;
 
-    int gap = 2;
+    int gap = count > 16 ? 1 : 2;
     int total_gap = (count - 1) * gap;
     int bar_w = (w - (UI_PAD_X * 2) - total_gap) / count;
     if (bar_w < 3) bar_w = 3;
     int start_x = UI_PAD_X;
 
+    if (full) St7735_FillRect(0, spec_y0, w, spec_h, UI_COLOR_BG);
+
     for (int i = 0; i < count; i++) {
         int level = 0;
         if (bands && i < band_count) level = bands[i];
@@ -1150,33 +1104,255 @@ void Ui_DrawMicBody(const int* bands, int band_count, int freq_hz, int vol_pct)
 
         int x = start_x + i * (bar_w + gap);
         int fill_h = (spec_h * level) / 100;
-        int y = spec_y1 - fill_h;
-
-        St7735_FillRect(x, spec_y0, bar_w, spec_h, UI_COLOR_MUTED);
-        if (fill_h > 0) {
-            St7735_FillRect(x, y, bar_w, fill_h, UI_COLOR_ACCENT);
+        int old_h = full ? -1 : s_mic.fill_h[i];
+
+        if (old_h < 0) {
+            St7735_FillRect(x, spec_y0, bar_w, spec_h - fill_h, UI_COLOR_MUTED);
+            if (fill_h > 0) St7735_FillRect(x, spec_y1 - fill_h, bar_w, fill_h, UI_COLOR_ACCENT);
+        } else if (fill_h > old_h) {
+            St7735_FillRect(x, spec_y1 - fill_h, bar_w, fill_h - old_h, UI_COLOR_ACCENT);
+        } else if (fill_h < old_h) {
+            St7735_FillRect(x, spec_y1 - old_h, bar_w, old_h - fill_h, UI_COLOR_MUTED);
         }
+        s_mic.fill_h[i] = fill_h;
     }
 
     int vol_bar_w = w - (UI_PAD_X * 2) - 40;
     if (vol_bar_w < 20) vol_bar_w = 20;
     int vol_bar_x = UI_PAD_X + 40;
+    int fill_w = (vol_bar_w * vol_pct) / 100;
+
+    if (full) {
+        Ui_LineBufInit(UI_LINE_H);
+        uint16_t* buf = Ui_LineBufNext();
+        LineBufFill(buf, w, UI_LINE_H, UI_COLOR_BG);
+        draw_text8x16_to_buf(buf, w, UI_LINE_H, UI_PAD_X, 2, "VOL", UI_COLOR_MUTED);
+        St7735_BlitRect(0, bar_y - 6, w, UI_LINE_H, buf);
+
+        St7735_FillRect(vol_bar_x, bar_y, vol_bar_w, bar_h, UI_COLOR_MUTED);
+        if (fill_w > 0) St7735_FillRect(vol_bar_x, bar_y, fill_w, bar_h, UI_COLOR_ACCENT);
+    } else if (fill_w > s_mic.vol_fill_w) {
+        St7735_FillRect(vol_bar_x + s_mic.vol_fill_w, bar_y, fill_w - s_mic.vol_fill_w, bar_h, UI_COLOR_ACCENT);
+    } else if (fill_w < s_mic.vol_fill_w) {
+        St7735_FillRect(vol_bar_x + fill_w, bar_y, s_mic.vol_fill_w - fill_w, bar_h, UI_COLOR_MUTED);
+    }
+    s_mic.vol_fill_w = fill_w;
+
+    s_mic.count = count;
+    s_mic.valid = true;
+}
+
+// Black -> blue -> magenta -> red -> yellow -> white as seen on the glass,
+// interpolated once. The first and last 5-bit fields trade places on this
+// panel (BGR MADCTL plus the driver's RB swap), as in the UI_COLOR_* values.
+static void Ui_BuildHeatLut(void)
+{
+    static const uint8_t k_stops[][3] = {
+        {   0,   0,   0 }, {  20,  10,  90 }, { 120,  20, 140 }, { 220,  50,  60 },
+        { 250, 150,  20 }, { 255, 230,  80 }, { 255, 255, 255 },
+    };
+    const int segs = (int)(sizeof(k_stops) / sizeof(k_stops[0])) - 1;
+
+    for (int i = 0; i < 256; i++) {
+        int pos = i * segs;             // segment index * 256 + fraction
+        int s = pos / 256;
+        int f = pos % 256;
+        if (s >= segs) {
+            s = segs - 1;
+            f = 256;
+        }
+        uint8_t rgb[3];
+        for (int c = 0; c < 3; c++) {
+            rgb[c] = (uint8_t)((k_stops[s][c] * (256 - f) + k_stops[s + 1][c] * f) / 256);
+        }
+        s_heat_lut[i] = RGB565(rgb[2], rgb[1], rgb[0]);
+    }
+    s_heat_lut_ready = true;
+}
+
+void Ui_BeginMicWaterfall(int max_hz)
+{
+    int w = St7735_Width();
+    int axis_y = UI_HEADER_H;
+
+    if (!s_heat_lut_ready) Ui_BuildHeatLut();
 
-    // Redraw volume label and bar without clearing the whole area
+    // Axis row: labels at 0, 1/4 .. 4/4 of max_hz
     Ui_LineBufInit(UI_LINE_H);
-    buf = Ui_LineBufNext();
+    uint16_t* buf = Ui_LineBufNext();
     LineBufFill(buf, w, UI_LINE_H, UI_COLOR_BG);
-    draw_text8x16_to_buf(buf, w, UI_LINE_H, UI_PAD_X, 2, "VOL", UI_COLOR_MUTED);
-    St7735_BlitRect(0, bar_y - 6, w, UI_LINE_H, buf);
+    for (int q = 0; q <= 4; q++) {
+        char label[12];
+        int hz = max_hz * q / 4;
+        if (hz >= 1000) snprintf(label, sizeof(label), "%dk", (hz + 500) / 1000);
+        else snprintf(label, sizeof(label), "%d", hz);
+        int lw = (int)strlen(label) * (UI_FONT_W + UI_CHAR_GAP);
+        int x = (w - 1) * q / 4 - lw / 2;
+        if (x < 0) x = 0;
+        if (x + lw > w) x = w - lw;
+        draw_text8x16_to_buf(buf, w, UI_LINE_H, x, 1, label, UI_COLOR_MUTED);
+    }
+    St7735_BlitRect(0, axis_y, w, UI_LINE_H, buf);
+
+    s_wf.top = axis_y + UI_LINE_H;
+    s_wf.rows = St7735_Height() - s_wf.top - UI_FOOTER_H;
+    s_wf.row = s_wf.top;
+    St7735_FillRect(0, s_wf.top, w, s_wf.rows, s_heat_lut[0]);
+    St7735_SetScrollArea(s_wf.top, UI_FOOTER_H);
+    St7735_ScrollTo(s_wf.row);
+    s_wf.active = true;
+}
 
-    St7735_FillRect(vol_bar_x, bar_y, vol_bar_w, bar_h, UI_COLOR_MUTED);
-    int fill_w = (vol_bar_w * vol_pct) / 100;
-    if (fill_w > 0) {
-        St7735_FillRect(vol_bar_x, bar_y, fill_w, bar_h, UI_COLOR_ACCENT);
+// One line: palette lookup per column, one row of pixels, one scroll command
+void Ui_DrawMicWaterfallLine(const uint8_t* levels, int count)
+{
+    if (!s_wf.active || !levels || count <= 0) return;
+
+    int w = St7735_Width();
+    Ui_LineBufInit(UI_LINE_H);
+    uint16_t* buf = Ui_LineBufNext();
+    // More levels than columns: keep the loudest of each group
+    for (int x = 0; x < w; x++) {
+        int i0 = x * count / w;
+        int i1 = (x + 1) * count / w;
+        uint8_t v = levels[i0];
+        for (int i = i0 + 1; i < i1; i++) {
+            if (levels[i] > v) v = levels[i];
+        }
+        buf[x] = s_heat_lut[v];
     }
+
+    s_wf.row = s_wf.row == s_wf.top ? s_wf.top + s_wf.rows - 1 : s_wf.row - 1;
+    St7735_BlitRect(0, s_wf.row, w, 1, buf);
+    St7735_ScrollTo(s_wf.row);
 }
 
-void Ui_DrawSpeakerBody(bool playing, int vol_pct)
+void Ui_EndMicWaterfall(void)
+{
+    if (!s_wf.active) return;
+    s_wf.active = false;
+    St7735_ScrollReset();
+}
+
+#define UI_TUNER_SCALE    4
+#define UI_TUNER_NEEDLE_W 6
+#define UI_TUNER_METER_H  28
+
+// 8x16 text magnified `scale` times, centred, across full-width strips so
+// the previous text is erased in the same pass
+static void Ui_DrawTextScaledCentered(int y, const char* s, int scale, uint16_t fg)
+{
+    enum { MAX_CHARS = 6, SRC_W = MAX_CHARS * (UI_FONT_W + UI_CHAR_GAP) };
+    uint16_t src[UI_FONT_H * SRC_W];
+    int w = St7735_Width();
+
+    int chars = (int)strlen(s);
+    if (chars > MAX_CHARS) chars = MAX_CHARS;
+    int src_w = chars * (UI_FONT_W + UI_CHAR_GAP);
+    int x0 = (w - src_w * scale) / 2;
+    if (x0 < 0) x0 = 0;
+
+    char text[MAX_CHARS + 1];
+    memcpy(text, s, (size_t)chars);
+    text[chars] = '\0';
+    LineBufFill(src, SRC_W, UI_FONT_H, UI_COLOR_BG);
+    FontRaster_Text8x16(src, SRC_W, UI_FONT_H, 0, 0, text, fg, UI_FONT_W + UI_CHAR_GAP, UI_FONT_H);
+
+    Ui_LineBufInit(UI_LINE_H);
+    for (int sy = 0; sy < UI_FONT_H; sy++) {
+        uint16_t* buf = Ui_LineBufNext();
+        LineBufFill(buf, w, scale, UI_COLOR_BG);
+        for (int sx = 0; sx < src_w; sx++) {
+            uint16_t c = src[sy * SRC_W + sx];
+            if (c == UI_COLOR_BG) continue;
+            LineBufFillRect(buf, w, scale, x0 + sx * scale, 0, scale, scale, c);
+        }
+        St7735_BlitRect(0, y + sy * scale, w, scale, buf);
+    }
+}
+
+void Ui_DrawTunerBody(const char* note, int cents, uint32_t freq_centihz, int clarity_pct)
+{
+    int w = St7735_Width();
+    int body_y = UI_HEADER_H;
+    bool voiced = note && freq_centihz > 0;
+    bool full = !s_tuner.valid;
+
+    if (cents < -50) cents = -50;
+    if (cents > 50) cents = 50;
+
+    int note_y = body_y + UI_PAD_Y + 4;
+    int text_y = note_y + UI_FONT_H * UI_TUNER_SCALE + 8;
+    int meter_y = text_y + UI_LINE_H + 8;
+    int label_y = meter_y + UI_TUNER_METER_H + 2;
+    int meter_x = UI_PAD_X;
+    int meter_w = w - UI_PAD_X * 2;
+
+    if (full) St7735_FillRect(0, body_y, w, St7735_Height() - UI_HEADER_H - UI_FOOTER_H, UI_COLOR_BG);
+
+    int abs_cents = cents < 0 ? -cents : cents;
+    uint16_t in_tune = RGB565(40, 220, 90);
+    uint16_t note_fg = !voiced ? UI_COLOR_MUTED : abs_cents <= 5 ? in_tune : UI_COLOR_TEXT;
+
+    const char* shown = voiced ? note : "--";
+    if (full || strcmp(shown, s_tuner.note) != 0) {
+        Ui_DrawTextScaledCentered(note_y, shown, UI_TUNER_SCALE, note_fg);
+        snprintf(s_tuner.note, sizeof(s_tuner.note), "%s", shown);
+    }
+
+    char line[40];
+    if (voiced) {
+        snprintf(line, sizeof(line), "%4lu.%02lu Hz  %+3dc  %3d%%", (unsigned long)(freq_centihz / 100),
+                 (unsigned long)(freq_centihz % 100), cents, clarity_pct);
+    } else {
+        snprintf(line, sizeof(line), "   --- Hz");
+    }
+    if (full || strcmp(line, s_tuner.text) != 0) {
+        Ui_LineBufInit(UI_LINE_H);
+        uint16_t* buf = Ui_LineBufNext();
+        LineBufFill(buf, w, UI_LINE_H, UI_COLOR_BG);
+        draw_text8x16_to_buf(buf, w, UI_LINE_H, UI_PAD_X, 2, line, voiced ? UI_COLOR_TEXT : UI_COLOR_MUTED);
+        St7735_BlitRect(0, text_y, w, UI_LINE_H, buf);
+        strcpy(s_tuner.text, line);
+    }
+
+    int centre_x = meter_x + meter_w / 2;
+    if (full) {
+        St7735_FillRect(meter_x, meter_y, meter_w, UI_TUNER_METER_H, UI_COLOR_MUTED);
+        St7735_FillRect(centre_x - 1, meter_y, 2, UI_TUNER_METER_H, UI_COLOR_TEXT);
+
+        Ui_LineBufInit(UI_LINE_H);
+        uint16_t* buf = Ui_LineBufNext();
+        LineBufFill(buf, w, UI_LINE_H, UI_COLOR_BG);
+        draw_text8x16_to_buf(buf, w, UI_LINE_H, meter_x, 2, "-50", UI_COLOR_MUTED);
+        draw_text8x16_to_buf(buf, w, UI_LINE_H, centre_x - 4, 2, "0", UI_COLOR_MUTED);
+        draw_text8x16_to_buf(buf, w, UI_LINE_H, meter_x + meter_w - 3 * (UI_FONT_W + UI_CHAR_GAP), 2, "+50",
+                             UI_COLOR_MUTED);
+        St7735_BlitRect(0, label_y, w, UI_LINE_H, buf);
+        s_tuner.needle_x = -1;
+    }
+
+    // Needle: restore the track under the old one, then draw the new one
+    int travel = meter_w - UI_TUNER_NEEDLE_W;
+    int needle_x = voiced ? meter_x + (cents + 50) * travel / 100 : -1;
+    uint16_t needle_fg = abs_cents <= 5 ? in_tune : UI_COLOR_ACCENT;
+    if (needle_x != s_tuner.needle_x || needle_fg != s_tuner.needle_color) {
+        int old = s_tuner.needle_x;
+        if (old >= 0) {
+            St7735_FillRect(old, meter_y, UI_TUNER_NEEDLE_W, UI_TUNER_METER_H, UI_COLOR_MUTED);
+            if (centre_x + 1 > old && centre_x - 1 < old + UI_TUNER_NEEDLE_W) {
+                St7735_FillRect(centre_x - 1, meter_y, 2, UI_TUNER_METER_H, UI_COLOR_TEXT);
+            }
+        }
+        if (needle_x >= 0) St7735_FillRect(needle_x, meter_y, UI_TUNER_NEEDLE_W, UI_TUNER_METER_H, needle_fg);
+        s_tuner.needle_x = needle_x;
+        s_tuner.needle_color = needle_fg;
+    }
+
+    s_tuner.valid = true;
+}
+
+void Ui_DrawSpeakerBody(bool playing, int vol_pct, const char* eq)
 {
     int w = St7735_Width();
     int body_y = UI_HEADER_H;
@@ -1221,6 +1397,49 @@ void Ui_DrawSpeakerBody(bool playing, int vol_pct)
     LineBufFill(buf, w, UI_LINE_H, UI_COLOR_BG);
     draw_text8x16_to_buf(buf, w, UI_LINE_H, UI_PAD_X, 2, "Hola soy espanol.", UI_COLOR_TEXT);
     St7735_BlitRect(0, y, w, UI_LINE_H, buf);
+
+    y += UI_LINE_H + 6;
+    Ui_LineBufInit(UI_LINE_H);
+    buf = Ui_LineBufNext();
+    LineBufFill(buf, w, UI_LINE_H, UI_COLOR_BG);
+    snprintf(line, sizeof(line), "EQ     : %s", eq);
+    draw_text8x16_to_buf(buf, w, UI_LINE_H, UI_PAD_X, 2, line, UI_COLOR_TEXT);
+    St7735_BlitRect(0, y, w, UI_LINE_H, buf);
+}
+
+void Ui_DrawMonitorBody(int selected, int block_samples, int block_us, int dma_desc, int gain_db,
+                        const char* fx, bool pinging)
+{
+    int w = St7735_Width();
+    int body_y = UI_HEADER_H;
+    int body_h = St7735_Height() - UI_HEADER_H - UI_FOOTER_H;
+
+    // Rows only: the live figures below stay put
+    UiRect body = { .x = 0, .y = body_y, .w = w, .h = body_h };
+
+    int y = UI_HEADER_H + UI_PAD_Y;
+    char line[48];
+
+    snprintf(line, sizeof(line), "BLOCK %3d  %d.%d ms", block_samples, block_us / 1000, (block_us % 1000) / 100);
+    Ui_DrawListRowInRect(body, y, line, selected == 0);
+    y += UI_LINE_H;
+
+    snprintf(line, sizeof(line), "DMA   %3d  x block", dma_desc);
+    Ui_DrawListRowInRect(body, y, line, selected == 1);
+    y += UI_LINE_H;
+
+    snprintf(line, sizeof(line), "GAIN  %+3d  dB", gain_db);
+    Ui_DrawListRowInRect(body, y, line, selected == 2);
+    y += UI_LINE_H;
+
+    snprintf(line, sizeof(line), "FX    %s", fx ? fx : "");
+    Ui_DrawListRowInRect(body, y, line, selected == 3);
+    y += UI_LINE_H;
+
+    snprintf(line, sizeof(line), "PING  %s", pinging ? "..." : "OK:CLICK");
+    Ui_DrawListRowInRect(body, y, line, selected == 4);
+
+    St7735_Flush();
 }
 
 void Ui_DrawColorTestBody(int selected, bool sw_invert, bool sw_rb_swap, bool hw_invert)
@@ -0,0 +1,72 @@
+#include "ui/ui_wrap.h"
+
+#include <stddef.h>
+
+const char* UiWrap_NextLine(const char* p, int cols, char* out, int out_cap)
+{
+    if (!p) p = "";
+    if (cols < 1) cols = 1;
+    if (out_cap < 2) { if (out_cap == 1) out[0] = 0; return p; }
+
+    // Skip leading spaces/tabs (but not newlines)
+    while (*p == ' ' || *p == '\t') p++;
+
+    // If immediate newline, produce empty line and consume it
+    if (*p == '\n') {
+        out[0] = 0;
+        return p + 1;
+    }
+
+    int maxc = cols;
+    if (maxc > out_cap - 1) maxc = out_cap - 1;
+
+    int n = 0;
+    int last_space_out = -1;   // index in out
+    const char* last_space_p = NULL;
+
+    while (*p && *p != '\n' && n < maxc) {
+        char ch = *p;
+        out[n++] = ch;
+
+        if (ch == ' ' || ch == '\t') {
+            last_space_out = n - 1;
+            last_space_p = p;
+        }
+        p++;
+    }
+
+    // If we stopped because of newline, just consume it
+    if (*p == '\n') {
+        out[n] = 0;
+        return p + 1;
+    }
+
+    // If we filled maxc and there is still text on the same logical line,
+    // try to break at last space to avoid cutting a word.
+    if (n == maxc && *p && *p != '\n' && last_space_out >= 0) {
+        // Trim trailing spaces in out
+        int cut = last_space_out;
+        while (cut > 0 && (out[cut] == ' ' || out[cut] == '\t')) cut--;
+        out[cut + 1] = 0;
+
+        // Continue after the space
+        p = last_space_p + 1;
+        while (*p == ' ' || *p == '\t') p++;
+        return p;
+    }
+
+    // Otherwise hard cut
+    out[n] = 0;
+    return p;
+}
+
+const char* UiWrap_SkipLines(const char* text, int cols, int skip_lines)
+{
+    const char* p = text ? text : "";
+    char tmp[64];
+
+    for (int i = 0; i < skip_lines && *p; i++) {
+        p = UiWrap_NextLine(p, cols, tmp, (int)sizeof(tmp));
+    }
+    return p;
+}
@@ -0,0 +1,11 @@
+#pragma once
+
+// Word wrap shared by the LCD text pages and UiConsole. Pure C.
+
+// Copies the next wrapped line of p into out (null-terminated): breaks at the
+// last space that fits, hard-cuts words longer than cols, honours '\n'.
+// Returns the position after this line.
+const char* UiWrap_NextLine(const char* p, int cols, char* out, int out_cap);
+
+// Position after skip_lines wrapped lines
+const char* UiWrap_SkipLines(const char* text, int cols, int skip_lines);
@@ -0,0 +1,122 @@
+#!/usr/bin/env python3
+"""Pack a raw 16-bit mono PCM clip into a compressed audio asset.
+
+The output is the format of main/dsp/audio_asset.h: a 16-byte "SND1"
+header, then IMA-ADPCM blocks (dsp/ima_adpcm.h, bit exact with
+ImaAdpcm_EncodeBlock), G.711 mu-law bytes, or the PCM unchanged.
+
+    python3 tools/audio_pack.py main/core/hola_es.pcm hola_es.ima --rate 16000
+    python3 tools/audio_pack.py clip.pcm clip.ulaw --format ulaw --rate 8000
+
+main/CMakeLists.txt runs it at build time for every embedded clip and
+prints the size it saved.
+"""
+
+import argparse
+import struct
+import sys
+
+FORMATS = {"pcm": 0, "ima": 1, "ulaw": 2}
+
+BLOCK_BYTES = 256
+BLOCK_SAMPLES = 1 + (BLOCK_BYTES - 4) * 2
+
+STEP = [
+    7, 8, 9, 10, 11, 12, 13, 14, 16, 17, 19, 21, 23, 25, 28, 31, 34, 37, 41, 45,
+    50, 55, 60, 66, 73, 80, 88, 97, 107, 118, 130, 143, 157, 173, 190, 209, 230,
+    253, 279, 307, 337, 371, 408, 449, 494, 544, 598, 658, 724, 796, 876, 963,
+    1060, 1166, 1282, 1411, 1552, 1707, 1878, 2066, 2272, 2499, 2749, 3024, 3327,
+    3660, 4026, 4428, 4871, 5358, 5894, 6484, 7132, 7845, 8630, 9493, 10442,
+    11487, 12635, 13899, 15289, 16818, 18500, 20350, 22385, 24623, 27086, 29794,
+    32767,
+]
+INDEX_ADJ = [-1, -1, -1, -1, 2, 4, 6, 8]
+
+
+def clamp(v, lo, hi):
+    return lo if v < lo else hi if v > hi else v
+
+
+def ima_encode(samples):
+    """Same arithmetic as encode_one() in dsp/ima_adpcm.c."""
+    out = bytearray()
+    index = 0
+    for start in range(0, len(samples), BLOCK_SAMPLES):
+        block = samples[start:start + BLOCK_SAMPLES]
+        block += [0] * (BLOCK_SAMPLES - len(block))
+        pred = block[0]
+        out += struct.pack("<hBB", pred, index, 0)
+        nibbles = []
+        for s in block[1:]:
+            step = STEP[index]
+            diff = s - pred
+            nib = 0
+            if diff < 0:
+                nib = 8
+                diff = -diff
+            vpdiff = step >> 3
+            for bit in (4, 2, 1):
+                if diff >= step:
+                    nib |= bit
+                    diff -= step
+                    vpdiff += step
+                step >>= 1
+            pred = clamp(pred - vpdiff if nib & 8 else pred + vpdiff, -32768, 32767)
+            index = clamp(index + INDEX_ADJ[nib & 7], 0, 88)
+            nibbles.append(nib)
+        for i in range(0, len(nibbles), 2):
+            out.append(nibbles[i] | (nibbles[i + 1] << 4))
+    return bytes(out)
+
+
+def ulaw_encode(samples):
+    """G.711, as AudioAsset_UlawEncode()."""
+    out = bytearray()
+    for s in samples:
+        sign = 0
+        if s < 0:
+            s = -s
+            sign = 0x80
+        s = min(s, 32635) + 0x84
+        seg = 7
+        while seg > 0 and not (s & (0x80 << seg)):
+            seg -= 1
+        mant = (s >> (seg + 3)) & 0x0F
+        out.append(~(sign | (seg << 4) | mant) & 0xFF)
+    return bytes(out)
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    ap.add_argument("input", help="raw little-endian int16 mono PCM")
+    ap.add_argument("output")
+    ap.add_argument("--rate", type=int, required=True, help="sample rate of the input")
+    ap.add_argument("--format", choices=sorted(FORMATS), default="ima")
+    args = ap.parse_args()
+
+    with open(args.input, "rb") as f:
+        raw = f.read()
+    if len(raw) % 2:
+        raw = raw[:-1]
+    samples = list(struct.unpack("<%dh" % (len(raw) // 2), raw))
+
+    if args.format == "ima":
+        payload = ima_encode(samples)
+    elif args.format == "ulaw":
+        payload = ulaw_encode(samples)
+    else:
+        payload = raw
+
+    header = b"SND1" + struct.pack("<B3xII", FORMATS[args.format], args.rate, len(samples))
+    with open(args.output, "wb") as f:
+        f.write(header + payload)
+
+    total = len(header) + len(payload)
+    print("audio_pack: %s %d -> %d bytes (%s, %.1f%%, saves %d)" % (
+        args.input.rsplit("/", 1)[-1], len(raw), total, args.format, 100.0 * total / max(len(raw), 1),
+        len(raw) - total))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
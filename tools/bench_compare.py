@@ -0,0 +1,93 @@
+#!/usr/bin/env python3
+"""Compare two runs of the BENCH experiment.
+
+Each run prints one line on the serial console, e.g.
+
+    BENCH v1 build=Og-160mhz fill=30.758,4.99,12 text_row=1.930,4.97,40 ...
+
+with name=ms_per_op,MB/s,cpu%. Pass two logs (or files holding just the
+line); the last BENCH line of each is used:
+
+    python3 tools/bench_compare.py before.log after.log
+
+For the default vs perf profile A/B, capture one log from each build:
+
+    idf.py flash monitor | tee base.log        (BENCH page, OK)
+    ./build_perf.sh flash monitor | tee perf.log
+    python3 tools/bench_compare.py base.log perf.log
+
+The app simulator prints the same line, so host runs can be compared too.
+"""
+
+import argparse
+import sys
+
+
+def parse(path):
+    line = None
+    with open(path, errors="replace") as f:
+        for raw in f:
+            pos = raw.find("BENCH v")
+            if pos >= 0:
+                line = raw[pos:].strip()
+    if line is None:
+        sys.exit("%s: no BENCH line" % path)
+
+    fields = line.split()
+    version = fields[1]
+    build = "?"
+    rows = {}
+    order = []
+    for item in fields[2:]:
+        name, _, vals = item.partition("=")
+        if name == "build":
+            build = vals
+            continue
+        try:
+            ms, mbs, cpu = (float(v) for v in vals.split(","))
+        except ValueError:
+            sys.exit("%s: bad field %r" % (path, item))
+        rows[name] = (ms, mbs, cpu)
+        order.append(name)
+    return version, build, order, rows
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    ap.add_argument("base")
+    ap.add_argument("new")
+    ap.add_argument("--threshold", type=float, default=3.0,
+                    help="mark ms/op changes larger than this percentage (default 3)")
+    args = ap.parse_args()
+
+    v0, build0, order, a = parse(args.base)
+    v1, build1, _, b = parse(args.new)
+    if v0 != v1:
+        sys.exit("script versions differ (%s vs %s), results are not comparable" % (v0, v1))
+
+    print("base: %s  (%s)" % (build0, args.base))
+    print("new:  %s  (%s)" % (build1, args.new))
+    print()
+    print("%-12s %10s %10s %8s %7s   %6s %6s   %4s %4s" %
+          ("workload", "ms/op", "new", "delta", "speedup", "MB/s", "new", "cpu", "new"))
+    worse = 0
+    for name in order:
+        if name not in b:
+            print("%-12s missing in %s" % (name, args.new))
+            continue
+        (ms0, mb0, cpu0), (ms1, mb1, cpu1) = a[name], b[name]
+        delta = (ms1 - ms0) * 100.0 / ms0 if ms0 else 0.0
+        speedup = ms0 / ms1 if ms1 else 0.0
+        mark = ""
+        if delta > args.threshold:
+            mark = "  slower"
+            worse += 1
+        elif delta < -args.threshold:
+            mark = "  faster"
+        print("%-12s %10.3f %10.3f %+7.1f%% %6.2fx   %6.2f %6.2f   %4d %4d%s" %
+              (name, ms0, ms1, delta, speedup, mb0, mb1, cpu0, cpu1, mark))
+    return 1 if worse else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,156 @@
+#!/usr/bin/env python3
+"""Convert an EvTrace console dump into Chrome / Perfetto trace JSON.
+
+Build with CONFIG_EVTRACE_ENABLE (menuconfig, "Event trace"), then capture
+the serial output while pressing UP on the MEM page, e.g.
+
+    idf.py monitor | tee trace.log
+    python3 tools/evtrace_to_json.py trace.log -o trace.json
+
+then open trace.json in https://ui.perfetto.dev or chrome://tracing.
+Lines that are not part of the dump (normal log output) are ignored.
+If the log holds several dumps, the last one is used unless --all is given.
+"""
+
+import argparse
+import json
+import sys
+
+TYPE_BEGIN, TYPE_END, TYPE_INSTANT, TYPE_COUNTER, TYPE_META = range(5)
+
+
+class Dump:
+    def __init__(self, cpu_hz):
+        self.cpu_hz = cpu_hz
+        self.names = {}
+        self.tasks = {}
+        self.events = []    # (ccount, task, id, type, core, value)
+
+
+def parse(lines):
+    dumps = []
+    cur = None
+    for raw in lines:
+        line = raw.strip()
+        if line.startswith("#EVTRACE"):
+            fields = dict(f.split("=", 1) for f in line.split()[2:] if "=" in f)
+            cur = Dump(int(fields.get("cpu_hz", "160000000")))
+        elif cur is None:
+            continue
+        elif line.startswith("#ID "):
+            _, num, name = line.split(None, 2)
+            cur.names[int(num)] = name
+        elif line.startswith("#TASK "):
+            _, handle, name = line.split(None, 2)
+            cur.tasks[int(handle, 16)] = name
+        elif line.startswith("E "):
+            parts = line.split()
+            if len(parts) != 7:
+                continue
+            try:
+                cc, task, eid, etype, core, value = (int(p, 16) for p in parts[1:])
+            except ValueError:
+                continue
+            cur.events.append((cc, task, eid, etype, core, value))
+        elif line.startswith("#END"):
+            dumps.append(cur)
+            cur = None
+    return dumps
+
+
+def unwrap32(values):
+    """Turn a sequence of wrapping 32-bit counters into monotonic integers."""
+    out = []
+    base = 0
+    prev = None
+    for v in values:
+        if prev is not None and v < prev:
+            base += 1 << 32
+        out.append(base + v)
+        prev = v
+    return out
+
+
+def to_chrome(dump, pid):
+    sync_id = next((k for k, v in dump.names.items() if v == "sync"), 0)
+    cycles_per_us = dump.cpu_hz / 1e6
+
+    by_core = {}
+    for ev in dump.events:
+        by_core.setdefault(ev[4], []).append(ev)
+
+    out = []
+    for core, evs in sorted(by_core.items()):
+        cycles = unwrap32([e[0] for e in evs])
+
+        # (cycles, us) anchors from sync events; the us value wraps too
+        syncs = [(c, e[5]) for c, e in zip(cycles, evs) if e[2] == sync_id and e[3] == TYPE_META]
+        sync_us = unwrap32([s[1] for s in syncs])
+        anchors = [(c, us) for (c, _), us in zip(syncs, sync_us)]
+        if not anchors:
+            anchors = [(cycles[0], 0)]
+
+        ai = 0
+        for c, e in zip(cycles, evs):
+            while ai + 1 < len(anchors) and anchors[ai + 1][0] <= c:
+                ai += 1
+            ac, aus = anchors[ai]
+            ts = aus + (c - ac) / cycles_per_us
+
+            _, task, eid, etype, _, value = e
+            name = dump.names.get(eid, "id%d" % eid)
+            rec = {"name": name, "ts": ts, "pid": pid, "tid": task}
+
+            if etype == TYPE_BEGIN:
+                rec.update(ph="B", args={"value": value, "core": core})
+            elif etype == TYPE_END:
+                rec.update(ph="E")
+            elif etype == TYPE_INSTANT:
+                rec.update(ph="i", s="t", args={"value": value, "core": core})
+            elif etype == TYPE_COUNTER:
+                rec.update(ph="C", tid=0, args={name: value})
+            else:
+                continue
+            out.append(rec)
+
+    for handle, tname in dump.tasks.items():
+        out.append({"name": "thread_name", "ph": "M", "pid": pid, "tid": handle,
+                    "args": {"name": tname}})
+    out.append({"name": "process_name", "ph": "M", "pid": pid,
+                "args": {"name": "esp32 dump %d" % pid}})
+
+    out.sort(key=lambda r: r.get("ts", -1))
+    return out
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    ap.add_argument("log", nargs="?", help="serial log (default: stdin)")
+    ap.add_argument("-o", "--output", help="output JSON (default: stdout)")
+    ap.add_argument("--all", action="store_true", help="convert every dump in the log")
+    args = ap.parse_args()
+
+    src = open(args.log, errors="replace") if args.log else sys.stdin
+    with src:
+        dumps = parse(src)
+    if not dumps:
+        sys.exit("no complete #EVTRACE ... #END block found")
+
+    if not args.all:
+        dumps = dumps[-1:]
+
+    events = []
+    for i, d in enumerate(dumps, 1):
+        events.extend(to_chrome(d, i))
+
+    doc = {"traceEvents": events, "displayTimeUnit": "ms"}
+    dst = open(args.output, "w") if args.output else sys.stdout
+    with dst:
+        json.dump(doc, dst)
+
+    n = sum(len(d.events) for d in dumps)
+    print("%d events from %d dump(s)" % (n, len(dumps)), file=sys.stderr)
+
+
+if __name__ == "__main__":
+    main()
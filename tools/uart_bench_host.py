@@ -0,0 +1,410 @@
+#!/usr/bin/env python3
+"""Far end for the UART experiment BENCH mode (UART protocol v2).
+
+The device sends v2 DATA probes carrying an id and a timestamp. This script
+echoes every valid frame back unchanged, so the device can measure round
+trip time and goodput. It can also play the device side (--probe), which
+is handy against a pty loopback when no board is attached:
+
+    # board on a USB serial adapter wired to UART1 (GPIO35/36); BENCH
+    # needs the device link in COBS framing (UART page LINK, OK)
+    python3 tools/uart_bench_host.py --port /dev/ttyUSB0 --baud 115200 --cobs
+
+    # no hardware: echo and prober talk over a pty pair in one process
+    python3 tools/uart_bench_host.py --loopback --size 256 --rate 0
+
+    # or in two shells
+    python3 tools/uart_bench_host.py --pty            # prints /dev/pts/N
+    python3 tools/uart_bench_host.py --probe --port /dev/pts/N
+
+With the device link in COBS framing (UART page LINK, or
+CONFIG_APP_UART1_COBS) pass --cobs: v2 frames then travel on the data
+channel, the device's deferred log on channel 2 is printed, and --stats
+asks for the link counters on channel 3 once a second. BENCH only runs
+framed: under legacy framing any AA xx 55 inside a probe reads as a key.
+
+Only the standard library is used (termios for the serial setup).
+"""
+
+import argparse
+import binascii
+import os
+import pty
+import select
+import struct
+import sys
+import termios
+import threading
+import time
+import tty
+import zlib
+
+SOF = b"\xB2\x2B"
+VERSION = 2
+FLAG_CRC32 = 0x01
+TYPE_DATA = 1
+TYPE_ACK = 2
+HDR_LEN = 8
+MAX_PAYLOAD = 1024
+BENCH_HDR = 8
+
+# input/cobs_mux.h channels
+MUX_KEY = 0
+MUX_DATA = 1
+MUX_LOG = 2
+MUX_TELEM = 3
+TELEM_FIELDS = ("baud", "rx_bytes", "key_frames", "data_bytes", "ring_overrun", "hw_overruns",
+                "mux_frames", "mux_errors", "dlog_dropped")
+
+
+def crc16(data):
+    # CRC-16/CCITT-FALSE, same as Crc16_Update(CRC16_INIT, ...)
+    return binascii.crc_hqx(data, 0xFFFF)
+
+
+def encode(ftype, seq, ack, payload, flags=0):
+    flags = (VERSION << 4) | (flags & FLAG_CRC32)
+    body = struct.pack("<BBBBH", flags, ftype, seq & 0xFF, ack & 0xFF, len(payload)) + payload
+    if flags & FLAG_CRC32:
+        trailer = struct.pack("<I", zlib.crc32(body) & 0xFFFFFFFF)
+    else:
+        trailer = struct.pack("<H", crc16(body))
+    return SOF + body + trailer
+
+
+def cobs_encode(chan, payload):
+    """00 | COBS(chan, payload, crc16 LE) | 00, as CobsMux_Encode."""
+    raw = bytes([chan]) + payload
+    raw += struct.pack("<H", crc16(raw))
+    out = bytearray(b"\x00")
+    block = bytearray()
+    for b in raw:
+        if b == 0:
+            out.append(len(block) + 1)
+            out += block
+            block.clear()
+            continue
+        block.append(b)
+        if len(block) == 254:
+            out.append(0xFF)
+            out += block
+            block.clear()
+    out.append(len(block) + 1)
+    out += block
+    out.append(0)
+    return bytes(out)
+
+
+def cobs_decode(frame):
+    """One frame between delimiters -> (chan, payload), None when invalid."""
+    out = bytearray()
+    i = 0
+    while i < len(frame):
+        code = frame[i]
+        if code == 0 or i + code > len(frame):
+            return None
+        out += frame[i + 1:i + code]
+        i += code
+        if code != 0xFF and i < len(frame):
+            out.append(0)
+    if len(out) < 3 or struct.unpack_from("<H", out, len(out) - 2)[0] != crc16(bytes(out[:-2])):
+        return None
+    return out[0], bytes(out[1:-2])
+
+
+class Link:
+    """The serial link, raw or COBS framed. read() returns data-channel
+    bytes only; log lines and telemetry are printed as they arrive."""
+
+    def __init__(self, fd, cobs=False, quiet=False):
+        self.fd = fd
+        self.cobs = cobs
+        self.quiet = quiet
+        self.pending = bytearray()
+        self.mux_errors = 0
+
+    def write(self, data):
+        write_all(self.fd, cobs_encode(MUX_DATA, data) if self.cobs else data)
+
+    def request_stats(self):
+        if self.cobs:
+            write_all(self.fd, cobs_encode(MUX_TELEM, b"?"))
+
+    def read(self, n=65536):
+        """None at end of file."""
+        data = os.read(self.fd, n)
+        if not data:
+            return None
+        if not self.cobs:
+            return data
+        self.pending += data
+        *frames, rest = self.pending.split(b"\x00")
+        self.pending = bytearray(rest)
+        out = bytearray()
+        for f in frames:
+            if not f:
+                continue
+            d = cobs_decode(bytes(f))
+            if d is None:
+                self.mux_errors += 1
+                continue
+            chan, payload = d
+            if chan == MUX_DATA:
+                out += payload
+            elif chan == MUX_LOG and not self.quiet:
+                sys.stdout.write("log: " + payload.decode("utf-8", "replace"))
+            elif chan == MUX_TELEM and payload[:1] == b"\x01":
+                n_fields = min(len(TELEM_FIELDS), (len(payload) - 1) // 4)
+                vals = struct.unpack_from("<%dI" % n_fields, payload, 1)
+                print("telemetry: " + "  ".join("%s %d" % kv for kv in zip(TELEM_FIELDS, vals)))
+        return bytes(out)
+
+
+class Parser:
+    """Stream parser; yields (flags, type, seq, ack, payload, raw_frame)."""
+
+    def __init__(self):
+        self.buf = bytearray()
+        self.crc_errors = 0
+        self.header_errors = 0
+
+    def feed(self, data):
+        self.buf += data
+        out = []
+        while True:
+            i = self.buf.find(SOF)
+            if i < 0:
+                # Keep a trailing SOF0 in case SOF1 arrives next
+                del self.buf[:-1 if self.buf[-1:] == SOF[:1] else len(self.buf)]
+                return out
+            if i:
+                del self.buf[:i]
+            if len(self.buf) < HDR_LEN:
+                return out
+
+            flags, ftype, seq, ack, length = struct.unpack_from("<BBBBH", self.buf, 2)
+            ok_hdr = (flags >> 4) == VERSION and not (flags & 0x0E) and (
+                (ftype == TYPE_DATA and length <= MAX_PAYLOAD) or (ftype == TYPE_ACK and length == 0))
+            if not ok_hdr:
+                self.header_errors += 1
+                del self.buf[:2]
+                continue
+
+            crc_len = 4 if flags & FLAG_CRC32 else 2
+            total = HDR_LEN + length + crc_len
+            if len(self.buf) < total:
+                return out
+
+            body = bytes(self.buf[2:HDR_LEN + length])
+            if crc_len == 4:
+                good = struct.unpack_from("<I", self.buf, HDR_LEN + length)[0] == (zlib.crc32(body) & 0xFFFFFFFF)
+            else:
+                good = struct.unpack_from("<H", self.buf, HDR_LEN + length)[0] == crc16(body)
+
+            if not good:
+                self.crc_errors += 1
+                del self.buf[:2]
+                continue
+
+            raw = bytes(self.buf[:total])
+            del self.buf[:total]
+            out.append((flags, ftype, seq, ack, body[6:], raw))
+
+
+BAUDS = {b: getattr(termios, "B%d" % b) for b in
+         (9600, 19200, 38400, 57600, 115200, 230400, 460800, 500000, 576000, 921600,
+          1000000, 1500000, 2000000) if hasattr(termios, "B%d" % b)}
+
+
+def open_port(path, baud):
+    fd = os.open(path, os.O_RDWR | os.O_NOCTTY)
+    tty.setraw(fd)
+    attrs = termios.tcgetattr(fd)
+    if baud in BAUDS:
+        attrs[4] = attrs[5] = BAUDS[baud]
+    else:
+        print("warning: unsupported baud %d, left unchanged" % baud, file=sys.stderr)
+    attrs[2] |= termios.CLOCAL | termios.CREAD
+    termios.tcsetattr(fd, termios.TCSANOW, attrs)
+    return fd
+
+
+def write_all(fd, data):
+    view = memoryview(data)
+    while view:
+        n = os.write(fd, view)
+        view = view[n:]
+
+
+def run_echo(link, stop, quiet=False, stats=False):
+    parser = Parser()
+    frames = 0
+    nbytes = 0
+    last = time.monotonic()
+    while not stop.is_set():
+        r, _, _ = select.select([link.fd], [], [], 0.2)
+        if r:
+            try:
+                data = link.read(4096)
+            except OSError:
+                break
+            if data is None:
+                break
+            for flags, ftype, seq, ack, payload, raw in parser.feed(data):
+                if ftype == TYPE_DATA:
+                    link.write(raw)
+                    frames += 1
+                    nbytes += len(payload)
+
+        now = time.monotonic()
+        if stats and now - last >= 1.0:
+            link.request_stats()
+        if not quiet and now - last >= 1.0:
+            print("echo: %d frames/s  %d B/s  crc_err %d  hdr_err %d" %
+                  (frames / (now - last), nbytes / (now - last), parser.crc_errors,
+                   parser.header_errors))
+            frames = nbytes = 0
+            last = now
+
+
+def percentile(sorted_v, p):
+    if not sorted_v:
+        return 0
+    k = max(0, (len(sorted_v) * p + 99) // 100 - 1)
+    return sorted_v[k]
+
+
+def run_probe(link, size, rate, seconds, depth=4, window=256):
+    """Same algorithm as the device BENCH mode."""
+    size = max(BENCH_HDR, min(size, MAX_PAYLOAD))
+    filler = bytes(i & 0x7F for i in range(size))
+    parser = Parser()
+    t0 = time.monotonic()
+    next_id = 0
+    in_flight = 0
+    sent = 0
+    lost = 0
+    valid_from = 0
+    progress = t0
+    next_due = t0
+    rtts = []
+    rtt_max = 0
+    good = 0
+    last_report = t0
+    good_at_report = 0
+
+    def send():
+        nonlocal next_id, in_flight, sent
+        t_us = int(time.monotonic() * 1e6) & 0xFFFFFFFF
+        pl = struct.pack("<II", next_id & 0xFFFFFFFF, t_us) + filler[BENCH_HDR:]
+        link.write(encode(TYPE_DATA, next_id, 0, pl))
+        next_id += 1
+        in_flight += 1
+        sent += 1
+
+    while time.monotonic() - t0 < seconds:
+        now = time.monotonic()
+        if in_flight and now - progress >= 1.0:
+            lost += in_flight
+            in_flight = 0
+            valid_from = next_id
+            progress = now
+
+        if rate == 0:
+            while in_flight < depth:
+                send()
+            timeout = 0.02
+        else:
+            period = 1.0 / rate
+            if now - next_due > 8 * period:
+                next_due = now
+            while now >= next_due and in_flight < 32:
+                if in_flight == 0:
+                    progress = now
+                send()
+                next_due += period
+            timeout = max(0.0, min(0.02, next_due - time.monotonic()))
+
+        r, _, _ = select.select([link.fd], [], [], timeout)
+        if r:
+            data = link.read()
+            if data is None:
+                break
+            for flags, ftype, seq, ack, payload, raw in parser.feed(data):
+                if ftype != TYPE_DATA or len(payload) < BENCH_HDR:
+                    continue
+                pid, t_us = struct.unpack_from("<II", payload)
+                if not (valid_from & 0xFFFFFFFF) <= pid < (next_id & 0xFFFFFFFF):
+                    continue
+                rtt = ((int(time.monotonic() * 1e6) & 0xFFFFFFFF) - t_us) & 0xFFFFFFFF
+                rtts.append(rtt)
+                del rtts[:-window]
+                rtt_max = max(rtt_max, rtt)
+                in_flight = max(0, in_flight - 1)
+                progress = time.monotonic()
+                good += len(payload)
+
+        now = time.monotonic()
+        if now - last_report >= 1.0:
+            s = sorted(rtts)
+            print("probe: size %d rate %s  p50 %.2f ms  p99 %.2f ms  max %.2f ms  "
+                  "goodput %d B/s  sent %d lost %d" %
+                  (size, rate or "MAX", percentile(s, 50) / 1e3, percentile(s, 99) / 1e3,
+                   rtt_max / 1e3, (good - good_at_report) / (now - last_report), sent, lost))
+            last_report = now
+            good_at_report = good
+
+    return sorted(rtts), rtt_max, good / seconds, sent, lost
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    ap.add_argument("--port", help="serial device or pty path")
+    ap.add_argument("--baud", type=int, default=115200)
+    ap.add_argument("--pty", action="store_true", help="create a pty and echo on it")
+    ap.add_argument("--probe", action="store_true", help="act as the prober instead of the echo")
+    ap.add_argument("--loopback", action="store_true", help="echo + prober over an internal pty pair")
+    ap.add_argument("--size", type=int, default=64, help="probe payload bytes (probe modes)")
+    ap.add_argument("--rate", type=int, default=100, help="probes/s, 0 = closed loop MAX")
+    ap.add_argument("--seconds", type=float, default=10.0, help="probe run time")
+    ap.add_argument("--cobs", action="store_true", help="device link in COBS channel framing")
+    ap.add_argument("--stats", action="store_true", help="with --cobs: poll link telemetry every second")
+    args = ap.parse_args()
+
+    stop = threading.Event()
+
+    if args.loopback:
+        master, slave = pty.openpty()
+        tty.setraw(master)
+        tty.setraw(slave)
+        th = threading.Thread(target=run_echo, args=(Link(master, args.cobs, True), stop, True), daemon=True)
+        th.start()
+        s, mx, gp, sent, lost = run_probe(Link(slave, args.cobs), args.size, args.rate, args.seconds)
+        stop.set()
+        print("result: n %d  p50 %.3f ms  p99 %.3f ms  max %.3f ms  goodput %d B/s  sent %d lost %d" %
+              (len(s), percentile(s, 50) / 1e3, percentile(s, 99) / 1e3, mx / 1e3, gp, sent, lost))
+        return 0 if s else 1
+
+    if args.pty:
+        master, slave = pty.openpty()
+        tty.setraw(slave)
+        print("echo on %s" % os.ttyname(slave), flush=True)
+        fd = master
+    elif args.port:
+        fd = open_port(args.port, args.baud)
+    else:
+        ap.error("need --port, --pty or --loopback")
+
+    try:
+        link = Link(fd, args.cobs)
+        if args.probe:
+            run_probe(link, args.size, args.rate, args.seconds)
+        else:
+            run_echo(link, stop, stats=args.stats)
+    except KeyboardInterrupt:
+        pass
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())